@@ -50,6 +50,7 @@ using theia::LossFunctionType;
 using theia::MatchingStrategy;
 using theia::OptimizeIntrinsicsType;
 using theia::ReconstructionEstimatorType;
+using theia::RelativePoseVerificationType;
 
 inline DescriptorExtractorType StringToDescriptorExtractorType(
     const std::string& descriptor) {
@@ -84,6 +85,10 @@ inline MatchingStrategy StringToMatchingStrategyType(
     return MatchingStrategy::BRUTE_FORCE;
   } else if (matching_strategy == "CASCADE_HASHING") {
     return MatchingStrategy::CASCADE_HASHING;
+  } else if (matching_strategy == "QUANTIZED_BRUTE_FORCE") {
+    return MatchingStrategy::QUANTIZED_BRUTE_FORCE;
+  } else if (matching_strategy == "APPROXIMATE_NEAREST_NEIGHBOR") {
+    return MatchingStrategy::APPROXIMATE_NEAREST_NEIGHBOR;
   } else {
     LOG(FATAL)
         << "Invalid matching strategy specified. Using BRUTE_FORCE instead.";
@@ -91,6 +96,21 @@ inline MatchingStrategy StringToMatchingStrategyType(
   }
 }
 
+inline RelativePoseVerificationType StringToRelativePoseVerificationType(
+    const std::string& verification_type) {
+  if (verification_type == "FIVE_POINT") {
+    return RelativePoseVerificationType::FIVE_POINT;
+  } else if (verification_type == "KNOWN_ROTATION") {
+    return RelativePoseVerificationType::KNOWN_ROTATION;
+  } else if (verification_type == "KNOWN_VERTICAL") {
+    return RelativePoseVerificationType::KNOWN_VERTICAL;
+  } else {
+    LOG(FATAL) << "Invalid relative pose verification type. Please use "
+                  "FIVE_POINT, KNOWN_ROTATION, or KNOWN_VERTICAL.";
+    return RelativePoseVerificationType::FIVE_POINT;
+  }
+}
+
 inline ReconstructionEstimatorType StringToReconstructionEstimatorType(
     const std::string& reconstruction_estimator) {
   if (reconstruction_estimator == "GLOBAL") {
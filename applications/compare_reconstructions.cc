@@ -54,6 +54,8 @@ DEFINE_double(robust_alignment_threshold, 0.0,
               "If greater than 0.0, this threshold sets determines inliers for "
               "RANSAC alignment of reconstructions. The inliers are then used "
               "for a least squares alignment.");
+DEFINE_int32(num_threads, 1,
+             "Number of threads used to apply the alignment transformation.");
 
 using theia::Reconstruction;
 using theia::TrackId;
@@ -133,9 +135,12 @@ void EvaluateAlignedPoseError(
   if (FLAGS_robust_alignment_threshold > 0.0) {
     AlignReconstructionsRobust(FLAGS_robust_alignment_threshold,
                                reference_reconstruction,
+                               FLAGS_num_threads,
                                reconstruction_to_align);
   } else {
-    AlignReconstructions(reference_reconstruction, reconstruction_to_align);
+    AlignReconstructions(reference_reconstruction,
+                         FLAGS_num_threads,
+                         reconstruction_to_align);
   }
 
   std::vector<double> rotation_bins = {1, 2, 5, 10, 15, 20, 45};
@@ -84,8 +84,9 @@ DEFINE_string(feature_density,
               "features from each image.");
 DEFINE_string(matching_strategy,
               "CASCADE_HASHING",
-              "Strategy used to match features. Must be BRUTE_FORCE "
-              " or CASCADE_HASHING");
+              "Strategy used to match features. Must be BRUTE_FORCE, "
+              "CASCADE_HASHING, QUANTIZED_BRUTE_FORCE, or "
+              "APPROXIMATE_NEAREST_NEIGHBOR");
 DEFINE_string(matching_working_directory,
               "",
               "Directory used during matching to store features for "
@@ -97,6 +98,12 @@ DEFINE_double(max_sampson_error_for_verified_match,
               "geometrically valid. This threshold is relative to an image "
               "with a width of 1024 pixels and will be appropriately scaled "
               "for images with different resolutions.");
+DEFINE_string(relative_pose_verification_type,
+              "FIVE_POINT",
+              "Minimal solver used to verify calibrated image pairs. Must be "
+              "FIVE_POINT, KNOWN_ROTATION, or KNOWN_VERTICAL. The known "
+              "orientation solvers are only used for image pairs that both "
+              "have an orientation in the calibration file.");
 DEFINE_int32(min_num_inliers_for_valid_match,
              30,
              "Minimum number of geometrically verified inliers that a pair on "
@@ -200,6 +207,13 @@ DEFINE_double(position_estimation_robust_loss_width,
               0.1,
               "Robust loss width to use for position estimation.");
 
+// Least unsquared deviation position estimation options.
+DEFINE_bool(least_unsquared_deviation_adaptive_rho,
+            false,
+            "Adapt the ADMM penalty parameter to balance the primal and dual "
+            "residuals in least unsquared deviation position estimation. This "
+            "usually reduces the number of iterations.");
+
 // Incremental SfM options.
 DEFINE_double(absolute_pose_reprojection_error_threshold,
               4.0,
@@ -232,6 +246,10 @@ DEFINE_double(
 DEFINE_bool(bundle_adjust_tracks,
             true,
             "Set to true to optimize tracks immediately upon estimation.");
+DEFINE_bool(use_robust_triangulation,
+            false,
+            "Set to true to triangulate tracks with RANSAC over pairs of "
+            "observations and remove outlier observations from the tracks.");
 
 // Bundle adjustment parameters.
 DEFINE_string(bundle_adjustment_robust_loss_function,
@@ -245,6 +263,15 @@ DEFINE_double(bundle_adjustment_robust_loss_width,
               "If the BA loss function is not NONE, then this value controls "
               "where the robust loss begins with respect to reprojection error "
               "in pixels.");
+DEFINE_bool(bundle_adjustment_use_adaptive_linear_solver,
+            false,
+            "Set to true to choose the bundle adjustment linear solver from "
+            "the sparsity of each problem rather than the number of cameras.");
+DEFINE_double(bundle_adjustment_min_relative_cost_decrease_per_second,
+              0.0,
+              "If greater than 0, bundle adjustment stops once the relative "
+              "decrease in reprojection error per second falls below this "
+              "value.");
 
 // Track Subsampling parameters.
 DEFINE_bool(subsample_tracks_for_bundle_adjustment,
@@ -295,6 +322,10 @@ ReconstructionBuilderOptions SetReconstructionBuilderOptions() {
   options.matching_options.geometric_verification_options
       .estimate_twoview_info_options.max_sampson_error_pixels =
       FLAGS_max_sampson_error_for_verified_match;
+  options.matching_options.geometric_verification_options
+      .estimate_twoview_info_options.verification_type =
+      StringToRelativePoseVerificationType(
+          FLAGS_relative_pose_verification_type);
   options.matching_options.geometric_verification_options.bundle_adjustment =
       FLAGS_bundle_adjust_two_view_geometry;
   options.matching_options.geometric_verification_options
@@ -353,6 +384,9 @@ ReconstructionBuilderOptions SetReconstructionBuilderOptions() {
   reconstruction_estimator_options.nonlinear_position_estimator_options
       .min_num_points_per_view =
       FLAGS_position_estimation_min_num_tracks_per_view;
+  reconstruction_estimator_options
+      .least_unsquared_deviation_position_estimator_options.adaptive_rho =
+      FLAGS_least_unsquared_deviation_adaptive_rho;
   reconstruction_estimator_options
       .refine_camera_positions_and_points_after_position_estimation =
       FLAGS_refine_camera_positions_and_points_after_position_estimation;
@@ -375,12 +409,20 @@ ReconstructionBuilderOptions SetReconstructionBuilderOptions() {
       FLAGS_triangulation_reprojection_error_pixels;
   reconstruction_estimator_options.bundle_adjust_tracks =
       FLAGS_bundle_adjust_tracks;
+  reconstruction_estimator_options.use_robust_triangulation =
+      FLAGS_use_robust_triangulation;
 
   // Bundle adjustment options (used by all SfM pipelines).
   reconstruction_estimator_options.bundle_adjustment_loss_function_type =
       StringToLossFunction(FLAGS_bundle_adjustment_robust_loss_function);
   reconstruction_estimator_options.bundle_adjustment_robust_loss_width =
       FLAGS_bundle_adjustment_robust_loss_width;
+  reconstruction_estimator_options
+      .bundle_adjustment_use_adaptive_linear_solver =
+      FLAGS_bundle_adjustment_use_adaptive_linear_solver;
+  reconstruction_estimator_options
+      .bundle_adjustment_min_relative_cost_decrease_per_second =
+      FLAGS_bundle_adjustment_min_relative_cost_decrease_per_second;
 
   // Track subsampling options.
   reconstruction_estimator_options.subsample_tracks_for_bundle_adjustment =
@@ -60,6 +60,8 @@
 #endif  // __APPLE__
 
 DEFINE_string(reconstruction, "", "Reconstruction file to be viewed.");
+DEFINE_int32(num_threads, 1,
+             "Number of threads used to normalize the reconstruction.");
 
 // Containers for the data.
 std::vector<theia::Camera> cameras;
@@ -424,7 +426,7 @@ int main(int argc, char* argv[]) {
       << "Could not read reconstruction file.";
 
   // Centers the reconstruction based on the absolute deviation of 3D points.
-  reconstruction->Normalize();
+  reconstruction->Normalize(FLAGS_num_threads);
 
   // Set up camera drawing.
   cameras.reserve(reconstruction->NumViews());
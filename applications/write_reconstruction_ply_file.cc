@@ -41,6 +41,9 @@ DEFINE_string(ply_file, "", "Output PLY file.");
 DEFINE_int32(min_num_observations_per_point, 3,
              "Minimum number of observations for a point to be written out to "
              "the PLY file. This helps reduce noise in the resulty PLY file.");
+DEFINE_bool(binary, false,
+            "Write the PLY file in binary little endian format instead of "
+            "ASCII. Binary files are much faster to write and are smaller.");
 
 int main(int argc, char* argv[]) {
   google::InitGoogleLogging(argv[0]);
@@ -52,7 +55,10 @@ int main(int argc, char* argv[]) {
 
   CHECK(WritePlyFile(FLAGS_ply_file,
                      reconstruction,
-                     FLAGS_min_num_observations_per_point))
+                     FLAGS_min_num_observations_per_point,
+                     FLAGS_binary
+                         ? theia::PlyFileFormat::BINARY_LITTLE_ENDIAN
+                         : theia::PlyFileFormat::ASCII))
       << "Could not write out PLY file.";
   return 0;
 }
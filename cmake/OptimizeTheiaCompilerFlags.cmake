@@ -94,9 +94,9 @@ macro(OptimizeTheiaCompilerFlags)
     if (CMAKE_COMPILER_IS_GNUCXX)
       # Linux
       if (CMAKE_SYSTEM_NAME MATCHES "Linux")
-        if (NOT GCC_VERSION VERSION_LESS 4.2)
+        if (BUILD_FOR_NATIVE_CPU AND NOT GCC_VERSION VERSION_LESS 4.2)
           set (THEIA_CXX_FLAGS "${THEIA_CXX_FLAGS} -march=native -mtune=native")
-        endif (NOT GCC_VERSION VERSION_LESS 4.2)
+        endif (BUILD_FOR_NATIVE_CPU AND NOT GCC_VERSION VERSION_LESS 4.2)
       endif (CMAKE_SYSTEM_NAME MATCHES "Linux")
       # Mac OS X
       if (CMAKE_SYSTEM_NAME MATCHES "Darwin")
@@ -42,6 +42,7 @@
 #include "theia/image/descriptor/sift_descriptor.h"
 #include "theia/image/image.h"
 #include "theia/image/image_cache.h"
+#include "theia/image/image_mask.h"
 #include "theia/image/keypoint_detector/keypoint.h"
 #include "theia/image/keypoint_detector/keypoint_detector.h"
 #include "theia/image/keypoint_detector/sift_detector.h"
@@ -59,6 +60,7 @@
 #include "theia/io/reconstruction_writer.h"
 #include "theia/io/sift_binary_file.h"
 #include "theia/io/sift_text_file.h"
+#include "theia/io/track_and_view_graph_files.h"
 #include "theia/io/write_bundler_files.h"
 #include "theia/io/write_calibration.h"
 #include "theia/io/write_keypoints_and_descriptors.h"
@@ -69,18 +71,23 @@
 #include "theia/matching/cascade_hashing_feature_matcher.h"
 #include "theia/matching/create_feature_matcher.h"
 #include "theia/matching/distance.h"
+#include "theia/matching/distance_kernels.h"
 #include "theia/matching/feature_correspondence.h"
 #include "theia/matching/feature_matcher.h"
 #include "theia/matching/feature_matcher_options.h"
 #include "theia/matching/feature_matcher_utils.h"
 #include "theia/matching/features_and_matches_database.h"
 #include "theia/matching/fisher_vector_extractor.h"
+#include "theia/matching/flann_feature_matcher.h"
 #include "theia/matching/global_descriptor_extractor.h"
 #include "theia/matching/guided_epipolar_matcher.h"
 #include "theia/matching/image_pair_match.h"
+#include "theia/matching/image_pair_matching_log.h"
 #include "theia/matching/indexed_feature_match.h"
 #include "theia/matching/in_memory_features_and_matches_database.h"
 #include "theia/matching/keypoints_and_descriptors.h"
+#include "theia/matching/quantized_brute_force_feature_matcher.h"
+#include "theia/matching/quantized_descriptors.h"
 #include "theia/matching/rocksdb_features_and_matches_database.h"
 #include "theia/math/closed_form_polynomial_solver.h"
 #include "theia/math/constrained_l1_solver.h"
@@ -90,6 +97,7 @@
 #include "theia/math/graph/connected_components.h"
 #include "theia/math/graph/minimum_spanning_tree.h"
 #include "theia/math/graph/normalized_graph_cut.h"
+#include "theia/math/graph/parallel_connected_components.h"
 #include "theia/math/graph/triplet_extractor.h"
 #include "theia/math/histogram.h"
 #include "theia/math/l1_solver.h"
@@ -105,6 +113,7 @@
 #include "theia/math/reservoir_sampler.h"
 #include "theia/math/rotation.h"
 #include "theia/math/util.h"
+#include "theia/sfm/bundle_adjustment/adaptive_bundle_adjustment.h"
 #include "theia/sfm/bundle_adjustment/angular_epipolar_error.h"
 #include "theia/sfm/bundle_adjustment/bundle_adjust_two_views.h"
 #include "theia/sfm/bundle_adjustment/bundle_adjuster.h"
@@ -113,6 +122,7 @@
 #include "theia/sfm/bundle_adjustment/optimize_relative_position_with_known_rotation.h"
 #include "theia/sfm/bundle_adjustment/orthogonal_vector_error.h"
 #include "theia/sfm/bundle_adjustment/unit_norm_three_vector_parameterization.h"
+#include "theia/sfm/camera/batch_distortion_utils.h"
 #include "theia/sfm/camera/camera.h"
 #include "theia/sfm/camera/camera_intrinsics_model.h"
 #include "theia/sfm/camera/camera_intrinsics_model_type.h"
@@ -136,6 +146,7 @@
 #include "theia/sfm/estimators/estimate_homography.h"
 #include "theia/sfm/estimators/estimate_relative_pose.h"
 #include "theia/sfm/estimators/estimate_relative_pose_with_known_orientation.h"
+#include "theia/sfm/estimators/estimate_relative_pose_with_known_vertical.h"
 #include "theia/sfm/estimators/estimate_rigid_transformation_2d_3d.h"
 #include "theia/sfm/estimators/estimate_similarity_transformation_2d_3d.h"
 #include "theia/sfm/estimators/estimate_triangulation.h"
@@ -180,6 +191,7 @@
 #include "theia/sfm/pose/four_point_relative_pose_partial_rotation.h"
 #include "theia/sfm/pose/fundamental_matrix_util.h"
 #include "theia/sfm/pose/perspective_three_point.h"
+#include "theia/sfm/pose/perspective_three_point_lambda_twist.h"
 #include "theia/sfm/pose/position_from_two_rays.h"
 #include "theia/sfm/pose/relative_pose_from_two_points_with_known_rotation.h"
 #include "theia/sfm/pose/seven_point_fundamental_matrix.h"
@@ -234,6 +246,7 @@
 #include "theia/solvers/ransac.h"
 #include "theia/solvers/sample_consensus_estimator.h"
 #include "theia/solvers/sampler.h"
+#include "theia/util/cpu_features.h"
 #include "theia/util/enable_enum_bitmask_operators.h"
 #include "theia/util/filesystem.h"
 #include "theia/util/hash.h"
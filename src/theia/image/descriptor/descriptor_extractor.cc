@@ -35,32 +35,158 @@
 #include "theia/image/descriptor/descriptor_extractor.h"
 
 #include <Eigen/Core>
+#include <glog/logging.h>
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+#include <utility>
+#include <vector>
 
 #include "theia/image/image.h"
+#include "theia/image/image_mask.h"
 #include "theia/image/keypoint_detector/keypoint.h"
 
 namespace theia {
+namespace {
+
+// Features are detected in a region of interest that contains all valid pixels
+// of the mask plus a margin so that keypoints near the border of the valid
+// region have the image support they need. The top-left corner of the region is
+// aligned so that the first octaves of the scale space sample the same pixels
+// as they would for the full image.
+static constexpr int kRegionOfInterestMargin = 64;
+static constexpr int kRegionOfInterestAlignment = 16;
+// Cropping the image is only worth it if it removes enough pixels.
+static constexpr double kMaxRegionOfInterestAreaRatio = 0.9;
+
+// Removes the features that lie in invalid pixels of the mask in a single pass.
+void RemoveMaskedFeatures(const ImageMask& mask,
+                          std::vector<Keypoint>* keypoints,
+                          std::vector<Eigen::VectorXf>* descriptors) {
+  CHECK_EQ(keypoints->size(), descriptors->size());
+  int num_valid_features = 0;
+  for (int i = 0; i < keypoints->size(); i++) {
+    if (!mask.IsValid((*keypoints)[i].x(), (*keypoints)[i].y())) {
+      continue;
+    }
+    if (i != num_valid_features) {
+      (*keypoints)[num_valid_features] = (*keypoints)[i];
+      (*descriptors)[num_valid_features].swap((*descriptors)[i]);
+    }
+    ++num_valid_features;
+  }
+  keypoints->resize(num_valid_features);
+  descriptors->resize(num_valid_features);
+}
+
+}  // namespace
 
 // Compute the descriptor for multiple keypoints in a given image.
 bool DescriptorExtractor::ComputeDescriptors(
     const FloatImage& image,
     std::vector<Keypoint>* keypoints,
     std::vector<Eigen::VectorXf>* descriptors) {
-  const FloatImage& gray_image = image.AsGrayscaleImage();
-  descriptors->reserve(keypoints->size());
-
-  auto keypoint_it = keypoints->begin();
-  while (keypoint_it != keypoints->end()) {
-    Eigen::VectorXf descriptor;
-    if (!ComputeDescriptor(gray_image,
-                           *keypoint_it,
-                           &descriptor)) {
-      keypoint_it = keypoints->erase(keypoint_it);
+  const FloatImage gray_image = image.AsGrayscaleImage();
+  std::vector<Eigen::VectorXf> keypoint_descriptors(keypoints->size());
+  std::vector<bool> is_valid(keypoints->size(), false);
+  ComputeDescriptorsOfKeypoints(
+      gray_image, *keypoints, &keypoint_descriptors, &is_valid);
+
+  // Remove the keypoints whose descriptors could not be extracted in a single
+  // pass.
+  descriptors->reserve(descriptors->size() + keypoints->size());
+  int num_valid_keypoints = 0;
+  for (int i = 0; i < keypoints->size(); i++) {
+    if (!is_valid[i]) {
       continue;
     }
+    (*keypoints)[num_valid_keypoints++] = (*keypoints)[i];
+    descriptors->emplace_back(std::move(keypoint_descriptors[i]));
+  }
+  keypoints->resize(num_valid_keypoints);
+  return true;
+}
+
+void DescriptorExtractor::ComputeDescriptorsOfKeypoints(
+    const FloatImage& gray_image,
+    const std::vector<Keypoint>& keypoints,
+    std::vector<Eigen::VectorXf>* descriptors,
+    std::vector<bool>* is_valid) {
+  for (int i = 0; i < keypoints.size(); i++) {
+    (*is_valid)[i] =
+        ComputeDescriptor(gray_image, keypoints[i], &(*descriptors)[i]);
+  }
+}
 
-    descriptors->push_back(descriptor);
+bool DescriptorExtractor::DetectAndExtractDescriptorsWithMask(
+    const FloatImage& image,
+    const ImageMask& mask,
+    std::vector<Keypoint>* keypoints,
+    std::vector<Eigen::VectorXf>* descriptors) {
+  CHECK(mask.Width() == image.Width() && mask.Height() == image.Height())
+      << "The image and the mask must have the same size.";
+  int min_x, min_y, max_x, max_y;
+  if (!mask.GetValidRegion(&min_x, &min_y, &max_x, &max_y)) {
+    VLOG(2) << "The mask does not contain any valid pixels.";
+    return true;
+  }
+
+  min_x = std::max(0, min_x - kRegionOfInterestMargin);
+  min_y = std::max(0, min_y - kRegionOfInterestMargin);
+  min_x -= min_x % kRegionOfInterestAlignment;
+  min_y -= min_y % kRegionOfInterestAlignment;
+  max_x = std::min(image.Width() - 1, max_x + kRegionOfInterestMargin);
+  max_y = std::min(image.Height() - 1, max_y + kRegionOfInterestMargin);
+  const int roi_width = max_x - min_x + 1;
+  const int roi_height = max_y - min_y + 1;
+  if (roi_width * static_cast<double>(roi_height) >
+      kMaxRegionOfInterestAreaRatio * image.Width() * image.Height()) {
+    return DetectAndExtractDescriptorsInMask(
+        image, mask, keypoints, descriptors);
+  }
+
+  // Copy the region of interest of the grayscale image.
+  const FloatImage gray_image = image.AsGrayscaleImage();
+  FloatImage roi_image(roi_width, roi_height, 1);
+  for (int y = 0; y < roi_height; y++) {
+    std::memcpy(roi_image.Data() + y * roi_width,
+                gray_image.Data() + (min_y + y) * gray_image.Width() + min_x,
+                roi_width * sizeof(float));
+  }
+  const ImageMask roi_mask = mask.Crop(min_x, min_y, roi_width, roi_height);
+
+  const int num_existing_keypoints = keypoints->size();
+  if (!DetectAndExtractDescriptorsInMask(
+          roi_image, roi_mask, keypoints, descriptors)) {
+    return false;
+  }
+
+  // Move the keypoints back to the coordinate system of the full image.
+  for (int i = num_existing_keypoints; i < keypoints->size(); i++) {
+    (*keypoints)[i].set_x((*keypoints)[i].x() + min_x);
+    (*keypoints)[i].set_y((*keypoints)[i].y() + min_y);
+  }
+  return true;
+}
+
+bool DescriptorExtractor::DetectAndExtractDescriptorsInMask(
+    const FloatImage& image,
+    const ImageMask& mask,
+    std::vector<Keypoint>* keypoints,
+    std::vector<Eigen::VectorXf>* descriptors) {
+  std::vector<Keypoint> detected_keypoints;
+  std::vector<Eigen::VectorXf> detected_descriptors;
+  if (!DetectAndExtractDescriptors(
+          image, &detected_keypoints, &detected_descriptors)) {
+    return false;
   }
+  RemoveMaskedFeatures(mask, &detected_keypoints, &detected_descriptors);
+  keypoints->insert(keypoints->end(),
+                    detected_keypoints.begin(),
+                    detected_keypoints.end());
+  descriptors->insert(descriptors->end(),
+                      std::make_move_iterator(detected_descriptors.begin()),
+                      std::make_move_iterator(detected_descriptors.end()));
   return true;
 }
 
@@ -42,6 +42,7 @@
 
 namespace theia {
 class FloatImage;
+class ImageMask;
 class Keypoint;
 
 // This interface class is meant to define all descriptor extractors. Different
@@ -65,7 +66,9 @@ class DescriptorExtractor {
   // Compute the descriptors for multiple keypoints in a given image. This
   // method will return all descriptors that could be extracted. If any
   // descriptors could not be extracted at a given keypoint, that keypoint will
-  // be removed from the container. Returns true on success and false on
+  // be removed from the container. The image is converted to grayscale once and
+  // all descriptors are computed with a single call to
+  // ComputeDescriptorsOfKeypoints. Returns true on success and false on
   // failure.
   virtual bool ComputeDescriptors(
       const FloatImage& image,
@@ -80,6 +83,41 @@ class DescriptorExtractor {
       std::vector<Keypoint>* keypoints,
       std::vector<Eigen::VectorXf>* descriptors) = 0;
 
+  // Detects keypoints and extracts descriptors only in the valid pixels of the
+  // mask, which must have the same size as the image. If the valid pixels only
+  // cover part of the image then detection is restricted to a region of
+  // interest around them.
+  bool DetectAndExtractDescriptorsWithMask(
+      const FloatImage& image,
+      const ImageMask& mask,
+      std::vector<Keypoint>* keypoints,
+      std::vector<Eigen::VectorXf>* descriptors);
+
+ protected:
+  // Computes the descriptors of all keypoints of the grayscale image at once.
+  // The descriptor of the i-th keypoint is written to (*descriptors)[i] and
+  // (*is_valid)[i] is set to whether it could be extracted. The default
+  // implementation calls ComputeDescriptor for each keypoint. Derived classes
+  // should override this method if the descriptors of different keypoints share
+  // expensive work (e.g., building a scale space).
+  virtual void ComputeDescriptorsOfKeypoints(
+      const FloatImage& gray_image,
+      const std::vector<Keypoint>& keypoints,
+      std::vector<Eigen::VectorXf>* descriptors,
+      std::vector<bool>* is_valid);
+
+  // Detects keypoints and extracts descriptors in the valid pixels of the mask,
+  // where the mask has the same size as the image. New features are appended
+  // to the output containers. The default
+  // implementation extracts all features and then removes the ones that lie in
+  // invalid pixels. Derived classes should override this method if keypoints
+  // can be rejected before their descriptors are computed.
+  virtual bool DetectAndExtractDescriptorsInMask(
+      const FloatImage& image,
+      const ImageMask& mask,
+      std::vector<Keypoint>* keypoints,
+      std::vector<Eigen::VectorXf>* descriptors);
+
  private:
   DISALLOW_COPY_AND_ASSIGN(DescriptorExtractor);
 };
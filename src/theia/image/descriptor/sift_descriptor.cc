@@ -43,6 +43,7 @@ extern "C" {
 #include "glog/logging.h"
 #include "theia/image/descriptor/descriptor_extractor.h"
 #include "theia/image/image.h"
+#include "theia/image/image_mask.h"
 #include "theia/image/keypoint_detector/keypoint.h"
 #include <Eigen/Core>
 
@@ -71,7 +72,10 @@ double GetValidFirstOctave(const int first_octave,
 
 SiftDescriptorExtractor::SiftDescriptorExtractor(
     const SiftParameters& detector_params)
-    : sift_params_(detector_params), sift_filter_(nullptr, vl_sift_delete) {}
+    : sift_params_(detector_params),
+      sift_filter_(nullptr, vl_sift_delete),
+      bound_image_data_(nullptr),
+      has_bound_scale_space_(false) {}
 
 SiftDescriptorExtractor::SiftDescriptorExtractor(int num_octaves,
                                                  int num_levels,
@@ -81,7 +85,9 @@ SiftDescriptorExtractor::SiftDescriptorExtractor(int num_octaves,
                    first_octave,
                    10.0f,
                    255.0 * 0.02 / num_levels),
-      sift_filter_(nullptr, vl_sift_delete) {}
+      sift_filter_(nullptr, vl_sift_delete),
+      bound_image_data_(nullptr),
+      has_bound_scale_space_(false) {}
 
 SiftDescriptorExtractor::SiftDescriptorExtractor()
     : SiftDescriptorExtractor(-1, 3, -1) {}
@@ -94,19 +100,12 @@ bool SiftDescriptorExtractor::ComputeDescriptor(const FloatImage& image,
   CHECK(keypoint.has_scale() && keypoint.has_orientation())
       << "Keypoint must have scale and orientation to compute a SIFT "
       << "descriptor.";
-  // If the filter has been set, but is not usable for the input image (i.e. the
-  // width and height are different) then we must make a new filter. Adding this
-  // statement will save the function from regenerating the filter for
-  // successive calls with images of the same size (e.g. a video sequence).
-  if (!sift_filter_ || (sift_filter_->width != image.Cols() ||
-                        sift_filter_->height != image.Rows())) {
-    const int first_octave = GetValidFirstOctave(
-        sift_params_.first_octave, image.Rows(), image.Cols());
-    sift_filter_.reset(vl_sift_new(image.Cols(),
-                                   image.Rows(),
-                                   sift_params_.num_octaves,
-                                   sift_params_.num_levels,
-                                   first_octave));
+  if (bound_gray_image_ != nullptr) {
+    CHECK_EQ(image.Data(), bound_image_data_)
+        << "ComputeDescriptor must be called with the bound image.";
+  }
+  if (!has_bound_scale_space_) {
+    PrepareSiftFilter(image.Cols(), image.Rows());
   }
 
   // Create the vl sift keypoint from the one passed in.
@@ -117,26 +116,32 @@ bool SiftDescriptorExtractor::ComputeDescriptor(const FloatImage& image,
                         keypoint.y(),
                         keypoint.scale());
 
-  // The VLFeat functions take in a non-const image pointer so that it can
-  // calculate gaussian pyramids. Obviously, we do not want to break our const
-  // input, so the best solution (for now) is to copy the image.
-  FloatImage mutable_image = image.AsGrayscaleImage();
-
-  // Calculate the first octave to process.
-  int vl_status =
-      vl_sift_process_first_octave(sift_filter_.get(), mutable_image.Data());
-  // Proceed through the octaves we reach the same one as the keypoint.
-  while (sift_keypoint.o != sift_filter_->o_cur) {
-    vl_sift_process_next_octave(sift_filter_.get());
+  // VLFeat only keeps the current octave of the scale space, so the scale space
+  // has to be built again if the keypoint belongs to an octave that has already
+  // been processed.
+  if (!has_bound_scale_space_ || sift_keypoint.o < sift_filter_->o_cur) {
+    has_bound_scale_space_ = false;
+    const int vl_status = bound_gray_image_ != nullptr
+                              ? ProcessFirstOctave(*bound_gray_image_)
+                              : ProcessFirstOctave(image.AsGrayscaleImage());
+    if (vl_status == VL_ERR_EOF) {
+      VLOG(2) << "Could not compute the first octave of the image.";
+      return false;
+    }
+    has_bound_scale_space_ = bound_gray_image_ != nullptr;
   }
 
-  if (vl_status == VL_ERR_EOF) {
-    LOG(FATAL) << "could not extract sift descriptors";
+  // Proceed through the octaves until we reach the one of the keypoint.
+  while (sift_filter_->o_cur < sift_keypoint.o) {
+    if (vl_sift_process_next_octave(sift_filter_.get()) == VL_ERR_EOF) {
+      VLOG(2) << "Could not reach the octave of the keypoint.";
+      return false;
+    }
   }
 
   // Calculate the sift feature. Note that we are passing in a direct pointer to
   // the descriptor's underlying data.
-  CHECK_NOTNULL(descriptor)->resize(128);
+  CHECK_NOTNULL(descriptor)->setZero(kNumSiftDimensions);
   vl_sift_calc_keypoint_descriptor(sift_filter_.get(),
                                    descriptor->data(),
                                    &sift_keypoint,
@@ -147,92 +152,87 @@ bool SiftDescriptorExtractor::ComputeDescriptor(const FloatImage& image,
   return true;
 }
 
-bool SiftDescriptorExtractor::ComputeDescriptors(
-    const FloatImage& image,
-    std::vector<Keypoint>* keypoints,
-    std::vector<Eigen::VectorXf>* descriptors) {
-  // If the filter has been set, but is not usable for the input image (i.e. the
-  // width and height are different) then we must make a new filter. Adding this
-  // statement will save the function from regenerating the filter for
-  // successive calls with images of the same size (e.g. a video sequence).
-  if (!sift_filter_ || (sift_filter_->width != image.Cols() ||
-                        sift_filter_->height != image.Rows())) {
-    const int first_octave = GetValidFirstOctave(
-        sift_params_.first_octave, image.Rows(), image.Cols());
-    sift_filter_.reset(vl_sift_new(image.Cols(),
-                                   image.Rows(),
-                                   sift_params_.num_octaves,
-                                   sift_params_.num_levels,
-                                   first_octave));
-  }
+void SiftDescriptorExtractor::BindImage(const FloatImage& image) {
+  bound_gray_image_.reset(new FloatImage(image.AsGrayscaleImage()));
+  bound_image_data_ = image.Data();
+  has_bound_scale_space_ = false;
+}
 
-  // Create the vl sift keypoint from the one passed in.
-  std::vector<VlSiftKeypoint> sift_keypoints(keypoints->size());
-  for (int i = 0; i < keypoints->size(); i++) {
-    CHECK((*keypoints)[i].has_scale() && (*keypoints)[i].has_orientation())
+void SiftDescriptorExtractor::UnbindImage() {
+  bound_gray_image_.reset();
+  bound_image_data_ = nullptr;
+  has_bound_scale_space_ = false;
+}
+
+void SiftDescriptorExtractor::ComputeDescriptorsOfKeypoints(
+    const FloatImage& gray_image,
+    const std::vector<Keypoint>& keypoints,
+    std::vector<Eigen::VectorXf>* descriptors,
+    std::vector<bool>* is_valid) {
+  PrepareSiftFilter(gray_image.Cols(), gray_image.Rows());
+
+  // Create the vl sift keypoints from the ones passed in.
+  std::vector<VlSiftKeypoint> sift_keypoints(keypoints.size());
+  for (int i = 0; i < keypoints.size(); i++) {
+    CHECK(keypoints[i].has_scale() && keypoints[i].has_orientation())
         << "Keypoint must have scale and orientation to compute a SIFT "
         << "descriptor.";
     vl_sift_keypoint_init(sift_filter_.get(),
                           &sift_keypoints[i],
-                          (*keypoints)[i].x(),
-                          (*keypoints)[i].y(),
-                          (*keypoints)[i].scale());
+                          keypoints[i].x(),
+                          keypoints[i].y(),
+                          keypoints[i].scale());
   }
-  // The VLFeat functions take in a non-const image pointer so that it can
-  // calculate gaussian pyramids. Obviously, we do not want to break our const
-  // input, so the best solution (for now) is to copy the image.
-  FloatImage mutable_image = image.AsGrayscaleImage();
 
   // Calculate the first octave to process.
-  int vl_status =
-      vl_sift_process_first_octave(sift_filter_.get(), mutable_image.Data());
+  int vl_status = ProcessFirstOctave(gray_image);
 
-  // Proceed through the octaves we reach the same one as the keypoint.  We
-  // first resize the descriptors vector so that the keypoint indicies will be
-  // properly matched to the descriptors.
-  descriptors->resize(keypoints->size(), Eigen::VectorXf(128));
+  // Proceed through the octaves and compute the descriptors of the keypoints
+  // that belong to each of them. Keypoints of octaves that are never reached
+  // remain invalid.
   while (vl_status != VL_ERR_EOF) {
-    // Go through each keypoint to see if it came from this octave.
     for (int i = 0; i < sift_keypoints.size(); i++) {
       if (sift_keypoints[i].o != sift_filter_->o_cur) continue;
 
+      Eigen::VectorXf& descriptor = (*descriptors)[i];
+      descriptor.setZero(kNumSiftDimensions);
       vl_sift_calc_keypoint_descriptor(sift_filter_.get(),
-                                       (*descriptors)[i].data(),
+                                       descriptor.data(),
                                        &sift_keypoints[i],
-                                       (*keypoints)[i].orientation());
+                                       keypoints[i].orientation());
+      if (sift_params_.root_sift) {
+        ConvertToRootSift(&descriptor);
+      }
+      (*is_valid)[i] = true;
     }
     vl_status = vl_sift_process_next_octave(sift_filter_.get());
   }
+}
 
-  if (sift_params_.root_sift) {
-    for (int i = 0; i < descriptors->size(); i++) {
-      ConvertToRootSift(&(*descriptors)[i]);
-    }
-  }
+bool SiftDescriptorExtractor::DetectAndExtractDescriptors(
+    const FloatImage& image,
+    std::vector<Keypoint>* keypoints,
+    std::vector<Eigen::VectorXf>* descriptors) {
+  return DetectAndExtractMaskedDescriptors(
+      image, nullptr, keypoints, descriptors);
+}
 
-  return true;
+bool SiftDescriptorExtractor::DetectAndExtractDescriptorsInMask(
+    const FloatImage& image,
+    const ImageMask& mask,
+    std::vector<Keypoint>* keypoints,
+    std::vector<Eigen::VectorXf>* descriptors) {
+  return DetectAndExtractMaskedDescriptors(
+      image, &mask, keypoints, descriptors);
 }
 
-bool SiftDescriptorExtractor::DetectAndExtractDescriptors(
+bool SiftDescriptorExtractor::DetectAndExtractMaskedDescriptors(
     const FloatImage& image,
+    const ImageMask* mask,
     std::vector<Keypoint>* keypoints,
     std::vector<Eigen::VectorXf>* descriptors) {
-  // If the filter has been set, but is not usable for the input image (i.e. the
-  // width and height are different) then we must make a new filter. Adding this
-  // statement will save the function from regenerating the filter for
-  // successive calls with images of the same size (e.g. a video sequence).
-  if (!sift_filter_ || (sift_filter_->width != image.Cols() ||
-                        sift_filter_->height != image.Rows())) {
-    const int first_octave = GetValidFirstOctave(
-        sift_params_.first_octave, image.Rows(), image.Cols());
-    sift_filter_.reset(vl_sift_new(image.Cols(),
-                                   image.Rows(),
-                                   sift_params_.num_octaves,
-                                   sift_params_.num_levels,
-                                   first_octave));
-    vl_sift_set_edge_thresh(sift_filter_.get(), sift_params_.edge_threshold);
-    vl_sift_set_peak_thresh(sift_filter_.get(), sift_params_.peak_threshold);
-  }
+  const int num_existing_descriptors = descriptors->size();
+  PrepareSiftFilter(image.Cols(), image.Rows());
 
   // The VLFeat functions take in a non-const image pointer so that it can
   // calculate gaussian pyramids. Obviously, we do not want to break our const
@@ -240,8 +240,7 @@ bool SiftDescriptorExtractor::DetectAndExtractDescriptors(
   FloatImage mutable_image = image.AsGrayscaleImage();
 
   // Calculate the first octave to process.
-  int vl_status =
-      vl_sift_process_first_octave(sift_filter_.get(), mutable_image.Data());
+  int vl_status = ProcessFirstOctave(mutable_image);
   // Process octaves until you can't anymore.
   while (vl_status != VL_ERR_EOF) {
     // Detect the keypoints.
@@ -253,6 +252,12 @@ bool SiftDescriptorExtractor::DetectAndExtractDescriptors(
     const int num_keypoints = vl_sift_get_nkeypoints(sift_filter_.get());
 
     for (int i = 0; i < num_keypoints; ++i) {
+      // Skip masked keypoints before doing any work on them.
+      if (mask != nullptr &&
+          !mask->IsValid(vl_keypoints[i].x, vl_keypoints[i].y)) {
+        continue;
+      }
+
       // Calculate (up to 4) orientations of the keypoint.
       double angles[4];
       int num_angles = vl_sift_calc_keypoint_orientations(
@@ -281,15 +286,47 @@ bool SiftDescriptorExtractor::DetectAndExtractDescriptors(
   }
 
   if (sift_params_.root_sift) {
-    for (auto& descriptor : *descriptors) {
-      ConvertToRootSift(&descriptor);
-      CHECK(!descriptor.hasNaN());
+    for (int i = num_existing_descriptors; i < descriptors->size(); i++) {
+      ConvertToRootSift(&(*descriptors)[i]);
+      CHECK(!(*descriptors)[i].hasNaN());
     }
   }
 
   return true;
 }
 
+void SiftDescriptorExtractor::PrepareSiftFilter(const int width,
+                                                const int height) {
+  has_bound_scale_space_ = false;
+  // If the filter has been set, but is not usable for the input image (i.e. the
+  // width and height are different) then we must make a new filter. Adding this
+  // statement will save the function from regenerating the filter for
+  // successive calls with images of the same size (e.g. a video sequence).
+  if (sift_filter_ &&
+      sift_filter_->width == width && sift_filter_->height == height) {
+    return;
+  }
+  const int first_octave =
+      GetValidFirstOctave(sift_params_.first_octave, width, height);
+  sift_filter_.reset(vl_sift_new(width,
+                                 height,
+                                 sift_params_.num_octaves,
+                                 sift_params_.num_levels,
+                                 first_octave));
+  vl_sift_set_edge_thresh(sift_filter_.get(), sift_params_.edge_threshold);
+  vl_sift_set_peak_thresh(sift_filter_.get(), sift_params_.peak_threshold);
+}
+
+int SiftDescriptorExtractor::ProcessFirstOctave(const FloatImage& gray_image) {
+  const int vl_status =
+      vl_sift_process_first_octave(sift_filter_.get(), gray_image.Data());
+  // VLFeat only recomputes the gradients when the octave changes, so the
+  // gradients of a previous image would be used for the first octave of this
+  // image if the filter is reused.
+  sift_filter_->grad_o = sift_filter_->o_min - 1;
+  return vl_status;
+}
+
 // Converts to a RootSIFT descriptor which is proven to provide better matches
 // for SIFT: "Three things everyone should know to improve object retrieval" by
 // Arandjelovic and Zisserman.
@@ -49,6 +49,7 @@ extern "C" {
 namespace theia {
 
 class FloatImage;
+class ImageMask;
 class Keypoint;
 
 class SiftDescriptorExtractor : public DescriptorExtractor {
@@ -61,15 +62,22 @@ class SiftDescriptorExtractor : public DescriptorExtractor {
   SiftDescriptorExtractor();
   ~SiftDescriptorExtractor();
 
-  // Computes a descriptor at a single keypoint.
+  // Computes a descriptor at a single keypoint. Unless an image is bound, the
+  // scale space of the image is built for every call.
   bool ComputeDescriptor(const FloatImage& image,
                          const Keypoint& keypoint,
                          Eigen::VectorXf* descriptor);
 
-  // Compute multiple descriptors for keypoints from a single image.
-  bool ComputeDescriptors(const FloatImage& image,
-                          std::vector<Keypoint>* keypoints,
-                          std::vector<Eigen::VectorXf>* descriptors);
+  // Binds the image so that successive calls to ComputeDescriptor reuse its
+  // scale space. The scale space is only built once as long as the octaves of
+  // the keypoints are visited in increasing order (e.g., when the keypoints are
+  // sorted by scale). A grayscale copy of the image is kept, so the descriptors
+  // describe the image as it was when it was bound: BindImage must be called
+  // again after the image is modified. ComputeDescriptor must only be called
+  // with the bound image object until UnbindImage is called. This is checked
+  // by comparing the pixel buffer of the image.
+  void BindImage(const FloatImage& image);
+  void UnbindImage();
 
   // Detect keypoints using the Sift keypoint detector and extracts them at the
   // same time.
@@ -80,9 +88,52 @@ class SiftDescriptorExtractor : public DescriptorExtractor {
   // This method is only public so that we can easily test it.
   static void ConvertToRootSift(Eigen::VectorXf* descriptor);
 
+ protected:
+  // Computes the descriptors of all keypoints with a single pass over the
+  // octaves of the scale space.
+  void ComputeDescriptorsOfKeypoints(const FloatImage& gray_image,
+                                     const std::vector<Keypoint>& keypoints,
+                                     std::vector<Eigen::VectorXf>* descriptors,
+                                     std::vector<bool>* is_valid);
+
+  // Keypoints in invalid pixels of the mask are discarded before their
+  // orientations and descriptors are computed.
+  bool DetectAndExtractDescriptorsInMask(
+      const FloatImage& image,
+      const ImageMask& mask,
+      std::vector<Keypoint>* keypoints,
+      std::vector<Eigen::VectorXf>* descriptors);
+
  private:
+  // Detects and extracts the features of the image. If the mask is not null,
+  // only the keypoints in valid pixels of the mask are kept.
+  bool DetectAndExtractMaskedDescriptors(
+      const FloatImage& image,
+      const ImageMask* mask,
+      std::vector<Keypoint>* keypoints,
+      std::vector<Eigen::VectorXf>* descriptors);
+
+  // Creates a new sift filter if there is none or if the current one cannot be
+  // used for an image of the given size. The scale space of the bound image is
+  // invalidated.
+  void PrepareSiftFilter(const int width, const int height);
+
+  // Computes the first octave of the scale space of the grayscale image and
+  // returns the VLFeat status.
+  int ProcessFirstOctave(const FloatImage& gray_image);
+
   const SiftParameters sift_params_;
   std::unique_ptr<VlSiftFilt, void (*)(VlSiftFilt*)> sift_filter_;
+
+  // The grayscale copy of the image passed to BindImage, or null if no image
+  // is bound. The sift filter holds an octave of its scale space if
+  // has_bound_scale_space_ is true.
+  std::unique_ptr<FloatImage> bound_gray_image_;
+  // The pixel buffer of the image passed to BindImage. It is only used to check
+  // that ComputeDescriptor is called with the bound image.
+  const float* bound_image_data_;
+  bool has_bound_scale_space_;
+
   DISALLOW_COPY_AND_ASSIGN(SiftDescriptorExtractor);
 };
 
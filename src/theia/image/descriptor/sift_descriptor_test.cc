@@ -34,12 +34,18 @@
 
 #include <gflags/gflags.h>
 #include <glog/logging.h>
+#include <algorithm>
 #include <string>
+#include <vector>
 #include "gtest/gtest.h"
 
 #include "theia/image/image.h"
+#include "theia/image/image_mask.h"
+#include "theia/image/keypoint_detector/keypoint.h"
 #include "theia/image/keypoint_detector/sift_detector.h"
 #include "theia/image/descriptor/sift_descriptor.h"
+#include "theia/util/random.h"
+#include "theia/util/timer.h"
 
 DEFINE_string(test_img, "image/descriptor/img1.png",
               "Name of test image file.");
@@ -48,6 +54,24 @@ namespace theia {
 
 namespace {
 std::string img_filename = THEIA_DATA_DIR + std::string("/") + FLAGS_test_img;
+
+// Computes the descriptors of the keypoints one at a time with
+// SiftDescriptorExtractor::ComputeDescriptor and checks that they are exactly
+// the descriptors computed by ComputeDescriptors.
+void ExpectSameDescriptorsAsBatch(
+    const FloatImage& image,
+    const std::vector<Keypoint>& keypoints,
+    const std::vector<Eigen::VectorXf>& batch_descriptors,
+    SiftDescriptorExtractor* sift_extractor) {
+  ASSERT_EQ(keypoints.size(), batch_descriptors.size());
+  for (int i = 0; i < keypoints.size(); i++) {
+    Eigen::VectorXf descriptor;
+    EXPECT_TRUE(
+        sift_extractor->ComputeDescriptor(image, keypoints[i], &descriptor));
+    EXPECT_EQ(descriptor, batch_descriptors[i]);
+  }
+}
+
 }  // namespace
 
 TEST(SiftDescriptor, Sanity) {
@@ -72,6 +96,158 @@ TEST(SiftDescriptor, Sanity) {
                                                 &sift_descriptors));
 }
 
+TEST(SiftDescriptor, ComputeDescriptorMatchesComputeDescriptors) {
+  static const int kNumUnboundKeypoints = 10;
+  FloatImage input_img(img_filename);
+
+  SiftDescriptorExtractor sift_extractor;
+  std::vector<Keypoint> keypoints;
+  std::vector<Eigen::VectorXf> descriptors;
+  EXPECT_TRUE(sift_extractor.DetectAndExtractDescriptors(input_img,
+                                                         &keypoints,
+                                                         &descriptors));
+  ASSERT_GT(keypoints.size(), kNumUnboundKeypoints);
+
+  std::vector<Eigen::VectorXf> batch_descriptors;
+  EXPECT_TRUE(sift_extractor.ComputeDescriptors(input_img,
+                                                &keypoints,
+                                                &batch_descriptors));
+  ASSERT_EQ(keypoints.size(), batch_descriptors.size());
+
+  // Without a bound image the scale space is built for every keypoint.
+  const std::vector<Keypoint> unbound_keypoints(
+      keypoints.begin(), keypoints.begin() + kNumUnboundKeypoints);
+  const std::vector<Eigen::VectorXf> unbound_batch_descriptors(
+      batch_descriptors.begin(),
+      batch_descriptors.begin() + kNumUnboundKeypoints);
+  ExpectSameDescriptorsAsBatch(
+      input_img, unbound_keypoints, unbound_batch_descriptors, &sift_extractor);
+
+  // The detected keypoints are mostly ordered by octave so the scale space of
+  // the bound image is reused between most keypoints.
+  sift_extractor.BindImage(input_img);
+  ExpectSameDescriptorsAsBatch(
+      input_img, keypoints, batch_descriptors, &sift_extractor);
+
+  // In reverse order the scale space must be rebuilt whenever the octave of the
+  // keypoint has already been processed.
+  std::reverse(keypoints.begin(), keypoints.end());
+  std::reverse(batch_descriptors.begin(), batch_descriptors.end());
+  ExpectSameDescriptorsAsBatch(
+      input_img, keypoints, batch_descriptors, &sift_extractor);
+  std::reverse(keypoints.begin(), keypoints.end());
+  std::reverse(batch_descriptors.begin(), batch_descriptors.end());
+
+  // Modify the pixels around the first keypoint in place. The bound image is
+  // described as it was when it was bound until it is bound again.
+  const int x = static_cast<int>(keypoints[0].x());
+  const int y = static_cast<int>(keypoints[0].y());
+  for (int c = 0; c < input_img.Channels(); c++) {
+    input_img.SetXY(x, y, c, 1.0f - input_img.GetXY(x, y, c));
+  }
+  Eigen::VectorXf descriptor;
+  EXPECT_TRUE(
+      sift_extractor.ComputeDescriptor(input_img, keypoints[0], &descriptor));
+  EXPECT_EQ(descriptor, batch_descriptors[0]);
+
+  SiftDescriptorExtractor modified_sift_extractor;
+  std::vector<Eigen::VectorXf> modified_descriptors;
+  EXPECT_TRUE(modified_sift_extractor.ComputeDescriptors(
+      input_img, &keypoints, &modified_descriptors));
+  EXPECT_NE(modified_descriptors[0], batch_descriptors[0]);
+  sift_extractor.BindImage(input_img);
+  ExpectSameDescriptorsAsBatch(
+      input_img, keypoints, modified_descriptors, &sift_extractor);
+
+  // The modified image is also described correctly once it is unbound.
+  sift_extractor.UnbindImage();
+  EXPECT_TRUE(
+      sift_extractor.ComputeDescriptor(input_img, keypoints[0], &descriptor));
+  EXPECT_EQ(descriptor, modified_descriptors[0]);
+}
+
+namespace {
+
+// Returns random keypoints that were not detected by the sift filter, sorted
+// by increasing scale.
+std::vector<Keypoint> RandomExternalKeypoints(const FloatImage& image,
+                                              const int num_keypoints) {
+  RandomNumberGenerator rng(59);
+  std::vector<Keypoint> keypoints(num_keypoints);
+  for (int i = 0; i < num_keypoints; i++) {
+    keypoints[i] = Keypoint(rng.RandDouble(0, image.Width() - 1),
+                            rng.RandDouble(0, image.Height() - 1),
+                            Keypoint::OTHER);
+    keypoints[i].set_scale(rng.RandDouble(1.0, 16.0));
+    keypoints[i].set_orientation(rng.RandDouble(-M_PI, M_PI));
+  }
+  std::sort(keypoints.begin(),
+            keypoints.end(),
+            [](const Keypoint& keypoint1, const Keypoint& keypoint2) {
+              return keypoint1.scale() < keypoint2.scale();
+            });
+  return keypoints;
+}
+
+}  // namespace
+
+// Describes externally supplied keypoints with both the single and the batch
+// methods and checks that the descriptors are identical.
+TEST(SiftDescriptor, DescribeExternalKeypoints) {
+  static const int kNumKeypoints = 100;
+  FloatImage input_img(img_filename);
+  const std::vector<Keypoint> keypoints =
+      RandomExternalKeypoints(input_img, kNumKeypoints);
+
+  SiftDescriptorExtractor sift_extractor;
+  std::vector<Keypoint> batch_keypoints = keypoints;
+  std::vector<Eigen::VectorXf> batch_descriptors;
+  EXPECT_TRUE(sift_extractor.ComputeDescriptors(input_img,
+                                                &batch_keypoints,
+                                                &batch_descriptors));
+  ASSERT_EQ(batch_keypoints.size(), kNumKeypoints);
+
+  sift_extractor.BindImage(input_img);
+  Eigen::VectorXf descriptor;
+  for (int i = 0; i < kNumKeypoints; i++) {
+    EXPECT_TRUE(
+        sift_extractor.ComputeDescriptor(input_img, keypoints[i], &descriptor));
+    EXPECT_EQ(descriptor, batch_descriptors[i]);
+  }
+}
+
+// Times the single and the batch methods on many external keypoints. Run it
+// explicitly with --gtest_also_run_disabled_tests.
+TEST(SiftDescriptor, DISABLED_DescribeExternalKeypointsBenchmark) {
+  static const int kNumKeypoints = 5000;
+  FloatImage input_img(img_filename);
+  const std::vector<Keypoint> keypoints =
+      RandomExternalKeypoints(input_img, kNumKeypoints);
+
+  SiftDescriptorExtractor sift_extractor;
+  Timer timer;
+  timer.Reset();
+  std::vector<Keypoint> batch_keypoints = keypoints;
+  std::vector<Eigen::VectorXf> batch_descriptors;
+  EXPECT_TRUE(sift_extractor.ComputeDescriptors(input_img,
+                                                &batch_keypoints,
+                                                &batch_descriptors));
+  const double batch_time = timer.ElapsedTimeInSeconds();
+
+  timer.Reset();
+  Eigen::VectorXf descriptor;
+  sift_extractor.BindImage(input_img);
+  for (int i = 0; i < kNumKeypoints; i++) {
+    EXPECT_TRUE(
+        sift_extractor.ComputeDescriptor(input_img, keypoints[i], &descriptor));
+  }
+  const double single_time = timer.ElapsedTimeInSeconds();
+
+  LOG(INFO) << "Describing " << kNumKeypoints << " keypoints took "
+            << batch_time << " seconds with ComputeDescriptors and "
+            << single_time << " seconds with ComputeDescriptor.";
+}
+
 TEST(SiftDescriptor, ZeroDescriptorRootSiftTest) {
   Eigen::VectorXf descriptor(128);
   descriptor.setZero();
@@ -103,4 +279,46 @@ TEST(SiftDescriptor, DifferentImageSizes) {
                                                          &descriptors));
 }
 
+TEST(SiftDescriptor, DetectAndExtractDescriptorsWithMask) {
+  FloatImage input_img(img_filename);
+
+  // Only keep the top-left quadrant of the image.
+  ImageMask mask(input_img.Width(), input_img.Height());
+  for (int y = 0; y < input_img.Height(); y++) {
+    for (int x = 0; x < input_img.Width(); x++) {
+      mask.SetPixel(
+          x, y, x < input_img.Width() / 2 && y < input_img.Height() / 2);
+    }
+  }
+
+  SiftDescriptorExtractor sift_extractor;
+  std::vector<Keypoint> keypoints;
+  std::vector<Eigen::VectorXf> descriptors;
+  EXPECT_TRUE(sift_extractor.DetectAndExtractDescriptors(input_img,
+                                                         &keypoints,
+                                                         &descriptors));
+  int num_unmasked_keypoints = 0;
+  for (const Keypoint& keypoint : keypoints) {
+    if (mask.IsValid(keypoint.x(), keypoint.y())) {
+      ++num_unmasked_keypoints;
+    }
+  }
+
+  std::vector<Keypoint> masked_keypoints;
+  std::vector<Eigen::VectorXf> masked_descriptors;
+  EXPECT_TRUE(sift_extractor.DetectAndExtractDescriptorsWithMask(
+      input_img, mask, &masked_keypoints, &masked_descriptors));
+  EXPECT_EQ(masked_keypoints.size(), masked_descriptors.size());
+  EXPECT_GT(masked_keypoints.size(), 0);
+  for (const Keypoint& keypoint : masked_keypoints) {
+    EXPECT_TRUE(mask.IsValid(keypoint.x(), keypoint.y()));
+  }
+
+  // Detection is restricted to a region of interest around the valid pixels,
+  // so the keypoints near its border may differ slightly from the keypoints of
+  // the full image.
+  EXPECT_NEAR(masked_keypoints.size(), num_unmasked_keypoints,
+              0.1 * num_unmasked_keypoints);
+}
+
 }  // namespace theia
@@ -0,0 +1,155 @@
+// Copyright (C) 2026 The Regents of the University of California (Regents).
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials provided
+//       with the distribution.
+//
+//     * Neither the name of The Regents or University of California nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+// Please contact the author of this library if you have any questions.
+// Author: agent (agent@local)
+
+#include "theia/image/image_mask.h"
+
+#include <glog/logging.h>
+#include <stdint.h>
+#include <algorithm>
+#include <bitset>
+#include <vector>
+
+#include "theia/image/image.h"
+
+namespace theia {
+
+ImageMask::ImageMask() : width_(0), height_(0), words_per_row_(0) {}
+
+ImageMask::ImageMask(const int width, const int height)
+    : width_(width), height_(height), words_per_row_((width + 63) / 64) {
+  CHECK_GE(width, 0);
+  CHECK_GE(height, 0);
+  bits_.resize(words_per_row_ * height_, ~static_cast<uint64_t>(0));
+  // Clear the padding bits at the end of each row so that counting the valid
+  // pixels does not need to treat the last word of a row differently.
+  if (width_ % 64 != 0) {
+    const uint64_t last_word = (static_cast<uint64_t>(1) << (width_ % 64)) - 1;
+    for (int y = 0; y < height_; y++) {
+      bits_[(y + 1) * words_per_row_ - 1] = last_word;
+    }
+  }
+}
+
+ImageMask::ImageMask(const FloatImage& mask_image, const float threshold)
+    : width_(mask_image.Width()),
+      height_(mask_image.Height()),
+      words_per_row_((mask_image.Width() + 63) / 64) {
+  bits_.resize(words_per_row_ * height_, 0);
+  const FloatImage gray_mask_image = mask_image.AsGrayscaleImage();
+  const float* pixels = gray_mask_image.Data();
+  for (int y = 0; y < height_; y++) {
+    const float* row = pixels + y * width_;
+    uint64_t* row_bits = bits_.data() + y * words_per_row_;
+    for (int x = 0; x < width_; x++) {
+      if (row[x] >= threshold) {
+        row_bits[x >> 6] |= static_cast<uint64_t>(1) << (x & 63);
+      }
+    }
+  }
+}
+
+void ImageMask::SetPixel(const int x, const int y, const bool is_valid) {
+  DCHECK(x >= 0 && x < width_ && y >= 0 && y < height_);
+  const uint64_t bit = static_cast<uint64_t>(1) << (x & 63);
+  if (is_valid) {
+    bits_[y * words_per_row_ + (x >> 6)] |= bit;
+  } else {
+    bits_[y * words_per_row_ + (x >> 6)] &= ~bit;
+  }
+}
+
+int ImageMask::NumValidPixels() const {
+  int num_valid_pixels = 0;
+  for (const uint64_t word : bits_) {
+    num_valid_pixels += std::bitset<64>(word).count();
+  }
+  return num_valid_pixels;
+}
+
+bool ImageMask::GetValidRegion(int* min_x,
+                               int* min_y,
+                               int* max_x,
+                               int* max_y) const {
+  *min_x = width_;
+  *min_y = height_;
+  *max_x = -1;
+  *max_y = -1;
+  for (int y = 0; y < height_; y++) {
+    const uint64_t* row_bits = bits_.data() + y * words_per_row_;
+    int first_word = 0;
+    while (first_word < words_per_row_ && row_bits[first_word] == 0) {
+      ++first_word;
+    }
+    if (first_word == words_per_row_) {
+      continue;
+    }
+    int last_word = words_per_row_ - 1;
+    while (row_bits[last_word] == 0) {
+      --last_word;
+    }
+
+    // Only the first and last valid pixels of the row can change the
+    // horizontal bounds.
+    int first_bit = 0;
+    while (((row_bits[first_word] >> first_bit) & 1) == 0) {
+      ++first_bit;
+    }
+    int last_bit = 63;
+    while (((row_bits[last_word] >> last_bit) & 1) == 0) {
+      --last_bit;
+    }
+    *min_x = std::min(*min_x, 64 * first_word + first_bit);
+    *max_x = std::max(*max_x, 64 * last_word + last_bit);
+    *min_y = std::min(*min_y, y);
+    *max_y = y;
+  }
+  return *max_y >= 0;
+}
+
+ImageMask ImageMask::Crop(const int x,
+                          const int y,
+                          const int width,
+                          const int height) const {
+  CHECK(x >= 0 && y >= 0 && x + width <= width_ && y + height <= height_)
+      << "The cropped region must lie inside of the mask.";
+  ImageMask cropped_mask(width, height);
+  for (int row = 0; row < height; row++) {
+    for (int col = 0; col < width; col++) {
+      cropped_mask.SetPixel(col, row, IsValidPixel(x + col, y + row));
+    }
+  }
+  return cropped_mask;
+}
+
+}  // namespace theia
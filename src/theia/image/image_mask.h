@@ -0,0 +1,104 @@
+// Copyright (C) 2026 The Regents of the University of California (Regents).
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials provided
+//       with the distribution.
+//
+//     * Neither the name of The Regents or University of California nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+// Please contact the author of this library if you have any questions.
+// Author: agent (agent@local)
+
+#ifndef THEIA_IMAGE_IMAGE_MASK_H_
+#define THEIA_IMAGE_IMAGE_MASK_H_
+
+#include <stdint.h>
+#include <cmath>
+#include <vector>
+
+namespace theia {
+
+class FloatImage;
+
+// A binary image mask that marks which pixels of an image are valid (e.g., for
+// feature extraction). The mask is stored with one bit per pixel so that even
+// masks for very large images remain small and cache friendly. A point (x, y)
+// lies in the pixel (floor(x), floor(y)), following the convention of
+// FloatImage::BilinearInterpolate.
+class ImageMask {
+ public:
+  ImageMask();
+
+  // Creates a mask where all pixels are valid.
+  ImageMask(const int width, const int height);
+
+  // Creates a mask from a mask image. A pixel is valid if the grayscale value
+  // of the mask image at that pixel is greater than or equal to the threshold.
+  ImageMask(const FloatImage& mask_image, const float threshold);
+
+  int Width() const { return width_; }
+  int Height() const { return height_; }
+
+  // Returns true if the pixel is valid. Pixels outside of the mask are invalid.
+  bool IsValidPixel(const int x, const int y) const {
+    if (x < 0 || y < 0 || x >= width_ || y >= height_) {
+      return false;
+    }
+    return (bits_[y * words_per_row_ + (x >> 6)] >> (x & 63)) & 1;
+  }
+
+  // Returns true if the point (x, y) lies in a valid pixel.
+  bool IsValid(const double x, const double y) const {
+    return IsValidPixel(static_cast<int>(std::floor(x)),
+                        static_cast<int>(std::floor(y)));
+  }
+
+  void SetPixel(const int x, const int y, const bool is_valid);
+
+  // Returns the number of valid pixels.
+  int NumValidPixels() const;
+
+  // Computes the smallest rectangle that contains all valid pixels. The bounds
+  // are inclusive. Returns false if there are no valid pixels.
+  bool GetValidRegion(int* min_x, int* min_y, int* max_x, int* max_y) const;
+
+  // Returns the mask of the rectangle with the given top-left corner and size.
+  // The rectangle must lie inside of the mask.
+  ImageMask Crop(const int x,
+                 const int y,
+                 const int width,
+                 const int height) const;
+
+ private:
+  int width_;
+  int height_;
+  int words_per_row_;
+  std::vector<uint64_t> bits_;
+};
+
+}  // namespace theia
+
+#endif  // THEIA_IMAGE_IMAGE_MASK_H_
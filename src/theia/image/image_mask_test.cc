@@ -0,0 +1,125 @@
+// Copyright (C) 2026 The Regents of the University of California (Regents).
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials provided
+//       with the distribution.
+//
+//     * Neither the name of The Regents or University of California nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+// Please contact the author of this library if you have any questions.
+// Author: agent (agent@local)
+
+#include <string>
+
+#include "gtest/gtest.h"
+#include "theia/image/image.h"
+#include "theia/image/image_mask.h"
+
+namespace theia {
+
+TEST(ImageMask, AllPixelsValid) {
+  const ImageMask mask(100, 30);
+  EXPECT_EQ(mask.NumValidPixels(), 100 * 30);
+  EXPECT_TRUE(mask.IsValidPixel(0, 0));
+  EXPECT_TRUE(mask.IsValidPixel(99, 29));
+  EXPECT_FALSE(mask.IsValidPixel(100, 0));
+  EXPECT_FALSE(mask.IsValidPixel(0, -1));
+  EXPECT_TRUE(mask.IsValid(99.9, 29.9));
+  EXPECT_FALSE(mask.IsValid(-0.1, 0.0));
+
+  int min_x, min_y, max_x, max_y;
+  EXPECT_TRUE(mask.GetValidRegion(&min_x, &min_y, &max_x, &max_y));
+  EXPECT_EQ(min_x, 0);
+  EXPECT_EQ(min_y, 0);
+  EXPECT_EQ(max_x, 99);
+  EXPECT_EQ(max_y, 29);
+}
+
+TEST(ImageMask, SetPixel) {
+  ImageMask mask(130, 20);
+  for (int y = 0; y < mask.Height(); y++) {
+    for (int x = 0; x < mask.Width(); x++) {
+      mask.SetPixel(x, y, false);
+    }
+  }
+  EXPECT_EQ(mask.NumValidPixels(), 0);
+  int min_x, min_y, max_x, max_y;
+  EXPECT_FALSE(mask.GetValidRegion(&min_x, &min_y, &max_x, &max_y));
+
+  mask.SetPixel(70, 5, true);
+  mask.SetPixel(3, 12, true);
+  mask.SetPixel(129, 8, true);
+  EXPECT_EQ(mask.NumValidPixels(), 3);
+  EXPECT_TRUE(mask.IsValidPixel(70, 5));
+  EXPECT_TRUE(mask.IsValid(70.5, 5.5));
+  EXPECT_FALSE(mask.IsValidPixel(71, 5));
+  EXPECT_TRUE(mask.GetValidRegion(&min_x, &min_y, &max_x, &max_y));
+  EXPECT_EQ(min_x, 3);
+  EXPECT_EQ(min_y, 5);
+  EXPECT_EQ(max_x, 129);
+  EXPECT_EQ(max_y, 12);
+
+  mask.SetPixel(70, 5, false);
+  EXPECT_FALSE(mask.IsValidPixel(70, 5));
+  EXPECT_EQ(mask.NumValidPixels(), 2);
+}
+
+TEST(ImageMask, Crop) {
+  ImageMask mask(200, 100);
+  for (int y = 0; y < mask.Height(); y++) {
+    for (int x = 0; x < mask.Width(); x++) {
+      mask.SetPixel(x, y, (x + y) % 3 == 0);
+    }
+  }
+
+  const ImageMask cropped_mask = mask.Crop(65, 10, 90, 40);
+  EXPECT_EQ(cropped_mask.Width(), 90);
+  EXPECT_EQ(cropped_mask.Height(), 40);
+  for (int y = 0; y < cropped_mask.Height(); y++) {
+    for (int x = 0; x < cropped_mask.Width(); x++) {
+      EXPECT_EQ(cropped_mask.IsValidPixel(x, y),
+                mask.IsValidPixel(x + 65, y + 10));
+    }
+  }
+}
+
+TEST(ImageMask, FromMaskImage) {
+  FloatImage mask_image(80, 60, 1);
+  for (int y = 0; y < mask_image.Height(); y++) {
+    for (int x = 0; x < mask_image.Width(); x++) {
+      mask_image.SetXY(x, y, 0, y < 20 ? 0.0f : 1.0f);
+    }
+  }
+
+  const ImageMask mask(mask_image, 0.5f);
+  EXPECT_EQ(mask.Width(), 80);
+  EXPECT_EQ(mask.Height(), 60);
+  EXPECT_EQ(mask.NumValidPixels(), 80 * 40);
+  EXPECT_FALSE(mask.IsValidPixel(10, 19));
+  EXPECT_TRUE(mask.IsValidPixel(10, 20));
+}
+
+}  // namespace theia
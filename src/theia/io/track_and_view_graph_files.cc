@@ -0,0 +1,429 @@
+// Copyright (C) 2026 The Regents of the University of California (Regents).
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials provided
+//       with the distribution.
+//
+//     * Neither the name of The Regents or University of California nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+// Please contact the author of this library if you have any questions.
+// Author: agent (agent@local)
+
+#include "theia/io/track_and_view_graph_files.h"
+
+#include <cereal/archives/portable_binary.hpp>
+#include <cereal/types/string.hpp>
+#include <cereal/types/vector.hpp>
+#include <glog/logging.h>
+#include <stdint.h>
+
+#include <algorithm>
+#include <fstream>  // NOLINT
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "theia/sfm/feature.h"
+#include "theia/sfm/reconstruction.h"
+#include "theia/sfm/track.h"
+#include "theia/sfm/twoview_info.h"
+#include "theia/sfm/types.h"
+#include "theia/sfm/view.h"
+#include "theia/sfm/view_graph/view_graph.h"
+#include "theia/util/map_util.h"
+#include "theia/util/threadpool.h"
+
+namespace theia {
+
+namespace {
+
+// Identifiers at the start of the files ("TTRK" and "TVGR").
+static const uint32_t kTracksFileMagic = 0x4b525454;
+static const uint32_t kViewGraphFileMagic = 0x52475654;
+static const uint32_t kFileVersion = 1;
+
+bool FeatureLess(const Feature& feature1, const Feature& feature2) {
+  return std::make_pair(feature1.x(), feature1.y()) <
+         std::make_pair(feature2.x(), feature2.y());
+}
+
+// Returns the view ids of all views with the given names, or false if any of
+// the views does not exist in the reconstruction.
+bool GetViewIdsFromNames(const Reconstruction& reconstruction,
+                         const std::vector<std::string>& view_names,
+                         std::vector<ViewId>* view_ids) {
+  view_ids->resize(view_names.size());
+  for (int i = 0; i < view_names.size(); i++) {
+    (*view_ids)[i] = reconstruction.ViewIdFromName(view_names[i]);
+    if ((*view_ids)[i] == kInvalidViewId) {
+      LOG(WARNING) << "The view " << view_names[i]
+                   << " does not exist in the reconstruction.";
+      return false;
+    }
+  }
+  return true;
+}
+
+// Reads the header of the file and returns false if the file does not have the
+// expected magic number and version.
+template <class Archive>
+bool ReadHeader(const uint32_t expected_magic,
+                Archive* input_archive,
+                uint64_t* content_hash) {
+  uint32_t magic, version;
+  (*input_archive)(magic, version, *content_hash);
+  if (magic != expected_magic || version != kFileVersion) {
+    LOG(WARNING) << "Unsupported file type or version.";
+    return false;
+  }
+  return true;
+}
+
+}  // namespace
+
+bool WriteTracksFile(const Reconstruction& reconstruction,
+                     const uint64_t content_hash,
+                     const std::string& output_file) {
+  std::vector<TrackId> track_ids = reconstruction.TrackIds();
+  std::sort(track_ids.begin(), track_ids.end());
+
+  // Collect the sorted unique features of each view that observes a track.
+  std::unordered_map<ViewId, std::vector<Feature> > features_of_view;
+  for (const TrackId track_id : track_ids) {
+    const Track* track = reconstruction.Track(track_id);
+    for (const ViewId view_id : track->ViewIds()) {
+      const Feature* feature =
+          reconstruction.View(view_id)->GetFeature(track_id);
+      features_of_view[view_id].emplace_back(*feature);
+    }
+  }
+
+  std::vector<ViewId> view_ids;
+  view_ids.reserve(features_of_view.size());
+  for (auto& view_features : features_of_view) {
+    view_ids.emplace_back(view_features.first);
+    std::vector<Feature>& features = view_features.second;
+    std::sort(features.begin(), features.end(), FeatureLess);
+    features.erase(std::unique(features.begin(), features.end()),
+                   features.end());
+  }
+  std::sort(view_ids.begin(), view_ids.end());
+
+  std::unordered_map<ViewId, uint32_t> view_indices;
+  std::vector<std::string> view_names(view_ids.size());
+  std::vector<uint32_t> feature_offsets(view_ids.size() + 1, 0);
+  std::vector<double> feature_coordinates;
+  for (int i = 0; i < view_ids.size(); i++) {
+    view_indices[view_ids[i]] = i;
+    view_names[i] = reconstruction.View(view_ids[i])->Name();
+    const std::vector<Feature>& features =
+        FindOrDie(features_of_view, view_ids[i]);
+    feature_offsets[i + 1] = feature_offsets[i] + features.size();
+    for (const Feature& feature : features) {
+      feature_coordinates.emplace_back(feature.x());
+      feature_coordinates.emplace_back(feature.y());
+    }
+  }
+
+  // Store the observations of each track as view and feature indices.
+  std::vector<uint32_t> track_offsets(track_ids.size() + 1, 0);
+  std::vector<uint32_t> observation_view_indices, observation_feature_indices;
+  for (int i = 0; i < track_ids.size(); i++) {
+    const Track* track = reconstruction.Track(track_ids[i]);
+    std::vector<ViewId> track_view_ids(track->ViewIds().begin(),
+                                       track->ViewIds().end());
+    std::sort(track_view_ids.begin(), track_view_ids.end());
+    for (const ViewId view_id : track_view_ids) {
+      const std::vector<Feature>& features =
+          FindOrDie(features_of_view, view_id);
+      const Feature* feature =
+          reconstruction.View(view_id)->GetFeature(track_ids[i]);
+      observation_view_indices.emplace_back(FindOrDie(view_indices, view_id));
+      observation_feature_indices.emplace_back(
+          std::lower_bound(
+              features.begin(), features.end(), *feature, FeatureLess) -
+          features.begin());
+    }
+    track_offsets[i + 1] = observation_view_indices.size();
+  }
+
+  std::ofstream output_writer(output_file, std::ios::out | std::ios::binary);
+  if (!output_writer.is_open()) {
+    LOG(ERROR) << "Could not open the file: " << output_file << " for writing.";
+    return false;
+  }
+
+  // Make sure that Cereal is able to finish executing before returning.
+  {
+    cereal::PortableBinaryOutputArchive output_archive(output_writer);
+    output_archive(kTracksFileMagic,
+                   kFileVersion,
+                   content_hash,
+                   view_names,
+                   feature_offsets,
+                   feature_coordinates,
+                   track_offsets,
+                   observation_view_indices,
+                   observation_feature_indices);
+  }
+  return output_writer.good();
+}
+
+bool ReadTracksFile(const std::string& input_file,
+                    const int num_threads,
+                    Reconstruction* reconstruction) {
+  CHECK_NOTNULL(reconstruction);
+  CHECK_EQ(reconstruction->NumTracks(), 0)
+      << "Tracks may only be read into a reconstruction without tracks.";
+
+  std::ifstream input_reader(input_file, std::ios::in | std::ios::binary);
+  if (!input_reader.is_open()) {
+    LOG(ERROR) << "Could not open the file: " << input_file << " for reading.";
+    return false;
+  }
+
+  uint64_t content_hash;
+  std::vector<std::string> view_names;
+  std::vector<uint32_t> feature_offsets, track_offsets,
+      observation_view_indices, observation_feature_indices;
+  std::vector<double> feature_coordinates;
+  try {
+    cereal::PortableBinaryInputArchive input_archive(input_reader);
+    if (!ReadHeader(kTracksFileMagic, &input_archive, &content_hash)) {
+      return false;
+    }
+    input_archive(view_names,
+                  feature_offsets,
+                  feature_coordinates,
+                  track_offsets,
+                  observation_view_indices,
+                  observation_feature_indices);
+  } catch (const cereal::Exception& exception) {
+    LOG(WARNING) << "Could not read the tracks file " << input_file << ": "
+                 << exception.what();
+    return false;
+  }
+
+  // Validate the file before modifying the reconstruction. The offsets must
+  // start at 0 and be monotonic, otherwise the number of features of a view or
+  // observations of a track underflows and the indices below are unchecked.
+  const int num_views = view_names.size();
+  if (feature_offsets.size() != num_views + 1 || feature_offsets[0] != 0 ||
+      !std::is_sorted(feature_offsets.begin(), feature_offsets.end()) ||
+      feature_coordinates.size() !=
+          2 * static_cast<size_t>(feature_offsets.back()) ||
+      track_offsets.empty() || track_offsets[0] != 0 ||
+      !std::is_sorted(track_offsets.begin(), track_offsets.end()) ||
+      observation_view_indices.size() != track_offsets.back() ||
+      observation_feature_indices.size() != track_offsets.back()) {
+    LOG(WARNING) << "The tracks file " << input_file << " is corrupted.";
+    return false;
+  }
+  for (int i = 0; i < observation_view_indices.size(); i++) {
+    const uint32_t view_index = observation_view_indices[i];
+    if (view_index >= num_views ||
+        observation_feature_indices[i] >= feature_offsets[view_index + 1] -
+                                              feature_offsets[view_index]) {
+      LOG(WARNING) << "The tracks file " << input_file << " is corrupted.";
+      return false;
+    }
+  }
+  std::vector<ViewId> view_ids;
+  if (!GetViewIdsFromNames(*reconstruction, view_names, &view_ids)) {
+    return false;
+  }
+
+  // Decode the observations of all tracks in parallel and add them to the
+  // reconstruction.
+  const int num_tracks = track_offsets.size() - 1;
+  std::vector<std::vector<std::pair<ViewId, Feature> > > tracks(num_tracks);
+  ParallelForBlocks(
+      num_threads, num_tracks, [&](const int start, const int end) {
+        for (int i = start; i < end; i++) {
+          tracks[i].reserve(track_offsets[i + 1] - track_offsets[i]);
+          for (int j = track_offsets[i]; j < track_offsets[i + 1]; j++) {
+            const uint32_t view_index = observation_view_indices[j];
+            const uint32_t feature_index =
+                feature_offsets[view_index] + observation_feature_indices[j];
+            tracks[i].emplace_back(
+                view_ids[view_index],
+                Feature(feature_coordinates[2 * feature_index],
+                        feature_coordinates[2 * feature_index + 1]));
+          }
+        }
+      });
+
+  const std::vector<TrackId> track_ids =
+      reconstruction->AddTracks(tracks, num_threads);
+  for (const TrackId track_id : track_ids) {
+    CHECK_NE(track_id, kInvalidTrackId)
+        << "Could not add the tracks of " << input_file;
+  }
+  return true;
+}
+
+bool WriteViewGraphFile(const Reconstruction& reconstruction,
+                        const ViewGraph& view_graph,
+                        const uint64_t content_hash,
+                        const std::string& output_file) {
+  // Sort the edges so that the file does not depend on the hash map order.
+  std::vector<std::pair<ViewIdPair, const TwoViewInfo*> > edges;
+  edges.reserve(view_graph.NumEdges());
+  for (const auto& edge : view_graph.GetAllEdges()) {
+    edges.emplace_back(edge.first, &edge.second);
+  }
+  std::sort(edges.begin(),
+            edges.end(),
+            [](const std::pair<ViewIdPair, const TwoViewInfo*>& edge1,
+               const std::pair<ViewIdPair, const TwoViewInfo*>& edge2) {
+              return edge1.first < edge2.first;
+            });
+
+  std::unordered_map<ViewId, uint32_t> view_indices;
+  std::vector<std::string> view_names;
+  std::vector<uint32_t> edge_view_indices1, edge_view_indices2;
+  std::vector<TwoViewInfo> twoview_infos;
+  const auto view_index = [&](const ViewId view_id) {
+    const auto it = view_indices.find(view_id);
+    if (it != view_indices.end()) {
+      return it->second;
+    }
+    const uint32_t index = view_names.size();
+    view_indices[view_id] = index;
+    view_names.emplace_back(reconstruction.View(view_id)->Name());
+    return index;
+  };
+  for (const auto& edge : edges) {
+    CHECK_NOTNULL(reconstruction.View(edge.first.first));
+    CHECK_NOTNULL(reconstruction.View(edge.first.second));
+    edge_view_indices1.emplace_back(view_index(edge.first.first));
+    edge_view_indices2.emplace_back(view_index(edge.first.second));
+    twoview_infos.emplace_back(*edge.second);
+  }
+
+  std::ofstream output_writer(output_file, std::ios::out | std::ios::binary);
+  if (!output_writer.is_open()) {
+    LOG(ERROR) << "Could not open the file: " << output_file << " for writing.";
+    return false;
+  }
+
+  // Make sure that Cereal is able to finish executing before returning.
+  {
+    cereal::PortableBinaryOutputArchive output_archive(output_writer);
+    output_archive(kViewGraphFileMagic,
+                   kFileVersion,
+                   content_hash,
+                   view_names,
+                   edge_view_indices1,
+                   edge_view_indices2,
+                   twoview_infos);
+  }
+  return output_writer.good();
+}
+
+bool ReadViewGraphFile(const std::string& input_file,
+                       const Reconstruction& reconstruction,
+                       ViewGraph* view_graph) {
+  CHECK_NOTNULL(view_graph);
+  CHECK_EQ(view_graph->NumViews(), 0)
+      << "A view graph may only be read into an empty view graph.";
+
+  std::ifstream input_reader(input_file, std::ios::in | std::ios::binary);
+  if (!input_reader.is_open()) {
+    LOG(ERROR) << "Could not open the file: " << input_file << " for reading.";
+    return false;
+  }
+
+  uint64_t content_hash;
+  std::vector<std::string> view_names;
+  std::vector<uint32_t> edge_view_indices1, edge_view_indices2;
+  std::vector<TwoViewInfo> twoview_infos;
+  try {
+    cereal::PortableBinaryInputArchive input_archive(input_reader);
+    if (!ReadHeader(kViewGraphFileMagic, &input_archive, &content_hash)) {
+      return false;
+    }
+    input_archive(
+        view_names, edge_view_indices1, edge_view_indices2, twoview_infos);
+  } catch (const cereal::Exception& exception) {
+    LOG(WARNING) << "Could not read the view graph file " << input_file << ": "
+                 << exception.what();
+    return false;
+  }
+
+  const int num_edges = twoview_infos.size();
+  if (edge_view_indices1.size() != num_edges ||
+      edge_view_indices2.size() != num_edges) {
+    LOG(WARNING) << "The view graph file " << input_file << " is corrupted.";
+    return false;
+  }
+  for (int i = 0; i < num_edges; i++) {
+    if (edge_view_indices1[i] >= view_names.size() ||
+        edge_view_indices2[i] >= view_names.size()) {
+      LOG(WARNING) << "The view graph file " << input_file << " is corrupted.";
+      return false;
+    }
+  }
+  std::vector<ViewId> view_ids;
+  if (!GetViewIdsFromNames(reconstruction, view_names, &view_ids)) {
+    return false;
+  }
+
+  // The view graph requires the two view info to describe the transformation
+  // from the smaller to the larger view id, which may have changed if the views
+  // were added in a different order.
+  for (int i = 0; i < num_edges; i++) {
+    const ViewId view_id1 = view_ids[edge_view_indices1[i]];
+    const ViewId view_id2 = view_ids[edge_view_indices2[i]];
+    if (view_id1 > view_id2) {
+      SwapCameras(&twoview_infos[i]);
+    }
+    view_graph->AddEdge(view_id1, view_id2, twoview_infos[i]);
+  }
+  return true;
+}
+
+bool ReadTrackOrViewGraphFileContentHash(const std::string& input_file,
+                                         uint64_t* content_hash) {
+  CHECK_NOTNULL(content_hash);
+  std::ifstream input_reader(input_file, std::ios::in | std::ios::binary);
+  if (!input_reader.is_open()) {
+    return false;
+  }
+
+  uint32_t magic, version;
+  try {
+    cereal::PortableBinaryInputArchive input_archive(input_reader);
+    input_archive(magic, version, *content_hash);
+  } catch (const cereal::Exception& exception) {
+    return false;
+  }
+  return (magic == kTracksFileMagic || magic == kViewGraphFileMagic) &&
+         version == kFileVersion;
+}
+
+}  // namespace theia
@@ -0,0 +1,96 @@
+// Copyright (C) 2026 The Regents of the University of California (Regents).
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials provided
+//       with the distribution.
+//
+//     * Neither the name of The Regents or University of California nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+// Please contact the author of this library if you have any questions.
+// Author: agent (agent@local)
+
+#ifndef THEIA_IO_TRACK_AND_VIEW_GRAPH_FILES_H_
+#define THEIA_IO_TRACK_AND_VIEW_GRAPH_FILES_H_
+
+#include <stdint.h>
+#include <string>
+
+namespace theia {
+
+class Reconstruction;
+class ViewGraph;
+
+// Binary files that store the tracks and the view graph that are built from
+// the feature matches so that later runs can load them instead of building
+// them again (e.g., when only the estimator options change).
+//
+// Views are referenced by their names so that the files remain valid when the
+// views are added to a reconstruction in a different order. The tracks file
+// stores the unique features of each view once, and each track is a list of
+// (view index, feature index) observations. Both files store a content hash
+// given by the caller, which should describe the inputs that were used to
+// build the tracks and view graph (e.g., the matches and track options), so
+// that the caller can determine whether the files may safely be reused.
+
+// Writes all tracks of the reconstruction in the order of their track ids.
+bool WriteTracksFile(const Reconstruction& reconstruction,
+                     const uint64_t content_hash,
+                     const std::string& output_file);
+
+// Adds the tracks of the file to the reconstruction, which must not contain any
+// tracks and must contain all views that are referenced by the tracks. The
+// tracks are added in the order of their track ids at the time of writing, so
+// tracks with contiguous ids (e.g., from the TrackBuilder) receive the same
+// ids again. The tracks are added with num_threads threads. Returns false and
+// leaves the reconstruction unchanged if the file could not be read or a view
+// does not exist.
+bool ReadTracksFile(const std::string& input_file,
+                    const int num_threads,
+                    Reconstruction* reconstruction);
+
+// Writes all edges of the view graph. The reconstruction is used to look up the
+// names of the views.
+bool WriteViewGraphFile(const Reconstruction& reconstruction,
+                        const ViewGraph& view_graph,
+                        const uint64_t content_hash,
+                        const std::string& output_file);
+
+// Adds the edges of the file to the view graph, which must be empty. The views
+// are mapped to the view ids of the reconstruction by their names. Returns
+// false and leaves the view graph unchanged if the file could not be read or a
+// view does not exist in the reconstruction.
+bool ReadViewGraphFile(const std::string& input_file,
+                       const Reconstruction& reconstruction,
+                       ViewGraph* view_graph);
+
+// Reads only the content hash of a tracks or view graph file. Returns false if
+// the file does not exist or is not a valid tracks or view graph file.
+bool ReadTrackOrViewGraphFileContentHash(const std::string& input_file,
+                                         uint64_t* content_hash);
+
+}  // namespace theia
+
+#endif  // THEIA_IO_TRACK_AND_VIEW_GRAPH_FILES_H_
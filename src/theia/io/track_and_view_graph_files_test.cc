@@ -0,0 +1,290 @@
+// Copyright (C) 2026 The Regents of the University of California (Regents).
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials provided
+//       with the distribution.
+//
+//     * Neither the name of The Regents or University of California nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+// Please contact the author of this library if you have any questions.
+// Author: agent (agent@local)
+
+#include <Eigen/Core>
+#include <cereal/archives/portable_binary.hpp>
+#include <cereal/types/string.hpp>
+#include <cereal/types/vector.hpp>
+#include <stdint.h>
+#include <fstream>  // NOLINT
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "theia/io/track_and_view_graph_files.h"
+#include "theia/sfm/reconstruction.h"
+#include "theia/sfm/track.h"
+#include "theia/sfm/twoview_info.h"
+#include "theia/sfm/types.h"
+#include "theia/sfm/view.h"
+#include "theia/sfm/view_graph/view_graph.h"
+#include "theia/util/random.h"
+
+namespace theia {
+
+namespace {
+
+RandomNumberGenerator rng(59);
+
+const std::string tracks_filepath =
+    THEIA_DATA_DIR + std::string("/io/tracks_test.bin");
+const std::string view_graph_filepath =
+    THEIA_DATA_DIR + std::string("/io/view_graph_test.bin");
+
+static const int kNumViews = 10;
+static const int kNumTracks = 200;
+static const uint64_t kContentHash = 0x0123456789abcdefULL;
+
+std::string ViewName(const int i) { return "view_" + std::to_string(i); }
+
+// Creates a reconstruction with random tracks. Some features are shared by
+// several tracks to ensure that the unique features of each view are stored
+// correctly.
+void CreateReconstructionWithTracks(Reconstruction* reconstruction) {
+  for (int i = 0; i < kNumViews; i++) {
+    reconstruction->AddView(ViewName(i));
+  }
+  for (int i = 0; i < kNumTracks; i++) {
+    std::vector<std::pair<ViewId, Feature> > track;
+    for (int j = 0; j < kNumViews; j++) {
+      if (track.size() < 2 || rng.RandDouble(0.0, 1.0) < 0.3) {
+        const Feature feature = i % 10 == 0 ? Feature(j, j)
+                                            : Feature(rng.RandDouble(0, 100),
+                                                      rng.RandDouble(0, 100));
+        track.emplace_back(reconstruction->ViewIdFromName(ViewName(j)),
+                           feature);
+      }
+    }
+    ASSERT_NE(reconstruction->AddTrack(track), kInvalidTrackId);
+  }
+}
+
+void CreateViewGraph(const Reconstruction& reconstruction,
+                     ViewGraph* view_graph) {
+  for (int i = 0; i < kNumViews; i++) {
+    for (int j = i + 1; j < kNumViews; j += 2) {
+      TwoViewInfo info;
+      info.focal_length_1 = 100.0 + i;
+      info.focal_length_2 = 100.0 + j;
+      info.position_2 = rng.RandVector3d().normalized();
+      info.rotation_2 = 0.1 * rng.RandVector3d();
+      info.num_verified_matches = 50 + i + j;
+      view_graph->AddEdge(reconstruction.ViewIdFromName(ViewName(i)),
+                          reconstruction.ViewIdFromName(ViewName(j)),
+                          info);
+    }
+  }
+}
+
+// Writes a tracks file with the given contents in the format of
+// WriteTracksFile, which allows to create corrupted files.
+void WriteRawTracksFile(
+    const std::vector<std::string>& view_names,
+    const std::vector<uint32_t>& feature_offsets,
+    const std::vector<double>& feature_coordinates,
+    const std::vector<uint32_t>& track_offsets,
+    const std::vector<uint32_t>& observation_view_indices,
+    const std::vector<uint32_t>& observation_feature_indices) {
+  static const uint32_t kTracksFileMagic = 0x4b525454;
+  static const uint32_t kFileVersion = 1;
+  std::ofstream output_writer(tracks_filepath,
+                              std::ios::out | std::ios::binary);
+  cereal::PortableBinaryOutputArchive output_archive(output_writer);
+  output_archive(kTracksFileMagic,
+                 kFileVersion,
+                 kContentHash,
+                 view_names,
+                 feature_offsets,
+                 feature_coordinates,
+                 track_offsets,
+                 observation_view_indices,
+                 observation_feature_indices);
+}
+
+// Adds the views in reverse order so that the view ids differ from the views
+// of the reconstruction created above.
+void AddViewsInReverseOrder(Reconstruction* reconstruction) {
+  for (int i = kNumViews - 1; i >= 0; i--) {
+    reconstruction->AddView(ViewName(i));
+  }
+}
+
+}  // namespace
+
+TEST(TrackAndViewGraphFiles, TracksRoundTrip) {
+  Reconstruction reconstruction;
+  CreateReconstructionWithTracks(&reconstruction);
+  EXPECT_TRUE(WriteTracksFile(reconstruction, kContentHash, tracks_filepath));
+
+  uint64_t content_hash;
+  EXPECT_TRUE(
+      ReadTrackOrViewGraphFileContentHash(tracks_filepath, &content_hash));
+  EXPECT_EQ(content_hash, kContentHash);
+
+  for (const int num_threads : {1, 4}) {
+    Reconstruction read_reconstruction;
+    AddViewsInReverseOrder(&read_reconstruction);
+    EXPECT_TRUE(
+        ReadTracksFile(tracks_filepath, num_threads, &read_reconstruction));
+    ASSERT_EQ(read_reconstruction.NumTracks(), reconstruction.NumTracks());
+
+    for (const TrackId track_id : reconstruction.TrackIds()) {
+      const Track* track = reconstruction.Track(track_id);
+      const Track* read_track = read_reconstruction.Track(track_id);
+      ASSERT_NE(read_track, nullptr);
+      ASSERT_EQ(read_track->NumViews(), track->NumViews());
+      for (const ViewId view_id : track->ViewIds()) {
+        const View* view = reconstruction.View(view_id);
+        const ViewId read_view_id =
+            read_reconstruction.ViewIdFromName(view->Name());
+        ASSERT_TRUE(read_track->ViewIds().count(read_view_id));
+        const Feature* read_feature =
+            read_reconstruction.View(read_view_id)->GetFeature(track_id);
+        ASSERT_NE(read_feature, nullptr);
+        EXPECT_EQ(*read_feature, *view->GetFeature(track_id));
+      }
+    }
+  }
+}
+
+TEST(TrackAndViewGraphFiles, TracksWithMissingView) {
+  Reconstruction reconstruction;
+  CreateReconstructionWithTracks(&reconstruction);
+  EXPECT_TRUE(WriteTracksFile(reconstruction, kContentHash, tracks_filepath));
+
+  // The reconstruction must remain unchanged if a view does not exist.
+  Reconstruction read_reconstruction;
+  for (int i = 1; i < kNumViews; i++) {
+    read_reconstruction.AddView(ViewName(i));
+  }
+  EXPECT_FALSE(ReadTracksFile(tracks_filepath, 1, &read_reconstruction));
+  EXPECT_EQ(read_reconstruction.NumTracks(), 0);
+}
+
+TEST(TrackAndViewGraphFiles, CorruptedFeatureOffsets) {
+  Reconstruction reconstruction;
+  reconstruction.AddView(ViewName(0));
+  reconstruction.AddView(ViewName(1));
+  const std::vector<std::string> view_names = {ViewName(0), ViewName(1)};
+  const std::vector<double> feature_coordinates = {1.0, 2.0, 3.0, 4.0};
+
+  // A valid file with one track that observes one feature in each view.
+  WriteRawTracksFile(
+      view_names, {0, 1, 2}, feature_coordinates, {0, 2}, {0, 1}, {0, 0});
+  EXPECT_TRUE(ReadTracksFile(tracks_filepath, 1, &reconstruction));
+  EXPECT_EQ(reconstruction.NumTracks(), 1);
+
+  // The feature offsets must start at 0.
+  Reconstruction read_reconstruction;
+  read_reconstruction.AddView(ViewName(0));
+  read_reconstruction.AddView(ViewName(1));
+  WriteRawTracksFile(
+      view_names, {1, 2, 2}, feature_coordinates, {0, 2}, {0, 1}, {0, 0});
+  EXPECT_FALSE(ReadTracksFile(tracks_filepath, 1, &read_reconstruction));
+
+  // Decreasing feature offsets would let the number of features of view 1
+  // underflow so that its feature index is not caught as out of bounds.
+  WriteRawTracksFile(
+      view_names, {0, 2, 1}, {1.0, 2.0}, {0, 2}, {0, 1}, {0, 5});
+  EXPECT_FALSE(ReadTracksFile(tracks_filepath, 1, &read_reconstruction));
+
+  // The same holds for the track offsets.
+  WriteRawTracksFile(
+      view_names, {0, 1, 2}, feature_coordinates, {2, 0, 2}, {0, 1}, {0, 0});
+  EXPECT_FALSE(ReadTracksFile(tracks_filepath, 1, &read_reconstruction));
+  EXPECT_EQ(read_reconstruction.NumTracks(), 0);
+}
+
+TEST(TrackAndViewGraphFiles, ViewGraphRoundTrip) {
+  Reconstruction reconstruction;
+  CreateReconstructionWithTracks(&reconstruction);
+  ViewGraph view_graph;
+  CreateViewGraph(reconstruction, &view_graph);
+  EXPECT_TRUE(WriteViewGraphFile(
+      reconstruction, view_graph, kContentHash, view_graph_filepath));
+
+  uint64_t content_hash;
+  EXPECT_TRUE(ReadTrackOrViewGraphFileContentHash(view_graph_filepath,
+                                                  &content_hash));
+  EXPECT_EQ(content_hash, kContentHash);
+
+  // The two view infos must be swapped since the order of the view ids is
+  // reversed.
+  Reconstruction read_reconstruction;
+  AddViewsInReverseOrder(&read_reconstruction);
+  ViewGraph read_view_graph;
+  EXPECT_TRUE(ReadViewGraphFile(
+      view_graph_filepath, read_reconstruction, &read_view_graph));
+  ASSERT_EQ(read_view_graph.NumEdges(), view_graph.NumEdges());
+  for (const auto& edge : view_graph.GetAllEdges()) {
+    const ViewId read_view_id1 = read_reconstruction.ViewIdFromName(
+        reconstruction.View(edge.first.first)->Name());
+    const ViewId read_view_id2 = read_reconstruction.ViewIdFromName(
+        reconstruction.View(edge.first.second)->Name());
+    const TwoViewInfo* read_info =
+        read_view_graph.GetEdge(read_view_id1, read_view_id2);
+    ASSERT_NE(read_info, nullptr);
+
+    TwoViewInfo expected_info = edge.second;
+    SwapCameras(&expected_info);
+    EXPECT_DOUBLE_EQ(read_info->focal_length_1, expected_info.focal_length_1);
+    EXPECT_DOUBLE_EQ(read_info->focal_length_2, expected_info.focal_length_2);
+    EXPECT_LT((read_info->position_2 - expected_info.position_2).norm(), 1e-12);
+    EXPECT_LT((read_info->rotation_2 - expected_info.rotation_2).norm(), 1e-12);
+    EXPECT_EQ(read_info->num_verified_matches,
+              expected_info.num_verified_matches);
+  }
+}
+
+TEST(TrackAndViewGraphFiles, InvalidFile) {
+  uint64_t content_hash;
+  EXPECT_FALSE(ReadTrackOrViewGraphFileContentHash(
+      THEIA_DATA_DIR + std::string("/io/does_not_exist.bin"), &content_hash));
+
+  // A view graph file is not a valid tracks file.
+  Reconstruction reconstruction;
+  CreateReconstructionWithTracks(&reconstruction);
+  ViewGraph view_graph;
+  CreateViewGraph(reconstruction, &view_graph);
+  EXPECT_TRUE(WriteViewGraphFile(
+      reconstruction, view_graph, kContentHash, view_graph_filepath));
+  Reconstruction read_reconstruction;
+  AddViewsInReverseOrder(&read_reconstruction);
+  EXPECT_FALSE(ReadTracksFile(view_graph_filepath, 1, &read_reconstruction));
+  EXPECT_EQ(read_reconstruction.NumTracks(), 0);
+}
+
+}  // namespace theia
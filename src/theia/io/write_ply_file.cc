@@ -35,86 +35,195 @@
 #include "theia/io/write_ply_file.h"
 
 #include <glog/logging.h>
+#include <stdint.h>
+#include <Eigen/Core>
+#include <cstring>
 #include <fstream>  // NOLINT
+#include <ostream>  // NOLINT
 #include <string>
 #include <vector>
 
 #include "theia/sfm/reconstruction.h"
+#include "theia/sfm/track.h"
+#include "theia/sfm/types.h"
+#include "theia/sfm/view.h"
 
 namespace theia {
 
-// Gather points from tracks.
-void GatherTracks(const Reconstruction& reconstruction,
-                  std::vector<Eigen::Vector3d>* points_to_write,
-                  std::vector<Eigen::Vector3i>* colors_to_write) {
+namespace {
+
+// The size of the buffer that binary vertices are packed into before they are
+// written to disk.
+static const int kBinaryWriteBufferSize = 1 << 20;
+
+// Each binary vertex is stored as three floats for the position and three
+// bytes for the color.
+static const int kBinaryVertexSize = 3 * sizeof(float) + 3;
+
+bool ShouldWriteTrack(const Track& track,
+                      const int min_num_observations_per_point) {
+  return track.IsEstimated() &&
+         track.NumViews() >= min_num_observations_per_point;
+}
+
+void WriteHeader(const int num_vertices,
+                 const PlyFileFormat format,
+                 std::ostream* ply_writer) {
+  *ply_writer << "ply"
+    << '\n' << (format == PlyFileFormat::ASCII
+                 ? "format ascii 1.0"
+                 : "format binary_little_endian 1.0")
+             << '\n' << "element vertex " << num_vertices
+    << '\n' << "property float x"
+    << '\n' << "property float y"
+    << '\n' << "property float z"
+    << '\n' << "property uchar red"
+    << '\n' << "property uchar green"
+    << '\n' << "property uchar blue"
+    << '\n' << "end_header" << '\n';
+}
+
+// Packs the vertex into the buffer in little-endian byte order regardless of
+// the byte order of the host.
+char* PackBinaryVertex(const Eigen::Vector3d& point,
+                       const uint8_t red,
+                       const uint8_t green,
+                       const uint8_t blue,
+                       char* buffer) {
+  for (int i = 0; i < 3; i++) {
+    const float coordinate = static_cast<float>(point[i]);
+    uint32_t bits;
+    std::memcpy(&bits, &coordinate, sizeof(bits));
+    *buffer++ = static_cast<char>(bits & 0xff);
+    *buffer++ = static_cast<char>((bits >> 8) & 0xff);
+    *buffer++ = static_cast<char>((bits >> 16) & 0xff);
+    *buffer++ = static_cast<char>((bits >> 24) & 0xff);
+  }
+  *buffer++ = static_cast<char>(red);
+  *buffer++ = static_cast<char>(green);
+  *buffer++ = static_cast<char>(blue);
+  return buffer;
+}
+
+// Writes the vertices to the binary file through a large buffer so that only
+// a few large writes are issued.
+bool WriteBinaryVertices(const Reconstruction& reconstruction,
+                         const int min_num_observations_per_point,
+                         std::ostream* ply_writer) {
+  std::vector<char> buffer(kBinaryWriteBufferSize);
+  char* const buffer_end =
+      buffer.data() + (kBinaryWriteBufferSize / kBinaryVertexSize) *
+                          kBinaryVertexSize;
+  char* buffer_position = buffer.data();
+  const auto add_vertex = [&](const Eigen::Vector3d& point,
+                              const uint8_t red,
+                              const uint8_t green,
+                              const uint8_t blue) {
+    if (buffer_position == buffer_end) {
+      ply_writer->write(buffer.data(), buffer_position - buffer.data());
+      buffer_position = buffer.data();
+    }
+    buffer_position =
+        PackBinaryVertex(point, red, green, blue, buffer_position);
+  };
+
   for (const TrackId track_id : reconstruction.TrackIds()) {
     const Track& track = *reconstruction.Track(track_id);
-    points_to_write->emplace_back(track.Point().hnormalized());
-    colors_to_write->emplace_back(track.Color()[0],
-                                  track.Color()[1],
-                                  track.Color()[2]);
+    if (!ShouldWriteTrack(track, min_num_observations_per_point)) {
+      continue;
+    }
+    add_vertex(track.Point().hnormalized(),
+               track.Color()[0],
+               track.Color()[1],
+               track.Color()[2]);
   }
-}
 
-// Gather camera positions.
-void GatherCameras(const Reconstruction& reconstruction,
-                   std::vector<Eigen::Vector3d>* points_to_write,
-                   std::vector<Eigen::Vector3i>* colors_to_write) {
   for (const ViewId view_id : reconstruction.ViewIds()) {
     const View& view = *reconstruction.View(view_id);
-    if (!view.IsEstimated()) {
+    if (view.IsEstimated()) {
+      add_vertex(view.Camera().GetPosition(), 0, 255, 0);
+    }
+  }
+
+  ply_writer->write(buffer.data(), buffer_position - buffer.data());
+  return !ply_writer->fail();
+}
+
+void WriteAsciiVertices(const Reconstruction& reconstruction,
+                        const int min_num_observations_per_point,
+                        std::ostream* ply_writer) {
+  for (const TrackId track_id : reconstruction.TrackIds()) {
+    const Track& track = *reconstruction.Track(track_id);
+    if (!ShouldWriteTrack(track, min_num_observations_per_point)) {
       continue;
     }
-    points_to_write->emplace_back(view.Camera().GetPosition());
-    colors_to_write->emplace_back(0, 255, 0);
+    const Eigen::Vector3i color = track.Color().cast<int>();
+    *ply_writer << track.Point().hnormalized().transpose() << " "
+                << color.transpose() << "\n";
+  }
+
+  const Eigen::Vector3i camera_color(0, 255, 0);
+  for (const ViewId view_id : reconstruction.ViewIds()) {
+    const View& view = *reconstruction.View(view_id);
+    if (view.IsEstimated()) {
+      *ply_writer << view.Camera().GetPosition().transpose() << " "
+                  << camera_color.transpose() << "\n";
+    }
   }
 }
 
+}  // namespace
+
 // Writes a PLY file for viewing in software such as MeshLab.
 bool WritePlyFile(const std::string& ply_file,
-                  const Reconstruction& const_reconstruction,
+                  const Reconstruction& reconstruction,
                   const int min_num_observations_per_point) {
+  return WritePlyFile(ply_file,
+                      reconstruction,
+                      min_num_observations_per_point,
+                      PlyFileFormat::ASCII);
+}
+
+bool WritePlyFile(const std::string& ply_file,
+                  const Reconstruction& reconstruction,
+                  const int min_num_observations_per_point,
+                  const PlyFileFormat format) {
   CHECK_GT(ply_file.length(), 0);
 
   // Return false if the file cannot be opened for writing.
-  std::ofstream ply_writer(ply_file, std::ofstream::out);
+  std::ofstream ply_writer(ply_file, std::ofstream::out | std::ofstream::binary);
   if (!ply_writer.is_open()) {
     LOG(ERROR) << "Could not open the file: " << ply_file
                << " for writing a PLY file.";
     return false;
   }
 
-  // First, remove any points that are unestimated or do not have enough 3D
-  // points.
-  Reconstruction reconstruction = const_reconstruction;
-  const auto& track_ids = reconstruction.TrackIds();
-  for (const TrackId track_id : track_ids) {
-    const Track& track = *reconstruction.Track(track_id);
-    if (!track.IsEstimated() || track.NumViews() < min_num_observations_per_point) {
-      reconstruction.RemoveTrack(track_id);
+  // Count the points that are estimated and have enough observations, along
+  // with the estimated cameras.
+  int num_vertices = 0;
+  for (const TrackId track_id : reconstruction.TrackIds()) {
+    if (ShouldWriteTrack(*reconstruction.Track(track_id),
+                         min_num_observations_per_point)) {
+      ++num_vertices;
+    }
+  }
+  for (const ViewId view_id : reconstruction.ViewIds()) {
+    if (reconstruction.View(view_id)->IsEstimated()) {
+      ++num_vertices;
     }
   }
 
-  // Extract points that we will write to the PLY file.
-  std::vector<Eigen::Vector3d> points_to_write;
-  std::vector<Eigen::Vector3i> colors_to_write;
-  GatherTracks(reconstruction, &points_to_write, &colors_to_write);
-  GatherCameras(reconstruction, &points_to_write, &colors_to_write);
-
-  ply_writer << "ply"
-    << '\n' << "format ascii 1.0"
-             << '\n' << "element vertex " << points_to_write.size()
-    << '\n' << "property float x"
-    << '\n' << "property float y"
-    << '\n' << "property float z"
-    << '\n' << "property uchar red"
-    << '\n' << "property uchar green"
-    << '\n' << "property uchar blue"
-    << '\n' << "end_header" << std::endl;
-
-  for (int i = 0; i < points_to_write.size(); i++) {
-    ply_writer << points_to_write[i].transpose() << " "
-               << colors_to_write[i].transpose() << "\n";
+  WriteHeader(num_vertices, format, &ply_writer);
+  if (format == PlyFileFormat::BINARY_LITTLE_ENDIAN) {
+    if (!WriteBinaryVertices(
+            reconstruction, min_num_observations_per_point, &ply_writer)) {
+      LOG(ERROR) << "Could not write the vertices to the PLY file: "
+                 << ply_file;
+      return false;
+    }
+  } else {
+    WriteAsciiVertices(
+        reconstruction, min_num_observations_per_point, &ply_writer);
   }
 
   return true;
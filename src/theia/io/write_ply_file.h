@@ -41,11 +41,27 @@ namespace theia {
 
 class Reconstruction;
 
-// Writes a PLY file for viewing in software such as MeshLab.
+// The encoding of the vertices in a PLY file. ASCII files are human-readable,
+// while binary files are much faster to write and read and about 3x smaller.
+enum class PlyFileFormat {
+  ASCII = 0,
+  BINARY_LITTLE_ENDIAN = 1,
+};
+
+// Writes a PLY file for viewing in software such as MeshLab. Each estimated
+// track with at least min_num_observations_per_point observations is written as
+// a vertex with its color, followed by the positions of all estimated cameras
+// as green vertices.
 bool WritePlyFile(const std::string& ply_file,
                   const Reconstruction& reconstruction,
                   const int min_num_observations_per_point);
 
+// Same as above, but the vertices are written with the given format.
+bool WritePlyFile(const std::string& ply_file,
+                  const Reconstruction& reconstruction,
+                  const int min_num_observations_per_point,
+                  const PlyFileFormat format);
+
 }  // namespace theia
 
 #endif  // THEIA_IO_WRITE_PLY_FILE_H_
@@ -0,0 +1,223 @@
+// Copyright (C) 2026 The Regents of the University of California (Regents).
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials provided
+//       with the distribution.
+//
+//     * Neither the name of The Regents or University of California nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+// Please contact the author of this library if you have any questions.
+// Author: agent (agent@local)
+
+#include <Eigen/Core>
+#include <stdint.h>
+#include <cstdio>
+#include <cstring>
+#include <fstream>  // NOLINT
+#include <sstream>  // NOLINT
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "theia/io/write_ply_file.h"
+#include "theia/sfm/reconstruction.h"
+#include "theia/sfm/track.h"
+#include "theia/sfm/types.h"
+#include "theia/sfm/view.h"
+#include "theia/util/random.h"
+
+namespace theia {
+
+namespace {
+
+RandomNumberGenerator rng(59);
+
+const std::string ply_filepath =
+    THEIA_DATA_DIR + std::string("/io/write_ply_file_test.ply");
+
+struct PlyVertex {
+  Eigen::Vector3f point;
+  Eigen::Vector3i color;
+};
+
+// Creates a reconstruction with estimated tracks observed by three views, and
+// one estimated track that is only observed by two views.
+void CreateReconstruction(const int num_tracks,
+                          Reconstruction* reconstruction) {
+  const ViewId view_id1 = reconstruction->AddView("1");
+  const ViewId view_id2 = reconstruction->AddView("2");
+  const ViewId view_id3 = reconstruction->AddView("3");
+  reconstruction->MutableView(view_id1)->SetEstimated(true);
+  reconstruction->MutableView(view_id1)->MutableCamera()->SetPosition(
+      Eigen::Vector3d(1.0, 2.0, 3.0));
+
+  for (int i = 0; i <= num_tracks; i++) {
+    std::vector<std::pair<ViewId, Feature> > track;
+    track.emplace_back(view_id1, Feature(i, i));
+    track.emplace_back(view_id2, Feature(i, i));
+    if (i < num_tracks) {
+      track.emplace_back(view_id3, Feature(i, i));
+    }
+    Track* mutable_track =
+        reconstruction->MutableTrack(reconstruction->AddTrack(track));
+    mutable_track->SetEstimated(true);
+    *mutable_track->MutablePoint() = rng.RandVector4d();
+    (*mutable_track->MutablePoint())[3] = 1.0;
+    *mutable_track->MutableColor() << i % 256, (2 * i) % 256, (3 * i) % 256;
+  }
+}
+
+// A minimal PLY reader for the vertex layout written by WritePlyFile.
+bool ReadPlyFile(const std::string& ply_file,
+                 std::string* format,
+                 std::vector<PlyVertex>* vertices) {
+  std::ifstream ply_reader(ply_file, std::ios::in | std::ios::binary);
+  if (!ply_reader.is_open()) {
+    return false;
+  }
+
+  std::string line;
+  int num_vertices = -1;
+  while (std::getline(ply_reader, line) && line != "end_header") {
+    std::stringstream line_stream(line);
+    std::string keyword;
+    line_stream >> keyword;
+    if (keyword == "format") {
+      line_stream >> *format;
+    } else if (keyword == "element") {
+      std::string element;
+      line_stream >> element >> num_vertices;
+    }
+  }
+  if (line != "end_header" || num_vertices < 0) {
+    return false;
+  }
+
+  vertices->resize(num_vertices);
+  for (PlyVertex& vertex : *vertices) {
+    if (*format == "ascii") {
+      ply_reader >> vertex.point.x() >> vertex.point.y() >> vertex.point.z() >>
+          vertex.color.x() >> vertex.color.y() >> vertex.color.z();
+    } else {
+      char record[15];
+      ply_reader.read(record, sizeof(record));
+      for (int i = 0; i < 3; i++) {
+        uint32_t bits = 0;
+        for (int j = 3; j >= 0; j--) {
+          bits = (bits << 8) | static_cast<uint8_t>(record[4 * i + j]);
+        }
+        std::memcpy(&vertex.point[i], &bits, sizeof(bits));
+        vertex.color[i] = static_cast<uint8_t>(record[12 + i]);
+      }
+    }
+  }
+  return !ply_reader.fail();
+}
+
+void TestRoundTrip(const PlyFileFormat format,
+                   const std::string& expected_format,
+                   const float tolerance) {
+  static const int kNumTracks = 100;
+  static const int kMinNumObservations = 3;
+
+  Reconstruction reconstruction;
+  CreateReconstruction(kNumTracks, &reconstruction);
+  EXPECT_TRUE(WritePlyFile(
+      ply_filepath, reconstruction, kMinNumObservations, format));
+
+  std::string file_format;
+  std::vector<PlyVertex> vertices;
+  ASSERT_TRUE(ReadPlyFile(ply_filepath, &file_format, &vertices));
+  EXPECT_EQ(file_format, expected_format);
+
+  // All tracks but the one with two observations are written, along with
+  // the one estimated camera.
+  ASSERT_EQ(vertices.size(), kNumTracks + 1);
+  int vertex_index = 0;
+  for (const TrackId track_id : reconstruction.TrackIds()) {
+    const Track& track = *reconstruction.Track(track_id);
+    if (track.NumViews() < kMinNumObservations) {
+      continue;
+    }
+    const PlyVertex& vertex = vertices[vertex_index++];
+    EXPECT_LE((vertex.point - track.Point().hnormalized().cast<float>())
+                  .lpNorm<Eigen::Infinity>(),
+              tolerance);
+    EXPECT_EQ(vertex.color, track.Color().cast<int>());
+  }
+  EXPECT_EQ(vertices.back().point, Eigen::Vector3f(1.0, 2.0, 3.0));
+  EXPECT_EQ(vertices.back().color, Eigen::Vector3i(0, 255, 0));
+  std::remove(ply_filepath.c_str());
+}
+
+}  // namespace
+
+TEST(WritePlyFile, AsciiRoundTrip) {
+  TestRoundTrip(PlyFileFormat::ASCII, "ascii", 1e-5);
+}
+
+TEST(WritePlyFile, BinaryRoundTrip) {
+  TestRoundTrip(PlyFileFormat::BINARY_LITTLE_ENDIAN, "binary_little_endian", 0);
+}
+
+// The ASCII and binary files of the same reconstruction must contain the same
+// vertices, and the binary file must be smaller.
+TEST(WritePlyFile, AsciiAndBinaryAgree) {
+  static const int kNumTracks = 100;
+
+  Reconstruction reconstruction;
+  CreateReconstruction(kNumTracks, &reconstruction);
+
+  std::string ascii_format, binary_format;
+  std::vector<PlyVertex> ascii_vertices, binary_vertices;
+  EXPECT_TRUE(
+      WritePlyFile(ply_filepath, reconstruction, 3, PlyFileFormat::ASCII));
+  ASSERT_TRUE(ReadPlyFile(ply_filepath, &ascii_format, &ascii_vertices));
+  std::ifstream ascii_file(ply_filepath, std::ios::binary | std::ios::ate);
+  const int64_t ascii_file_size = ascii_file.tellg();
+
+  EXPECT_TRUE(WritePlyFile(
+      ply_filepath, reconstruction, 3, PlyFileFormat::BINARY_LITTLE_ENDIAN));
+  ASSERT_TRUE(ReadPlyFile(ply_filepath, &binary_format, &binary_vertices));
+  std::ifstream binary_file(ply_filepath, std::ios::binary | std::ios::ate);
+  const int64_t binary_file_size = binary_file.tellg();
+
+  EXPECT_EQ(ascii_format, "ascii");
+  EXPECT_EQ(binary_format, "binary_little_endian");
+  ASSERT_EQ(ascii_vertices.size(), binary_vertices.size());
+  for (int i = 0; i < ascii_vertices.size(); i++) {
+    EXPECT_LE((ascii_vertices[i].point - binary_vertices[i].point)
+                  .lpNorm<Eigen::Infinity>(),
+              1e-5);
+    EXPECT_EQ(ascii_vertices[i].color, binary_vertices[i].color);
+  }
+  EXPECT_LT(binary_file_size, ascii_file_size);
+  std::remove(ply_filepath.c_str());
+}
+
+}  // namespace theia
@@ -37,6 +37,7 @@
 #include <Eigen/Core>
 #include <glog/logging.h>
 #include <algorithm>
+#include <limits>
 #include <vector>
 
 #include "theia/matching/distance.h"
@@ -44,7 +45,49 @@
 #include "theia/matching/indexed_feature_match.h"
 
 namespace theia {
+namespace {
 
+typedef Eigen::Matrix<float, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>
+    RowMajorMatrixXf;
+
+// The distances are computed in blocks of this many features of each image so
+// that the blocks of descriptors and distances stay in the cache.
+static constexpr int kQueryBlockSize = 256;
+static constexpr int kCandidateBlockSize = 512;
+// The descriptors of the other images are stacked into matrices of at most this
+// many descriptors (unless a single image has more descriptors).
+static constexpr int kMaxNumStackedDescriptors = 65536;
+
+// Keeps track of the nearest neighbor and the distance to the second nearest
+// neighbor.
+struct TwoNearestNeighbors {
+  int index = -1;
+  float distance = std::numeric_limits<float>::max();
+  float second_distance = std::numeric_limits<float>::max();
+
+  void Add(const int candidate_index, const float candidate_distance) {
+    if (candidate_distance < distance) {
+      second_distance = distance;
+      distance = candidate_distance;
+      index = candidate_index;
+    } else if (candidate_distance < second_distance) {
+      second_distance = candidate_distance;
+    }
+  }
+};
+
+// Copies the descriptors into the rows of a matrix.
+void StackDescriptors(const std::vector<Eigen::VectorXf>& descriptors,
+                      const int start_row,
+                      RowMajorMatrixXf* stacked_descriptors) {
+  for (int i = 0; i < descriptors.size(); i++) {
+    CHECK_EQ(descriptors[i].size(), stacked_descriptors->cols())
+        << "All descriptors must have the same dimension.";
+    stacked_descriptors->row(start_row + i) = descriptors[i];
+  }
+}
+
+}  // namespace
 
 bool BruteForceFeatureMatcher::MatchImagePair(
     const KeypointsAndDescriptors& features1,
@@ -116,4 +159,135 @@ bool BruteForceFeatureMatcher::MatchImagePair(
   return matches->size() >= this->options_.min_num_feature_matches;
 }
 
+void BruteForceFeatureMatcher::MatchImageToImages(
+    const KeypointsAndDescriptors& features1,
+    const std::vector<std::shared_ptr<const KeypointsAndDescriptors> >&
+        features2,
+    std::vector<std::vector<IndexedFeatureMatch> >* matches,
+    std::vector<bool>* is_valid_match) {
+  const int num_images = features2.size();
+  matches->clear();
+  matches->resize(num_images);
+  is_valid_match->assign(num_images,
+                         this->options_.min_num_feature_matches <= 0);
+  const int num_queries = features1.descriptors.size();
+  if (num_queries == 0) {
+    return;
+  }
+
+  const int num_dimensions = features1.descriptors[0].size();
+  RowMajorMatrixXf descriptors1(num_queries, num_dimensions);
+  StackDescriptors(features1.descriptors, 0, &descriptors1);
+  const Eigen::VectorXf sq_norms1 = descriptors1.rowwise().squaredNorm();
+  const float sq_lowes_ratio =
+      this->options_.lowes_ratio * this->options_.lowes_ratio;
+  const auto passes_ratio_test = [&](const TwoNearestNeighbors& neighbors) {
+    return !this->options_.use_lowes_ratio ||
+           neighbors.distance < sq_lowes_ratio * neighbors.second_distance;
+  };
+
+  // The other images are matched in batches whose descriptors are stacked into
+  // a single matrix. The descriptors of image i of the batch are stored in the
+  // rows [offsets[i], offsets[i + 1]).
+  int batch_start = 0;
+  while (batch_start < num_images) {
+    std::vector<int> offsets(1, 0);
+    int batch_end = batch_start;
+    while (batch_end < num_images &&
+           (batch_end == batch_start ||
+            offsets.back() + features2[batch_end]->descriptors.size() <=
+                kMaxNumStackedDescriptors)) {
+      offsets.emplace_back(offsets.back() +
+                           features2[batch_end]->descriptors.size());
+      ++batch_end;
+    }
+    const int num_batch_images = batch_end - batch_start;
+    const int num_candidates = offsets.back();
+
+    RowMajorMatrixXf descriptors2(num_candidates, num_dimensions);
+    std::vector<int> candidate_images(num_candidates);
+    for (int i = 0; i < num_batch_images; i++) {
+      StackDescriptors(
+          features2[batch_start + i]->descriptors, offsets[i], &descriptors2);
+      std::fill(candidate_images.begin() + offsets[i],
+                candidate_images.begin() + offsets[i + 1],
+                i);
+    }
+    const Eigen::VectorXf sq_norms2 = descriptors2.rowwise().squaredNorm();
+
+    // The two nearest neighbors of each feature of the first image in each of
+    // the other images, and of each feature of the other images in the first
+    // image.
+    std::vector<TwoNearestNeighbors> forward_neighbors(num_queries *
+                                                       num_batch_images);
+    std::vector<TwoNearestNeighbors> reverse_neighbors(num_candidates);
+
+    // Compute the squared distances ||a||^2 + ||b||^2 - 2 a.b block by block.
+    Eigen::MatrixXf dot_products;
+    for (int c = 0; c < num_candidates; c += kCandidateBlockSize) {
+      const int num_block_candidates =
+          std::min(kCandidateBlockSize, num_candidates - c);
+      for (int q = 0; q < num_queries; q += kQueryBlockSize) {
+        const int num_block_queries =
+            std::min(kQueryBlockSize, num_queries - q);
+        dot_products.noalias() =
+            descriptors1.middleRows(q, num_block_queries) *
+            descriptors2.middleRows(c, num_block_candidates).transpose();
+
+        for (int j = 0; j < num_block_candidates; j++) {
+          const int candidate = c + j;
+          const int image = candidate_images[candidate];
+          const int feature2 = candidate - offsets[image];
+          for (int i = 0; i < num_block_queries; i++) {
+            const int query = q + i;
+            const float distance =
+                std::max(0.0f,
+                         sq_norms1[query] + sq_norms2[candidate] -
+                             2.0f * dot_products(i, j));
+            forward_neighbors[query * num_batch_images + image].Add(feature2,
+                                                                    distance);
+            reverse_neighbors[candidate].Add(query, distance);
+          }
+        }
+      }
+    }
+
+    // Gather the matches of each image pair from the nearest neighbors.
+    for (int i = 0; i < num_batch_images; i++) {
+      std::vector<IndexedFeatureMatch>& image_matches =
+          (*matches)[batch_start + i];
+      for (int query = 0; query < num_queries; query++) {
+        const TwoNearestNeighbors& neighbors =
+            forward_neighbors[query * num_batch_images + i];
+        if (neighbors.index >= 0 && passes_ratio_test(neighbors)) {
+          image_matches.emplace_back(
+              query, neighbors.index, neighbors.distance);
+        }
+      }
+      if (image_matches.size() < this->options_.min_num_feature_matches) {
+        (*is_valid_match)[batch_start + i] = false;
+        continue;
+      }
+
+      // Compute the symmetric matches, if applicable.
+      if (this->options_.keep_only_symmetric_matches) {
+        std::vector<IndexedFeatureMatch> reverse_matches;
+        for (int candidate = offsets[i]; candidate < offsets[i + 1];
+             candidate++) {
+          const TwoNearestNeighbors& neighbors = reverse_neighbors[candidate];
+          if (passes_ratio_test(neighbors)) {
+            reverse_matches.emplace_back(candidate - offsets[i],
+                                         neighbors.index,
+                                         neighbors.distance);
+          }
+        }
+        IntersectMatches(reverse_matches, &image_matches);
+      }
+      (*is_valid_match)[batch_start + i] =
+          image_matches.size() >= this->options_.min_num_feature_matches;
+    }
+    batch_start = batch_end;
+  }
+}
+
 }  // namespace theia
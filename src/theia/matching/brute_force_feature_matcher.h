@@ -47,7 +47,9 @@ struct IndexedFeatureMatch;
 struct KeypointsAndDescriptors;
 
 // Performs features matching between two sets of features using a brute force
-// matching method.
+// matching method. When one image is matched against several other images, the
+// descriptors of the other images are matched in a single blocked pass and the
+// two nearest neighbors are tracked separately for each image pair.
 class BruteForceFeatureMatcher : public FeatureMatcher {
  public:
   BruteForceFeatureMatcher(
@@ -62,6 +64,13 @@ class BruteForceFeatureMatcher : public FeatureMatcher {
       const KeypointsAndDescriptors& features2,
       std::vector<IndexedFeatureMatch>* matched_featuers) override;
 
+  void MatchImageToImages(
+      const KeypointsAndDescriptors& features1,
+      const std::vector<std::shared_ptr<const KeypointsAndDescriptors> >&
+          features2,
+      std::vector<std::vector<IndexedFeatureMatch> >* matched_features,
+      std::vector<bool>* is_valid_match) override;
+
   DISALLOW_COPY_AND_ASSIGN(BruteForceFeatureMatcher);
 };
 }  // namespace theia
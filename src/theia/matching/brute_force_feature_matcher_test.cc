@@ -33,14 +33,19 @@
 // Author: Chris Sweeney (cmsweeney@cs.ucsb.edu)
 
 #include <Eigen/Core>
+#include <algorithm>
+#include <cstdio>
+#include <string>
 #include <vector>
 
 #include "theia/matching/brute_force_feature_matcher.h"
 #include "theia/matching/distance.h"
 #include "theia/matching/feature_matcher.h"
 #include "theia/matching/image_pair_match.h"
+#include "theia/matching/image_pair_matching_log.h"
 #include "theia/matching/in_memory_features_and_matches_database.h"
 #include "theia/matching/keypoints_and_descriptors.h"
+#include "theia/util/random.h"
 
 #include "gtest/gtest.h"
 
@@ -50,6 +55,8 @@ using Eigen::VectorXf;
 
 static const int kNumDescriptors = 10;
 static const int kNumDescriptorDimensions = 10;
+static const std::string kMatchingLogFilepath =  // NOLINT
+    THEIA_DATA_DIR + std::string("/brute_force_matching_log.txt");
 
 TEST(BruteForceFeatureMatcherTest, NoOptions) {
   // Set up descriptors.
@@ -89,6 +96,41 @@ TEST(BruteForceFeatureMatcherTest, NoOptions) {
   EXPECT_GT(database.NumMatches(), 0);
 }
 
+// The matches of a requested image pair must be stored in the orientation in
+// which the pair was requested, even when the pairs are scheduled in tiles.
+TEST(BruteForceFeatureMatcherTest, KeepsImagePairOrientation) {
+  KeypointsAndDescriptors features;
+  features.descriptors.resize(kNumDescriptors);
+  for (int i = 0; i < kNumDescriptors; i++) {
+    features.descriptors[i] = VectorXf::Constant(kNumDescriptorDimensions, 1);
+    features.descriptors[i].normalize();
+  }
+  features.keypoints.resize(features.descriptors.size());
+
+  FeatureMatcherOptions options;
+  options.min_num_feature_matches = 0;
+  options.keep_only_symmetric_matches = false;
+  options.use_lowes_ratio = false;
+  options.perform_geometric_verification = false;
+  options.image_pair_tile_size = 1;
+
+  InMemoryFeaturesAndMatchesDatabase database;
+  database.PutFeatures("1", features);
+  database.PutFeatures("2", features);
+  database.PutFeatures("3", features);
+
+  BruteForceFeatureMatcher matcher(options, &database);
+  matcher.AddImages({"1", "2", "3"});
+  matcher.SetImagePairsToMatch({{"2", "1"}, {"1", "3"}});
+  matcher.MatchImages();
+
+  EXPECT_EQ(database.NumMatches(), 2);
+  const ImagePairMatch match = database.GetImagePairMatch("2", "1");
+  EXPECT_EQ(match.image1, "2");
+  EXPECT_EQ(match.image2, "1");
+  EXPECT_EQ(database.GetImagePairMatch("1", "3").image1, "1");
+}
+
 TEST(BruteForceFeatureMatcherTest, RatioTest) {
   // Set up descriptors.
   KeypointsAndDescriptors features1, features2;
@@ -180,4 +222,155 @@ TEST(BruteForceFeatureMatcherTest, SymmetricMatches) {
   EXPECT_EQ(database.NumMatches(), 1);
 }
 
+TEST(BruteForceFeatureMatcherTest, ResumeFromMatchingLog) {
+  // Set up descriptors.
+  KeypointsAndDescriptors features;
+  features.descriptors.resize(kNumDescriptors);
+  for (int i = 0; i < kNumDescriptors; i++) {
+    features.descriptors[i] = VectorXf::Constant(kNumDescriptorDimensions, 1);
+    features.descriptors[i].normalize();
+  }
+  features.keypoints.resize(features.descriptors.size());
+
+  // Set options.
+  FeatureMatcherOptions options;
+  options.min_num_feature_matches = 0;
+  options.keep_only_symmetric_matches = false;
+  options.use_lowes_ratio = false;
+  options.perform_geometric_verification = false;
+  options.image_pair_matching_log_filepath = kMatchingLogFilepath;
+  std::remove(kMatchingLogFilepath.c_str());
+
+  InMemoryFeaturesAndMatchesDatabase database;
+  database.PutFeatures("1", features);
+  database.PutFeatures("2", features);
+  database.PutFeatures("3", features);
+
+  // Match only the first pair, as if matching was interrupted.
+  {
+    BruteForceFeatureMatcher matcher(options, &database);
+    matcher.AddImage("1");
+    matcher.AddImage("2");
+    matcher.AddImage("3");
+    matcher.SetImagePairsToMatch({{"1", "2"}});
+    matcher.MatchImages();
+    EXPECT_EQ(matcher.NumAttemptedImagePairs(), 1);
+    EXPECT_EQ(database.NumMatches(), 1);
+  }
+
+  // Resuming should only match the remaining pairs.
+  {
+    BruteForceFeatureMatcher matcher(options, &database);
+    matcher.AddImage("1");
+    matcher.AddImage("2");
+    matcher.AddImage("3");
+    matcher.MatchImages();
+    EXPECT_EQ(matcher.NumImagePairsToMatch(), 3);
+    EXPECT_EQ(matcher.NumAttemptedImagePairs(), 3);
+    EXPECT_EQ(matcher.matching_log()->NumRecordedPairs(), 3);
+    EXPECT_EQ(database.NumMatches(), 3);
+  }
+
+  std::remove(kMatchingLogFilepath.c_str());
+}
+
+// Computes the symmetric matches that pass the ratio test by exhaustive search.
+std::vector<FeatureCorrespondence> ReferenceMatches(
+    const KeypointsAndDescriptors& features1,
+    const KeypointsAndDescriptors& features2,
+    const float lowes_ratio) {
+  const auto nearest_neighbor = [&](
+      const Eigen::VectorXf& descriptor,
+      const std::vector<Eigen::VectorXf>& others) {
+    std::vector<std::pair<float, int> > distances;
+    for (int i = 0; i < others.size(); i++) {
+      distances.emplace_back((descriptor - others[i]).squaredNorm(), i);
+    }
+    std::sort(distances.begin(), distances.end());
+    return distances[0].first < lowes_ratio * lowes_ratio * distances[1].first
+               ? distances[0].second
+               : -1;
+  };
+
+  std::vector<FeatureCorrespondence> matches;
+  for (int i = 0; i < features1.descriptors.size(); i++) {
+    const int j =
+        nearest_neighbor(features1.descriptors[i], features2.descriptors);
+    if (j < 0) {
+      continue;
+    }
+    const int reverse_j =
+        nearest_neighbor(features2.descriptors[j], features1.descriptors);
+    if (reverse_j == i) {
+      matches.emplace_back(
+          Feature(features1.keypoints[i].x(), features1.keypoints[i].y()),
+          Feature(features2.keypoints[j].x(), features2.keypoints[j].y()));
+    }
+  }
+  return matches;
+}
+
+TEST(BruteForceFeatureMatcherTest, MatchImageToImages) {
+  static const int kNumImages = 4;
+  static const int kNumFeatures = 300;
+  static const int kNumSiftDimensions = 128;
+  static const double kNoise = 0.02;
+  RandomNumberGenerator rng(61);
+
+  // The features of all images are noisy copies of a shuffled subset of the
+  // same random descriptors.
+  std::vector<Eigen::VectorXf> descriptors(kNumFeatures);
+  for (int i = 0; i < kNumFeatures; i++) {
+    descriptors[i].resize(kNumSiftDimensions);
+    for (int j = 0; j < kNumSiftDimensions; j++) {
+      descriptors[i](j) = rng.RandFloat(0.0, 1.0);
+    }
+  }
+
+  InMemoryFeaturesAndMatchesDatabase database;
+  std::vector<KeypointsAndDescriptors> features(kNumImages);
+  for (int i = 0; i < kNumImages; i++) {
+    features[i].image_name = std::to_string(i);
+    const int num_features = kNumFeatures - 50 * i;
+    for (int j = 0; j < num_features; j++) {
+      Eigen::VectorXf descriptor = descriptors[(7 * j + i) % kNumFeatures];
+      for (int k = 0; k < kNumSiftDimensions; k++) {
+        descriptor(k) += rng.RandGaussian(0.0, kNoise);
+      }
+      features[i].descriptors.emplace_back(descriptor.normalized());
+      features[i].keypoints.emplace_back(j, i, Keypoint::OTHER);
+    }
+    database.PutFeatures(features[i].image_name, features[i]);
+  }
+
+  FeatureMatcherOptions options;
+  options.min_num_feature_matches = 0;
+  options.perform_geometric_verification = false;
+
+  // All pairs share the first image so they are matched at once.
+  BruteForceFeatureMatcher matcher(options, &database);
+  for (int i = 0; i < kNumImages; i++) {
+    matcher.AddImage(features[i].image_name);
+  }
+  matcher.SetImagePairsToMatch({{"0", "1"}, {"0", "2"}, {"0", "3"}});
+  matcher.MatchImages();
+  ASSERT_EQ(database.NumMatches(), kNumImages - 1);
+
+  for (int i = 1; i < kNumImages; i++) {
+    const std::vector<FeatureCorrespondence> expected_matches =
+        ReferenceMatches(features[0], features[i], options.lowes_ratio);
+    const std::vector<FeatureCorrespondence> matches =
+        database.GetImagePairMatch("0", features[i].image_name)
+            .correspondences;
+    EXPECT_GT(expected_matches.size(), 0);
+    ASSERT_EQ(matches.size(), expected_matches.size());
+    for (const FeatureCorrespondence& match : matches) {
+      EXPECT_NE(std::find(expected_matches.begin(),
+                          expected_matches.end(),
+                          match),
+                expected_matches.end());
+    }
+  }
+}
+
 }  // namespace theia
@@ -74,9 +74,10 @@ CascadeHashingFeatureMatcher::~CascadeHashingFeatureMatcher() {}
 
 std::shared_ptr<HashedImage> CascadeHashingFeatureMatcher::FetchHashedImage(
     const std::string& image_name) {
-  const auto features = this->feature_and_matches_db_->GetFeatures(image_name);
+  const auto features =
+      this->feature_and_matches_db_->GetSharedFeatures(image_name);
   return std::make_shared<HashedImage>(
-      cascade_hasher_->CreateHashedSiftDescriptors(features.descriptors));
+      cascade_hasher_->CreateHashedSiftDescriptors(features->descriptors));
 }
 
 // Initializes the cascade hasher (only if needed).
@@ -98,15 +99,15 @@ void CascadeHashingFeatureMatcher::AddImage(const std::string& image_name) {
   }
 
   // Get the features from the db and create hashed descriptors.
-  const KeypointsAndDescriptors& features =
-      this->feature_and_matches_db_->GetFeatures(image_name);
+  const auto features =
+      this->feature_and_matches_db_->GetSharedFeatures(image_name);
 
-  if (features.descriptors.size() == 0) {
+  if (features->descriptors.size() == 0) {
     return;
   }
 
   // Initialize the cascade hasher if needed.
-  InitializeCascadeHasher(features.descriptors[0].size());
+  InitializeCascadeHasher(features->descriptors[0].size());
 }
 
 void CascadeHashingFeatureMatcher::AddImages(
@@ -118,10 +119,10 @@ void CascadeHashingFeatureMatcher::AddImages(
 
   // Initialize cascade hasher (if needed).
   for (int i = 0; i < image_names.size(); i++) {
-    const KeypointsAndDescriptors& init_features =
-        this->feature_and_matches_db_->GetFeatures(image_names[i]);
-    if (init_features.descriptors.size() > 0) {
-      InitializeCascadeHasher(init_features.descriptors[0].size());
+    const auto init_features =
+        this->feature_and_matches_db_->GetSharedFeatures(image_names[i]);
+    if (init_features->descriptors.size() > 0) {
+      InitializeCascadeHasher(init_features->descriptors[0].size());
       return;
     }
   }
@@ -42,6 +42,8 @@
 #include "theia/matching/distance.h"
 #include "theia/matching/feature_matcher.h"
 #include "theia/matching/features_and_matches_database.h"
+#include "theia/matching/flann_feature_matcher.h"
+#include "theia/matching/quantized_brute_force_feature_matcher.h"
 
 namespace theia {
 
@@ -56,6 +58,13 @@ std::unique_ptr<FeatureMatcher> CreateFeatureMatcher(
   } else if (matching_strategy == MatchingStrategy::BRUTE_FORCE) {
     matcher.reset(
         new BruteForceFeatureMatcher(options, features_and_matches_database));
+  } else if (matching_strategy == MatchingStrategy::QUANTIZED_BRUTE_FORCE) {
+    matcher.reset(new QuantizedBruteForceFeatureMatcher(
+        options, features_and_matches_database));
+  } else if (matching_strategy ==
+             MatchingStrategy::APPROXIMATE_NEAREST_NEIGHBOR) {
+    matcher.reset(
+        new FlannFeatureMatcher(options, features_and_matches_database));
   } else {
     LOG(FATAL) << "Invalid matching strategy specified.";
   }
@@ -46,6 +46,8 @@ struct FeatureMatcherOptions;
 enum class MatchingStrategy {
   BRUTE_FORCE = 0,
   CASCADE_HASHING = 1,
+  QUANTIZED_BRUTE_FORCE = 2,
+  APPROXIMATE_NEAREST_NEIGHBOR = 3,
 };
 
 // A factory method for creating an L2-based feature matcher (i.e. for float
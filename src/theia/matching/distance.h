@@ -37,23 +37,53 @@
 
 #include <Eigen/Core>
 #include <glog/logging.h>
+#include <stdint.h>
+
+#include "theia/matching/distance_kernels.h"
 
 namespace theia {
 // This file includes all of the distance metrics that are used:
-// L2 distance for euclidean features.
+// L2 distance for euclidean features and Hamming distance for binary features.
+// The distances are computed with the SIMD kernels selected at runtime for the
+// CPU (see distance_kernels.h).
 
-// Squared Euclidean distance functor. We let Eigen handle the SSE optimization.
-// NOTE: This assumes that each vector has a unit norm:
-//  ||x - y||^2 = ||x||^2 + ||y||^2 - 2*||x^t * y|| = 2 - 2 * x.dot(y).
+// Squared Euclidean distance functor.
 struct L2 {
   typedef float DistanceType;
   typedef Eigen::VectorXf DescriptorType;
 
+  L2()
+      : squared_l2_distance_(
+            GetDescriptorDistanceKernels().squared_l2_distance) {}
+
   DistanceType operator()(const Eigen::VectorXf& descriptor_a,
                           const Eigen::VectorXf& descriptor_b) const {
     DCHECK_EQ(descriptor_a.size(), descriptor_b.size());
-    return (descriptor_a - descriptor_b).squaredNorm();
+    return squared_l2_distance_(
+        descriptor_a.data(), descriptor_b.data(), descriptor_a.size());
+  }
+
+ private:
+  float (*squared_l2_distance_)(const float*, const float*, const int);
+};
+
+// Hamming distance functor for binary descriptors stored as bytes.
+struct Hamming {
+  typedef int DistanceType;
+  typedef Eigen::Matrix<uint8_t, Eigen::Dynamic, 1> DescriptorType;
+
+  Hamming()
+      : hamming_distance_(GetDescriptorDistanceKernels().hamming_distance) {}
+
+  DistanceType operator()(const DescriptorType& descriptor_a,
+                          const DescriptorType& descriptor_b) const {
+    DCHECK_EQ(descriptor_a.size(), descriptor_b.size());
+    return hamming_distance_(
+        descriptor_a.data(), descriptor_b.data(), descriptor_a.size());
   }
+
+ private:
+  int (*hamming_distance_)(const uint8_t*, const uint8_t*, const int);
 };
 
 }  // namespace theia
@@ -0,0 +1,381 @@
+// Copyright (C) 2026 The Regents of the University of California (Regents).
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials provided
+//       with the distribution.
+//
+//     * Neither the name of The Regents or University of California nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+// Please contact the author of this library if you have any questions.
+// Author: agent (agent@local)
+
+#include "theia/matching/distance_kernels.h"
+
+#include <glog/logging.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "theia/util/cpu_features.h"
+
+// The SIMD kernels are compiled with function-specific target attributes
+// rather than global compiler flags so that they are available in any build
+// and are only called when the CPU supports them.
+#if (defined(__GNUC__) || defined(__clang__)) && defined(__x86_64__)
+#define THEIA_HAS_X86_SIMD_KERNELS
+#include <immintrin.h>
+#define THEIA_TARGET(instruction_sets) \
+  __attribute__((target(instruction_sets)))
+#endif
+
+namespace theia {
+
+namespace {
+
+uint64_t LoadUnaligned64(const uint8_t* data) {
+  uint64_t value;
+  memcpy(&value, data, sizeof(value));
+  return value;
+}
+
+int PopulationCount(uint64_t value) {
+  value = value - ((value >> 1) & 0x5555555555555555ULL);
+  value = (value & 0x3333333333333333ULL) +
+          ((value >> 2) & 0x3333333333333333ULL);
+  value = (value + (value >> 4)) & 0x0f0f0f0f0f0f0f0fULL;
+  return static_cast<int>((value * 0x0101010101010101ULL) >> 56);
+}
+
+// ----------------------------- Scalar kernels ----------------------------- //
+
+float SquaredL2DistanceScalar(const float* descriptor1,
+                              const float* descriptor2,
+                              const int size) {
+  float distance = 0.0f;
+  for (int i = 0; i < size; i++) {
+    const float difference = descriptor1[i] - descriptor2[i];
+    distance += difference * difference;
+  }
+  return distance;
+}
+
+int32_t Int8DotProductScalar(const int8_t* descriptor1,
+                             const int8_t* descriptor2,
+                             const int32_t descriptor2_sum,
+                             const int size) {
+  int32_t sum = 0;
+  for (int i = 0; i < size; i++) {
+    sum += static_cast<int16_t>(descriptor1[i]) *
+           static_cast<int16_t>(descriptor2[i]);
+  }
+  return sum;
+}
+
+int HammingDistanceScalar(const uint8_t* descriptor1,
+                          const uint8_t* descriptor2,
+                          const int num_bytes) {
+  int distance = 0;
+  int i = 0;
+  for (; i + 8 <= num_bytes; i += 8) {
+    distance += PopulationCount(LoadUnaligned64(descriptor1 + i) ^
+                                LoadUnaligned64(descriptor2 + i));
+  }
+  for (; i < num_bytes; i++) {
+    distance += PopulationCount(descriptor1[i] ^ descriptor2[i]);
+  }
+  return distance;
+}
+
+#ifdef THEIA_HAS_X86_SIMD_KERNELS
+
+// ----------------------------- SSE4.2 kernels ----------------------------- //
+
+THEIA_TARGET("sse4.2,popcnt")
+float SquaredL2DistanceSse(const float* descriptor1,
+                           const float* descriptor2,
+                           const int size) {
+  __m128 sum = _mm_setzero_ps();
+  int i = 0;
+  for (; i + 4 <= size; i += 4) {
+    const __m128 difference = _mm_sub_ps(_mm_loadu_ps(descriptor1 + i),
+                                         _mm_loadu_ps(descriptor2 + i));
+    sum = _mm_add_ps(sum, _mm_mul_ps(difference, difference));
+  }
+  sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+  sum = _mm_add_ss(sum, _mm_shuffle_ps(sum, sum, 1));
+  return _mm_cvtss_f32(sum) +
+         SquaredL2DistanceScalar(descriptor1 + i, descriptor2 + i, size - i);
+}
+
+THEIA_TARGET("sse4.2,popcnt")
+int32_t Int8DotProductSse(const int8_t* descriptor1,
+                          const int8_t* descriptor2,
+                          const int32_t descriptor2_sum,
+                          const int size) {
+  __m128i sum = _mm_setzero_si128();
+  for (int i = 0; i < size; i += 8) {
+    const __m128i values1 = _mm_cvtepi8_epi16(
+        _mm_loadl_epi64(reinterpret_cast<const __m128i*>(descriptor1 + i)));
+    const __m128i values2 = _mm_cvtepi8_epi16(
+        _mm_loadl_epi64(reinterpret_cast<const __m128i*>(descriptor2 + i)));
+    sum = _mm_add_epi32(sum, _mm_madd_epi16(values1, values2));
+  }
+  sum = _mm_hadd_epi32(sum, sum);
+  sum = _mm_hadd_epi32(sum, sum);
+  return _mm_cvtsi128_si32(sum);
+}
+
+THEIA_TARGET("sse4.2,popcnt")
+int HammingDistanceSse(const uint8_t* descriptor1,
+                       const uint8_t* descriptor2,
+                       const int num_bytes) {
+  int distance = 0;
+  int i = 0;
+  for (; i + 8 <= num_bytes; i += 8) {
+    distance += static_cast<int>(_mm_popcnt_u64(
+        LoadUnaligned64(descriptor1 + i) ^ LoadUnaligned64(descriptor2 + i)));
+  }
+  for (; i < num_bytes; i++) {
+    distance += _mm_popcnt_u32(descriptor1[i] ^ descriptor2[i]);
+  }
+  return distance;
+}
+
+// ------------------------------ AVX2 kernels ------------------------------ //
+
+THEIA_TARGET("avx2,fma,popcnt")
+float SquaredL2DistanceAvx2(const float* descriptor1,
+                            const float* descriptor2,
+                            const int size) {
+  __m256 sum = _mm256_setzero_ps();
+  int i = 0;
+  for (; i + 8 <= size; i += 8) {
+    const __m256 difference = _mm256_sub_ps(_mm256_loadu_ps(descriptor1 + i),
+                                            _mm256_loadu_ps(descriptor2 + i));
+    sum = _mm256_fmadd_ps(difference, difference, sum);
+  }
+  __m128 sum128 =
+      _mm_add_ps(_mm256_castps256_ps128(sum), _mm256_extractf128_ps(sum, 1));
+  sum128 = _mm_add_ps(sum128, _mm_movehl_ps(sum128, sum128));
+  sum128 = _mm_add_ss(sum128, _mm_shuffle_ps(sum128, sum128, 1));
+  return _mm_cvtss_f32(sum128) +
+         SquaredL2DistanceScalar(descriptor1 + i, descriptor2 + i, size - i);
+}
+
+THEIA_TARGET("avx2,fma,popcnt")
+int32_t Int8DotProductAvx2(const int8_t* descriptor1,
+                           const int8_t* descriptor2,
+                           const int32_t descriptor2_sum,
+                           const int size) {
+  // VPMADDUBSW would saturate the 16-bit intermediate sums for full range
+  // values, so the values are widened to 16 bits and VPMADDWD is used instead.
+  __m256i sum = _mm256_setzero_si256();
+  for (int i = 0; i < size; i += 16) {
+    const __m256i values1 = _mm256_cvtepi8_epi16(
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(descriptor1 + i)));
+    const __m256i values2 = _mm256_cvtepi8_epi16(
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(descriptor2 + i)));
+    sum = _mm256_add_epi32(sum, _mm256_madd_epi16(values1, values2));
+  }
+  __m128i sum128 = _mm_add_epi32(_mm256_castsi256_si128(sum),
+                                 _mm256_extracti128_si256(sum, 1));
+  sum128 = _mm_hadd_epi32(sum128, sum128);
+  sum128 = _mm_hadd_epi32(sum128, sum128);
+  return _mm_cvtsi128_si32(sum128);
+}
+
+THEIA_TARGET("avx2,fma,popcnt")
+int HammingDistanceAvx2(const uint8_t* descriptor1,
+                        const uint8_t* descriptor2,
+                        const int num_bytes) {
+  // Counts the bits of each nibble with a table lookup (VPSHUFB) and sums the
+  // byte counts into 64-bit lanes with VPSADBW.
+  const __m256i lookup = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3,
+                                          1, 2, 2, 3, 2, 3, 3, 4,
+                                          0, 1, 1, 2, 1, 2, 2, 3,
+                                          1, 2, 2, 3, 2, 3, 3, 4);
+  const __m256i low_nibble_mask = _mm256_set1_epi8(0x0f);
+  __m256i sum = _mm256_setzero_si256();
+  int i = 0;
+  for (; i + 32 <= num_bytes; i += 32) {
+    const __m256i difference = _mm256_xor_si256(
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(descriptor1 + i)),
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(descriptor2 + i)));
+    const __m256i low_nibbles = _mm256_and_si256(difference, low_nibble_mask);
+    const __m256i high_nibbles =
+        _mm256_and_si256(_mm256_srli_epi16(difference, 4), low_nibble_mask);
+    const __m256i counts =
+        _mm256_add_epi8(_mm256_shuffle_epi8(lookup, low_nibbles),
+                        _mm256_shuffle_epi8(lookup, high_nibbles));
+    sum = _mm256_add_epi64(sum,
+                           _mm256_sad_epu8(counts, _mm256_setzero_si256()));
+  }
+  const int distance = static_cast<int>(_mm256_extract_epi64(sum, 0) +
+                                        _mm256_extract_epi64(sum, 1) +
+                                        _mm256_extract_epi64(sum, 2) +
+                                        _mm256_extract_epi64(sum, 3));
+  return distance +
+         HammingDistanceSse(descriptor1 + i, descriptor2 + i, num_bytes - i);
+}
+
+// ---------------------------- AVX-512 kernels ----------------------------- //
+
+THEIA_TARGET("avx512f,avx512bw,avx2,fma,popcnt")
+float SquaredL2DistanceAvx512(const float* descriptor1,
+                              const float* descriptor2,
+                              const int size) {
+  __m512 sum = _mm512_setzero_ps();
+  for (int i = 0; i < size; i += 16) {
+    // The remaining values are loaded with a mask so no scalar loop is needed.
+    const int num_values = size - i;
+    const __mmask16 mask =
+        num_values >= 16 ? 0xffff
+                         : static_cast<__mmask16>((1 << num_values) - 1);
+    const __m512 difference =
+        _mm512_sub_ps(_mm512_maskz_loadu_ps(mask, descriptor1 + i),
+                      _mm512_maskz_loadu_ps(mask, descriptor2 + i));
+    sum = _mm512_fmadd_ps(difference, difference, sum);
+  }
+  return _mm512_reduce_add_ps(sum);
+}
+
+THEIA_TARGET("avx512f,avx512bw,avx2,fma,popcnt")
+int32_t Int8DotProductAvx512(const int8_t* descriptor1,
+                             const int8_t* descriptor2,
+                             const int32_t descriptor2_sum,
+                             const int size) {
+  __m512i sum = _mm512_setzero_si512();
+  for (int i = 0; i < size; i += 32) {
+    const __m512i values1 = _mm512_cvtepi8_epi16(
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(descriptor1 + i)));
+    const __m512i values2 = _mm512_cvtepi8_epi16(
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(descriptor2 + i)));
+    sum = _mm512_add_epi32(sum, _mm512_madd_epi16(values1, values2));
+  }
+  return _mm512_reduce_add_epi32(sum);
+}
+
+THEIA_TARGET("avx512f,avx512bw,avx512vnni,avx2,fma,popcnt")
+int32_t Int8DotProductAvx512Vnni(const int8_t* descriptor1,
+                                 const int8_t* descriptor2,
+                                 const int32_t descriptor2_sum,
+                                 const int size) {
+  // VPDPBUSD multiplies unsigned bytes by signed bytes. Flipping the sign bit
+  // of descriptor1 adds 128 to each of its values, and the resulting
+  // 128 * sum(descriptor2) is subtracted afterwards.
+  const __m512i sign_bit = _mm512_set1_epi8(static_cast<char>(0x80));
+  __m512i sum = _mm512_setzero_si512();
+  for (int i = 0; i < size; i += 64) {
+    const __m512i values1 =
+        _mm512_xor_si512(_mm512_loadu_si512(descriptor1 + i), sign_bit);
+    const __m512i values2 = _mm512_loadu_si512(descriptor2 + i);
+    sum = _mm512_dpbusd_epi32(sum, values1, values2);
+  }
+  return _mm512_reduce_add_epi32(sum) - 128 * descriptor2_sum;
+}
+
+THEIA_TARGET("avx512f,avx512bw,avx512vpopcntdq,avx2,fma,popcnt")
+int HammingDistanceAvx512Vpopcntdq(const uint8_t* descriptor1,
+                                   const uint8_t* descriptor2,
+                                   const int num_bytes) {
+  __m512i sum = _mm512_setzero_si512();
+  for (int i = 0; i < num_bytes; i += 64) {
+    const int num_remaining_bytes = num_bytes - i;
+    const __mmask64 mask =
+        num_remaining_bytes >= 64
+            ? ~0ULL
+            : static_cast<__mmask64>((1ULL << num_remaining_bytes) - 1);
+    const __m512i difference =
+        _mm512_xor_si512(_mm512_maskz_loadu_epi8(mask, descriptor1 + i),
+                         _mm512_maskz_loadu_epi8(mask, descriptor2 + i));
+    sum = _mm512_add_epi64(sum, _mm512_popcnt_epi64(difference));
+  }
+  return static_cast<int>(_mm512_reduce_add_epi64(sum));
+}
+
+#endif  // THEIA_HAS_X86_SIMD_KERNELS
+
+DescriptorDistanceKernels CreateDescriptorDistanceKernels(
+    const SimdLevel simd_level) {
+  DescriptorDistanceKernels kernels;
+  kernels.simd_level = simd_level;
+  kernels.squared_l2_distance = SquaredL2DistanceScalar;
+  kernels.int8_dot_product = Int8DotProductScalar;
+  kernels.hamming_distance = HammingDistanceScalar;
+
+#ifdef THEIA_HAS_X86_SIMD_KERNELS
+  const CpuFeatures& cpu_features = GetCpuFeatures();
+  switch (simd_level) {
+    case SimdLevel::SCALAR:
+      break;
+    case SimdLevel::SSE4_2:
+      kernels.squared_l2_distance = SquaredL2DistanceSse;
+      kernels.int8_dot_product = Int8DotProductSse;
+      kernels.hamming_distance = HammingDistanceSse;
+      break;
+    case SimdLevel::AVX2:
+      kernels.squared_l2_distance = SquaredL2DistanceAvx2;
+      kernels.int8_dot_product = Int8DotProductAvx2;
+      kernels.hamming_distance = HammingDistanceAvx2;
+      break;
+    case SimdLevel::AVX512:
+      kernels.squared_l2_distance = SquaredL2DistanceAvx512;
+      kernels.int8_dot_product = cpu_features.avx512vnni
+                                     ? Int8DotProductAvx512Vnni
+                                     : Int8DotProductAvx512;
+      kernels.hamming_distance = cpu_features.avx512vpopcntdq
+                                     ? HammingDistanceAvx512Vpopcntdq
+                                     : HammingDistanceAvx2;
+      break;
+    default:
+      LOG(FATAL) << "Invalid SIMD level.";
+  }
+#endif  // THEIA_HAS_X86_SIMD_KERNELS
+
+  return kernels;
+}
+
+}  // namespace
+
+const DescriptorDistanceKernels& GetDescriptorDistanceKernels() {
+  static const DescriptorDistanceKernels& kernels =
+      GetDescriptorDistanceKernels(GetSupportedSimdLevel());
+  return kernels;
+}
+
+const DescriptorDistanceKernels& GetDescriptorDistanceKernels(
+    const SimdLevel simd_level) {
+  CHECK(IsSimdLevelSupported(simd_level))
+      << "The CPU does not support SIMD level "
+      << SimdLevelToString(simd_level);
+  static const DescriptorDistanceKernels kernels[] = {
+      CreateDescriptorDistanceKernels(SimdLevel::SCALAR),
+      CreateDescriptorDistanceKernels(SimdLevel::SSE4_2),
+      CreateDescriptorDistanceKernels(SimdLevel::AVX2),
+      CreateDescriptorDistanceKernels(SimdLevel::AVX512)};
+  return kernels[static_cast<int>(simd_level)];
+}
+
+}  // namespace theia
@@ -0,0 +1,81 @@
+// Copyright (C) 2026 The Regents of the University of California (Regents).
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials provided
+//       with the distribution.
+//
+//     * Neither the name of The Regents or University of California nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+// Please contact the author of this library if you have any questions.
+// Author: agent (agent@local)
+
+#ifndef THEIA_MATCHING_DISTANCE_KERNELS_H_
+#define THEIA_MATCHING_DISTANCE_KERNELS_H_
+
+#include <stdint.h>
+
+#include "theia/util/cpu_features.h"
+
+namespace theia {
+
+// A table of the low-level kernels used to compute descriptor distances. One
+// table is implemented for each SIMD level and the table for the fastest level
+// supported by the CPU is selected at runtime, so the kernels do not depend on
+// the instruction set the library was compiled for. The scalar table serves as
+// the reference implementation.
+struct DescriptorDistanceKernels {
+  SimdLevel simd_level;
+
+  // Returns the squared L2 distance between two float vectors of any size.
+  float (*squared_l2_distance)(const float* descriptor1,
+                               const float* descriptor2,
+                               const int size);
+
+  // Returns the dot product of two int8 vectors. The size must be a multiple
+  // of 64 and the sum of the values of descriptor2 must be given.
+  int32_t (*int8_dot_product)(const int8_t* descriptor1,
+                              const int8_t* descriptor2,
+                              const int32_t descriptor2_sum,
+                              const int size);
+
+  // Returns the number of bits that differ between two binary vectors of any
+  // number of bytes.
+  int (*hamming_distance)(const uint8_t* descriptor1,
+                          const uint8_t* descriptor2,
+                          const int num_bytes);
+};
+
+// Returns the kernels for the highest SIMD level supported by the CPU.
+const DescriptorDistanceKernels& GetDescriptorDistanceKernels();
+
+// Returns the kernels for the given SIMD level, which must be supported by the
+// CPU. This is mostly useful for testing and benchmarking.
+const DescriptorDistanceKernels& GetDescriptorDistanceKernels(
+    const SimdLevel simd_level);
+
+}  // namespace theia
+
+#endif  // THEIA_MATCHING_DISTANCE_KERNELS_H_
@@ -0,0 +1,164 @@
+// Copyright (C) 2026 The Regents of the University of California (Regents).
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials provided
+//       with the distribution.
+//
+//     * Neither the name of The Regents or University of California nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+// Please contact the author of this library if you have any questions.
+// Author: agent (agent@local)
+
+#include <glog/logging.h>
+#include <stdint.h>
+#include <cmath>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "theia/matching/distance_kernels.h"
+#include "theia/util/cpu_features.h"
+#include "theia/util/random.h"
+
+namespace theia {
+
+namespace {
+
+RandomNumberGenerator rng(64);
+
+// Returns all SIMD levels that the CPU supports, starting with the scalar
+// reference level.
+std::vector<SimdLevel> SupportedSimdLevels() {
+  std::vector<SimdLevel> simd_levels;
+  for (const SimdLevel simd_level : {SimdLevel::SCALAR,
+                                     SimdLevel::SSE4_2,
+                                     SimdLevel::AVX2,
+                                     SimdLevel::AVX512}) {
+    if (IsSimdLevelSupported(simd_level)) {
+      simd_levels.emplace_back(simd_level);
+    }
+  }
+  return simd_levels;
+}
+
+}  // namespace
+
+TEST(DistanceKernels, SupportedSimdLevels) {
+  const CpuFeatures& cpu_features = GetCpuFeatures();
+  const SimdLevel simd_level = GetSupportedSimdLevel();
+  LOG(INFO) << "Supported SIMD level: " << SimdLevelToString(simd_level);
+  EXPECT_TRUE(IsSimdLevelSupported(SimdLevel::SCALAR));
+  if (IsSimdLevelSupported(SimdLevel::AVX2)) {
+    EXPECT_TRUE(cpu_features.avx2);
+    EXPECT_TRUE(cpu_features.fma);
+  }
+  if (IsSimdLevelSupported(SimdLevel::AVX512)) {
+    EXPECT_TRUE(cpu_features.avx512f);
+    EXPECT_TRUE(cpu_features.avx512bw);
+  }
+  EXPECT_EQ(GetDescriptorDistanceKernels().simd_level, simd_level);
+}
+
+TEST(DistanceKernels, SquaredL2Distance) {
+  const DescriptorDistanceKernels& reference =
+      GetDescriptorDistanceKernels(SimdLevel::SCALAR);
+  for (const SimdLevel simd_level : SupportedSimdLevels()) {
+    const DescriptorDistanceKernels& kernels =
+        GetDescriptorDistanceKernels(simd_level);
+    // Test sizes that are not multiples of the register width as well.
+    for (int size = 0; size < 150; size++) {
+      std::vector<float> descriptor1(size), descriptor2(size);
+      for (int i = 0; i < size; i++) {
+        descriptor1[i] = rng.RandFloat(-1.0f, 1.0f);
+        descriptor2[i] = rng.RandFloat(-1.0f, 1.0f);
+      }
+      const float expected_distance = reference.squared_l2_distance(
+          descriptor1.data(), descriptor2.data(), size);
+      EXPECT_NEAR(kernels.squared_l2_distance(
+                      descriptor1.data(), descriptor2.data(), size),
+                  expected_distance,
+                  1e-5 * expected_distance)
+          << "SIMD level: " << SimdLevelToString(simd_level);
+    }
+  }
+}
+
+TEST(DistanceKernels, Int8DotProduct) {
+  const DescriptorDistanceKernels& reference =
+      GetDescriptorDistanceKernels(SimdLevel::SCALAR);
+  for (const SimdLevel simd_level : SupportedSimdLevels()) {
+    const DescriptorDistanceKernels& kernels =
+        GetDescriptorDistanceKernels(simd_level);
+    for (int size = 64; size <= 256; size += 64) {
+      std::vector<int8_t> descriptor1(size), descriptor2(size);
+      int32_t descriptor2_sum = 0;
+      for (int i = 0; i < size; i++) {
+        descriptor1[i] = static_cast<int8_t>(rng.RandInt(-127, 127));
+        descriptor2[i] = static_cast<int8_t>(rng.RandInt(-127, 127));
+        descriptor2_sum += descriptor2[i];
+      }
+      EXPECT_EQ(kernels.int8_dot_product(descriptor1.data(),
+                                         descriptor2.data(),
+                                         descriptor2_sum,
+                                         size),
+                reference.int8_dot_product(descriptor1.data(),
+                                           descriptor2.data(),
+                                           descriptor2_sum,
+                                           size))
+          << "SIMD level: " << SimdLevelToString(simd_level);
+    }
+
+    // Full range values must not saturate.
+    const std::vector<int8_t> descriptor(64, -127);
+    EXPECT_EQ(kernels.int8_dot_product(
+                  descriptor.data(), descriptor.data(), -127 * 64, 64),
+              127 * 127 * 64);
+  }
+}
+
+TEST(DistanceKernels, HammingDistance) {
+  for (const SimdLevel simd_level : SupportedSimdLevels()) {
+    const DescriptorDistanceKernels& kernels =
+        GetDescriptorDistanceKernels(simd_level);
+    for (int num_bytes = 0; num_bytes < 150; num_bytes++) {
+      std::vector<uint8_t> descriptor1(num_bytes), descriptor2(num_bytes);
+      int expected_distance = 0;
+      for (int i = 0; i < num_bytes; i++) {
+        descriptor1[i] = static_cast<uint8_t>(rng.RandInt(0, 255));
+        descriptor2[i] = static_cast<uint8_t>(rng.RandInt(0, 255));
+        for (int bit = 0; bit < 8; bit++) {
+          expected_distance += ((descriptor1[i] ^ descriptor2[i]) >> bit) & 1;
+        }
+      }
+      EXPECT_EQ(kernels.hamming_distance(
+                    descriptor1.data(), descriptor2.data(), num_bytes),
+                expected_distance)
+          << "SIMD level: " << SimdLevelToString(simd_level);
+    }
+  }
+}
+
+}  // namespace theia
@@ -72,9 +72,26 @@ TEST(L2Distance, KnownDistance) {
     L2 l2_dist;
     const float dist =
         static_cast<float>((descriptor1 - descriptor2).squaredNorm());
-    ASSERT_DOUBLE_EQ(l2_dist(descriptor1, descriptor2), dist);
+    ASSERT_FLOAT_EQ(l2_dist(descriptor1, descriptor2), dist);
   }
 }
 
+// Known Hamming distance.
+TEST(HammingDistance, KnownDistance) {
+  const int num_bytes = 61;
+  Hamming::DescriptorType descriptor1(num_bytes), descriptor2(num_bytes);
+  Hamming hamming_dist;
+  for (int n = 0; n < kNumTrials; n++) {
+    int dist = 0;
+    for (int i = 0; i < num_bytes; i++) {
+      descriptor1[i] = static_cast<uint8_t>(rng.RandInt(0, 255));
+      descriptor2[i] = static_cast<uint8_t>(rng.RandInt(0, 255));
+      dist += std::bitset<8>(descriptor1[i] ^ descriptor2[i]).count();
+    }
+    ASSERT_EQ(hamming_dist(descriptor1, descriptor2), dist);
+  }
+  ASSERT_EQ(hamming_dist(descriptor1, descriptor1), 0);
+}
+
 }  // namespace
 }  // namespace theia
@@ -34,6 +34,7 @@
 
 #include "theia/matching/feature_matcher.h"
 
+#include <Eigen/Core>
 #include <glog/logging.h>
 
 #include <algorithm>
@@ -41,6 +42,7 @@
 #include <memory>
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
 #include <utility>
 #include <vector>
 
@@ -48,6 +50,7 @@
 
 #include "theia/matching/feature_correspondence.h"
 #include "theia/matching/feature_matcher_options.h"
+#include "theia/matching/feature_matcher_utils.h"
 #include "theia/matching/features_and_matches_database.h"
 #include "theia/matching/image_pair_match.h"
 #include "theia/matching/keypoints_and_descriptors.h"
@@ -82,7 +85,15 @@ FeatureMatcher::~FeatureMatcher() {}
 FeatureMatcher::FeatureMatcher(
     const FeatureMatcherOptions& options,
     FeaturesAndMatchesDatabase* feature_and_matches_db)
-    : options_(options), feature_and_matches_db_(feature_and_matches_db) {}
+    : options_(options),
+      feature_and_matches_db_(feature_and_matches_db),
+      num_image_pairs_to_match_(0),
+      num_attempted_image_pairs_(0) {
+  if (!options_.image_pair_matching_log_filepath.empty()) {
+    matching_log_.reset(
+        new ImagePairMatchingLog(options_.image_pair_matching_log_filepath));
+  }
+}
 
 void FeatureMatcher::AddImage(const std::string& image_name) {
   image_names_.push_back(image_name);
@@ -101,6 +112,18 @@ void FeatureMatcher::SetImagePairsToMatch(
   pairs_to_match_ = pairs_to_match;
 }
 
+int FeatureMatcher::NumImagePairsToMatch() const {
+  return num_image_pairs_to_match_;
+}
+
+int FeatureMatcher::NumAttemptedImagePairs() const {
+  return num_attempted_image_pairs_;
+}
+
+const ImagePairMatchingLog* FeatureMatcher::matching_log() const {
+  return matching_log_.get();
+}
+
 void FeatureMatcher::MatchImages() {
   // If SetImagePairsToMatch has not been called, match all image-to-image
   // pairs.
@@ -108,19 +131,80 @@ void FeatureMatcher::MatchImages() {
     SelectAllPairs(image_names_, &pairs_to_match_);
   }
 
-  // Add workers for matching. It is more efficient to let each thread compute
-  // multiple matches at a time than add each matching task to the pool. This is
-  // sort of like OpenMP's dynamic schedule in that it is able to balance
-  // threads fairly efficiently.
+  // Skip the pairs that were attempted by a previous run.
+  num_image_pairs_to_match_ = pairs_to_match_.size();
+  if (matching_log_ != nullptr) {
+    pairs_to_match_.erase(
+        std::remove_if(
+            pairs_to_match_.begin(),
+            pairs_to_match_.end(),
+            [this](const std::pair<std::string, std::string>& pair) {
+              return matching_log_->Contains(pair.first, pair.second);
+            }),
+        pairs_to_match_.end());
+    LOG_IF(INFO, pairs_to_match_.size() < num_image_pairs_to_match_)
+        << "Skipping " << num_image_pairs_to_match_ - pairs_to_match_.size()
+        << " image pairs that were already attempted.";
+  }
+  num_attempted_image_pairs_ =
+      num_image_pairs_to_match_ - static_cast<int>(pairs_to_match_.size());
+
   const int num_matches = pairs_to_match_.size();
+  if (num_matches == 0) {
+    return;
+  }
   const int num_threads =
       std::min(options_.num_threads, static_cast<int>(num_matches));
+
+  // Determine the groups of image pairs that each worker will match.
+  std::vector<int> task_boundaries;
+  if (options_.image_pair_tile_size > 0) {
+    // Each tile holds the pairs of up to image_pair_tile_size query images with
+    // up to kMaxNumImagesToMatchAtOnce_ other images, so that every query image
+    // of a tile is matched against all of its images in the tile at once.
+    // Ensure that there are (roughly) at least 4 tiles per thread so that the
+    // threads are balanced. Tiles of Q x W images result in about
+    // (N / Q) * ceil(N / W) / 2 tiles for N images.
+    std::unordered_set<std::string> images_to_match;
+    for (const auto& pair : pairs_to_match_) {
+      images_to_match.emplace(pair.first);
+      images_to_match.emplace(pair.second);
+    }
+    const int num_images = images_to_match.size();
+    const int num_tile_columns =
+        (num_images + kMaxNumImagesToMatchAtOnce_ - 1) /
+        kMaxNumImagesToMatchAtOnce_;
+    const int max_tile_size =
+        std::max(1, num_images * num_tile_columns / (8 * num_threads));
+    const int tile_size =
+        std::min(options_.image_pair_tile_size, max_tile_size);
+    task_boundaries = ScheduleImagePairsInTiles(image_names_,
+                                                tile_size,
+                                                kMaxNumImagesToMatchAtOnce_,
+                                                &pairs_to_match_);
+    VLOG(1) << "Matching " << num_matches << " image pairs in "
+            << task_boundaries.size() - 1 << " tiles of up to " << tile_size
+            << " x " << kMaxNumImagesToMatchAtOnce_ << " images.";
+  } else {
+    // It is more efficient to let each thread compute multiple matches at a
+    // time than add each matching task to the pool. This is sort of like
+    // OpenMP's dynamic schedule in that it is able to balance threads fairly
+    // efficiently.
+    const int interval_step = std::max(
+        1, std::min(this->kMaxThreadingStepSize_, num_matches / num_threads));
+    for (int i = 0; i < num_matches; i += interval_step) {
+      task_boundaries.emplace_back(i);
+    }
+    task_boundaries.emplace_back(num_matches);
+  }
+
+  // Add workers for matching.
   std::unique_ptr<ThreadPool> pool(new ThreadPool(num_threads));
-  const int interval_step =
-      std::min(this->kMaxThreadingStepSize_, num_matches / num_threads);
-  for (int i = 0; i < num_matches; i += interval_step) {
-    const int end_interval = std::min(num_matches, i + interval_step);
-    pool->Add(&FeatureMatcher::MatchAndVerifyImagePairs, this, i, end_interval);
+  for (int i = 0; i + 1 < task_boundaries.size(); i++) {
+    pool->Add(&FeatureMatcher::MatchAndVerifyImagePairs,
+              this,
+              task_boundaries[i],
+              task_boundaries[i + 1]);
   }
   // Wait for all threads to finish.
   pool.reset(nullptr);
@@ -130,69 +214,148 @@ void FeatureMatcher::MatchImages() {
           << " pairs selected for matching.";
 }
 
+void FeatureMatcher::MatchImageToImages(
+    const KeypointsAndDescriptors& features1,
+    const std::vector<std::shared_ptr<const KeypointsAndDescriptors> >&
+        features2,
+    std::vector<std::vector<IndexedFeatureMatch> >* matched_features,
+    std::vector<bool>* is_valid_match) {
+  matched_features->clear();
+  matched_features->resize(features2.size());
+  is_valid_match->resize(features2.size());
+  for (int i = 0; i < features2.size(); i++) {
+    (*is_valid_match)[i] =
+        MatchImagePair(features1, *features2[i], &(*matched_features)[i]);
+  }
+}
+
 void FeatureMatcher::MatchAndVerifyImagePairs(const int start_index,
                                               const int end_index) {
-  for (int i = start_index; i < end_index; i++) {
-    const std::string image1_name = pairs_to_match_[i].first;
-    const std::string image2_name = pairs_to_match_[i].second;
-
-    // Match the image pair. If the pair fails to match then continue to the
-    // next match.
-    ImagePairMatch image_pair_match;
-    image_pair_match.image1 = image1_name;
-    image_pair_match.image2 = image2_name;
-
-    // Get the keypoints and descriptors from the db.
-    const KeypointsAndDescriptors& features1 =
-        feature_and_matches_db_->GetFeatures(image1_name);
-    const KeypointsAndDescriptors& features2 =
-        feature_and_matches_db_->GetFeatures(image2_name);
+  int group_start = start_index;
+  while (group_start < end_index) {
+    // Group the consecutive pairs that share the first image so that the first
+    // image is matched against all of the other images at once.
+    const std::string& image1_name = pairs_to_match_[group_start].first;
+    int group_end = group_start + 1;
+    while (group_end < end_index &&
+           group_end - group_start < kMaxNumImagesToMatchAtOnce_ &&
+           pairs_to_match_[group_end].first == image1_name) {
+      ++group_end;
+    }
 
-    // Compute the visual matches from feature descriptors.
-    std::vector<IndexedFeatureMatch> putative_matches;
-    if (!MatchImagePair(features1, features2, &putative_matches)) {
-      VLOG(2)
-          << "Could not match a sufficient number of features between images "
-          << image1_name << " and " << image2_name;
-      continue;
+    // Get the keypoints and descriptors from the db. Shared handles are used
+    // so that databases holding the features in memory do not copy them.
+    const std::shared_ptr<const KeypointsAndDescriptors> features1 =
+        feature_and_matches_db_->GetSharedFeatures(image1_name);
+    std::vector<std::shared_ptr<const KeypointsAndDescriptors> > features2;
+    features2.reserve(group_end - group_start);
+    for (int i = group_start; i < group_end; i++) {
+      features2.emplace_back(feature_and_matches_db_->GetSharedFeatures(
+          pairs_to_match_[i].second));
     }
 
-    // Perform geometric verification if applicable.
-    if (options_.perform_geometric_verification) {
-      // If geometric verification fails, do not add the match to the output.
-      if (!GeometricVerification(
-              features1, features2, putative_matches, &image_pair_match)) {
-        VLOG(2) << "Geometric verification between images " << image1_name
-                << " and " << image2_name << " failed.";
+    // Compute the visual matches from feature descriptors.
+    std::vector<std::vector<IndexedFeatureMatch> > putative_matches;
+    std::vector<bool> is_valid_match;
+    MatchImageToImages(
+        *features1, features2, &putative_matches, &is_valid_match);
+
+    for (int i = group_start; i < group_end; i++) {
+      const std::string& image2_name = pairs_to_match_[i].second;
+      // If the pair fails to match then continue to the next match.
+      if (!is_valid_match[i - group_start]) {
+        VLOG(2) << "Could not match a sufficient number of features "
+                << "between images " << image1_name << " and " << image2_name;
+        RecordAttemptedImagePair(
+            image1_name,
+            image2_name,
+            ImagePairMatchingStatus::INSUFFICIENT_FEATURE_MATCHES);
         continue;
       }
-    } else {
-      // If no geometric verification is performed then the putative matches are
-      // output.
-      image_pair_match.correspondences.reserve(putative_matches.size());
-      for (int i = 0; i < putative_matches.size(); i++) {
-        const Keypoint& keypoint1 =
-            features1.keypoints[putative_matches[i].feature1_ind];
-        const Keypoint& keypoint2 =
-            features2.keypoints[putative_matches[i].feature2_ind];
-        image_pair_match.correspondences.emplace_back(
-            Feature(keypoint1.x(), keypoint1.y()),
-            Feature(keypoint2.x(), keypoint2.y()));
-      }
+
+      VerifyAndStoreImagePair(image1_name,
+                              image2_name,
+                              *features1,
+                              *features2[i - group_start],
+                              putative_matches[i - group_start]);
     }
+    group_start = group_end;
+  }
+}
 
-    // Log information about the matching results.
-    VLOG(1) << "Images " << image1_name << " and " << image2_name
-            << " were matched with " << image_pair_match.correspondences.size()
-            << " verified matches and "
-            << image_pair_match.twoview_info.num_homography_inliers
-            << " homography matches out of " << putative_matches.size()
-            << " putative matches.";
+void FeatureMatcher::VerifyAndStoreImagePair(
+    const std::string& image1_name,
+    const std::string& image2_name,
+    const KeypointsAndDescriptors& features1,
+    const KeypointsAndDescriptors& features2,
+    const std::vector<IndexedFeatureMatch>& putative_matches) {
+  ImagePairMatch image_pair_match;
+  image_pair_match.image1 = image1_name;
+  image_pair_match.image2 = image2_name;
 
-    // This operation is thread safe.
-    feature_and_matches_db_->PutImagePairMatch(
-        image1_name, image2_name, image_pair_match);
+  // Compute the sorted descriptor distances of the putative matches if desired.
+  if (options_.num_sorted_descriptor_distances > 0) {
+    ComputeSortedDescriptorDistances(
+        features1.descriptors,
+        features2.descriptors,
+        putative_matches,
+        options_.num_sorted_descriptor_distances,
+        &image_pair_match.sorted_descriptor_distances);
   }
+
+  // Perform geometric verification if applicable.
+  if (options_.perform_geometric_verification) {
+    // If geometric verification fails, do not add the match to the output.
+    if (!GeometricVerification(
+            features1, features2, putative_matches, &image_pair_match)) {
+      VLOG(2) << "Geometric verification between images " << image1_name
+              << " and " << image2_name << " failed.";
+      RecordAttemptedImagePair(
+          image1_name,
+          image2_name,
+          ImagePairMatchingStatus::FAILED_GEOMETRIC_VERIFICATION);
+      return;
+    }
+  } else {
+    // If no geometric verification is performed then the putative matches are
+    // output.
+    image_pair_match.correspondences.reserve(putative_matches.size());
+    for (int i = 0; i < putative_matches.size(); i++) {
+      const Keypoint& keypoint1 =
+          features1.keypoints[putative_matches[i].feature1_ind];
+      const Keypoint& keypoint2 =
+          features2.keypoints[putative_matches[i].feature2_ind];
+      image_pair_match.correspondences.emplace_back(
+          Feature(keypoint1.x(), keypoint1.y()),
+          Feature(keypoint2.x(), keypoint2.y()));
+    }
+  }
+
+  // Log information about the matching results.
+  VLOG(1) << "Images " << image1_name << " and " << image2_name
+          << " were matched with " << image_pair_match.correspondences.size()
+          << " verified matches and "
+          << image_pair_match.twoview_info.num_homography_inliers
+          << " homography matches out of " << putative_matches.size()
+          << " putative matches.";
+
+  // This operation is thread safe.
+  feature_and_matches_db_->PutImagePairMatch(
+      image1_name, image2_name, image_pair_match);
+  // The pair is only recorded after the match is written to the database so
+  // that the log never contains pairs whose matches were lost.
+  RecordAttemptedImagePair(
+      image1_name, image2_name, ImagePairMatchingStatus::MATCHED);
+}
+
+void FeatureMatcher::RecordAttemptedImagePair(
+    const std::string& image1_name,
+    const std::string& image2_name,
+    const ImagePairMatchingStatus status) {
+  if (matching_log_ != nullptr) {
+    matching_log_->Record(image1_name, image2_name, status);
+  }
+  ++num_attempted_image_pairs_;
 }
 
 bool FeatureMatcher::GeometricVerification(
@@ -214,17 +377,65 @@ bool FeatureMatcher::GeometricVerification(
         features2.image_name);
   }
 
+  Eigen::MatrixXd putative_sorted_distances;
+  putative_sorted_distances.swap(image_pair_match->sorted_descriptor_distances);
   TwoViewMatchGeometricVerification geometric_verification(
       options_.geometric_verification_options,
       intrinsics1,
       intrinsics2,
       features1,
       features2,
-      putative_matches);
+      putative_matches,
+      putative_sorted_distances);
+
+  if (!geometric_verification.VerifyMatches(
+          &image_pair_match->correspondences,
+          &image_pair_match->twoview_info)) {
+    return false;
+  }
+
+  if (putative_sorted_distances.size() == 0) {
+    return true;
+  }
+
+  // The sorted distances only depend on the first feature of each match, so
+  // the distances of the putative matches are reused for the verified matches.
+  // Only the matches found by guided matching need to be computed.
+  std::unordered_map<int, int> putative_row_of_feature1;
+  for (int i = 0; i < putative_matches.size(); i++) {
+    putative_row_of_feature1.emplace(putative_matches[i].feature1_ind, i);
+  }
+  const std::vector<IndexedFeatureMatch>& verified_matches =
+      geometric_verification.matches();
+  Eigen::MatrixXd* sorted_distances =
+      &image_pair_match->sorted_descriptor_distances;
+  sorted_distances->resize(verified_matches.size(),
+                           putative_sorted_distances.cols());
+  std::vector<IndexedFeatureMatch> new_matches;
+  std::vector<int> new_match_rows;
+  for (int i = 0; i < verified_matches.size(); i++) {
+    const int putative_row = FindWithDefault(
+        putative_row_of_feature1, verified_matches[i].feature1_ind, -1);
+    if (putative_row == -1) {
+      new_matches.emplace_back(verified_matches[i]);
+      new_match_rows.emplace_back(i);
+      continue;
+    }
+    sorted_distances->row(i) = putative_sorted_distances.row(putative_row);
+  }
 
-  // Return whether geometric verification succeeds.
-  return geometric_verification.VerifyMatches(
-      &image_pair_match->correspondences, &image_pair_match->twoview_info);
+  if (!new_matches.empty()) {
+    Eigen::MatrixXd new_sorted_distances;
+    ComputeSortedDescriptorDistances(features1.descriptors,
+                                     features2.descriptors,
+                                     new_matches,
+                                     putative_sorted_distances.cols(),
+                                     &new_sorted_distances);
+    for (int i = 0; i < new_matches.size(); i++) {
+      sorted_distances->row(new_match_rows[i]) = new_sorted_distances.row(i);
+    }
+  }
+  return true;
 }
 
 }  // namespace theia
@@ -37,6 +37,7 @@
 
 #include <Eigen/Core>
 
+#include <atomic>
 #include <memory>
 #include <string>
 #include <unordered_map>
@@ -44,6 +45,7 @@
 #include <vector>
 
 #include "theia/matching/feature_matcher_options.h"
+#include "theia/matching/image_pair_matching_log.h"
 #include "theia/util/util.h"
 
 namespace theia {
@@ -104,6 +106,18 @@ class FeatureMatcher {
   virtual void SetImagePairsToMatch(
       const std::vector<std::pair<std::string, std::string> >& pairs_to_match);
 
+  // Returns the number of image pairs selected for matching in the last call to
+  // MatchImages and how many of those have been attempted so far. Pairs that
+  // were already attempted according to the image pair matching log count as
+  // attempted. These methods may be called from another thread to monitor the
+  // progress of MatchImages.
+  int NumImagePairsToMatch() const;
+  int NumAttemptedImagePairs() const;
+
+  // Returns the log of attempted image pairs, or nullptr if
+  // FeatureMatcherOptions::image_pair_matching_log_filepath is not set.
+  const ImagePairMatchingLog* matching_log() const;
+
  protected:
   // NOTE: This method should be overridden in the subclass implementations!
   // Returns true if the image pair is a valid match.
@@ -112,6 +126,20 @@ class FeatureMatcher {
       const KeypointsAndDescriptors& features2,
       std::vector<IndexedFeatureMatch>* matched_features) = 0;
 
+  // Matches the features of one image against the features of several other
+  // images. The matches between features1 and features2[i] are returned in
+  // matched_features[i], and is_valid_match[i] is set to the value that
+  // MatchImagePair would return for that image pair. The default
+  // implementation simply calls MatchImagePair for each image pair. Subclasses
+  // may override this method to share work across the image pairs (e.g., by
+  // matching against all of the other images in a single pass).
+  virtual void MatchImageToImages(
+      const KeypointsAndDescriptors& features1,
+      const std::vector<std::shared_ptr<const KeypointsAndDescriptors> >&
+          features2,
+      std::vector<std::vector<IndexedFeatureMatch> >* matched_features,
+      std::vector<bool>* is_valid_match);
+
   // Performs matching and geometric verification (if desired) on the
   // pairs_to_match_ between the specified indices. This is useful for thread
   // pooling.
@@ -121,7 +149,9 @@ class FeatureMatcher {
   // Performs geometric verification. By making this a virtual method, derived
   // classes may implement custom verification methods (e.g., if rotations are
   // known then custom solvers can be used to solve for only the relative
-  // translations).
+  // translations). If image_pair_match->sorted_descriptor_distances is not
+  // empty, it contains one row for each putative match on input and must
+  // contain one row for each verified correspondence on output.
   virtual bool GeometricVerification(
       const KeypointsAndDescriptors& features1,
       const KeypointsAndDescriptors& features2,
@@ -134,6 +164,12 @@ class FeatureMatcher {
   // dynamic schedule in that it is able to balance threads fairly efficiently.
   const int kMaxThreadingStepSize_ = 20;
 
+  // Consecutive image pairs that share the first image are matched with a
+  // single call to MatchImageToImages. This limits how many images are matched
+  // at once, which bounds the number of feature sets held in memory. It is also
+  // the number of columns of the tiles that the image pairs are scheduled in.
+  const int kMaxNumImagesToMatchAtOnce_ = 32;
+
   FeatureMatcherOptions options_;
 
   // A container for the image names.
@@ -146,6 +182,28 @@ class FeatureMatcher {
   std::vector<std::pair<std::string, std::string> > pairs_to_match_;
 
  private:
+  // Verifies the putative matches of the image pair (if desired) and stores the
+  // image pair match in the database.
+  void VerifyAndStoreImagePair(
+      const std::string& image1_name,
+      const std::string& image2_name,
+      const KeypointsAndDescriptors& features1,
+      const KeypointsAndDescriptors& features2,
+      const std::vector<IndexedFeatureMatch>& putative_matches);
+
+  // Records that matching the image pair was attempted.
+  void RecordAttemptedImagePair(const std::string& image1_name,
+                                const std::string& image2_name,
+                                const ImagePairMatchingStatus status);
+
+  // A durable log of all attempted image pairs that allows matching to be
+  // resumed after it is interrupted.
+  std::unique_ptr<ImagePairMatchingLog> matching_log_;
+
+  // Progress of the current call to MatchImages.
+  std::atomic<int> num_image_pairs_to_match_;
+  std::atomic<int> num_attempted_image_pairs_;
+
   DISALLOW_COPY_AND_ASSIGN(FeatureMatcher);
 };
 
@@ -46,6 +46,23 @@ struct FeatureMatcherOptions {
   // Number of threads to use in parallel for matching.
   int num_threads = 1;
 
+  // Image pairs are matched in tiles of the image pair matrix so that the
+  // features of only a few images are needed at a time, which keeps the
+  // feature caches of out-of-core databases effective. Each tile contains the
+  // pairs between at most this many query images and 32 other images, and is
+  // matched by a single thread that matches each query image against all of
+  // its images in the tile at once. Tiles are made smaller if needed to keep
+  // all threads busy. Set this to 0 to match the pairs in the order that they
+  // were given.
+  int image_pair_tile_size = 16;
+
+  // If set, every attempted image pair and its outcome (matched, too few
+  // feature matches, or failed geometric verification) is appended to this
+  // file as soon as it is processed. Pairs that are already present in the file
+  // are skipped by MatchImages, so an interrupted matching job can be resumed
+  // by running it again with the same file and database.
+  std::string image_pair_matching_log_filepath = "";
+
   // Only symmetric matches are kept.
   bool keep_only_symmetric_matches = true;
 
@@ -65,9 +82,26 @@ struct FeatureMatcherOptions {
   // The parameter settings for geometric verification.
   TwoViewMatchGeometricVerification::Options geometric_verification_options;
 
+  // If greater than 0, the L2 distances of the first feature of each match to
+  // its num_sorted_descriptor_distances nearest descriptors in the second image
+  // are computed and stored in ImagePairMatch::sorted_descriptor_distances.
+  // These distances are required by geometric verification with
+  // RansacType::EVSAC, which models them to sample the matches that are most
+  // likely correct first. At least 2 distances are needed for EVSAC. Computing
+  // the distances requires a brute force search over the descriptors of the
+  // second image for each match.
+  int num_sorted_descriptor_distances = 0;
+
   // Only images that contain more feature matches than this number will be
   // returned.
   int min_num_feature_matches = 30;
+
+  // Parameters of the randomized k-d forest that is built for the descriptors
+  // of each image with the APPROXIMATE_NEAREST_NEIGHBOR matching strategy.
+  // Using more trees and checking more leaves per query increases the recall of
+  // the nearest neighbor search at the cost of speed.
+  int ann_num_kd_trees = 4;
+  int ann_num_leaves_to_check = 256;
 };
 
 }  // namespace theia
@@ -34,10 +34,17 @@
 
 #include "theia/matching/feature_matcher_utils.h"
 
+#include <Eigen/Core>
 #include <glog/logging.h>
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <tuple>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
+#include "theia/matching/distance.h"
 #include "theia/matching/indexed_feature_match.h"
 #include "theia/util/map_util.h"
 
@@ -70,4 +77,90 @@ void IntersectMatches(const std::vector<IndexedFeatureMatch>& backwards_matches,
   }
 }
 
+std::vector<int> ScheduleImagePairsInTiles(
+    const std::vector<std::string>& image_names,
+    const int num_query_images,
+    const int num_images_per_query,
+    std::vector<std::pair<std::string, std::string> >* pairs) {
+  CHECK_NOTNULL(pairs);
+  CHECK_GT(num_query_images, 0);
+  CHECK_GT(num_images_per_query, 0);
+
+  // Assign an index to each image.
+  std::unordered_map<std::string, int> image_indices;
+  image_indices.reserve(image_names.size());
+  for (const std::string& image_name : image_names) {
+    image_indices.emplace(image_name, image_indices.size());
+  }
+  for (const auto& pair : *pairs) {
+    image_indices.emplace(pair.first, image_indices.size());
+    image_indices.emplace(pair.second, image_indices.size());
+  }
+
+  // Sort the pairs by tile and by the query image within each tile so that the
+  // pairs that share the query image are consecutive. The image with the lower
+  // index determines the tile row, but the pairs keep their orientation so that
+  // the matches are stored under the image pair that the caller requested.
+  typedef std::tuple<int, int, int, bool, int, int> PairKey;
+  std::vector<PairKey> keys;
+  keys.reserve(pairs->size());
+  for (int i = 0; i < pairs->size(); i++) {
+    const std::pair<std::string, std::string>& pair = (*pairs)[i];
+    const int index1 = FindOrDie(image_indices, pair.first);
+    const int index2 = FindOrDie(image_indices, pair.second);
+    const int query_index = std::min(index1, index2);
+    const int other_index = std::max(index1, index2);
+    keys.emplace_back(query_index / num_query_images,
+                      other_index / num_images_per_query,
+                      query_index,
+                      index1 > index2,
+                      other_index,
+                      i);
+  }
+  std::sort(keys.begin(), keys.end());
+
+  std::vector<std::pair<std::string, std::string> > sorted_pairs;
+  sorted_pairs.reserve(pairs->size());
+  std::vector<int> tile_boundaries;
+  for (int i = 0; i < keys.size(); i++) {
+    if (i == 0 || std::get<0>(keys[i]) != std::get<0>(keys[i - 1]) ||
+        std::get<1>(keys[i]) != std::get<1>(keys[i - 1])) {
+      tile_boundaries.emplace_back(i);
+    }
+    sorted_pairs.emplace_back(std::move((*pairs)[std::get<5>(keys[i])]));
+  }
+  tile_boundaries.emplace_back(keys.size());
+
+  pairs->swap(sorted_pairs);
+  return tile_boundaries;
+}
+
+void ComputeSortedDescriptorDistances(
+    const std::vector<Eigen::VectorXf>& descriptors1,
+    const std::vector<Eigen::VectorXf>& descriptors2,
+    const std::vector<IndexedFeatureMatch>& matches,
+    const int k,
+    Eigen::MatrixXd* sorted_distances) {
+  CHECK_NOTNULL(sorted_distances);
+  CHECK_GT(k, 0);
+  const int num_distances = std::min(k, static_cast<int>(descriptors2.size()));
+  sorted_distances->resize(matches.size(), num_distances);
+
+  L2 distance;
+  std::vector<float> squared_distances(descriptors2.size());
+  for (int i = 0; i < matches.size(); i++) {
+    const Eigen::VectorXf& descriptor1 =
+        descriptors1[matches[i].feature1_ind];
+    for (int j = 0; j < descriptors2.size(); j++) {
+      squared_distances[j] = distance(descriptor1, descriptors2[j]);
+    }
+    std::partial_sort(squared_distances.begin(),
+                      squared_distances.begin() + num_distances,
+                      squared_distances.end());
+    for (int j = 0; j < num_distances; j++) {
+      (*sorted_distances)(i, j) = std::sqrt(squared_distances[j]);
+    }
+  }
+}
+
 }  // namespace theia
@@ -35,6 +35,9 @@
 #ifndef THEIA_MATCHING_FEATURE_MATCHER_UTILS_H_
 #define THEIA_MATCHING_FEATURE_MATCHER_UTILS_H_
 
+#include <Eigen/Core>
+#include <string>
+#include <utility>
 #include <vector>
 
 namespace theia {
@@ -45,6 +48,37 @@ struct IndexedFeatureMatch;
 void IntersectMatches(const std::vector<IndexedFeatureMatch>& backwards_matches,
                       std::vector<IndexedFeatureMatch>* forward_matches);
 
+// Reorders the image pairs so that they are grouped into tiles of the image
+// pair matrix. Images are ordered as they appear in image_names, followed by
+// any images that only appear in the pairs, and the image of each pair that
+// comes first in this order is its query image. Each tile contains the pairs
+// between at most num_query_images query images and at most
+// num_images_per_query other images, so matching all pairs of a tile only
+// requires the features of at most num_query_images + num_images_per_query
+// images. Tiles are ordered row by row and the pairs within a tile are sorted
+// by their query image, so that a query image can be matched against all of
+// its images in the tile at once. The pairs keep the orientation that they
+// were given in.
+// Returns the index of the first pair of each tile followed by the total number
+// of pairs.
+std::vector<int> ScheduleImagePairsInTiles(
+    const std::vector<std::string>& image_names,
+    const int num_query_images,
+    const int num_images_per_query,
+    std::vector<std::pair<std::string, std::string> >* pairs);
+
+// Computes the k smallest L2 distances between the descriptor of the first
+// feature of each match and all descriptors of the second image. Each row of
+// sorted_distances holds the distances of one match in ascending order. If the
+// second image has fewer than k descriptors then only that many columns are
+// returned. These are the sorted distances used by EVSAC.
+void ComputeSortedDescriptorDistances(
+    const std::vector<Eigen::VectorXf>& descriptors1,
+    const std::vector<Eigen::VectorXf>& descriptors2,
+    const std::vector<IndexedFeatureMatch>& matches,
+    const int k,
+    Eigen::MatrixXd* sorted_distances);
+
 }  // namespace theia
 
 #endif  // THEIA_MATCHING_FEATURE_MATCHER_UTILS_H_
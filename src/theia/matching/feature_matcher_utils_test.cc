@@ -32,6 +32,11 @@
 // Please contact the author of this library if you have any questions.
 // Author: Chris Sweeney (cmsweeney@cs.ucsb.edu)
 
+#include <Eigen/Core>
+#include <algorithm>
+#include <set>
+#include <string>
+#include <utility>
 #include <vector>
 
 #include "gtest/gtest.h"
@@ -53,4 +58,112 @@ TEST(FeatureMatcherUtils, IntersectMatches) {
   EXPECT_EQ(matches[0].feature2_ind, 1);
 }
 
+TEST(FeatureMatcherUtils, ScheduleImagePairsInTiles) {
+  static const int kNumImages = 10;
+  static const int kNumQueryImages = 3;
+  static const int kNumImagesPerQuery = 4;
+
+  std::vector<std::string> image_names;
+  for (int i = 0; i < kNumImages; i++) {
+    image_names.emplace_back(std::to_string(i));
+  }
+
+  // Add all pairs in reverse order and with the query image second.
+  std::vector<std::pair<std::string, std::string> > pairs;
+  std::set<std::pair<std::string, std::string> > expected_pairs;
+  for (int i = kNumImages - 1; i >= 0; i--) {
+    for (int j = kNumImages - 1; j > i; j--) {
+      pairs.emplace_back(image_names[j], image_names[i]);
+      expected_pairs.emplace(image_names[j], image_names[i]);
+    }
+  }
+
+  const std::vector<int> tile_boundaries = ScheduleImagePairsInTiles(
+      image_names, kNumQueryImages, kNumImagesPerQuery, &pairs);
+
+  // The pairs should only be reordered and keep their orientation.
+  const std::set<std::pair<std::string, std::string> > scheduled_pairs(
+      pairs.begin(), pairs.end());
+  EXPECT_EQ(scheduled_pairs, expected_pairs);
+
+  // There are 4 x 3 tiles, of which 7 contain pairs of a query image with an
+  // image that comes after it.
+  ASSERT_EQ(tile_boundaries.size(), 8);
+  EXPECT_EQ(tile_boundaries.front(), 0);
+  EXPECT_EQ(tile_boundaries.back(), pairs.size());
+
+  // Each tile should only contain the images of one row and one column of
+  // tiles, and the pairs that share a query image should be consecutive. The
+  // query image is the second image of each pair here.
+  for (int i = 0; i + 1 < tile_boundaries.size(); i++) {
+    const int start = tile_boundaries[i];
+    const int end = tile_boundaries[i + 1];
+    ASSERT_LT(start, end);
+    const int row = std::stoi(pairs[start].second) / kNumQueryImages;
+    const int col = std::stoi(pairs[start].first) / kNumImagesPerQuery;
+    for (int j = start; j < end; j++) {
+      EXPECT_EQ(std::stoi(pairs[j].second) / kNumQueryImages, row);
+      EXPECT_EQ(std::stoi(pairs[j].first) / kNumImagesPerQuery, col);
+      if (j > start) {
+        EXPECT_LE(std::stoi(pairs[j - 1].second), std::stoi(pairs[j].second));
+      }
+    }
+  }
+}
+
+TEST(FeatureMatcherUtils, ScheduleImagePairsInTilesKeepsOrientation) {
+  const std::vector<std::string> image_names = {"a", "b", "c"};
+  std::vector<std::pair<std::string, std::string> > pairs = {
+      {"c", "a"}, {"a", "b"}, {"b", "a"}};
+
+  const std::vector<int> tile_boundaries =
+      ScheduleImagePairsInTiles(image_names, 1, 1, &pairs);
+  EXPECT_EQ(tile_boundaries, std::vector<int>({0, 2, 3}));
+
+  // The tile of query image "a" and image "b" comes first. Within a tile, the
+  // pairs whose first image is the query image come first.
+  const std::vector<std::pair<std::string, std::string> > expected_pairs = {
+      {"a", "b"}, {"b", "a"}, {"c", "a"}};
+  EXPECT_EQ(pairs, expected_pairs);
+}
+
+TEST(FeatureMatcherUtils, ComputeSortedDescriptorDistances) {
+  static const int kNumDescriptors = 50;
+  static const int kNumDistances = 5;
+
+  std::vector<Eigen::VectorXf> descriptors1(kNumDescriptors),
+      descriptors2(kNumDescriptors);
+  for (int i = 0; i < kNumDescriptors; i++) {
+    descriptors1[i] = Eigen::VectorXf::Random(128);
+    descriptors2[i] = Eigen::VectorXf::Random(128);
+  }
+  const std::vector<IndexedFeatureMatch> matches = {
+      IndexedFeatureMatch(3, 0, 0), IndexedFeatureMatch(7, 1, 0)};
+
+  Eigen::MatrixXd sorted_distances;
+  ComputeSortedDescriptorDistances(
+      descriptors1, descriptors2, matches, kNumDistances, &sorted_distances);
+  ASSERT_EQ(sorted_distances.rows(), matches.size());
+  ASSERT_EQ(sorted_distances.cols(), kNumDistances);
+
+  for (int i = 0; i < matches.size(); i++) {
+    std::vector<double> distances;
+    for (const Eigen::VectorXf& descriptor2 : descriptors2) {
+      distances.emplace_back(
+          (descriptors1[matches[i].feature1_ind] - descriptor2).norm());
+    }
+    std::sort(distances.begin(), distances.end());
+    for (int j = 0; j < kNumDistances; j++) {
+      EXPECT_NEAR(sorted_distances(i, j), distances[j], 1e-4);
+    }
+  }
+
+  // Only as many distances as there are descriptors in the second image are
+  // returned.
+  descriptors2.resize(kNumDistances - 2);
+  ComputeSortedDescriptorDistances(
+      descriptors1, descriptors2, matches, kNumDistances, &sorted_distances);
+  EXPECT_EQ(sorted_distances.cols(), kNumDistances - 2);
+}
+
 }  // namespace theia
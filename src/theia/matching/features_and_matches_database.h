@@ -35,6 +35,7 @@
 #ifndef THEIA_MATCHING_FEATURES_AND_MATCHES_DATABASE_H_
 #define THEIA_MATCHING_FEATURES_AND_MATCHES_DATABASE_H_
 
+#include <memory>
 #include <string>
 #include <utility>
 #include <vector>
@@ -42,6 +43,7 @@
 #include "theia/matching/image_pair_match.h"
 #include "theia/matching/keypoints_and_descriptors.h"
 #include "theia/sfm/camera_intrinsics_prior.h"
+#include "theia/sfm/twoview_info.h"
 
 namespace theia {
 
@@ -73,6 +75,15 @@ class FeaturesAndMatchesDatabase {
   virtual KeypointsAndDescriptors GetFeatures(
       const std::string& image_name) = 0;
 
+  // Returns a shared, immutable handle to the features of the image. Databases
+  // that keep the features in memory may return the stored features without
+  // copying them. By default the features are copied from GetFeatures.
+  virtual std::shared_ptr<const KeypointsAndDescriptors> GetSharedFeatures(
+      const std::string& image_name) {
+    return std::make_shared<const KeypointsAndDescriptors>(
+        GetFeatures(image_name));
+  }
+
   // Set the features for the image.
   virtual void PutFeatures(const std::string& image_name,
                            const KeypointsAndDescriptors& features) = 0;
@@ -81,10 +92,27 @@ class FeaturesAndMatchesDatabase {
   virtual std::vector<std::string> ImageNamesOfFeatures() = 0;
   virtual size_t NumImages() = 0;
 
+  // Signals the start and end of a phase where a large number of features are
+  // added to the database (e.g., during feature extraction). Databases that
+  // persist features to disk may use this to batch writes more efficiently.
+  // Features added during this phase must still be retrievable with
+  // GetFeatures. By default these methods do nothing.
+  virtual void BeginBulkFeatureIngestion() {}
+  virtual void EndBulkFeatureIngestion() {}
+
   // Get the image pair match for the images.
   virtual ImagePairMatch GetImagePairMatch(const std::string& image_name1,
                                            const std::string& image_name2) = 0;
 
+  // Returns only the two view info of the image pair match. Databases that
+  // store the matches on disk may override this so that the correspondences
+  // are not deserialized. By default the match is loaded with
+  // GetImagePairMatch.
+  virtual TwoViewInfo GetTwoViewInfo(const std::string& image_name1,
+                                     const std::string& image_name2) {
+    return GetImagePairMatch(image_name1, image_name2).twoview_info;
+  }
+
   // Set the image pair match for the images.
   virtual void PutImagePairMatch(const std::string& image_name1,
                                  const std::string& image_name2,
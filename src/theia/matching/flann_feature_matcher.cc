@@ -0,0 +1,202 @@
+// Copyright (C) 2026 The Regents of the University of California (Regents).
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials provided
+//       with the distribution.
+//
+//     * Neither the name of The Regents or University of California nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+// Please contact the author of this library if you have any questions.
+// Author: agent (agent@local)
+
+#include "theia/matching/flann_feature_matcher.h"
+
+#include <Eigen/Core>
+#include <glog/logging.h>
+
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "flann/flann.hpp"
+#include "theia/matching/feature_matcher_utils.h"
+#include "theia/matching/indexed_feature_match.h"
+#include "theia/matching/keypoints_and_descriptors.h"
+#include "theia/util/lru_cache.h"
+
+namespace theia {
+
+struct FlannFeatureMatcher::IndexedDescriptors {
+  // FLANN does not copy the descriptors, so they must outlive the index.
+  Eigen::Matrix<float, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>
+      descriptors;
+  std::unique_ptr<flann::Index<flann::L2<float> > > index;
+};
+
+FlannFeatureMatcher::FlannFeatureMatcher(
+    const FeatureMatcherOptions& options,
+    FeaturesAndMatchesDatabase* features_and_matches_database)
+    : FeatureMatcher(options, features_and_matches_database) {
+  CHECK_GT(options.ann_num_kd_trees, 0);
+  CHECK_GT(options.ann_num_leaves_to_check, 0);
+  // Initialize the cache.
+  const std::function<std::shared_ptr<IndexedDescriptors>(const std::string&)>
+      fetch_indexed_descriptors =
+          std::bind(&FlannFeatureMatcher::FetchIndexedDescriptors,
+                    this,
+                    std::placeholders::_1);
+  static constexpr int kNumImagesInCache = 256;
+  indexed_descriptors_.reset(
+      new IndexedDescriptorsCache(fetch_indexed_descriptors,
+                                  kNumImagesInCache));
+}
+
+FlannFeatureMatcher::~FlannFeatureMatcher() {}
+
+std::shared_ptr<FlannFeatureMatcher::IndexedDescriptors>
+FlannFeatureMatcher::BuildIndex(
+    const std::vector<Eigen::VectorXf>& descriptors) {
+  if (descriptors.empty()) {
+    return nullptr;
+  }
+
+  std::shared_ptr<IndexedDescriptors> indexed_descriptors =
+      std::make_shared<IndexedDescriptors>();
+  indexed_descriptors->descriptors.resize(descriptors.size(),
+                                          descriptors[0].size());
+  for (int i = 0; i < descriptors.size(); i++) {
+    indexed_descriptors->descriptors.row(i) = descriptors[i];
+  }
+
+  const flann::Matrix<float> flann_descriptors(
+      indexed_descriptors->descriptors.data(),
+      indexed_descriptors->descriptors.rows(),
+      indexed_descriptors->descriptors.cols());
+  indexed_descriptors->index.reset(new flann::Index<flann::L2<float> >(
+      flann_descriptors,
+      flann::KDTreeIndexParams(this->options_.ann_num_kd_trees)));
+  indexed_descriptors->index->buildIndex();
+  return indexed_descriptors;
+}
+
+std::shared_ptr<FlannFeatureMatcher::IndexedDescriptors>
+FlannFeatureMatcher::FetchIndexedDescriptors(const std::string& image_name) {
+  const auto features =
+      this->feature_and_matches_db_->GetSharedFeatures(image_name);
+  return BuildIndex(features->descriptors);
+}
+
+std::shared_ptr<FlannFeatureMatcher::IndexedDescriptors>
+FlannFeatureMatcher::GetIndexedDescriptors(
+    const KeypointsAndDescriptors& features) {
+  if (features.image_name.empty()) {
+    return BuildIndex(features.descriptors);
+  }
+  return indexed_descriptors_->Fetch(features.image_name);
+}
+
+void FlannFeatureMatcher::MatchDescriptors(
+    const IndexedDescriptors& query,
+    const IndexedDescriptors& database,
+    std::vector<IndexedFeatureMatch>* matches) {
+  const int num_queries = query.descriptors.rows();
+  const int num_nearest_neighbors =
+      std::min(2, static_cast<int>(database.descriptors.rows()));
+
+  // FLANN requires non-const pointers even though the queries are not
+  // modified.
+  const flann::Matrix<float> flann_queries(
+      const_cast<float*>(query.descriptors.data()),
+      num_queries,
+      query.descriptors.cols());
+  std::vector<int> nn_indices(num_queries * num_nearest_neighbors);
+  std::vector<float> nn_distances(num_queries * num_nearest_neighbors);
+  flann::Matrix<int> flann_nn_indices(
+      nn_indices.data(), num_queries, num_nearest_neighbors);
+  flann::Matrix<float> flann_nn_distances(
+      nn_distances.data(), num_queries, num_nearest_neighbors);
+  database.index->knnSearch(
+      flann_queries,
+      flann_nn_indices,
+      flann_nn_distances,
+      num_nearest_neighbors,
+      flann::SearchParams(this->options_.ann_num_leaves_to_check));
+
+  // FLANN returns squared L2 distances, so the ratio must be squared as well.
+  const float sq_lowes_ratio =
+      this->options_.lowes_ratio * this->options_.lowes_ratio;
+  matches->reserve(num_queries);
+  for (int i = 0; i < num_queries; i++) {
+    const int nearest_neighbor = flann_nn_indices[i][0];
+    if (nearest_neighbor < 0) {
+      continue;
+    }
+    const float second_nearest_distance =
+        (num_nearest_neighbors == 2 && flann_nn_indices[i][1] >= 0)
+            ? flann_nn_distances[i][1]
+            : std::numeric_limits<float>::max();
+    // Add to the matches vector if lowes ratio test is turned off or it is
+    // turned on and passes the test.
+    if (!this->options_.use_lowes_ratio ||
+        flann_nn_distances[i][0] < sq_lowes_ratio * second_nearest_distance) {
+      matches->emplace_back(i, nearest_neighbor, flann_nn_distances[i][0]);
+    }
+  }
+}
+
+bool FlannFeatureMatcher::MatchImagePair(
+    const KeypointsAndDescriptors& features1,
+    const KeypointsAndDescriptors& features2,
+    std::vector<IndexedFeatureMatch>* matches) {
+  // Get pointers to the indexed descriptors for each set of features.
+  const auto indexed_features1 = GetIndexedDescriptors(features1);
+  const auto indexed_features2 = GetIndexedDescriptors(features2);
+
+  // If no descriptors exist for either image, skip.
+  if (!indexed_features1 || !indexed_features2) {
+    return false;
+  }
+
+  // Compute forward matches.
+  MatchDescriptors(*indexed_features1, *indexed_features2, matches);
+  if (matches->size() < this->options_.min_num_feature_matches) {
+    return false;
+  }
+
+  // Compute the symmetric matches, if applicable.
+  if (this->options_.keep_only_symmetric_matches) {
+    std::vector<IndexedFeatureMatch> reverse_matches;
+    MatchDescriptors(*indexed_features2, *indexed_features1, &reverse_matches);
+    IntersectMatches(reverse_matches, matches);
+  }
+
+  return matches->size() >= this->options_.min_num_feature_matches;
+}
+
+}  // namespace theia
@@ -0,0 +1,108 @@
+// Copyright (C) 2026 The Regents of the University of California (Regents).
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials provided
+//       with the distribution.
+//
+//     * Neither the name of The Regents or University of California nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+// Please contact the author of this library if you have any questions.
+// Author: agent (agent@local)
+
+#ifndef THEIA_MATCHING_FLANN_FEATURE_MATCHER_H_
+#define THEIA_MATCHING_FLANN_FEATURE_MATCHER_H_
+
+#include <Eigen/Core>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "theia/matching/feature_matcher.h"
+#include "theia/matching/features_and_matches_database.h"
+#include "theia/util/lru_cache.h"
+#include "theia/util/util.h"
+
+namespace theia {
+struct FeatureMatcherOptions;
+struct IndexedFeatureMatch;
+struct KeypointsAndDescriptors;
+
+// Performs approximate nearest neighbor feature matching with FLANN. A
+// randomized k-d forest is built once for the descriptors of each image and
+// kept in a cache, so that the index of an image is reused for all of its image
+// pairs. Symmetric matches are found by querying the index of the first image
+// with the descriptors of the second image. The recall and speed of the search
+// are controlled by FeatureMatcherOptions::ann_num_kd_trees and
+// FeatureMatcherOptions::ann_num_leaves_to_check. This offers a tradeoff
+// between the exact brute force matching and the much faster but less
+// accurate cascade hashing.
+class FlannFeatureMatcher : public FeatureMatcher {
+ public:
+  FlannFeatureMatcher(
+      const FeatureMatcherOptions& options,
+      FeaturesAndMatchesDatabase* features_and_matches_database);
+  ~FlannFeatureMatcher();
+
+ private:
+  // The descriptors of an image stored contiguously along with the k-d forest
+  // that indexes them.
+  struct IndexedDescriptors;
+
+  bool MatchImagePair(
+      const KeypointsAndDescriptors& features1,
+      const KeypointsAndDescriptors& features2,
+      std::vector<IndexedFeatureMatch>* matched_features) override;
+
+  // Builds the k-d forest for the descriptors.
+  std::shared_ptr<IndexedDescriptors> BuildIndex(
+      const std::vector<Eigen::VectorXf>& descriptors);
+
+  // Method to fetch the indexed descriptors of an image and store them in a
+  // cache.
+  std::shared_ptr<IndexedDescriptors> FetchIndexedDescriptors(
+      const std::string& image_name);
+
+  // Returns the indexed descriptors of the features, using the cache if the
+  // features belong to a named image.
+  std::shared_ptr<IndexedDescriptors> GetIndexedDescriptors(
+      const KeypointsAndDescriptors& features);
+
+  // Finds the approximate nearest neighbors of the query descriptors that pass
+  // the ratio test (if enabled).
+  void MatchDescriptors(const IndexedDescriptors& query,
+                        const IndexedDescriptors& database,
+                        std::vector<IndexedFeatureMatch>* matches);
+
+  using IndexedDescriptorsCache =
+      LRUCache<std::string, std::shared_ptr<IndexedDescriptors>>;
+  std::unique_ptr<IndexedDescriptorsCache> indexed_descriptors_;
+
+  DISALLOW_COPY_AND_ASSIGN(FlannFeatureMatcher);
+};
+
+}  // namespace theia
+
+#endif  // THEIA_MATCHING_FLANN_FEATURE_MATCHER_H_
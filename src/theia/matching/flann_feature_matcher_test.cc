@@ -0,0 +1,209 @@
+// Copyright (C) 2026 The Regents of the University of California (Regents).
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials provided
+//       with the distribution.
+//
+//     * Neither the name of The Regents or University of California nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+// Please contact the author of this library if you have any questions.
+// Author: agent (agent@local)
+
+#include <Eigen/Core>
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "theia/matching/brute_force_feature_matcher.h"
+#include "theia/matching/feature_matcher.h"
+#include "theia/matching/flann_feature_matcher.h"
+#include "theia/matching/image_pair_match.h"
+#include "theia/matching/in_memory_features_and_matches_database.h"
+#include "theia/matching/keypoints_and_descriptors.h"
+#include "theia/util/random.h"
+
+#include "gtest/gtest.h"
+
+namespace theia {
+
+using Eigen::VectorXf;
+
+static const int kNumDescriptors = 10;
+static const int kNumDescriptorDimensions = 10;
+
+TEST(FlannFeatureMatcherTest, NoOptions) {
+  // Set up descriptors.
+  KeypointsAndDescriptors features1, features2;
+  features1.image_name = "1";
+  features2.image_name = "2";
+  features1.descriptors.resize(kNumDescriptors);
+  features2.descriptors.resize(kNumDescriptors);
+  for (int i = 0; i < kNumDescriptors; i++) {
+    // Avoid a zero vector.
+    features1.descriptors[i] = VectorXf::Constant(kNumDescriptorDimensions, 1);
+    features2.descriptors[i] = VectorXf::Constant(kNumDescriptorDimensions, 1);
+    features1.descriptors[i].normalize();
+    features2.descriptors[i].normalize();
+  }
+
+  // Set options.
+  FeatureMatcherOptions options;
+  options.min_num_feature_matches = 0;
+  options.keep_only_symmetric_matches = false;
+  options.use_lowes_ratio = false;
+  options.perform_geometric_verification = false;
+
+  // Add features.
+  features1.keypoints.resize(features1.descriptors.size());
+  features2.keypoints.resize(features2.descriptors.size());
+
+  InMemoryFeaturesAndMatchesDatabase database;
+  database.PutFeatures("1", features1);
+  database.PutFeatures("2", features2);
+
+  FlannFeatureMatcher matcher(options, &database);
+  matcher.AddImage("1");
+  matcher.AddImage("2");
+
+  // Match features
+  matcher.MatchImages();
+
+  // Check that the results are valid.
+  EXPECT_GT(database.NumMatches(), 0);
+}
+
+TEST(FlannFeatureMatcherTest, RatioTest) {
+  // Set up descriptors.
+  KeypointsAndDescriptors features1, features2;
+  features1.image_name = "1";
+  features2.image_name = "2";
+  features1.descriptors.resize(1);
+  features2.descriptors.resize(2);
+  features1.descriptors[0] =
+      VectorXf::Constant(kNumDescriptorDimensions, 1).normalized();
+
+  // Set the two descriptors to be very close to each other so that they do not
+  // pass the ratio test.
+  features2.descriptors[0] = VectorXf::Constant(kNumDescriptorDimensions, 1);
+  features2.descriptors[0](0) = 0.9;
+  features2.descriptors[0].normalize();
+  features2.descriptors[1] = VectorXf::Constant(kNumDescriptorDimensions, 1);
+  features2.descriptors[1](0) = 0.89;
+  features2.descriptors[1].normalize();
+
+  // Set options.
+  FeatureMatcherOptions options;
+  options.min_num_feature_matches = 0;
+  options.keep_only_symmetric_matches = false;
+  options.use_lowes_ratio = true;
+  options.perform_geometric_verification = false;
+
+  // Add features.
+  features1.keypoints.resize(features1.descriptors.size());
+  features2.keypoints.resize(features2.descriptors.size());
+
+  InMemoryFeaturesAndMatchesDatabase database;
+  database.PutFeatures("1", features1);
+  database.PutFeatures("2", features2);
+
+  FlannFeatureMatcher matcher(options, &database);
+  matcher.AddImage("1");
+  matcher.AddImage("2");
+
+  // Match features.
+  matcher.MatchImages();
+
+  // The only feature match does not pass the ratio test.
+  ASSERT_EQ(database.NumMatches(), 1);
+  EXPECT_EQ(database.GetImagePairMatch("1", "2").correspondences.size(), 0);
+}
+
+// The approximate matches should be nearly identical to the exact matches of
+// the brute force matcher.
+TEST(FlannFeatureMatcherTest, SameMatchesAsBruteForce) {
+  static const int kNumFeatures = 500;
+  static const int kNumSiftDimensions = 128;
+  static const double kNoise = 0.01;
+  RandomNumberGenerator rng(59);
+
+  // The features of the second image are noisy copies of the features of the
+  // first image.
+  KeypointsAndDescriptors features1, features2;
+  features1.image_name = "1";
+  features2.image_name = "2";
+  features1.descriptors.resize(kNumFeatures);
+  features2.descriptors.resize(kNumFeatures);
+  for (int i = 0; i < kNumFeatures; i++) {
+    features1.descriptors[i].resize(kNumSiftDimensions);
+    features2.descriptors[i].resize(kNumSiftDimensions);
+    for (int j = 0; j < kNumSiftDimensions; j++) {
+      features1.descriptors[i](j) = rng.RandFloat(0.0, 1.0);
+      features2.descriptors[i](j) =
+          features1.descriptors[i](j) + rng.RandGaussian(0.0, kNoise);
+    }
+    features1.descriptors[i].normalize();
+    features2.descriptors[i].normalize();
+  }
+  features1.keypoints.resize(kNumFeatures);
+  features2.keypoints.resize(kNumFeatures);
+
+  FeatureMatcherOptions options;
+  options.min_num_feature_matches = 0;
+  options.perform_geometric_verification = false;
+
+  InMemoryFeaturesAndMatchesDatabase brute_force_database;
+  brute_force_database.PutFeatures("1", features1);
+  brute_force_database.PutFeatures("2", features2);
+  BruteForceFeatureMatcher brute_force_matcher(options, &brute_force_database);
+  brute_force_matcher.AddImage("1");
+  brute_force_matcher.AddImage("2");
+  brute_force_matcher.MatchImages();
+
+  InMemoryFeaturesAndMatchesDatabase flann_database;
+  flann_database.PutFeatures("1", features1);
+  flann_database.PutFeatures("2", features2);
+  FlannFeatureMatcher flann_matcher(options, &flann_database);
+  flann_matcher.AddImage("1");
+  flann_matcher.AddImage("2");
+  flann_matcher.MatchImages();
+
+  const ImagePairMatch brute_force_match =
+      brute_force_database.GetImagePairMatch("1", "2");
+  const ImagePairMatch flann_match = flann_database.GetImagePairMatch("1", "2");
+  ASSERT_GT(brute_force_match.correspondences.size(), 0.9 * kNumFeatures);
+
+  int num_same_matches = 0;
+  for (const FeatureCorrespondence& match : flann_match.correspondences) {
+    if (std::find(brute_force_match.correspondences.begin(),
+                  brute_force_match.correspondences.end(),
+                  match) != brute_force_match.correspondences.end()) {
+      ++num_same_matches;
+    }
+  }
+  EXPECT_GT(num_same_matches, 0.9 * brute_force_match.correspondences.size());
+}
+
+}  // namespace theia
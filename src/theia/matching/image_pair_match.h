@@ -35,6 +35,7 @@
 #ifndef THEIA_MATCHING_IMAGE_PAIR_MATCH_H_
 #define THEIA_MATCHING_IMAGE_PAIR_MATCH_H_
 
+#include <Eigen/Core>
 #include <cereal/access.hpp>
 #include <cereal/cereal.hpp>
 #include <cereal/types/vector.hpp>
@@ -43,6 +44,7 @@
 #include <vector>
 
 #include "theia/alignment/alignment.h"
+#include "theia/io/eigen_serializable.h"
 #include "theia/matching/feature_correspondence.h"
 #include "theia/sfm/twoview_info.h"
 
@@ -61,6 +63,13 @@ struct ImagePairMatch {
   // then this only contains inlier correspondences.
   std::vector<FeatureCorrespondence> correspondences;
 
+  // The k smallest L2 descriptor distances of the first feature of each
+  // correspondence to the features of the second image, in ascending order with
+  // one row per correspondence. This is only computed if
+  // FeatureMatcherOptions::num_sorted_descriptor_distances is greater than 0
+  // and is empty otherwise.
+  Eigen::MatrixXd sorted_descriptor_distances;
+
  private:
   // Templated method for disk I/O with cereal. This method tells cereal which
   // data members should be used when reading/writing to/from disk.
@@ -68,11 +77,14 @@ struct ImagePairMatch {
   template <class Archive>
   void serialize(Archive& ar, const std::uint32_t version) {  // NOLINT
     ar(image1, image2, twoview_info, correspondences);
+    if (version > 0) {
+      ar(sorted_descriptor_distances);
+    }
   }
 };
 
 }  // namespace theia
 
-CEREAL_CLASS_VERSION(theia::ImagePairMatch, 0);
+CEREAL_CLASS_VERSION(theia::ImagePairMatch, 1);
 
 #endif  // THEIA_MATCHING_IMAGE_PAIR_MATCH_H_
@@ -0,0 +1,179 @@
+// Copyright (C) 2026 The Regents of the University of California (Regents).
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials provided
+//       with the distribution.
+//
+//     * Neither the name of The Regents or University of California nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+// Please contact the author of this library if you have any questions.
+// Author: agent (agent@local)
+
+#include "theia/matching/image_pair_matching_log.h"
+
+#include <glog/logging.h>
+
+#include <fstream>  // NOLINT
+#include <mutex>  // NOLINT
+#include <sstream>  // NOLINT
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+#include "theia/util/map_util.h"
+
+namespace theia {
+
+namespace {
+
+static const int kNumImagePairMatchingStatuses = 3;
+
+// Returns the pair of image names in a canonical order.
+std::pair<std::string, std::string> ImagePairKey(const std::string& image1,
+                                                 const std::string& image2) {
+  return image1 < image2 ? std::make_pair(image1, image2)
+                         : std::make_pair(image2, image1);
+}
+
+}  // namespace
+
+ImagePairMatchingLog::ImagePairMatchingLog(const std::string& filepath) {
+  std::string complete_lines;
+  if (!ReadLogFile(filepath, &complete_lines)) {
+    // Remove the incomplete last line so that it is not merged with the next
+    // entry.
+    std::ofstream log_rewriter(filepath, std::ios::out | std::ios::trunc);
+    log_rewriter << complete_lines;
+  }
+
+  log_writer_.open(filepath, std::ios::out | std::ios::app);
+  CHECK(log_writer_.is_open()) << "Could not open the image pair matching log "
+                               << filepath << " for writing.";
+  if (!statuses_.empty()) {
+    LOG(INFO) << "Read " << statuses_.size()
+              << " previously attempted image pairs from " << filepath;
+  }
+}
+
+ImagePairMatchingLog::~ImagePairMatchingLog() {}
+
+bool ImagePairMatchingLog::ReadLogFile(const std::string& filepath,
+                                       std::string* complete_lines) {
+  std::ifstream log_reader(filepath, std::ios::in);
+  if (!log_reader.is_open()) {
+    return true;
+  }
+  std::stringstream buffer;
+  buffer << log_reader.rdbuf();
+  const std::string contents = buffer.str();
+
+  int num_invalid_lines = 0;
+  size_t line_start = 0;
+  size_t line_end;
+  while ((line_end = contents.find('\n', line_start)) != std::string::npos) {
+    const std::string line =
+        contents.substr(line_start, line_end - line_start);
+    line_start = line_end + 1;
+    if (line.empty()) {
+      continue;
+    }
+
+    const size_t first_tab = line.find('\t');
+    const size_t second_tab = first_tab == std::string::npos
+                                  ? std::string::npos
+                                  : line.find('\t', first_tab + 1);
+    if (second_tab == std::string::npos || first_tab != 1 ||
+        line[0] < '0' || line[0] >= '0' + kNumImagePairMatchingStatuses) {
+      ++num_invalid_lines;
+      continue;
+    }
+
+    const ImagePairMatchingStatus status =
+        static_cast<ImagePairMatchingStatus>(line[0] - '0');
+    statuses_[ImagePairKey(
+        line.substr(first_tab + 1, second_tab - first_tab - 1),
+        line.substr(second_tab + 1))] = status;
+  }
+
+  LOG_IF(WARNING, num_invalid_lines > 0)
+      << "Skipped " << num_invalid_lines
+      << " invalid lines in the image pair matching log " << filepath;
+  LOG_IF(WARNING, line_start != contents.size())
+      << "Ignoring the incomplete last line of the image pair matching log "
+      << filepath;
+  *complete_lines = contents.substr(0, line_start);
+  return line_start == contents.size();
+}
+
+void ImagePairMatchingLog::Record(const std::string& image1,
+                                  const std::string& image2,
+                                  const ImagePairMatchingStatus status) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  statuses_[ImagePairKey(image1, image2)] = status;
+  // Flush after every entry so that the entry survives if the process is
+  // terminated.
+  log_writer_ << static_cast<int>(status) << "\t" << image1 << "\t" << image2
+              << "\n";
+  log_writer_.flush();
+}
+
+bool ImagePairMatchingLog::GetStatus(const std::string& image1,
+                                     const std::string& image2,
+                                     ImagePairMatchingStatus* status) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  const ImagePairMatchingStatus* recorded_status =
+      FindOrNull(statuses_, ImagePairKey(image1, image2));
+  if (recorded_status == nullptr) {
+    return false;
+  }
+  *status = *recorded_status;
+  return true;
+}
+
+bool ImagePairMatchingLog::Contains(const std::string& image1,
+                                    const std::string& image2) const {
+  ImagePairMatchingStatus status;
+  return GetStatus(image1, image2, &status);
+}
+
+int ImagePairMatchingLog::NumRecordedPairs() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return statuses_.size();
+}
+
+int ImagePairMatchingLog::NumRecordedPairs(
+    const ImagePairMatchingStatus status) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  int num_pairs = 0;
+  for (const auto& recorded_status : statuses_) {
+    if (recorded_status.second == status) {
+      ++num_pairs;
+    }
+  }
+  return num_pairs;
+}
+
+}  // namespace theia
@@ -0,0 +1,111 @@
+// Copyright (C) 2026 The Regents of the University of California (Regents).
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials provided
+//       with the distribution.
+//
+//     * Neither the name of The Regents or University of California nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+// Please contact the author of this library if you have any questions.
+// Author: agent (agent@local)
+
+#ifndef THEIA_MATCHING_IMAGE_PAIR_MATCHING_LOG_H_
+#define THEIA_MATCHING_IMAGE_PAIR_MATCHING_LOG_H_
+
+#include <fstream>  // NOLINT
+#include <mutex>  // NOLINT
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+#include "theia/util/hash.h"
+#include "theia/util/util.h"
+
+namespace theia {
+
+// The outcome of attempting to match an image pair.
+enum class ImagePairMatchingStatus {
+  // The pair was matched and the matches were written to the database.
+  MATCHED = 0,
+  // Too few features could be matched between the images.
+  INSUFFICIENT_FEATURE_MATCHES = 1,
+  // Geometric verification of the feature matches failed.
+  FAILED_GEOMETRIC_VERIFICATION = 2,
+};
+
+// A durable log of the image pairs that have been attempted during feature
+// matching. Each attempt is appended to a text file as soon as it is recorded,
+// so if matching is interrupted it may be resumed by skipping all pairs in the
+// log (including pairs that failed to match, which are not stored in the
+// features and matches database). Each line of the file is formatted as:
+//
+//   status<TAB>image1<TAB>image2
+//
+// where status is the integer value of the ImagePairMatchingStatus. An
+// incomplete last line (e.g., from a crash while writing) is removed.
+class ImagePairMatchingLog {
+ public:
+  // Reads all entries of the log file if it exists and opens it for appending
+  // new entries.
+  explicit ImagePairMatchingLog(const std::string& filepath);
+  ~ImagePairMatchingLog();
+
+  // Records the outcome of matching the image pair and writes it to the log
+  // file. This method is thread-safe.
+  void Record(const std::string& image1,
+              const std::string& image2,
+              const ImagePairMatchingStatus status);
+
+  // Returns true and sets the status if the image pair (in either order) has
+  // been recorded.
+  bool GetStatus(const std::string& image1,
+                 const std::string& image2,
+                 ImagePairMatchingStatus* status) const;
+  bool Contains(const std::string& image1, const std::string& image2) const;
+
+  // The total number of recorded image pairs and the number of recorded pairs
+  // with the given status.
+  int NumRecordedPairs() const;
+  int NumRecordedPairs(const ImagePairMatchingStatus status) const;
+
+ private:
+  // Reads the existing log entries. Returns false if the file does not end
+  // with a complete line. The contents of the file up to and including the
+  // last complete line are returned in complete_lines.
+  bool ReadLogFile(const std::string& filepath, std::string* complete_lines);
+
+  mutable std::mutex mutex_;
+  std::ofstream log_writer_;
+  std::unordered_map<std::pair<std::string, std::string>,
+                     ImagePairMatchingStatus>
+      statuses_;
+
+  DISALLOW_COPY_AND_ASSIGN(ImagePairMatchingLog);
+};
+
+}  // namespace theia
+
+#endif  // THEIA_MATCHING_IMAGE_PAIR_MATCHING_LOG_H_
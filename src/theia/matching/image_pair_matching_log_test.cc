@@ -0,0 +1,110 @@
+// Copyright (C) 2026 The Regents of the University of California (Regents).
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials provided
+//       with the distribution.
+//
+//     * Neither the name of The Regents or University of California nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+// Please contact the author of this library if you have any questions.
+// Author: agent (agent@local)
+
+#include <cstdio>
+#include <fstream>  // NOLINT
+#include <string>
+
+#include "gtest/gtest.h"
+
+#include "theia/matching/image_pair_matching_log.h"
+
+namespace theia {
+
+namespace {
+
+static const std::string kLogFilepath =
+    THEIA_DATA_DIR + std::string("/image_pair_matching_log.txt");
+
+}  // namespace
+
+TEST(ImagePairMatchingLog, RecordAndResume) {
+  std::remove(kLogFilepath.c_str());
+  {
+    ImagePairMatchingLog log(kLogFilepath);
+    EXPECT_EQ(log.NumRecordedPairs(), 0);
+    log.Record("a.jpg", "b.jpg", ImagePairMatchingStatus::MATCHED);
+    log.Record("a.jpg",
+               "c.jpg",
+               ImagePairMatchingStatus::INSUFFICIENT_FEATURE_MATCHES);
+    log.Record("c.jpg",
+               "b.jpg",
+               ImagePairMatchingStatus::FAILED_GEOMETRIC_VERIFICATION);
+    EXPECT_EQ(log.NumRecordedPairs(), 3);
+  }
+
+  // Reopening the log should restore all entries.
+  ImagePairMatchingLog log(kLogFilepath);
+  EXPECT_EQ(log.NumRecordedPairs(), 3);
+  EXPECT_EQ(log.NumRecordedPairs(ImagePairMatchingStatus::MATCHED), 1);
+  EXPECT_EQ(log.NumRecordedPairs(
+                ImagePairMatchingStatus::INSUFFICIENT_FEATURE_MATCHES),
+            1);
+
+  ImagePairMatchingStatus status;
+  EXPECT_TRUE(log.GetStatus("a.jpg", "b.jpg", &status));
+  EXPECT_EQ(status, ImagePairMatchingStatus::MATCHED);
+  // The order of the images should not matter.
+  EXPECT_TRUE(log.GetStatus("b.jpg", "c.jpg", &status));
+  EXPECT_EQ(status, ImagePairMatchingStatus::FAILED_GEOMETRIC_VERIFICATION);
+  EXPECT_TRUE(log.Contains("c.jpg", "a.jpg"));
+  EXPECT_FALSE(log.Contains("a.jpg", "d.jpg"));
+  std::remove(kLogFilepath.c_str());
+}
+
+TEST(ImagePairMatchingLog, IncompleteLastLine) {
+  // Simulate a crash while the last entry was written.
+  {
+    std::ofstream log_writer(kLogFilepath, std::ios::out);
+    log_writer << "0\ta.jpg\tb.jpg\n1\ta.jpg\tc.j";
+  }
+
+  {
+    ImagePairMatchingLog log(kLogFilepath);
+    EXPECT_EQ(log.NumRecordedPairs(), 1);
+    EXPECT_TRUE(log.Contains("a.jpg", "b.jpg"));
+    EXPECT_FALSE(log.Contains("a.jpg", "c.jpg"));
+    log.Record("a.jpg", "c.jpg", ImagePairMatchingStatus::MATCHED);
+  }
+
+  // The new entry should not be corrupted by the incomplete line.
+  ImagePairMatchingLog log(kLogFilepath);
+  EXPECT_EQ(log.NumRecordedPairs(), 2);
+  ImagePairMatchingStatus status;
+  EXPECT_TRUE(log.GetStatus("a.jpg", "c.jpg", &status));
+  EXPECT_EQ(status, ImagePairMatchingStatus::MATCHED);
+  std::remove(kLogFilepath.c_str());
+}
+
+}  // namespace theia
@@ -40,11 +40,14 @@
 #include <cereal/types/utility.hpp>
 #include <cereal/types/vector.hpp>
 #include <cstdlib>
+#include <functional>
 #include <fstream>  // NOLINT
 #include <glog/logging.h>
 #include <iostream>  // NOLINT
+#include <memory>
 #include <mutex>     // NOLINT
 #include <string>
+#include <vector>
 
 #include "theia/matching/image_pair_match.h"
 #include "theia/matching/keypoints_and_descriptors.h"
@@ -52,74 +55,159 @@
 
 namespace theia {
 
+InMemoryFeaturesAndMatchesDatabase::InMemoryFeaturesAndMatchesDatabase()
+    : shards_(kNumShards), features_are_frozen_(false) {}
+
+InMemoryFeaturesAndMatchesDatabase::Shard&
+InMemoryFeaturesAndMatchesDatabase::GetShard(const std::string& image_name) {
+  return shards_[std::hash<std::string>()(image_name) % kNumShards];
+}
+
 bool InMemoryFeaturesAndMatchesDatabase::ContainsCameraIntrinsicsPrior(
     const std::string& image_name) {
-  return ContainsKey(intrinsics_priors_, image_name);
+  Shard& shard = GetShard(image_name);
+  std::lock_guard<std::mutex> lock(shard.mutex);
+  return ContainsKey(shard.intrinsics_priors, image_name);
 }
 
 // Get/set the features for the image.
 CameraIntrinsicsPrior
 InMemoryFeaturesAndMatchesDatabase::GetCameraIntrinsicsPrior(
     const std::string& image_name) {
-  return FindOrDie(intrinsics_priors_, image_name);
+  Shard& shard = GetShard(image_name);
+  std::lock_guard<std::mutex> lock(shard.mutex);
+  return FindOrDie(shard.intrinsics_priors, image_name);
 }
 
 // Set the features for the image.
 void InMemoryFeaturesAndMatchesDatabase::PutCameraIntrinsicsPrior(
     const std::string& image_name, const CameraIntrinsicsPrior& intrinsics) {
-  intrinsics_priors_[image_name] = intrinsics;
+  Shard& shard = GetShard(image_name);
+  std::lock_guard<std::mutex> lock(shard.mutex);
+  shard.intrinsics_priors[image_name] = intrinsics;
 }
 
 // Supply an iterator to iterate over the priors.
 std::vector<std::string>
 InMemoryFeaturesAndMatchesDatabase::ImageNamesOfCameraIntrinsicsPriors() {
   std::vector<std::string> image_names;
-  image_names.reserve(intrinsics_priors_.size());
-  for (const auto& intrinsics : intrinsics_priors_) {
-    image_names.push_back(intrinsics.first);
+  for (Shard& shard : shards_) {
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    for (const auto& intrinsics : shard.intrinsics_priors) {
+      image_names.push_back(intrinsics.first);
+    }
   }
   return image_names;
 }
 
 size_t InMemoryFeaturesAndMatchesDatabase::NumCameraIntrinsicsPrior() {
-  return intrinsics_priors_.size();
+  size_t num_priors = 0;
+  for (Shard& shard : shards_) {
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    num_priors += shard.intrinsics_priors.size();
+  }
+  return num_priors;
+}
+
+std::shared_ptr<const KeypointsAndDescriptors>
+InMemoryFeaturesAndMatchesDatabase::FindFeatures(
+    const std::string& image_name) {
+  Shard& shard = GetShard(image_name);
+  // Frozen features are never modified so they may be read without locking.
+  if (features_are_frozen_) {
+    return FindWithDefault(shard.features, image_name, nullptr);
+  }
+  std::lock_guard<std::mutex> lock(shard.mutex);
+  return FindWithDefault(shard.features, image_name, nullptr);
 }
 
 bool InMemoryFeaturesAndMatchesDatabase::ContainsFeatures(
     const std::string& image_name) {
-  return ContainsKey(features_, image_name);
+  return FindFeatures(image_name) != nullptr;
 }
 
 // Get/set the features for the image.
 KeypointsAndDescriptors InMemoryFeaturesAndMatchesDatabase::GetFeatures(
     const std::string& image_name) {
-  return FindOrDie(features_, image_name);
+  return *GetSharedFeatures(image_name);
+}
+
+std::shared_ptr<const KeypointsAndDescriptors>
+InMemoryFeaturesAndMatchesDatabase::GetSharedFeatures(
+    const std::string& image_name) {
+  const std::shared_ptr<const KeypointsAndDescriptors> features =
+      FindFeatures(image_name);
+  CHECK(features != nullptr) << "Could not find features for " << image_name
+                             << " in the database.";
+  return features;
 }
 
 // Set the features for the image.
 void InMemoryFeaturesAndMatchesDatabase::PutFeatures(
     const std::string& image_name, const KeypointsAndDescriptors& features) {
-  features_[image_name] = features;
+  // Copy the features before acquiring the lock.
+  std::shared_ptr<const KeypointsAndDescriptors> shared_features =
+      std::make_shared<const KeypointsAndDescriptors>(features);
+  Shard& shard = GetShard(image_name);
+  std::lock_guard<std::mutex> lock(shard.mutex);
+  CHECK(!features_are_frozen_)
+      << "Features cannot be added after EndBulkFeatureIngestion is called.";
+  shard.features[image_name] = std::move(shared_features);
 }
 
 std::vector<std::string>
 InMemoryFeaturesAndMatchesDatabase::ImageNamesOfFeatures() {
   std::vector<std::string> features_keys;
-  features_keys.reserve(features_.size());
-  for (const auto& features : features_) {
-    features_keys.push_back(features.first);
+  for (Shard& shard : shards_) {
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    for (const auto& features : shard.features) {
+      features_keys.push_back(features.first);
+    }
   }
   return features_keys;
 }
 
 size_t InMemoryFeaturesAndMatchesDatabase::NumImages() {
-  return features_.size();
+  size_t num_images = 0;
+  for (Shard& shard : shards_) {
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    num_images += shard.features.size();
+  }
+  return num_images;
+}
+
+void InMemoryFeaturesAndMatchesDatabase::BeginBulkFeatureIngestion() {
+  features_are_frozen_ = false;
+}
+
+void InMemoryFeaturesAndMatchesDatabase::EndBulkFeatureIngestion() {
+  // Acquire all locks so that no write is in progress when the features are
+  // frozen.
+  for (Shard& shard : shards_) {
+    shard.mutex.lock();
+  }
+  features_are_frozen_ = true;
+  for (Shard& shard : shards_) {
+    shard.mutex.unlock();
+  }
 }
 
 // Get the image pair match for the images.
 ImagePairMatch InMemoryFeaturesAndMatchesDatabase::GetImagePairMatch(
     const std::string& image_name1, const std::string& image_name2) {
-  return FindOrDieNoPrint(matches_, std::make_pair(image_name1, image_name2));
+  Shard& shard = GetShard(image_name1);
+  std::lock_guard<std::mutex> lock(shard.mutex);
+  return FindOrDieNoPrint(shard.matches,
+                          std::make_pair(image_name1, image_name2));
+}
+
+TwoViewInfo InMemoryFeaturesAndMatchesDatabase::GetTwoViewInfo(
+    const std::string& image_name1, const std::string& image_name2) {
+  Shard& shard = GetShard(image_name1);
+  std::lock_guard<std::mutex> lock(shard.mutex);
+  return FindOrDieNoPrint(shard.matches,
+                          std::make_pair(image_name1, image_name2))
+      .twoview_info;
 }
 
 // Set the image pair match for the images.
@@ -127,22 +215,30 @@ void InMemoryFeaturesAndMatchesDatabase::PutImagePairMatch(
     const std::string& image_name1,
     const std::string& image_name2,
     const ImagePairMatch& matches) {
-  std::lock_guard<std::mutex> lock(mutex_);
-  matches_[std::make_pair(image_name1, image_name2)] = matches;
+  Shard& shard = GetShard(image_name1);
+  std::lock_guard<std::mutex> lock(shard.mutex);
+  shard.matches[std::make_pair(image_name1, image_name2)] = matches;
 }
 
 std::vector<std::pair<std::string, std::string>>
 InMemoryFeaturesAndMatchesDatabase::ImageNamesOfMatches() {
   std::vector<std::pair<std::string, std::string>> match_keys;
-  match_keys.reserve(matches_.size());
-  for (const auto& match : matches_) {
-    match_keys.push_back(match.first);
+  for (Shard& shard : shards_) {
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    for (const auto& match : shard.matches) {
+      match_keys.push_back(match.first);
+    }
   }
   return match_keys;
 }
 
 size_t InMemoryFeaturesAndMatchesDatabase::NumMatches() {
-  return matches_.size();
+  size_t num_matches = 0;
+  for (Shard& shard : shards_) {
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    num_matches += shard.matches.size();
+  }
+  return num_matches;
 }
 
 bool InMemoryFeaturesAndMatchesDatabase::ReadFromFile(
@@ -165,14 +261,12 @@ bool InMemoryFeaturesAndMatchesDatabase::ReadFromFile(
   }
   CHECK_EQ(view_names.size(), camera_intrinsics_prior.size());
 
-  matches_.reserve(matches.size());
   for (const auto& match : matches) {
-    matches_[std::make_pair(match.image1, match.image2)] = match;
+    PutImagePairMatch(match.image1, match.image2, match);
   }
 
-  intrinsics_priors_.reserve(camera_intrinsics_prior.size());
   for (int i = 0; i < view_names.size(); i++) {
-    intrinsics_priors_[view_names[i]] = camera_intrinsics_prior[i];
+    PutCameraIntrinsicsPrior(view_names[i], camera_intrinsics_prior[i]);
   }
 
   return true;
@@ -189,18 +283,17 @@ bool InMemoryFeaturesAndMatchesDatabase::WriteToFile(
 
   // Make sure that Cereal is able to finish executing before returning.
   std::vector<ImagePairMatch> matches;
-  matches.reserve(matches_.size());
-  for (const auto& match : matches_) {
-    matches.push_back(match.second);
-  }
-
   std::vector<std::string> view_names;
-  view_names.reserve(intrinsics_priors_.size());
   std::vector<CameraIntrinsicsPrior> camera_intrinsics_prior;
-  camera_intrinsics_prior.reserve(intrinsics_priors_.size());
-  for (const auto& prior : intrinsics_priors_) {
-    view_names.push_back(prior.first);
-    camera_intrinsics_prior.push_back(prior.second);
+  for (Shard& shard : shards_) {
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    for (const auto& match : shard.matches) {
+      matches.push_back(match.second);
+    }
+    for (const auto& prior : shard.intrinsics_priors) {
+      view_names.push_back(prior.first);
+      camera_intrinsics_prior.push_back(prior.second);
+    }
   }
   {
     cereal::PortableBinaryOutputArchive output_archive(matches_writer);
@@ -211,7 +304,10 @@ bool InMemoryFeaturesAndMatchesDatabase::WriteToFile(
 }
 
 void InMemoryFeaturesAndMatchesDatabase::RemoveAllMatches() {
-  matches_.clear();
+  for (Shard& shard : shards_) {
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    shard.matches.clear();
+  }
 }
 
 }  // namespace theia
@@ -35,10 +35,13 @@
 #ifndef THEIA_MATCHING_IN_MEMORY_FEATURES_AND_MATCHES_DATABASE_H_
 #define THEIA_MATCHING_IN_MEMORY_FEATURES_AND_MATCHES_DATABASE_H_
 
+#include <atomic>
+#include <memory>
 #include <mutex>  // NOLINT
 #include <string>
 #include <unordered_map>
 #include <utility>
+#include <vector>
 
 #include "theia/io/read_keypoints_and_descriptors.h"
 #include "theia/io/write_keypoints_and_descriptors.h"
@@ -46,15 +49,24 @@
 #include "theia/matching/image_pair_match.h"
 #include "theia/matching/keypoints_and_descriptors.h"
 #include "theia/sfm/camera_intrinsics_prior.h"
+#include "theia/sfm/twoview_info.h"
 #include "theia/util/filesystem.h"
 #include "theia/util/util.h"
 
 namespace theia {
 
 // A simple implementation for storing features and feature matches in memory.
+// The data is split into shards by image name, each protected by its own mutex,
+// so that concurrent readers and writers rarely contend for the same lock. The
+// features are stored as shared immutable objects that GetSharedFeatures hands
+// out without copying.
+//
+// Once EndBulkFeatureIngestion is called the features are frozen: they are read
+// without any locking and no more features may be added until
+// BeginBulkFeatureIngestion is called again.
 class InMemoryFeaturesAndMatchesDatabase : public FeaturesAndMatchesDatabase {
  public:
-  InMemoryFeaturesAndMatchesDatabase() = default;
+  InMemoryFeaturesAndMatchesDatabase();
   ~InMemoryFeaturesAndMatchesDatabase() = default;
 
   bool ContainsCameraIntrinsicsPrior(const std::string& image_name) override;
@@ -76,6 +88,8 @@ class InMemoryFeaturesAndMatchesDatabase : public FeaturesAndMatchesDatabase {
 
   // Get/set the features for the image.
   KeypointsAndDescriptors GetFeatures(const std::string& image_name) override;
+  std::shared_ptr<const KeypointsAndDescriptors> GetSharedFeatures(
+      const std::string& image_name) override;
 
   // Set the features for the image.
   void PutFeatures(const std::string& image_name,
@@ -85,11 +99,21 @@ class InMemoryFeaturesAndMatchesDatabase : public FeaturesAndMatchesDatabase {
   std::vector<std::string> ImageNamesOfFeatures() override;
   size_t NumImages() override;
 
+  // Unfreezes and freezes the features respectively. Features must not be read
+  // concurrently with a call to BeginBulkFeatureIngestion.
+  void BeginBulkFeatureIngestion() override;
+  void EndBulkFeatureIngestion() override;
+
   // Get the image pair match for the images.Returns true if the features exist
   // in the database and false otherwise.
   ImagePairMatch GetImagePairMatch(const std::string& image_name1,
                                    const std::string& image_name2) override;
 
+  // Returns the two view info of the image pair match without copying the
+  // correspondences.
+  TwoViewInfo GetTwoViewInfo(const std::string& image_name1,
+                             const std::string& image_name2) override;
+
   // Set the image pair match for the images.
   void PutImagePairMatch(const std::string& image_name1,
                          const std::string& image_name2,
@@ -107,11 +131,28 @@ class InMemoryFeaturesAndMatchesDatabase : public FeaturesAndMatchesDatabase {
  private:
   DISALLOW_COPY_AND_ASSIGN(InMemoryFeaturesAndMatchesDatabase);
 
-  std::mutex mutex_;
-  std::unordered_map<std::string, CameraIntrinsicsPrior> intrinsics_priors_;
-  std::unordered_map<std::string, KeypointsAndDescriptors> features_;
-  std::unordered_map<std::pair<std::string, std::string>, ImagePairMatch>
-      matches_;
+  static const int kNumShards = 64;
+
+  // All data associated with a subset of the image names. Matches are stored in
+  // the shard of the first image of the pair.
+  struct Shard {
+    std::mutex mutex;
+    std::unordered_map<std::string, CameraIntrinsicsPrior> intrinsics_priors;
+    std::unordered_map<std::string,
+                       std::shared_ptr<const KeypointsAndDescriptors>>
+        features;
+    std::unordered_map<std::pair<std::string, std::string>, ImagePairMatch>
+        matches;
+  };
+
+  Shard& GetShard(const std::string& image_name);
+
+  // Returns the stored features or a null pointer if the image has no features.
+  std::shared_ptr<const KeypointsAndDescriptors> FindFeatures(
+      const std::string& image_name);
+
+  std::vector<Shard> shards_;
+  std::atomic<bool> features_are_frozen_;
 };
 }  // namespace theia
 #endif  // THEIA_MATCHING_IN_MEMORY_FEATURES_AND_MATCHES_DATABASE_H_
@@ -0,0 +1,191 @@
+// Copyright (C) 2026 The Regents of the University of California (Regents).
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials provided
+//       with the distribution.
+//
+//     * Neither the name of The Regents or University of California nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+// Please contact the author of this library if you have any questions.
+// Author: agent (agent@local)
+
+#include <Eigen/Core>
+#include <memory>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "theia/matching/image_pair_match.h"
+#include "theia/matching/in_memory_features_and_matches_database.h"
+#include "theia/matching/keypoints_and_descriptors.h"
+
+namespace theia {
+
+namespace {
+
+KeypointsAndDescriptors CreateFeatures(const std::string& image_name,
+                                       const int num_features) {
+  KeypointsAndDescriptors features;
+  features.image_name = image_name;
+  features.keypoints.resize(num_features);
+  features.descriptors.resize(num_features);
+  for (int i = 0; i < num_features; i++) {
+    features.keypoints[i] = Keypoint(i, i + 1, Keypoint::OTHER);
+    features.descriptors[i] = Eigen::VectorXf::Random(128);
+  }
+  return features;
+}
+
+}  // namespace
+
+TEST(InMemoryFeaturesAndMatchesDatabase, PutAndGetFeatures) {
+  static const int kNumImages = 200;
+  static const int kNumFeatures = 10;
+
+  InMemoryFeaturesAndMatchesDatabase db;
+  std::vector<KeypointsAndDescriptors> features;
+  for (int i = 0; i < kNumImages; i++) {
+    features.emplace_back(
+        CreateFeatures("image" + std::to_string(i), kNumFeatures));
+    db.PutFeatures(features[i].image_name, features[i]);
+  }
+  EXPECT_EQ(db.NumImages(), kNumImages);
+  EXPECT_EQ(db.ImageNamesOfFeatures().size(), kNumImages);
+  EXPECT_FALSE(db.ContainsFeatures("unknown_image"));
+
+  for (int i = 0; i < kNumImages; i++) {
+    EXPECT_TRUE(db.ContainsFeatures(features[i].image_name));
+    const KeypointsAndDescriptors db_features =
+        db.GetFeatures(features[i].image_name);
+    ASSERT_EQ(db_features.descriptors.size(), kNumFeatures);
+    for (int j = 0; j < kNumFeatures; j++) {
+      EXPECT_EQ(db_features.keypoints[j].x(), features[i].keypoints[j].x());
+      EXPECT_EQ(db_features.descriptors[j], features[i].descriptors[j]);
+    }
+  }
+}
+
+TEST(InMemoryFeaturesAndMatchesDatabase, SharedFeaturesAreNotCopied) {
+  InMemoryFeaturesAndMatchesDatabase db;
+  db.PutFeatures("image", CreateFeatures("image", 10));
+
+  const std::shared_ptr<const KeypointsAndDescriptors> features1 =
+      db.GetSharedFeatures("image");
+  const std::shared_ptr<const KeypointsAndDescriptors> features2 =
+      db.GetSharedFeatures("image");
+  EXPECT_EQ(features1.get(), features2.get());
+
+  // Replacing the features must not invalidate the existing handles.
+  db.PutFeatures("image", CreateFeatures("image", 5));
+  EXPECT_EQ(features1->descriptors.size(), 10);
+  EXPECT_EQ(db.GetSharedFeatures("image")->descriptors.size(), 5);
+}
+
+TEST(InMemoryFeaturesAndMatchesDatabase, FrozenFeatures) {
+  static const int kNumImages = 100;
+  static const int kNumThreads = 4;
+
+  InMemoryFeaturesAndMatchesDatabase db;
+  db.BeginBulkFeatureIngestion();
+
+  // Add the features from several threads.
+  std::vector<std::thread> threads;
+  for (int t = 0; t < kNumThreads; t++) {
+    threads.emplace_back([&db, t]() {
+      for (int i = t; i < kNumImages; i += kNumThreads) {
+        const std::string image_name = "image" + std::to_string(i);
+        db.PutFeatures(image_name, CreateFeatures(image_name, i));
+      }
+    });
+  }
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+  db.EndBulkFeatureIngestion();
+
+  // Read the frozen features from several threads.
+  threads.clear();
+  std::vector<int> num_errors(kNumThreads, 0);
+  for (int t = 0; t < kNumThreads; t++) {
+    threads.emplace_back([&db, &num_errors, t]() {
+      for (int i = 0; i < kNumImages; i++) {
+        const std::string image_name = "image" + std::to_string(i);
+        if (!db.ContainsFeatures(image_name) ||
+            db.GetSharedFeatures(image_name)->descriptors.size() != i) {
+          ++num_errors[t];
+        }
+      }
+    });
+  }
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+  for (int t = 0; t < kNumThreads; t++) {
+    EXPECT_EQ(num_errors[t], 0);
+  }
+  EXPECT_EQ(db.NumImages(), kNumImages);
+
+  // Features may be added again once the bulk ingestion restarts.
+  db.BeginBulkFeatureIngestion();
+  db.PutFeatures("new_image", CreateFeatures("new_image", 1));
+  EXPECT_TRUE(db.ContainsFeatures("new_image"));
+}
+
+TEST(InMemoryFeaturesAndMatchesDatabase, PutAndGetMatches) {
+  static const int kNumImages = 20;
+
+  InMemoryFeaturesAndMatchesDatabase db;
+  for (int i = 0; i < kNumImages; i++) {
+    for (int j = i + 1; j < kNumImages; j++) {
+      ImagePairMatch match;
+      match.image1 = "image" + std::to_string(i);
+      match.image2 = "image" + std::to_string(j);
+      match.correspondences.resize(i + j);
+      match.twoview_info.num_verified_matches = i + j;
+      db.PutImagePairMatch(match.image1, match.image2, match);
+    }
+  }
+  EXPECT_EQ(db.NumMatches(), kNumImages * (kNumImages - 1) / 2);
+  EXPECT_EQ(db.ImageNamesOfMatches().size(), db.NumMatches());
+
+  for (int i = 0; i < kNumImages; i++) {
+    for (int j = i + 1; j < kNumImages; j++) {
+      const ImagePairMatch match = db.GetImagePairMatch(
+          "image" + std::to_string(i), "image" + std::to_string(j));
+      EXPECT_EQ(match.correspondences.size(), i + j);
+      EXPECT_EQ(db.GetTwoViewInfo("image" + std::to_string(i),
+                                  "image" + std::to_string(j))
+                    .num_verified_matches,
+                i + j);
+    }
+  }
+
+  db.RemoveAllMatches();
+  EXPECT_EQ(db.NumMatches(), 0);
+}
+
+}  // namespace theia
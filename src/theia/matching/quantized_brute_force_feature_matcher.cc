@@ -0,0 +1,178 @@
+// Copyright (C) 2026 The Regents of the University of California (Regents).
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials provided
+//       with the distribution.
+//
+//     * Neither the name of The Regents or University of California nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+// Please contact the author of this library if you have any questions.
+// Author: agent (agent@local)
+
+#include "theia/matching/quantized_brute_force_feature_matcher.h"
+
+#include <glog/logging.h>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "theia/matching/feature_matcher_utils.h"
+#include "theia/matching/features_and_matches_database.h"
+#include "theia/matching/indexed_feature_match.h"
+#include "theia/matching/keypoints_and_descriptors.h"
+#include "theia/matching/quantized_descriptors.h"
+#include "theia/util/lru_cache.h"
+
+namespace theia {
+
+QuantizedBruteForceFeatureMatcher::QuantizedBruteForceFeatureMatcher(
+    const FeatureMatcherOptions& options,
+    FeaturesAndMatchesDatabase* features_and_matches_database)
+    : FeatureMatcher(options, features_and_matches_database) {
+  // Initialize the cache.
+  const std::function<std::shared_ptr<const QuantizedDescriptors>(
+      const std::string&)>
+      fetch_quantized_descriptors = std::bind(
+          &QuantizedBruteForceFeatureMatcher::FetchQuantizedDescriptors,
+          this,
+          std::placeholders::_1);
+  static constexpr int kNumImagesInCache = 256;
+  quantized_descriptors_.reset(new QuantizedDescriptorsCache(
+      fetch_quantized_descriptors, kNumImagesInCache));
+}
+
+std::shared_ptr<const QuantizedDescriptors>
+QuantizedBruteForceFeatureMatcher::FetchQuantizedDescriptors(
+    const std::string& image_name) {
+  const auto features =
+      this->feature_and_matches_db_->GetSharedFeatures(image_name);
+  std::shared_ptr<QuantizedDescriptors> quantized_descriptors =
+      std::make_shared<QuantizedDescriptors>();
+  QuantizeDescriptors(features->descriptors, quantized_descriptors.get());
+  return quantized_descriptors;
+}
+
+std::shared_ptr<const QuantizedDescriptors>
+QuantizedBruteForceFeatureMatcher::GetQuantizedDescriptors(
+    const KeypointsAndDescriptors& features) {
+  if (!features.image_name.empty()) {
+    return quantized_descriptors_->Fetch(features.image_name);
+  }
+
+  std::shared_ptr<QuantizedDescriptors> quantized_descriptors =
+      std::make_shared<QuantizedDescriptors>();
+  QuantizeDescriptors(features.descriptors, quantized_descriptors.get());
+  return quantized_descriptors;
+}
+
+void QuantizedBruteForceFeatureMatcher::MatchQuantizedDescriptors(
+    const QuantizedDescriptors& query,
+    const QuantizedDescriptors& database,
+    std::vector<IndexedFeatureMatch>* matches) {
+  std::vector<IndexedFeatureMatch> nearest_neighbors;
+  std::vector<float> second_nearest_distances;
+  FindTwoNearestQuantizedNeighbors(
+      query, database, &nearest_neighbors, &second_nearest_distances);
+
+  const float sq_lowes_ratio =
+      this->options_.lowes_ratio * this->options_.lowes_ratio;
+  matches->reserve(nearest_neighbors.size());
+  for (int i = 0; i < nearest_neighbors.size(); i++) {
+    // Add to the matches vector if lowes ratio test is turned off or it is
+    // turned on and passes the test.
+    if (!this->options_.use_lowes_ratio ||
+        nearest_neighbors[i].distance <
+            sq_lowes_ratio * second_nearest_distances[i]) {
+      matches->emplace_back(nearest_neighbors[i]);
+    }
+  }
+}
+
+bool QuantizedBruteForceFeatureMatcher::MatchImagePair(
+    const KeypointsAndDescriptors& features1,
+    const KeypointsAndDescriptors& features2,
+    std::vector<IndexedFeatureMatch>* matches) {
+  if (features1.descriptors.empty() || features2.descriptors.empty()) {
+    return false;
+  }
+
+  QuantizedDescriptors quantized_descriptors1, quantized_descriptors2;
+  QuantizeDescriptors(features1.descriptors, &quantized_descriptors1);
+  QuantizeDescriptors(features2.descriptors, &quantized_descriptors2);
+  return MatchQuantizedImagePair(
+      quantized_descriptors1, quantized_descriptors2, matches);
+}
+
+void QuantizedBruteForceFeatureMatcher::MatchImageToImages(
+    const KeypointsAndDescriptors& features1,
+    const std::vector<std::shared_ptr<const KeypointsAndDescriptors> >&
+        features2,
+    std::vector<std::vector<IndexedFeatureMatch> >* matches,
+    std::vector<bool>* is_valid_match) {
+  matches->clear();
+  matches->resize(features2.size());
+  is_valid_match->assign(features2.size(), false);
+  if (features1.descriptors.empty()) {
+    return;
+  }
+
+  const std::shared_ptr<const QuantizedDescriptors> quantized_descriptors1 =
+      GetQuantizedDescriptors(features1);
+  for (int i = 0; i < features2.size(); i++) {
+    if (features2[i]->descriptors.empty()) {
+      continue;
+    }
+    const std::shared_ptr<const QuantizedDescriptors> quantized_descriptors2 =
+        GetQuantizedDescriptors(*features2[i]);
+    (*is_valid_match)[i] = MatchQuantizedImagePair(
+        *quantized_descriptors1, *quantized_descriptors2, &(*matches)[i]);
+  }
+}
+
+bool QuantizedBruteForceFeatureMatcher::MatchQuantizedImagePair(
+    const QuantizedDescriptors& quantized_descriptors1,
+    const QuantizedDescriptors& quantized_descriptors2,
+    std::vector<IndexedFeatureMatch>* matches) {
+  // Compute forward matches.
+  MatchQuantizedDescriptors(
+      quantized_descriptors1, quantized_descriptors2, matches);
+  if (matches->size() < this->options_.min_num_feature_matches) {
+    return false;
+  }
+
+  // Compute the symmetric matches, if applicable.
+  if (this->options_.keep_only_symmetric_matches) {
+    std::vector<IndexedFeatureMatch> reverse_matches;
+    MatchQuantizedDescriptors(
+        quantized_descriptors2, quantized_descriptors1, &reverse_matches);
+    IntersectMatches(reverse_matches, matches);
+  }
+
+  return matches->size() >= this->options_.min_num_feature_matches;
+}
+
+}  // namespace theia
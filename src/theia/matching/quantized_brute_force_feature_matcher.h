@@ -0,0 +1,112 @@
+// Copyright (C) 2026 The Regents of the University of California (Regents).
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials provided
+//       with the distribution.
+//
+//     * Neither the name of The Regents or University of California nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+// Please contact the author of this library if you have any questions.
+// Author: agent (agent@local)
+
+#ifndef THEIA_MATCHING_QUANTIZED_BRUTE_FORCE_FEATURE_MATCHER_H_
+#define THEIA_MATCHING_QUANTIZED_BRUTE_FORCE_FEATURE_MATCHER_H_
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "theia/matching/feature_matcher.h"
+#include "theia/matching/features_and_matches_database.h"
+#include "theia/matching/quantized_descriptors.h"
+#include "theia/util/lru_cache.h"
+#include "theia/util/util.h"
+
+namespace theia {
+struct FeatureMatcherOptions;
+struct IndexedFeatureMatch;
+struct KeypointsAndDescriptors;
+
+// Performs brute force feature matching on descriptors that are quantized to
+// 8-bit integers. The distances are computed with integer dot products, which
+// requires 4x less memory traffic than matching the float descriptors and
+// allows for much higher arithmetic throughput. Quantizing the descriptors is
+// linear in the number of features, so it is negligible compared to the
+// quadratic matching cost. The matches are nearly identical to those of the
+// BruteForceFeatureMatcher for float descriptors such as SIFT.
+class QuantizedBruteForceFeatureMatcher : public FeatureMatcher {
+ public:
+  QuantizedBruteForceFeatureMatcher(
+      const FeatureMatcherOptions& options,
+      FeaturesAndMatchesDatabase* features_and_matches_database);
+  ~QuantizedBruteForceFeatureMatcher() {}
+
+ private:
+  bool MatchImagePair(
+      const KeypointsAndDescriptors& features1,
+      const KeypointsAndDescriptors& features2,
+      std::vector<IndexedFeatureMatch>* matched_features) override;
+
+  // The quantized descriptors of each image are fetched from a cache so that
+  // images that are matched in several groups are only quantized once.
+  void MatchImageToImages(
+      const KeypointsAndDescriptors& features1,
+      const std::vector<std::shared_ptr<const KeypointsAndDescriptors> >&
+          features2,
+      std::vector<std::vector<IndexedFeatureMatch> >* matched_features,
+      std::vector<bool>* is_valid_match) override;
+
+  // Matches the quantized descriptors of an image pair.
+  bool MatchQuantizedImagePair(
+      const QuantizedDescriptors& quantized_descriptors1,
+      const QuantizedDescriptors& quantized_descriptors2,
+      std::vector<IndexedFeatureMatch>* matched_features);
+
+  // Finds the nearest neighbors of the query descriptors that pass the ratio
+  // test (if enabled).
+  void MatchQuantizedDescriptors(const QuantizedDescriptors& query,
+                                 const QuantizedDescriptors& database,
+                                 std::vector<IndexedFeatureMatch>* matches);
+
+  // Returns the quantized descriptors of the image. Images without a name are
+  // not cached.
+  std::shared_ptr<const QuantizedDescriptors> GetQuantizedDescriptors(
+      const KeypointsAndDescriptors& features);
+
+  // Method to fetch the features of an image from the database and quantize
+  // them for the cache.
+  std::shared_ptr<const QuantizedDescriptors> FetchQuantizedDescriptors(
+      const std::string& image_name);
+
+  using QuantizedDescriptorsCache =
+      LRUCache<std::string, std::shared_ptr<const QuantizedDescriptors> >;
+  std::unique_ptr<QuantizedDescriptorsCache> quantized_descriptors_;
+
+  DISALLOW_COPY_AND_ASSIGN(QuantizedBruteForceFeatureMatcher);
+};
+}  // namespace theia
+
+#endif  // THEIA_MATCHING_QUANTIZED_BRUTE_FORCE_FEATURE_MATCHER_H_
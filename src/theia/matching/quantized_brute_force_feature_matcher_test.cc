@@ -0,0 +1,322 @@
+// Copyright (C) 2026 The Regents of the University of California (Regents).
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials provided
+//       with the distribution.
+//
+//     * Neither the name of The Regents or University of California nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+// Please contact the author of this library if you have any questions.
+// Author: agent (agent@local)
+
+#include <Eigen/Core>
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "theia/matching/brute_force_feature_matcher.h"
+#include "theia/matching/distance.h"
+#include "theia/matching/feature_matcher.h"
+#include "theia/matching/image_pair_match.h"
+#include "theia/matching/in_memory_features_and_matches_database.h"
+#include "theia/matching/keypoints_and_descriptors.h"
+#include "theia/matching/quantized_brute_force_feature_matcher.h"
+#include "theia/util/random.h"
+
+#include "gtest/gtest.h"
+
+namespace theia {
+
+using Eigen::VectorXf;
+
+static const int kNumDescriptors = 10;
+static const int kNumDescriptorDimensions = 10;
+
+TEST(QuantizedBruteForceFeatureMatcherTest, NoOptions) {
+  // Set up descriptors.
+  KeypointsAndDescriptors features1, features2;
+  features1.descriptors.resize(kNumDescriptors);
+  features2.descriptors.resize(kNumDescriptors);
+  for (int i = 0; i < kNumDescriptors; i++) {
+    // Avoid a zero vector.
+    features1.descriptors[i] = VectorXf::Constant(kNumDescriptorDimensions, 1);
+    features2.descriptors[i] = VectorXf::Constant(kNumDescriptorDimensions, 1);
+    features1.descriptors[i].normalize();
+    features2.descriptors[i].normalize();
+  }
+
+  // Set options.
+  FeatureMatcherOptions options;
+  options.min_num_feature_matches = 0;
+  options.keep_only_symmetric_matches = false;
+  options.use_lowes_ratio = false;
+  options.perform_geometric_verification = false;
+
+  // Add features.
+  features1.keypoints.resize(features1.descriptors.size());
+  features2.keypoints.resize(features2.descriptors.size());
+  InMemoryFeaturesAndMatchesDatabase database;
+  database.PutFeatures("1", features1);
+  database.PutFeatures("2", features2);
+
+  QuantizedBruteForceFeatureMatcher matcher(options, &database);
+  matcher.AddImage("1");
+  matcher.AddImage("2");
+
+  // Match features
+  matcher.MatchImages();
+
+  // Check that the results are valid.
+  EXPECT_GT(database.NumMatches(), 0);
+}
+
+TEST(QuantizedBruteForceFeatureMatcherTest, RatioTest) {
+  // Set up descriptors.
+  KeypointsAndDescriptors features1, features2;
+  features1.descriptors.resize(1);
+  features2.descriptors.resize(2);
+
+  features1.descriptors[0] =
+      VectorXf::Constant(kNumDescriptorDimensions, 1).normalized();
+
+  // Set the two descriptors to be very close to each other so that they do not
+  // pass the ratio test.
+  features2.descriptors[0] = VectorXf::Constant(kNumDescriptorDimensions, 1);
+  features2.descriptors[0](0) = 0.9;
+  features2.descriptors[0].normalize();
+  features2.descriptors[1] = VectorXf::Constant(kNumDescriptorDimensions, 1);
+  features2.descriptors[1](0) = 0.89;
+  features2.descriptors[1].normalize();
+
+  // Set options.
+  FeatureMatcherOptions options;
+  options.min_num_feature_matches = 0;
+  options.keep_only_symmetric_matches = false;
+  options.use_lowes_ratio = true;
+  options.perform_geometric_verification = false;
+
+  // Add features.
+  features1.keypoints.resize(features1.descriptors.size());
+  features2.keypoints.resize(features2.descriptors.size());
+
+  InMemoryFeaturesAndMatchesDatabase database;
+  database.PutFeatures("1", features1);
+  database.PutFeatures("2", features2);
+
+  QuantizedBruteForceFeatureMatcher matcher(options, &database);
+  matcher.AddImage("1");
+  matcher.AddImage("2");
+
+  // Match features.
+  matcher.MatchImages();
+
+  // Check that the results are valid.
+  EXPECT_GT(database.NumMatches(), 0);
+}
+
+TEST(QuantizedBruteForceFeatureMatcherTest, SymmetricMatches) {
+  // Set up descriptors.
+  KeypointsAndDescriptors features1, features2;
+  features1.descriptors.resize(2);
+  features2.descriptors.resize(2);
+
+  features1.descriptors[0] =
+      VectorXf::Constant(kNumDescriptorDimensions, 1).normalized();
+  features1.descriptors[1] = VectorXf::Constant(kNumDescriptorDimensions, 0);
+  features1.descriptors[1](0) = 1.0;
+
+  // Set the two descriptors to be closer to features1.descriptors[0] so that
+  // the symmetric matching produces only 1 match.
+  features2.descriptors[0] = VectorXf::Constant(kNumDescriptorDimensions, 1);
+  features2.descriptors[0](0) = 0;
+  features2.descriptors[0].normalize();
+  features2.descriptors[1] = VectorXf::Constant(kNumDescriptorDimensions, 1);
+  features2.descriptors[1](1) = 0;
+  features2.descriptors[1](2) = 0;
+  features2.descriptors[1].normalize();
+
+  // Set options.
+  FeatureMatcherOptions options;
+  options.min_num_feature_matches = 0;
+  options.keep_only_symmetric_matches = true;
+  options.use_lowes_ratio = false;
+  options.perform_geometric_verification = false;
+
+  // Add features.
+  features1.keypoints.resize(features1.descriptors.size());
+  features2.keypoints.resize(features2.descriptors.size());
+
+  InMemoryFeaturesAndMatchesDatabase database;
+  database.PutFeatures("1", features1);
+  database.PutFeatures("2", features2);
+
+  QuantizedBruteForceFeatureMatcher matcher(options, &database);
+  matcher.AddImage("1");
+  matcher.AddImage("2");
+
+  // Match features.
+  matcher.MatchImages();
+
+  // Check that the results are valid.
+  EXPECT_EQ(database.NumMatches(), 1);
+}
+
+// The quantized matcher should produce (nearly) the same matches as the brute
+// force matcher on float descriptors.
+TEST(QuantizedBruteForceFeatureMatcherTest, MatchesFloatBruteForce) {
+  static const int kNumFeatures = 500;
+  static const int kDimension = 128;
+  static const float kNoise = 0.05;
+  static const float kMinFractionOfSameMatches = 0.99;
+
+  // Create SIFT-like descriptors with noisy copies in the second image.
+  RandomNumberGenerator rng(53);
+  KeypointsAndDescriptors features1, features2;
+  features1.descriptors.resize(kNumFeatures);
+  features2.descriptors.resize(kNumFeatures);
+  for (int i = 0; i < kNumFeatures; i++) {
+    features1.descriptors[i].resize(kDimension);
+    features2.descriptors[i].resize(kDimension);
+    for (int j = 0; j < kDimension; j++) {
+      features1.descriptors[i][j] = rng.RandFloat(0.0f, 1.0f);
+      features2.descriptors[i][j] = std::max(
+          0.0f, features1.descriptors[i][j] + rng.RandFloat(-kNoise, kNoise));
+    }
+    features1.descriptors[i].normalize();
+    features2.descriptors[i].normalize();
+  }
+  features1.keypoints.resize(features1.descriptors.size());
+  features2.keypoints.resize(features2.descriptors.size());
+
+  FeatureMatcherOptions options;
+  options.min_num_feature_matches = 0;
+  options.keep_only_symmetric_matches = true;
+  options.use_lowes_ratio = true;
+  options.perform_geometric_verification = false;
+
+  InMemoryFeaturesAndMatchesDatabase float_database, quantized_database;
+  float_database.PutFeatures("1", features1);
+  float_database.PutFeatures("2", features2);
+  quantized_database.PutFeatures("1", features1);
+  quantized_database.PutFeatures("2", features2);
+
+  BruteForceFeatureMatcher float_matcher(options, &float_database);
+  float_matcher.AddImage("1");
+  float_matcher.AddImage("2");
+  float_matcher.MatchImages();
+
+  QuantizedBruteForceFeatureMatcher quantized_matcher(options,
+                                                      &quantized_database);
+  quantized_matcher.AddImage("1");
+  quantized_matcher.AddImage("2");
+  quantized_matcher.MatchImages();
+
+  ASSERT_EQ(float_database.NumMatches(), 1);
+  ASSERT_EQ(quantized_database.NumMatches(), 1);
+  const ImagePairMatch float_matches =
+      float_database.GetImagePairMatch("1", "2");
+  const ImagePairMatch quantized_matches =
+      quantized_database.GetImagePairMatch("1", "2");
+  EXPECT_GT(float_matches.correspondences.size(),
+            kMinFractionOfSameMatches * kNumFeatures);
+
+  int num_same_matches = 0;
+  for (const FeatureCorrespondence& correspondence :
+       quantized_matches.correspondences) {
+    if (std::find(float_matches.correspondences.begin(),
+                  float_matches.correspondences.end(),
+                  correspondence) != float_matches.correspondences.end()) {
+      ++num_same_matches;
+    }
+  }
+  EXPECT_GT(num_same_matches,
+            kMinFractionOfSameMatches * float_matches.correspondences.size());
+}
+
+
+// Images whose features carry their name use the cached quantized descriptors,
+// which must give the same matches as quantizing the descriptors directly.
+TEST(QuantizedBruteForceFeatureMatcherTest, CachedQuantizedDescriptors) {
+  static const int kNumImages = 4;
+  static const int kNumFeatures = 200;
+  static const int kDimension = 128;
+  static const float kNoise = 0.05;
+
+  RandomNumberGenerator rng(59);
+  std::vector<Eigen::VectorXf> base_descriptors(kNumFeatures);
+  for (int i = 0; i < kNumFeatures; i++) {
+    base_descriptors[i].resize(kDimension);
+    for (int j = 0; j < kDimension; j++) {
+      base_descriptors[i][j] = rng.RandFloat(0.0f, 1.0f);
+    }
+  }
+
+  FeatureMatcherOptions options;
+  options.min_num_feature_matches = 0;
+  options.keep_only_symmetric_matches = true;
+  options.use_lowes_ratio = true;
+  options.perform_geometric_verification = false;
+
+  InMemoryFeaturesAndMatchesDatabase named_database, unnamed_database;
+  QuantizedBruteForceFeatureMatcher named_matcher(options, &named_database);
+  QuantizedBruteForceFeatureMatcher unnamed_matcher(options,
+                                                    &unnamed_database);
+  for (int i = 0; i < kNumImages; i++) {
+    const std::string image_name = std::to_string(i);
+    KeypointsAndDescriptors features;
+    features.descriptors.resize(kNumFeatures);
+    for (int j = 0; j < kNumFeatures; j++) {
+      features.descriptors[j] = base_descriptors[j];
+      for (int k = 0; k < kDimension; k++) {
+        features.descriptors[j][k] = std::max(
+            0.0f, features.descriptors[j][k] + rng.RandFloat(-kNoise, kNoise));
+      }
+      features.descriptors[j].normalize();
+    }
+    features.keypoints.resize(kNumFeatures);
+    unnamed_database.PutFeatures(image_name, features);
+    features.image_name = image_name;
+    named_database.PutFeatures(image_name, features);
+
+    named_matcher.AddImage(image_name);
+    unnamed_matcher.AddImage(image_name);
+  }
+  named_matcher.MatchImages();
+  unnamed_matcher.MatchImages();
+
+  ASSERT_EQ(named_database.NumMatches(), kNumImages * (kNumImages - 1) / 2);
+  ASSERT_EQ(unnamed_database.NumMatches(), named_database.NumMatches());
+  for (const auto& image_pair : named_database.ImageNamesOfMatches()) {
+    const ImagePairMatch named_matches = named_database.GetImagePairMatch(
+        image_pair.first, image_pair.second);
+    const ImagePairMatch unnamed_matches = unnamed_database.GetImagePairMatch(
+        image_pair.first, image_pair.second);
+    EXPECT_GT(named_matches.correspondences.size(), 0);
+    EXPECT_EQ(named_matches.correspondences, unnamed_matches.correspondences);
+  }
+}
+
+}  // namespace theia
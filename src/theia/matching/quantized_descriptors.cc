@@ -0,0 +1,173 @@
+// Copyright (C) 2026 The Regents of the University of California (Regents).
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials provided
+//       with the distribution.
+//
+//     * Neither the name of The Regents or University of California nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+// Please contact the author of this library if you have any questions.
+// Author: agent (agent@local)
+
+#include "theia/matching/quantized_descriptors.h"
+
+#include <Eigen/Core>
+#include <glog/logging.h>
+#include <stdint.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#include "theia/matching/distance_kernels.h"
+#include "theia/matching/indexed_feature_match.h"
+
+namespace theia {
+
+namespace {
+
+// The database is processed in blocks of roughly this size so that each block
+// stays in the L2 cache while all query descriptors are compared against it.
+static const int kDatabaseBlockSizeInBytes = 128 * 1024;
+
+}  // namespace
+
+void QuantizeDescriptors(const std::vector<Eigen::VectorXf>& descriptors,
+                         QuantizedDescriptors* quantized_descriptors) {
+  CHECK_NOTNULL(quantized_descriptors);
+  const int num_descriptors = descriptors.size();
+  const int dimension = descriptors.empty() ? 0 : descriptors[0].size();
+  const int padded_dimension =
+      kQuantizedDescriptorAlignment *
+      ((dimension + kQuantizedDescriptorAlignment - 1) /
+       kQuantizedDescriptorAlignment);
+
+  quantized_descriptors->dimension = dimension;
+  quantized_descriptors->padded_dimension = padded_dimension;
+  quantized_descriptors->values.assign(num_descriptors * padded_dimension, 0);
+  quantized_descriptors->scales.resize(num_descriptors);
+  quantized_descriptors->squared_norms.resize(num_descriptors);
+  quantized_descriptors->sums.resize(num_descriptors);
+
+  for (int i = 0; i < num_descriptors; i++) {
+    const Eigen::VectorXf& descriptor = descriptors[i];
+    CHECK_EQ(descriptor.size(), dimension)
+        << "All descriptors must have the same dimension.";
+
+    const float max_abs_value =
+        dimension > 0 ? descriptor.cwiseAbs().maxCoeff() : 0.0f;
+    const float scale = max_abs_value > 0.0f ? max_abs_value / 127.0f : 1.0f;
+
+    int8_t* quantized_descriptor =
+        quantized_descriptors->values.data() + i * padded_dimension;
+    int32_t squared_norm = 0;
+    int32_t sum = 0;
+    for (int j = 0; j < dimension; j++) {
+      const int value = std::max(
+          -127, std::min(127, static_cast<int>(std::lround(descriptor[j] /
+                                                           scale))));
+      quantized_descriptor[j] = static_cast<int8_t>(value);
+      squared_norm += value * value;
+      sum += value;
+    }
+
+    quantized_descriptors->scales[i] = scale;
+    quantized_descriptors->squared_norms[i] = scale * scale * squared_norm;
+    quantized_descriptors->sums[i] = sum;
+  }
+}
+
+int32_t QuantizedDotProduct(const int8_t* descriptor1,
+                            const int8_t* descriptor2,
+                            const int32_t descriptor2_sum,
+                            const int padded_dimension) {
+  DCHECK_EQ(padded_dimension % kQuantizedDescriptorAlignment, 0);
+  return GetDescriptorDistanceKernels().int8_dot_product(
+      descriptor1, descriptor2, descriptor2_sum, padded_dimension);
+}
+
+void FindTwoNearestQuantizedNeighbors(
+    const QuantizedDescriptors& query,
+    const QuantizedDescriptors& database,
+    std::vector<IndexedFeatureMatch>* nearest_neighbors,
+    std::vector<float>* second_nearest_distances) {
+  CHECK_NOTNULL(nearest_neighbors);
+  CHECK_NOTNULL(second_nearest_distances);
+  const int num_queries = query.NumDescriptors();
+  const int num_database_descriptors = database.NumDescriptors();
+
+  nearest_neighbors->resize(num_queries);
+  for (int i = 0; i < num_queries; i++) {
+    (*nearest_neighbors)[i] =
+        IndexedFeatureMatch(i, -1, std::numeric_limits<float>::max());
+  }
+  second_nearest_distances->assign(num_queries,
+                                   std::numeric_limits<float>::max());
+  if (num_queries == 0 || num_database_descriptors == 0) {
+    return;
+  }
+  CHECK_EQ(query.dimension, database.dimension);
+
+  const int padded_dimension = database.padded_dimension;
+  const auto int8_dot_product = GetDescriptorDistanceKernels().int8_dot_product;
+  const int block_size =
+      std::max(1, kDatabaseBlockSizeInBytes / std::max(1, padded_dimension));
+  for (int block_start = 0; block_start < num_database_descriptors;
+       block_start += block_size) {
+    const int block_end =
+        std::min(block_start + block_size, num_database_descriptors);
+    for (int i = 0; i < num_queries; i++) {
+      const int8_t* query_descriptor = query.Descriptor(i);
+      const float query_scale = 2.0f * query.scales[i];
+      const float query_squared_norm = query.squared_norms[i];
+      IndexedFeatureMatch& nearest_neighbor = (*nearest_neighbors)[i];
+      float& second_nearest_distance = (*second_nearest_distances)[i];
+
+      for (int j = block_start; j < block_end; j++) {
+        const int32_t dot_product = int8_dot_product(query_descriptor,
+                                                     database.Descriptor(j),
+                                                     database.sums[j],
+                                                     padded_dimension);
+        // ||x - y||^2 = ||x||^2 + ||y||^2 - 2 * x.dot(y).
+        const float distance = std::max(
+            0.0f,
+            query_squared_norm + database.squared_norms[j] -
+                query_scale * database.scales[j] * dot_product);
+
+        if (distance < nearest_neighbor.distance) {
+          second_nearest_distance = nearest_neighbor.distance;
+          nearest_neighbor.feature2_ind = j;
+          nearest_neighbor.distance = distance;
+        } else if (distance < second_nearest_distance) {
+          second_nearest_distance = distance;
+        }
+      }
+    }
+  }
+}
+
+}  // namespace theia
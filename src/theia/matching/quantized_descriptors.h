@@ -0,0 +1,104 @@
+// Copyright (C) 2026 The Regents of the University of California (Regents).
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials provided
+//       with the distribution.
+//
+//     * Neither the name of The Regents or University of California nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+// Please contact the author of this library if you have any questions.
+// Author: agent (agent@local)
+
+#ifndef THEIA_MATCHING_QUANTIZED_DESCRIPTORS_H_
+#define THEIA_MATCHING_QUANTIZED_DESCRIPTORS_H_
+
+#include <Eigen/Core>
+#include <stdint.h>
+#include <vector>
+
+namespace theia {
+
+struct IndexedFeatureMatch;
+
+// A set of float descriptors quantized to signed 8-bit integers. Each
+// descriptor is scaled so that its largest absolute value maps to 127, which
+// preserves the precision of descriptors such as SIFT whose entries are small
+// after normalization. Descriptors are stored contiguously and zero-padded to a
+// multiple of kQuantizedDescriptorAlignment values so that the distance kernels
+// can process full vector registers.
+struct QuantizedDescriptors {
+  QuantizedDescriptors() : dimension(0), padded_dimension(0) {}
+
+  int NumDescriptors() const { return scales.size(); }
+  const int8_t* Descriptor(const int i) const {
+    return values.data() + i * padded_dimension;
+  }
+
+  // The dimension of the original descriptors.
+  int dimension;
+  // The number of values stored for each descriptor.
+  int padded_dimension;
+
+  // The quantized values of all descriptors.
+  std::vector<int8_t> values;
+  // Multiplying the quantized values by the scale recovers the descriptor.
+  std::vector<float> scales;
+  // The squared norm of each dequantized descriptor.
+  std::vector<float> squared_norms;
+  // The sum of the quantized values of each descriptor. This is needed by
+  // dot product instructions that multiply unsigned by signed bytes.
+  std::vector<int32_t> sums;
+};
+
+static const int kQuantizedDescriptorAlignment = 64;
+
+// Quantizes the descriptors. All descriptors must have the same dimension.
+void QuantizeDescriptors(const std::vector<Eigen::VectorXf>& descriptors,
+                         QuantizedDescriptors* quantized_descriptors);
+
+// Returns the dot product of two quantized descriptors with padded_dimension
+// values. The sum of the values of descriptor2 must be given.
+int32_t QuantizedDotProduct(const int8_t* descriptor1,
+                            const int8_t* descriptor2,
+                            const int32_t descriptor2_sum,
+                            const int padded_dimension);
+
+// Finds the nearest and second nearest database descriptor for each query
+// descriptor with a brute force search. The database is processed in blocks
+// that fit into the cache so that each block is only loaded once for all
+// queries. The squared L2 distance of the dequantized descriptors is used, so
+// the results closely match those of the L2 distance on the float descriptors.
+// If the database contains fewer than two descriptors the second nearest
+// distance is std::numeric_limits<float>::max().
+void FindTwoNearestQuantizedNeighbors(
+    const QuantizedDescriptors& query,
+    const QuantizedDescriptors& database,
+    std::vector<IndexedFeatureMatch>* nearest_neighbors,
+    std::vector<float>* second_nearest_distances);
+
+}  // namespace theia
+
+#endif  // THEIA_MATCHING_QUANTIZED_DESCRIPTORS_H_
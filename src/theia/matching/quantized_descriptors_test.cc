@@ -0,0 +1,177 @@
+// Copyright (C) 2026 The Regents of the University of California (Regents).
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials provided
+//       with the distribution.
+//
+//     * Neither the name of The Regents or University of California nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+// Please contact the author of this library if you have any questions.
+// Author: agent (agent@local)
+
+#include <Eigen/Core>
+#include <stdint.h>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "theia/matching/distance.h"
+#include "theia/matching/indexed_feature_match.h"
+#include "theia/matching/quantized_descriptors.h"
+#include "theia/util/random.h"
+
+namespace theia {
+
+using Eigen::VectorXf;
+
+namespace {
+
+RandomNumberGenerator rng(52);
+
+// Creates non-negative unit norm descriptors similar to SIFT descriptors.
+std::vector<VectorXf> RandomDescriptors(const int num_descriptors,
+                                        const int dimension) {
+  std::vector<VectorXf> descriptors(num_descriptors);
+  for (int i = 0; i < num_descriptors; i++) {
+    descriptors[i].resize(dimension);
+    for (int j = 0; j < dimension; j++) {
+      descriptors[i][j] = rng.RandFloat(0.0f, 1.0f);
+    }
+    descriptors[i].normalize();
+  }
+  return descriptors;
+}
+
+}  // namespace
+
+TEST(QuantizedDescriptors, Quantization) {
+  static const int kNumDescriptors = 20;
+  static const int kDimension = 100;
+  const std::vector<VectorXf> descriptors =
+      RandomDescriptors(kNumDescriptors, kDimension);
+
+  QuantizedDescriptors quantized;
+  QuantizeDescriptors(descriptors, &quantized);
+  EXPECT_EQ(quantized.NumDescriptors(), kNumDescriptors);
+  EXPECT_EQ(quantized.dimension, kDimension);
+  EXPECT_EQ(quantized.padded_dimension % kQuantizedDescriptorAlignment, 0);
+  EXPECT_GE(quantized.padded_dimension, kDimension);
+
+  for (int i = 0; i < kNumDescriptors; i++) {
+    const int8_t* values = quantized.Descriptor(i);
+    int32_t sum = 0;
+    for (int j = 0; j < kDimension; j++) {
+      // The rounding error is at most half of the quantization step.
+      EXPECT_LE(std::abs(values[j] * quantized.scales[i] - descriptors[i][j]),
+                0.5f * quantized.scales[i] + 1e-6f);
+      sum += values[j];
+    }
+    for (int j = kDimension; j < quantized.padded_dimension; j++) {
+      EXPECT_EQ(values[j], 0);
+    }
+    EXPECT_EQ(quantized.sums[i], sum);
+    EXPECT_NEAR(quantized.squared_norms[i], 1.0, 1e-2);
+  }
+}
+
+TEST(QuantizedDescriptors, DotProduct) {
+  for (const int dimension : {7, 64, 128, 200}) {
+    // Use descriptors with negative values to exercise the full int8 range.
+    std::vector<VectorXf> descriptors(2);
+    for (VectorXf& descriptor : descriptors) {
+      descriptor.resize(dimension);
+      rng.SetRandom(&descriptor);
+    }
+
+    QuantizedDescriptors quantized;
+    QuantizeDescriptors(descriptors, &quantized);
+    int32_t expected_dot_product = 0;
+    for (int i = 0; i < dimension; i++) {
+      expected_dot_product +=
+          quantized.Descriptor(0)[i] * quantized.Descriptor(1)[i];
+    }
+    EXPECT_EQ(QuantizedDotProduct(quantized.Descriptor(0),
+                                  quantized.Descriptor(1),
+                                  quantized.sums[1],
+                                  quantized.padded_dimension),
+              expected_dot_product);
+  }
+}
+
+// The nearest neighbors should agree with a brute force search on the float
+// descriptors.
+TEST(QuantizedDescriptors, TwoNearestNeighbors) {
+  static const int kNumDatabaseDescriptors = 2000;
+  static const int kNumQueryDescriptors = 200;
+  static const int kDimension = 128;
+  static const float kNoise = 0.02;
+
+  const std::vector<VectorXf> database =
+      RandomDescriptors(kNumDatabaseDescriptors, kDimension);
+  std::vector<VectorXf> queries(kNumQueryDescriptors);
+  for (int i = 0; i < kNumQueryDescriptors; i++) {
+    VectorXf noise(kDimension);
+    rng.SetRandom(&noise);
+    queries[i] = (database[5 * i] + kNoise * noise).normalized();
+  }
+
+  QuantizedDescriptors quantized_database, quantized_queries;
+  QuantizeDescriptors(database, &quantized_database);
+  QuantizeDescriptors(queries, &quantized_queries);
+
+  std::vector<IndexedFeatureMatch> nearest_neighbors;
+  std::vector<float> second_nearest_distances;
+  FindTwoNearestQuantizedNeighbors(quantized_queries,
+                                   quantized_database,
+                                   &nearest_neighbors,
+                                   &second_nearest_distances);
+  ASSERT_EQ(nearest_neighbors.size(), kNumQueryDescriptors);
+  ASSERT_EQ(second_nearest_distances.size(), kNumQueryDescriptors);
+
+  L2 distance;
+  for (int i = 0; i < kNumQueryDescriptors; i++) {
+    float nearest_distance = std::numeric_limits<float>::max();
+    float second_nearest_distance = std::numeric_limits<float>::max();
+    for (int j = 0; j < kNumDatabaseDescriptors; j++) {
+      const float dist = distance(queries[i], database[j]);
+      if (dist < nearest_distance) {
+        second_nearest_distance = nearest_distance;
+        nearest_distance = dist;
+      } else if (dist < second_nearest_distance) {
+        second_nearest_distance = dist;
+      }
+    }
+
+    EXPECT_EQ(nearest_neighbors[i].feature1_ind, i);
+    EXPECT_EQ(nearest_neighbors[i].feature2_ind, 5 * i);
+    EXPECT_NEAR(nearest_neighbors[i].distance, nearest_distance, 2e-3);
+    EXPECT_NEAR(second_nearest_distances[i], second_nearest_distance, 2e-3);
+  }
+}
+
+}  // namespace theia
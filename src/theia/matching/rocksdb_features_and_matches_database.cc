@@ -34,12 +34,16 @@
 
 #include "theia/matching/rocksdb_features_and_matches_database.h"
 
+#include <algorithm>
+#include <cstdio>
 #include <cstdlib>
 #include <glog/logging.h>
 #include <istream>
+#include <memory>
 #include <mutex>
 #include <streambuf>
 #include <string>
+#include <unordered_map>
 
 #include <cereal/archives/portable_binary.hpp>
 #include <cereal/types/string.hpp>
@@ -48,6 +52,8 @@
 #include <cereal/types/vector.hpp>
 #include <rocksdb/db.h>
 #include <rocksdb/filter_policy.h>
+#include <rocksdb/options.h>
+#include <rocksdb/sst_file_writer.h>
 #include <rocksdb/table.h>
 
 #include "theia/matching/image_pair_match.h"
@@ -66,6 +72,13 @@ static const std::string kMatchesColumnFamilyName = "image_pair_matches";
 static const std::string kIntrinsicsColumnFamilyName =
     "camera_intrinsics_prior";
 static const std::string kNamePairSeparator = "/";
+static const std::string kBulkIngestionDirectoryName = "bulk_ingestion";
+
+// The number of level-0 files that triggers write slowdowns and stops while
+// bulk ingestion is active. Batches typically span the full key range, so
+// later batches land in level 0 and should not stall the ingestion.
+static const int kBulkIngestionLevel0SlowdownWritesTrigger = 1 << 16;
+static const int kBulkIngestionLevel0StopWritesTrigger = 1 << 17;
 
 // For serialization using the Cereal library we must provide a stream for the
 // data. This struct allows for the results from RocksDB to be directly consumed
@@ -96,11 +109,43 @@ StringPair DecomposeImageNamePair(const std::string& image_pair) {
   return std::make_pair(image_pair.substr(0, delimiter_index),
                         image_pair.substr(delimiter_index + 1));
 }
+
+std::string SerializeFeatures(const KeypointsAndDescriptors& features) {
+  std::stringstream ss;
+  {
+    cereal::PortableBinaryOutputArchive output_archive(ss);
+    output_archive(
+        features.image_name, features.keypoints, features.descriptors);
+  }
+  return ss.str();
+}
+
+KeypointsAndDescriptors DeserializeFeatures(const char* data,
+                                            const size_t size) {
+  // Create a stream wrapped around the serialized data.
+  ZeroCopyBuffer buffer(data, size);
+  std::istream ins(&buffer);
+
+  // Load the keypoints and descriptors.
+  KeypointsAndDescriptors features;
+  {
+    cereal::PortableBinaryInputArchive input_archive(ins);
+    input_archive(
+        features.image_name, features.keypoints, features.descriptors);
+  }
+  return features;
+}
 }  // namespace
 
 RocksDbFeaturesAndMatchesDatabase::RocksDbFeaturesAndMatchesDatabase(
-    const std::string& directory)
-    : directory_(directory) {
+    const std::string& directory,
+    const size_t max_bulk_ingestion_batch_size_in_bytes)
+    : directory_(directory),
+      max_bulk_ingestion_batch_size_in_bytes_(
+          max_bulk_ingestion_batch_size_in_bytes),
+      bulk_ingestion_active_(false),
+      pending_batch_size_in_bytes_(0),
+      num_ingested_batches_(0) {
   AppendTrailingSlashIfNeeded(&directory_);
   InitializeRocksDB();
 }
@@ -187,7 +232,10 @@ void RocksDbFeaturesAndMatchesDatabase::InitializeRocksDB() {
   }
 }
 
-RocksDbFeaturesAndMatchesDatabase::~RocksDbFeaturesAndMatchesDatabase() {}
+RocksDbFeaturesAndMatchesDatabase::~RocksDbFeaturesAndMatchesDatabase() {
+  // Make sure that no buffered features are lost.
+  EndBulkFeatureIngestion();
+}
 
 bool RocksDbFeaturesAndMatchesDatabase::ContainsCameraIntrinsicsPrior(
     const std::string& image_name) {
@@ -266,6 +314,11 @@ size_t RocksDbFeaturesAndMatchesDatabase::NumCameraIntrinsicsPrior() {
 
 bool RocksDbFeaturesAndMatchesDatabase::ContainsFeatures(
     const std::string& image_name) {
+  std::string serialized_features;
+  if (GetPendingFeatures(image_name, &serialized_features)) {
+    return true;
+  }
+
   rocksdb::ReadOptions options;
   const rocksdb::Slice key(image_name);
   rocksdb::PinnableSlice value;
@@ -277,6 +330,12 @@ bool RocksDbFeaturesAndMatchesDatabase::ContainsFeatures(
 // Get/set the features for the image.
 KeypointsAndDescriptors RocksDbFeaturesAndMatchesDatabase::GetFeatures(
     const std::string& image_name) {
+  std::string serialized_features;
+  if (GetPendingFeatures(image_name, &serialized_features)) {
+    return DeserializeFeatures(serialized_features.data(),
+                               serialized_features.size());
+  }
+
   rocksdb::ReadOptions options;
   const rocksdb::Slice key(image_name);
   rocksdb::PinnableSlice value;
@@ -284,53 +343,235 @@ KeypointsAndDescriptors RocksDbFeaturesAndMatchesDatabase::GetFeatures(
       database_->Get(options, features_handle_.get(), key, &value);
   CHECK(!status.IsNotFound())
       << "Could not find features for " << image_name << " in the database.";
-
-  // Create a stream wrapped around the rocksdb value.
-  ZeroCopyBuffer buffer(value.data(), value.size());
-  std::istream ins(&buffer);
-
-  // Load the keypoints and descriptors.
-  KeypointsAndDescriptors features;
-  {
-    cereal::PortableBinaryInputArchive input_archive(ins);
-    input_archive(
-        features.image_name, features.keypoints, features.descriptors);
-  }
-  return features;
+  return DeserializeFeatures(value.data(), value.size());
 }
 
 // Set the features for the image.
 void RocksDbFeaturesAndMatchesDatabase::PutFeatures(
     const std::string& image_name, const KeypointsAndDescriptors& features) {
-  std::stringstream ss;
-  {
-    cereal::PortableBinaryOutputArchive output_archive(ss);
-    output_archive(
-        features.image_name, features.keypoints, features.descriptors);
+  std::string serialized_features = SerializeFeatures(features);
+
+  // Buffer the features if bulk ingestion is active. Once the buffer is full it
+  // is ingested by this thread while the other threads keep buffering
+  // features into a new batch.
+  if (bulk_ingestion_active_) {
+    std::shared_ptr<FeaturesBatch> batch_to_ingest;
+    int batch_index = 0;
+    {
+      std::lock_guard<std::mutex> lock(bulk_ingestion_mutex_);
+      if (bulk_ingestion_active_) {
+        pending_batch_size_in_bytes_ +=
+            image_name.size() + serialized_features.size();
+        (*pending_batch_)[image_name] = std::move(serialized_features);
+        if (pending_batch_size_in_bytes_ <
+            max_bulk_ingestion_batch_size_in_bytes_) {
+          return;
+        }
+
+        batch_to_ingest = pending_batch_;
+        batch_index = num_ingested_batches_++;
+        ingesting_batches_.emplace_back(batch_to_ingest);
+        pending_batch_ = std::make_shared<FeaturesBatch>();
+        pending_batch_size_in_bytes_ = 0;
+      }
+    }
+
+    if (batch_to_ingest != nullptr) {
+      IngestFeaturesBatch(*batch_to_ingest, batch_index);
+
+      // The features are now in the database so the batch may be released.
+      std::lock_guard<std::mutex> lock(bulk_ingestion_mutex_);
+      ingesting_batches_.erase(std::find(ingesting_batches_.begin(),
+                                         ingesting_batches_.end(),
+                                         batch_to_ingest));
+      return;
+    }
   }
 
   rocksdb::WriteOptions options;
   const rocksdb::Slice key(image_name);
   const rocksdb::Status status =
-      database_->Put(options, features_handle_.get(), key, ss.str());
+      database_->Put(options, features_handle_.get(), key, serialized_features);
   CHECK(status.ok()) << "Could not insert features for " << image_name
                      << " into the database.";
 }
 
+void RocksDbFeaturesAndMatchesDatabase::BeginBulkFeatureIngestion() {
+  std::lock_guard<std::mutex> lock(bulk_ingestion_mutex_);
+  if (bulk_ingestion_active_) {
+    return;
+  }
+
+  const std::string bulk_ingestion_directory =
+      directory_ + kBulkIngestionDirectoryName;
+  if (!DirectoryExists(bulk_ingestion_directory)) {
+    CHECK(CreateNewDirectory(bulk_ingestion_directory))
+        << "Could not create the directory " << bulk_ingestion_directory;
+  }
+
+  // Avoid compactions and write stalls while the features are ingested. The
+  // features are compacted once when the bulk ingestion ends.
+  const std::unordered_map<std::string, std::string> bulk_ingestion_options = {
+      {"disable_auto_compactions", "true"},
+      {"level0_slowdown_writes_trigger",
+       std::to_string(kBulkIngestionLevel0SlowdownWritesTrigger)},
+      {"level0_stop_writes_trigger",
+       std::to_string(kBulkIngestionLevel0StopWritesTrigger)}};
+  const rocksdb::Status status =
+      database_->SetOptions(features_handle_.get(), bulk_ingestion_options);
+  CHECK(status.ok()) << "Could not disable compactions for bulk ingestion: "
+                     << status.ToString();
+
+  pending_batch_ = std::make_shared<FeaturesBatch>();
+  pending_batch_size_in_bytes_ = 0;
+  bulk_ingestion_active_ = true;
+}
+
+void RocksDbFeaturesAndMatchesDatabase::EndBulkFeatureIngestion() {
+  std::lock_guard<std::mutex> lock(bulk_ingestion_mutex_);
+  if (!bulk_ingestion_active_) {
+    return;
+  }
+  CHECK(ingesting_batches_.empty())
+      << "Bulk ingestion ended while features were still being added.";
+
+  // Ingest the remaining features.
+  if (!pending_batch_->empty()) {
+    IngestFeaturesBatch(*pending_batch_, num_ingested_batches_++);
+  }
+  pending_batch_.reset();
+  pending_batch_size_in_bytes_ = 0;
+  bulk_ingestion_active_ = false;
+
+  // Restore the options the column family was opened with and compact the
+  // ingested files.
+  const std::unordered_map<std::string, std::string> default_options = {
+      {"disable_auto_compactions",
+       options_->disable_auto_compactions ? "true" : "false"},
+      {"level0_slowdown_writes_trigger",
+       std::to_string(options_->level0_slowdown_writes_trigger)},
+      {"level0_stop_writes_trigger",
+       std::to_string(options_->level0_stop_writes_trigger)}};
+  rocksdb::Status status =
+      database_->SetOptions(features_handle_.get(), default_options);
+  CHECK(status.ok()) << "Could not restore the options after bulk ingestion: "
+                     << status.ToString();
+
+  if (num_ingested_batches_ > 0) {
+    status = database_->CompactRange(rocksdb::CompactRangeOptions(),
+                                     features_handle_.get(),
+                                     nullptr,
+                                     nullptr);
+    CHECK(status.ok()) << "Could not compact the ingested features: "
+                       << status.ToString();
+  }
+  num_ingested_batches_ = 0;
+}
+
+bool RocksDbFeaturesAndMatchesDatabase::GetPendingFeatures(
+    const std::string& image_name, std::string* serialized_features) {
+  if (!bulk_ingestion_active_) {
+    return false;
+  }
+
+  std::lock_guard<std::mutex> lock(bulk_ingestion_mutex_);
+  if (pending_batch_ != nullptr) {
+    const auto it = pending_batch_->find(image_name);
+    if (it != pending_batch_->end()) {
+      *serialized_features = it->second;
+      return true;
+    }
+  }
+  for (const auto& batch : ingesting_batches_) {
+    const auto it = batch->find(image_name);
+    if (it != batch->end()) {
+      *serialized_features = it->second;
+      return true;
+    }
+  }
+  return false;
+}
+
+void RocksDbFeaturesAndMatchesDatabase::IngestFeaturesBatch(
+    const FeaturesBatch& batch, const int batch_index) {
+  const std::string sst_filepath = directory_ + kBulkIngestionDirectoryName +
+                                   "/features_" + std::to_string(batch_index) +
+                                   ".sst";
+
+  // Write the features to an SST file. The batch is sorted by image name so the
+  // keys are added in the order required by the writer.
+  rocksdb::SstFileWriter sst_file_writer(
+      rocksdb::EnvOptions(), *options_, features_handle_.get());
+  rocksdb::Status status = sst_file_writer.Open(sst_filepath);
+  CHECK(status.ok()) << "Could not open " << sst_filepath << ": "
+                     << status.ToString();
+  for (const auto& features : batch) {
+    status = sst_file_writer.Put(features.first, features.second);
+    CHECK(status.ok()) << "Could not write features for " << features.first
+                       << " to " << sst_filepath << ": " << status.ToString();
+  }
+  status = sst_file_writer.Finish();
+  CHECK(status.ok()) << "Could not write " << sst_filepath << ": "
+                     << status.ToString();
+
+  // Move the file into the database.
+  rocksdb::IngestExternalFileOptions ingestion_options;
+  ingestion_options.move_files = true;
+  status = database_->IngestExternalFile(
+      features_handle_.get(), {sst_filepath}, ingestion_options);
+  CHECK(status.ok()) << "Could not ingest " << sst_filepath << ": "
+                     << status.ToString();
+
+  // The file is hard linked into the database if possible, so the original
+  // link may still exist.
+  std::remove(sst_filepath.c_str());
+}
+
 std::vector<std::string>
 RocksDbFeaturesAndMatchesDatabase::ImageNamesOfFeatures() {
-  // Iterate over the features column family and grab the keys.
   std::vector<std::string> image_names;
-  auto it =
-      database_->NewIterator(rocksdb::ReadOptions(), features_handle_.get());
+
+  // Collect the buffered features before reading the database. A batch that is
+  // ingested in the meantime is then seen at least once and the duplicates are
+  // removed below.
+  const bool include_pending_features = bulk_ingestion_active_;
+  if (include_pending_features) {
+    std::lock_guard<std::mutex> lock(bulk_ingestion_mutex_);
+    if (pending_batch_ != nullptr) {
+      for (const auto& features : *pending_batch_) {
+        image_names.push_back(features.first);
+      }
+    }
+    for (const auto& batch : ingesting_batches_) {
+      for (const auto& features : *batch) {
+        image_names.push_back(features.first);
+      }
+    }
+  }
+
+  // Iterate over the features column family and grab the keys.
+  std::unique_ptr<rocksdb::Iterator> it(
+      database_->NewIterator(rocksdb::ReadOptions(), features_handle_.get()));
   for (it->SeekToFirst(); it->Valid(); it->Next()) {
     image_names.push_back(it->key().ToString());
   }
 
+  if (include_pending_features) {
+    std::sort(image_names.begin(), image_names.end());
+    image_names.erase(std::unique(image_names.begin(), image_names.end()),
+                      image_names.end());
+  }
   return image_names;
 }
 
 size_t RocksDbFeaturesAndMatchesDatabase::NumImages() {
+  // The key estimate of the database does not account for the buffered
+  // features, which may also overwrite existing keys, so the images are
+  // counted explicitly during bulk ingestion.
+  if (bulk_ingestion_active_) {
+    return ImageNamesOfFeatures().size();
+  }
+
   std::uint64_t num_images;
   database_->GetIntProperty(
       features_handle_.get(), "rocksdb.estimate-num-keys", &num_images);
@@ -364,6 +605,34 @@ ImagePairMatch RocksDbFeaturesAndMatchesDatabase::GetImagePairMatch(
   return matches;
 }
 
+TwoViewInfo RocksDbFeaturesAndMatchesDatabase::GetTwoViewInfo(
+    const std::string& image_name1, const std::string& image_name2) {
+  const std::string image_name_pair =
+      ComposeImageNamePair(image_name1, image_name2);
+
+  rocksdb::ReadOptions options;
+  const rocksdb::Slice key(image_name_pair);
+  rocksdb::PinnableSlice value;
+  const rocksdb::Status status =
+      database_->Get(options, matches_handle_.get(), key, &value);
+  CHECK(!status.IsNotFound()) << "Could not find the image pair match for ("
+                              << image_name1 << ", " << image_name2 << ")";
+
+  ZeroCopyBuffer buffer(value.data(), value.size());
+  std::istream ins(&buffer);
+
+  // ImagePairMatch serializes its class version, the image names and the two
+  // view info before the correspondences, so reading stops after these.
+  std::uint32_t version;
+  std::string image1, image2;
+  TwoViewInfo twoview_info;
+  {
+    cereal::PortableBinaryInputArchive input_archive(ins);
+    input_archive(version, image1, image2, twoview_info);
+  }
+  return twoview_info;
+}
+
 // Set the image pair match for the images.
 void RocksDbFeaturesAndMatchesDatabase::PutImagePairMatch(
     const std::string& image_name1,
@@ -35,6 +35,9 @@
 #ifndef THEIA_MATCHING_ROCKSDB_FEATURES_AND_MATCHES_DATABASE_H_
 #define THEIA_MATCHING_ROCKSDB_FEATURES_AND_MATCHES_DATABASE_H_
 
+#include <atomic>
+#include <map>
+#include <memory>
 #include <mutex>  // NOLINT
 #include <string>
 #include <unordered_map>
@@ -44,6 +47,7 @@
 #include "theia/matching/features_and_matches_database.h"
 #include "theia/matching/image_pair_match.h"
 #include "theia/matching/keypoints_and_descriptors.h"
+#include "theia/sfm/twoview_info.h"
 #include "theia/util/hash.h"
 #include "theia/util/lru_cache.h"
 #include "theia/util/util.h"
@@ -61,7 +65,12 @@ namespace theia {
 // matches are kept in memory. This class is guaranteed to be thread safe.
 class RocksDbFeaturesAndMatchesDatabase : public FeaturesAndMatchesDatabase {
  public:
-  explicit RocksDbFeaturesAndMatchesDatabase(const std::string& directory);
+  // During bulk ingestion, features are buffered until the batch reaches
+  // max_bulk_ingestion_batch_size_in_bytes (256 MB by default) and the batch is
+  // then ingested as a single SST file.
+  explicit RocksDbFeaturesAndMatchesDatabase(
+      const std::string& directory,
+      const size_t max_bulk_ingestion_batch_size_in_bytes = 256 << 20);
   ~RocksDbFeaturesAndMatchesDatabase();
 
   bool ContainsCameraIntrinsicsPrior(const std::string& image_name) override;
@@ -89,15 +98,29 @@ class RocksDbFeaturesAndMatchesDatabase : public FeaturesAndMatchesDatabase {
   void PutFeatures(const std::string& image_name,
                    const KeypointsAndDescriptors& features) override;
 
-  // Supply an iterator to iterate over the features.
+  // Supply an iterator to iterate over the features. Features that are
+  // buffered for bulk ingestion are included.
   std::vector<std::string> ImageNamesOfFeatures() override;
   size_t NumImages() override;
 
+  // While bulk ingestion is active, features are buffered in memory and
+  // written out in batches as sorted SST files that are ingested directly into
+  // the database. This bypasses the memtable and avoids the write stalls and
+  // compactions that individual writes would trigger. Automatic compaction of
+  // the features is disabled until EndBulkFeatureIngestion is called, which
+  // ingests the remaining features and compacts the features once.
+  void BeginBulkFeatureIngestion() override;
+  void EndBulkFeatureIngestion() override;
+
   // Get the image pair match for the images.Returns true if the features exist
   // in the database and false otherwise.
   ImagePairMatch GetImagePairMatch(const std::string& image_name1,
                                    const std::string& image_name2) override;
 
+  // Deserializes only the image names and two view info of the stored match.
+  TwoViewInfo GetTwoViewInfo(const std::string& image_name1,
+                             const std::string& image_name2) override;
+
   // Set the image pair match for the images.
   void PutImagePairMatch(const std::string& image_name1,
                          const std::string& image_name2,
@@ -114,12 +137,36 @@ class RocksDbFeaturesAndMatchesDatabase : public FeaturesAndMatchesDatabase {
 
   void InitializeRocksDB();
 
+  // Serialized features keyed by image name. The map keeps the keys sorted as
+  // required by the SST file writer.
+  typedef std::map<std::string, std::string> FeaturesBatch;
+
+  // Returns true and sets the serialized features if the image is waiting to
+  // be ingested into the database.
+  bool GetPendingFeatures(const std::string& image_name,
+                          std::string* serialized_features);
+
+  // Writes the batch to an SST file and ingests it into the features column
+  // family.
+  void IngestFeaturesBatch(const FeaturesBatch& batch, const int batch_index);
+
   std::unique_ptr<rocksdb::Options> options_;
   std::string directory_;
+  const size_t max_bulk_ingestion_batch_size_in_bytes_;
   std::unique_ptr<rocksdb::DB> database_;
   std::unique_ptr<rocksdb::ColumnFamilyHandle> intrinsics_prior_handle_;
   std::unique_ptr<rocksdb::ColumnFamilyHandle> features_handle_;
   std::unique_ptr<rocksdb::ColumnFamilyHandle> matches_handle_;
+
+  // Bulk ingestion state. Batches that are being written to disk are kept in
+  // ingesting_batches_ until they are part of the database so that the
+  // features remain retrievable.
+  std::atomic<bool> bulk_ingestion_active_;
+  std::mutex bulk_ingestion_mutex_;
+  std::shared_ptr<FeaturesBatch> pending_batch_;
+  size_t pending_batch_size_in_bytes_;
+  std::vector<std::shared_ptr<FeaturesBatch>> ingesting_batches_;
+  int num_ingested_batches_;
 };
 }  // namespace theia
 #endif  // THEIA_MATCHING_LOCAL_FEATURES_AND_MATCHES_DATABASE_H_
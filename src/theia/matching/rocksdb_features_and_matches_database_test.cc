@@ -4,6 +4,7 @@
 #include "theia/matching/image_pair_match.h"
 #include "theia/matching/keypoints_and_descriptors.h"
 #include "theia/matching/rocksdb_features_and_matches_database.h"
+#include "theia/util/threadpool.h"
 
 namespace theia {
 namespace {
@@ -150,11 +151,166 @@ TEST(RocksDbFeaturesAndMatchesDatabase, ImageNames) {
   rocksdb::DestroyDB(db_directory, rocksdb::Options());
 }
 
+TEST(RocksDbFeaturesAndMatchesDatabase, BulkFeatureIngestion) {
+  static const int kNumImages = 100;
+  static const int kNumFeatures = 100;
+  static const int kStringLength = 64;
+
+  std::vector<std::string> image_names;
+  std::vector<KeypointsAndDescriptors> features(kNumImages);
+  for (int i = 0; i < kNumImages; i++) {
+    image_names.emplace_back(RandomString(kStringLength));
+    features[i].image_name = image_names[i];
+    features[i].keypoints.resize(kNumFeatures);
+    features[i].descriptors.resize(kNumFeatures);
+    for (int j = 0; j < kNumFeatures; j++) {
+      features[i].keypoints[j] = Keypoint(i, j, Keypoint::OTHER);
+      features[i].descriptors[j].setRandom();
+    }
+  }
+
+  {
+    RocksDbFeaturesAndMatchesDatabase db(db_directory);
+    db.BeginBulkFeatureIngestion();
+    for (int i = 0; i < kNumImages; i++) {
+      db.PutFeatures(image_names[i], features[i]);
+    }
+
+    // The features must be available before they are ingested.
+    for (int i = 0; i < kNumImages; i++) {
+      EXPECT_TRUE(db.ContainsFeatures(image_names[i]));
+      const KeypointsAndDescriptors db_features =
+          db.GetFeatures(image_names[i]);
+      ASSERT_EQ(db_features.descriptors.size(), kNumFeatures);
+      EXPECT_EQ(db_features.descriptors[0], features[i].descriptors[0]);
+    }
+    db.EndBulkFeatureIngestion();
+  }
+
+  // Open the DB again and ensure that the ingested features were persisted.
+  RocksDbFeaturesAndMatchesDatabase db(db_directory);
+  std::vector<std::string> db_image_names = db.ImageNamesOfFeatures();
+  std::sort(image_names.begin(), image_names.end());
+  std::sort(db_image_names.begin(), db_image_names.end());
+  EXPECT_EQ(image_names, db_image_names);
+
+  for (int i = 0; i < kNumImages; i++) {
+    const KeypointsAndDescriptors db_features =
+        db.GetFeatures(features[i].image_name);
+    ASSERT_EQ(db_features.keypoints.size(), kNumFeatures);
+    ASSERT_EQ(db_features.descriptors.size(), kNumFeatures);
+    for (int j = 0; j < kNumFeatures; j++) {
+      EXPECT_EQ(db_features.keypoints[j].x(), features[i].keypoints[j].x());
+      EXPECT_EQ(db_features.keypoints[j].y(), features[i].keypoints[j].y());
+      EXPECT_EQ(db_features.descriptors[j], features[i].descriptors[j]);
+    }
+  }
+
+  rocksdb::DestroyDB(db_directory, rocksdb::Options());
+}
+
+TEST(RocksDbFeaturesAndMatchesDatabase, ConcurrentBulkFeatureIngestion) {
+  static const int kNumImages = 200;
+  static const int kNumFeatures = 100;
+  static const int kStringLength = 64;
+  static const int kNumThreads = 4;
+  // Small enough that the features are ingested in many batches.
+  static const size_t kMaxBatchSizeInBytes = 64 << 10;
+
+  std::vector<std::string> image_names;
+  std::vector<KeypointsAndDescriptors> features(kNumImages);
+  for (int i = 0; i < kNumImages; i++) {
+    image_names.emplace_back(RandomString(kStringLength));
+    features[i].image_name = image_names[i];
+    features[i].keypoints.resize(kNumFeatures);
+    features[i].descriptors.resize(kNumFeatures);
+    for (int j = 0; j < kNumFeatures; j++) {
+      features[i].keypoints[j] = Keypoint(i, j, Keypoint::OTHER);
+      features[i].descriptors[j].setRandom();
+    }
+  }
+  std::vector<std::string> sorted_image_names = image_names;
+  std::sort(sorted_image_names.begin(), sorted_image_names.end());
+
+  {
+    RocksDbFeaturesAndMatchesDatabase db(db_directory, kMaxBatchSizeInBytes);
+    db.BeginBulkFeatureIngestion();
+    {
+      ThreadPool pool(kNumThreads);
+      for (int i = 0; i < kNumImages; i++) {
+        pool.Add([&db, &image_names, &features, i]() {
+          db.PutFeatures(image_names[i], features[i]);
+        });
+      }
+    }
+
+    // Some of the features are ingested and the rest are still buffered. All
+    // of them must be listed exactly once.
+    std::vector<std::string> db_image_names = db.ImageNamesOfFeatures();
+    std::sort(db_image_names.begin(), db_image_names.end());
+    EXPECT_EQ(sorted_image_names, db_image_names);
+    EXPECT_EQ(db.NumImages(), kNumImages);
+
+    for (int i = 0; i < kNumImages; i++) {
+      EXPECT_TRUE(db.ContainsFeatures(image_names[i]));
+      const KeypointsAndDescriptors db_features =
+          db.GetFeatures(image_names[i]);
+      ASSERT_EQ(db_features.descriptors.size(), kNumFeatures);
+      EXPECT_EQ(db_features.descriptors[0], features[i].descriptors[0]);
+    }
+
+    // Overwriting the features of an ingested image must not add a new image.
+    db.PutFeatures(image_names[0], features[0]);
+    EXPECT_EQ(db.NumImages(), kNumImages);
+    db.EndBulkFeatureIngestion();
+  }
+
+  // Open the DB again and ensure that all batches were persisted.
+  RocksDbFeaturesAndMatchesDatabase db(db_directory);
+  std::vector<std::string> db_image_names = db.ImageNamesOfFeatures();
+  std::sort(db_image_names.begin(), db_image_names.end());
+  EXPECT_EQ(sorted_image_names, db_image_names);
+
+  for (int i = 0; i < kNumImages; i++) {
+    const KeypointsAndDescriptors db_features =
+        db.GetFeatures(features[i].image_name);
+    ASSERT_EQ(db_features.descriptors.size(), kNumFeatures);
+    for (int j = 0; j < kNumFeatures; j++) {
+      EXPECT_EQ(db_features.descriptors[j], features[i].descriptors[j]);
+    }
+  }
+
+  rocksdb::DestroyDB(db_directory, rocksdb::Options());
+}
+
 TEST(RocksDbFeaturesAndMatchesDatabase, PutMatch) {}
 
 TEST(RocksDbFeaturesAndMatchesDatabase, GetMatchFromInputDB) {}
 
 TEST(RocksDbFeaturesAndMatchesDatabase, ContainsMatch) {}
+
+TEST(RocksDbFeaturesAndMatchesDatabase, GetTwoViewInfo) {
+  RocksDbFeaturesAndMatchesDatabase db(db_directory);
+
+  ImagePairMatch match;
+  match.image1 = "image1";
+  match.image2 = "image2";
+  match.twoview_info.focal_length_1 = 800.0;
+  match.twoview_info.position_2 = Eigen::Vector3d(1.0, 2.0, 3.0);
+  match.twoview_info.num_verified_matches = 100;
+  match.correspondences.resize(100);
+  db.PutImagePairMatch(match.image1, match.image2, match);
+
+  // Only the two view info is read, but it must be identical to the one in the
+  // full match.
+  const TwoViewInfo twoview_info = db.GetTwoViewInfo("image1", "image2");
+  EXPECT_EQ(twoview_info.focal_length_1, match.twoview_info.focal_length_1);
+  EXPECT_EQ(twoview_info.position_2, match.twoview_info.position_2);
+  EXPECT_EQ(twoview_info.num_verified_matches,
+            match.twoview_info.num_verified_matches);
+
+  rocksdb::DestroyDB(db_directory, rocksdb::Options());
+}
 TEST(RocksDbFeaturesAndMatchesDatabase, MatchNames) {
   static const int kNumMatches = 1000;
   static const int kStringLength = 64;
@@ -39,6 +39,7 @@
 #include <glog/logging.h>
 
 #include <algorithm>
+#include <cmath>
 #include <string>
 
 #include "theia/math/matrix/sparse_cholesky_llt.h"
@@ -54,7 +55,8 @@ ConstrainedL1Solver::ConstrainedL1Solver(
     const Eigen::VectorXd& geq_vec)
     : options_(options),
       num_l1_residuals_(b.size()),
-      num_inequality_constraints_(geq_vec.size()) {
+      num_inequality_constraints_(geq_vec.size()),
+      num_iterations_(0) {
   CHECK_EQ(A.cols(), geq_mat.cols());
   CHECK_EQ(A.rows(), b.rows());
   CHECK_EQ(geq_mat.rows(), geq_vec.rows());
@@ -110,11 +112,32 @@ ConstrainedL1Solver::ConstrainedL1Solver(
 // This can now be solved in the same form as the L1 minimization, with a
 // slightly different z update.
 void ConstrainedL1Solver::Solve(Eigen::VectorXd* solution) {
+  Eigen::VectorXd z, y;
+  Solve(solution, &z, &y);
+}
+
+void ConstrainedL1Solver::Solve(Eigen::VectorXd* solution,
+                                Eigen::VectorXd* splitting_variable,
+                                Eigen::VectorXd* dual_variable) {
   CHECK_NOTNULL(solution)->resize(A_.cols());
+  CHECK_NOTNULL(splitting_variable);
+  CHECK_NOTNULL(dual_variable);
+  num_iterations_ = 0;
+
   Eigen::VectorXd& x = *solution;
-  Eigen::VectorXd z(A_.rows()), u(A_.rows());
-  z.setZero();
-  u.setZero();
+  Eigen::VectorXd& z = *splitting_variable;
+  Eigen::VectorXd& u = *dual_variable;
+  if (z.size() == 0) {
+    z.setZero(A_.rows());
+  }
+  if (u.size() == 0) {
+    u.setZero(A_.rows());
+  }
+  CHECK_EQ(z.size(), A_.rows());
+  CHECK_EQ(u.size(), A_.rows());
+  // The iterations use the scaled dual variable u = y / rho.
+  double rho = options_.rho;
+  u /= rho;
 
   Eigen::VectorXd a_times_x(A_.rows()), z_old(z.size()), ax_hat(A_.rows());
   // Precompute some convergence terms.
@@ -130,12 +153,13 @@ void ConstrainedL1Solver::Solve(Eigen::VectorXd* solution) {
 
   // qp_options.max_num_iterations = 100;
   for (int i = 0; i < options_.max_num_iterations; i++) {
+    ++num_iterations_;
     x.noalias() = linear_solver_.Solve(A_.transpose() * (b_ + z - u));
 
     if (linear_solver_.Info() != Eigen::Success) {
       LOG(ERROR) << "L1 Minimization failed. Could not solve the sparse "
                     "linear system with Cholesky Decomposition";
-      return;
+      break;
     }
 
     a_times_x.noalias() = A_ * x;
@@ -144,20 +168,20 @@ void ConstrainedL1Solver::Solve(Eigen::VectorXd* solution) {
 
     // Update z and set z_old.
     std::swap(z, z_old);
-    z.noalias() = ModifiedShrinkage(ax_hat - b_ + u, 1.0 / options_.rho);
+    z.noalias() = ModifiedShrinkage(ax_hat - b_ + u, 1.0 / rho);
 
     // Update u.
     u.noalias() += ax_hat - z - b_;
 
     // Compute the convergence terms.
     const double r_norm = (a_times_x - z - b_).norm();
-    const double s_norm = (-options_.rho * A_.transpose() * (z - z_old)).norm();
+    const double s_norm = (-rho * A_.transpose() * (z - z_old)).norm();
     const double max_norm = std::max({a_times_x.norm(), z.norm(), rhs_norm});
+    const double dual_norm = (rho * A_.transpose() * u).norm();
     const double primal_eps =
         primal_abs_tolerance_eps + options_.relative_tolerance * max_norm;
-    const double dual_eps = dual_abs_tolerance_eps +
-                            options_.relative_tolerance *
-                                (options_.rho * A_.transpose() * u).norm();
+    const double dual_eps =
+        dual_abs_tolerance_eps + options_.relative_tolerance * dual_norm;
 
     // Log the result to the screen.
     VLOG(2) << theia::StringPrintf(
@@ -166,7 +190,22 @@ void ConstrainedL1Solver::Solve(Eigen::VectorXd* solution) {
     if (r_norm < primal_eps && s_norm < dual_eps) {
       break;
     }
+
+    // Balance the primal and dual residuals by updating rho. The scaled dual
+    // variable must be rescaled accordingly.
+    if (options_.adaptive_rho && r_norm > 0.0 && s_norm > 0.0) {
+      const double balanced_rho = rho * std::sqrt(r_norm / s_norm);
+      if (balanced_rho > options_.adaptive_rho_tolerance * rho ||
+          balanced_rho * options_.adaptive_rho_tolerance < rho) {
+        VLOG(2) << "Updating rho from " << rho << " to " << balanced_rho;
+        u *= rho / balanced_rho;
+        rho = balanced_rho;
+      }
+    }
   }
+
+  // Return the unscaled dual variable.
+  u *= rho;
 }
 
 Eigen::VectorXd ConstrainedL1Solver::ModifiedShrinkage(
@@ -71,6 +71,14 @@ class ConstrainedL1Solver {
     // Stopping criteria.
     double absolute_tolerance = 1e-4;
     double relative_tolerance = 1e-2;
+
+    // If true, rho is adapted during the iterations to balance the primal and
+    // dual residuals (see Section 3.4.1 of Boyd et al.). Rho is only updated
+    // when the balanced value differs from the current rho by more than a
+    // factor of adaptive_rho_tolerance. The linear system does not depend on
+    // rho so no refactorization is needed.
+    bool adaptive_rho = false;
+    double adaptive_rho_tolerance = 5.0;
   };
 
   // The linear system along with the equality and inequality constraints.
@@ -83,6 +91,17 @@ class ConstrainedL1Solver {
   // Solve the constrained L1 minimization above.
   void Solve(Eigen::VectorXd* solution);
 
+  // Same as above, but the ADMM iterations are warm started from the splitting
+  // variable z and the (unscaled) dual variable y, e.g., the values from a
+  // previous solve of a similar problem. Empty vectors are initialized to zero.
+  // On return, z and y contain the final iterates.
+  void Solve(Eigen::VectorXd* solution,
+             Eigen::VectorXd* splitting_variable,
+             Eigen::VectorXd* dual_variable);
+
+  // Returns the number of iterations performed by the last call to Solve.
+  int num_iterations() const { return num_iterations_; }
+
  private:
   // This method is used for the z-update, which is conveniently an element-wise
   // update. For the terms in vec corresponding to the L1 minimization, we
@@ -103,6 +122,8 @@ class ConstrainedL1Solver {
   // Cholesky linear solver. Since our linear system will be a SPD matrix we can
   // utilize the Cholesky factorization.
   SparseCholeskyLLt linear_solver_;
+
+  int num_iterations_;
 };
 
 }  // namespace theia
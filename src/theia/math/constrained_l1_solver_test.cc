@@ -0,0 +1,134 @@
+// Copyright (C) 2026 The Regents of the University of California (Regents).
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials provided
+//       with the distribution.
+//
+//     * Neither the name of The Regents or University of California nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+// Please contact the author of this library if you have any questions.
+// Author: agent (agent@local)
+
+#include <Eigen/Core>
+#include <Eigen/SparseCore>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "theia/math/constrained_l1_solver.h"
+#include "theia/util/random.h"
+
+namespace theia {
+
+namespace {
+
+RandomNumberGenerator rng(52);
+
+// Creates an L1 regression problem ||Ax - b||_1 with outliers where the
+// solution is constrained to x >= 0.5.
+void CreateProblem(Eigen::SparseMatrix<double>* A,
+                   Eigen::VectorXd* b,
+                   Eigen::SparseMatrix<double>* geq_mat,
+                   Eigen::VectorXd* geq_vec) {
+  static const int kNumResiduals = 200;
+  static const int kNumVariables = 10;
+  static const double kOutlierRatio = 0.2;
+
+  Eigen::MatrixXd dense_A(kNumResiduals, kNumVariables);
+  rng.SetRandom(&dense_A);
+  Eigen::VectorXd x(kNumVariables);
+  rng.SetRandom(&x);
+  x = x.array().abs() + 1.0;
+  *b = dense_A * x;
+  for (int i = 0; i < kNumResiduals; i++) {
+    if (rng.RandDouble(0.0, 1.0) < kOutlierRatio) {
+      (*b)[i] += rng.RandDouble(-10.0, 10.0);
+    }
+  }
+  *A = dense_A.sparseView();
+
+  geq_mat->resize(kNumVariables, kNumVariables);
+  geq_mat->setIdentity();
+  geq_vec->setConstant(kNumVariables, 0.5);
+}
+
+ConstrainedL1Solver::Options AccurateOptions() {
+  ConstrainedL1Solver::Options options;
+  options.max_num_iterations = 10000;
+  options.absolute_tolerance = 1e-8;
+  options.relative_tolerance = 1e-6;
+  return options;
+}
+
+}  // namespace
+
+TEST(ConstrainedL1Solver, AdaptiveRho) {
+  Eigen::SparseMatrix<double> A, geq_mat;
+  Eigen::VectorXd b, geq_vec;
+  CreateProblem(&A, &b, &geq_mat, &geq_vec);
+
+  // Use a poor choice of rho so that the residuals are unbalanced.
+  ConstrainedL1Solver::Options options = AccurateOptions();
+  options.rho = 1000.0;
+  ConstrainedL1Solver fixed_rho_solver(options, A, b, geq_mat, geq_vec);
+  Eigen::VectorXd fixed_rho_solution;
+  fixed_rho_solver.Solve(&fixed_rho_solution);
+
+  options.adaptive_rho = true;
+  ConstrainedL1Solver adaptive_rho_solver(options, A, b, geq_mat, geq_vec);
+  Eigen::VectorXd adaptive_rho_solution;
+  adaptive_rho_solver.Solve(&adaptive_rho_solution);
+
+  // Both solvers should find the same optimum, but adapting rho should require
+  // fewer iterations.
+  EXPECT_NEAR((A * fixed_rho_solution - b).lpNorm<1>(),
+              (A * adaptive_rho_solution - b).lpNorm<1>(),
+              1e-4);
+  EXPECT_LT((fixed_rho_solution - adaptive_rho_solution).norm(), 1e-3);
+  EXPECT_GE((geq_mat * adaptive_rho_solution - geq_vec).minCoeff(), -1e-6);
+  EXPECT_LT(adaptive_rho_solver.num_iterations(),
+            fixed_rho_solver.num_iterations());
+}
+
+TEST(ConstrainedL1Solver, WarmStart) {
+  Eigen::SparseMatrix<double> A, geq_mat;
+  Eigen::VectorXd b, geq_vec;
+  CreateProblem(&A, &b, &geq_mat, &geq_vec);
+
+  ConstrainedL1Solver solver(AccurateOptions(), A, b, geq_mat, geq_vec);
+  Eigen::VectorXd solution, z, y;
+  solver.Solve(&solution, &z, &y);
+  const int num_cold_start_iterations = solver.num_iterations();
+
+  // Solving again from the final iterates should converge almost immediately
+  // to the same solution.
+  Eigen::VectorXd warm_start_solution;
+  solver.Solve(&warm_start_solution, &z, &y);
+  EXPECT_LT(solver.num_iterations(), num_cold_start_iterations / 10);
+  EXPECT_LT((solution - warm_start_solution).norm(), 1e-4);
+}
+
+}  // namespace theia
@@ -0,0 +1,138 @@
+// Copyright (C) 2026 The Regents of the University of California (Regents).
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials provided
+//       with the distribution.
+//
+//     * Neither the name of The Regents or University of California nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+// Please contact the author of this library if you have any questions.
+// Author: agent (agent@local)
+
+#include "theia/math/graph/parallel_connected_components.h"
+
+#include <glog/logging.h>
+#include <algorithm>
+#include <atomic>
+#include <utility>
+#include <vector>
+
+#include "theia/util/threadpool.h"
+
+namespace theia {
+
+namespace {
+
+// Returns the root of the node. The tree is flattened with path halving as we
+// proceed. Concurrent updates are safe since a parent pointer is only ever
+// replaced by one of its ancestors.
+int FindRoot(std::vector<std::atomic<int> >* parents, int node) {
+  while (true) {
+    int parent = (*parents)[node].load();
+    if (parent == node) {
+      return node;
+    }
+    const int grandparent = (*parents)[parent].load();
+    if (parent != grandparent) {
+      (*parents)[node].compare_exchange_weak(parent, grandparent);
+    }
+    node = grandparent;
+  }
+}
+
+// Unions the trees containing the two nodes. The root with the larger index is
+// always attached to the root with the smaller index, so the root of each tree
+// is the smallest node in the tree. If another thread modifies one of the roots
+// concurrently then the compare-and-swap fails and we try again.
+void Union(std::vector<std::atomic<int> >* parents, int node1, int node2) {
+  while (true) {
+    node1 = FindRoot(parents, node1);
+    node2 = FindRoot(parents, node2);
+    if (node1 == node2) {
+      return;
+    }
+
+    if (node1 < node2) {
+      std::swap(node1, node2);
+    }
+    int expected_root = node1;
+    if ((*parents)[node1].compare_exchange_strong(expected_root, node2)) {
+      return;
+    }
+  }
+}
+
+}  // namespace
+
+int ComputeConnectedComponentLabels(
+    const int num_nodes,
+    const std::vector<std::pair<int, int> >& edges,
+    const int num_threads,
+    std::vector<int>* component_labels) {
+  CHECK_NOTNULL(component_labels);
+  CHECK_GE(num_nodes, 0);
+  CHECK_GT(num_threads, 0);
+
+  std::vector<std::atomic<int> > parents(num_nodes);
+  ParallelForBlocks(num_threads, num_nodes, [&](const int start, const int end) {
+    for (int i = start; i < end; i++) {
+      parents[i].store(i);
+    }
+  });
+
+  // Union the endpoints of all edges.
+  const int num_edges = static_cast<int>(edges.size());
+  ParallelForBlocks(num_threads, num_edges, [&](const int start, const int end) {
+    for (int i = start; i < end; i++) {
+      DCHECK(edges[i].first >= 0 && edges[i].first < num_nodes);
+      DCHECK(edges[i].second >= 0 && edges[i].second < num_nodes);
+      Union(&parents, edges[i].first, edges[i].second);
+    }
+  });
+
+  // Point every node directly at its root.
+  ParallelForBlocks(num_threads, num_nodes, [&](const int start, const int end) {
+    for (int i = start; i < end; i++) {
+      parents[i].store(FindRoot(&parents, i));
+    }
+  });
+
+  // Since each root is the smallest node of its component, the root of a node
+  // is always labeled before the node itself.
+  component_labels->resize(num_nodes);
+  int num_components = 0;
+  for (int i = 0; i < num_nodes; i++) {
+    const int root = parents[i].load();
+    if (root == i) {
+      (*component_labels)[i] = num_components++;
+    } else {
+      (*component_labels)[i] = (*component_labels)[root];
+    }
+  }
+  return num_components;
+}
+
+}  // namespace theia
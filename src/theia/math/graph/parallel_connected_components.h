@@ -0,0 +1,64 @@
+// Copyright (C) 2026 The Regents of the University of California (Regents).
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials provided
+//       with the distribution.
+//
+//     * Neither the name of The Regents or University of California nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+// Please contact the author of this library if you have any questions.
+// Author: agent (agent@local)
+
+#ifndef THEIA_MATH_GRAPH_PARALLEL_CONNECTED_COMPONENTS_H_
+#define THEIA_MATH_GRAPH_PARALLEL_CONNECTED_COMPONENTS_H_
+
+#include <utility>
+#include <vector>
+
+namespace theia {
+
+// Computes the connected components of an undirected graph with the nodes
+// [0, num_nodes) and the given edges. Unlike the ConnectedComponents class,
+// which stores the disjoint sets in a hash map and is meant to be built up one
+// edge at a time, this method operates on a compact edge list and processes
+// the edges in parallel with a lock-free union-find. This makes it suitable
+// for repeatedly computing the connected components of large graphs (e.g.,
+// after each filtering step of the view graph).
+//
+// Each node is assigned a dense component label in [0, num_components) such
+// that nodes share a label if and only if they are connected. Components are
+// labeled in order of their smallest node, so the output does not depend on
+// the number of threads. Nodes without any edges form their own component.
+// Returns the number of connected components.
+int ComputeConnectedComponentLabels(
+    const int num_nodes,
+    const std::vector<std::pair<int, int> >& edges,
+    const int num_threads,
+    std::vector<int>* component_labels);
+
+}  // namespace theia
+
+#endif  // THEIA_MATH_GRAPH_PARALLEL_CONNECTED_COMPONENTS_H_
@@ -0,0 +1,128 @@
+// Copyright (C) 2026 The Regents of the University of California (Regents).
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials provided
+//       with the distribution.
+//
+//     * Neither the name of The Regents or University of California nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+// Please contact the author of this library if you have any questions.
+// Author: agent (agent@local)
+
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "theia/math/graph/connected_components.h"
+#include "theia/math/graph/parallel_connected_components.h"
+#include "theia/util/random.h"
+
+namespace theia {
+
+TEST(ParallelConnectedComponents, FullyConnectedGraph) {
+  std::vector<std::pair<int, int> > edges;
+  for (int i = 0; i < 9; i++) {
+    edges.emplace_back(i, i + 1);
+  }
+
+  std::vector<int> labels;
+  EXPECT_EQ(ComputeConnectedComponentLabels(10, edges, 1, &labels), 1);
+  ASSERT_EQ(labels.size(), 10);
+  for (const int label : labels) {
+    EXPECT_EQ(label, 0);
+  }
+}
+
+TEST(ParallelConnectedComponents, IsolatedNodes) {
+  const std::vector<std::pair<int, int> > edges = { { 1, 3 }, { 4, 3 } };
+
+  std::vector<int> labels;
+  EXPECT_EQ(ComputeConnectedComponentLabels(6, edges, 1, &labels), 4);
+  // Components are labeled in order of their smallest node.
+  const std::vector<int> expected_labels = { 0, 1, 2, 1, 1, 3 };
+  EXPECT_EQ(labels, expected_labels);
+}
+
+TEST(ParallelConnectedComponents, EmptyGraph) {
+  std::vector<int> labels;
+  EXPECT_EQ(ComputeConnectedComponentLabels(0, {}, 4, &labels), 0);
+  EXPECT_TRUE(labels.empty());
+}
+
+// Ensures that the labels match the components from ConnectedComponents on
+// random graphs for different numbers of threads.
+TEST(ParallelConnectedComponents, RandomGraphs) {
+  static const int kNumNodes = 5000;
+  static const int kNumEdges = 4000;
+
+  RandomNumberGenerator rng(59);
+  for (int trial = 0; trial < 10; trial++) {
+    std::vector<std::pair<int, int> > edges;
+    ConnectedComponents<int> connected_components;
+    for (int i = 0; i < kNumEdges; i++) {
+      edges.emplace_back(rng.RandInt(0, kNumNodes - 1),
+                         rng.RandInt(0, kNumNodes - 1));
+      connected_components.AddEdge(edges.back().first, edges.back().second);
+    }
+    // Isolated nodes are not part of ConnectedComponents, so add self edges.
+    for (int i = 0; i < kNumNodes; i++) {
+      connected_components.AddEdge(i, i);
+    }
+    std::unordered_map<int, std::unordered_set<int> > disjoint_sets;
+    connected_components.Extract(&disjoint_sets);
+
+    std::vector<int> expected_labels;
+    for (const int num_threads : { 1, 2, 8 }) {
+      std::vector<int> labels;
+      const int num_components =
+          ComputeConnectedComponentLabels(kNumNodes, edges, num_threads,
+                                          &labels);
+      EXPECT_EQ(num_components, disjoint_sets.size());
+
+      // All nodes of a component must share a label that no other component
+      // uses.
+      std::unordered_set<int> used_labels;
+      for (const auto& disjoint_set : disjoint_sets) {
+        const int label = labels[*disjoint_set.second.begin()];
+        EXPECT_TRUE(used_labels.insert(label).second);
+        for (const int node : disjoint_set.second) {
+          EXPECT_EQ(labels[node], label);
+        }
+      }
+
+      // The labels should not depend on the number of threads.
+      if (expected_labels.empty()) {
+        expected_labels = labels;
+      } else {
+        EXPECT_EQ(labels, expected_labels);
+      }
+    }
+  }
+}
+
+}  // namespace theia
@@ -38,6 +38,7 @@
 #include <glog/logging.h>
 
 #include <algorithm>
+#include <cmath>
 #include <limits>
 #include <string>
 
@@ -50,7 +51,12 @@ QPSolver::QPSolver(const Options& options,
                    const Eigen::SparseMatrix<double>& P,
                    const Eigen::VectorXd& q,
                    const double r)
-    : options_(options), P_(P), q_(q), r_(r) {
+    : options_(options),
+      P_(P),
+      q_(q),
+      r_(r),
+      factorized_rho_(options.rho),
+      num_iterations_(0) {
   CHECK_EQ(P_.rows(), P_.cols()) << "P must be a symmetric matrix.";
   CHECK_EQ(P_.cols(), q_.size())
       << "The dimensions of P and q must be consistent.";
@@ -62,13 +68,29 @@ QPSolver::QPSolver(const Options& options,
 
   // Set up the linear solver to compute the cholesky decomposition of:
   //     P_ + rho * eye(N)
+  // The sparsity pattern does not depend on rho, so the symbolic analysis is
+  // only performed once.
   Eigen::SparseMatrix<double> spd_mat(P_.rows(), P_.cols());
   spd_mat.setIdentity();
-  spd_mat *= options_.rho;
   spd_mat += P_;
-
-  linear_solver_.Compute(spd_mat);
+  linear_solver_.AnalyzePattern(spd_mat);
   CHECK_EQ(linear_solver_.Info(), Eigen::Success);
+
+  CHECK(FactorizeLinearSystem(options_.rho));
+}
+
+bool QPSolver::FactorizeLinearSystem(const double rho) {
+  Eigen::SparseMatrix<double> spd_mat(P_.rows(), P_.cols());
+  spd_mat.setIdentity();
+  spd_mat *= rho;
+  spd_mat += P_;
+
+  linear_solver_.Factorize(spd_mat);
+  if (linear_solver_.Info() != Eigen::Success) {
+    return false;
+  }
+  factorized_rho_ = rho;
+  return true;
 }
 
 void QPSolver::SetMaxIterations(const int max_iterations) {
@@ -81,6 +103,17 @@ void QPSolver::SetLowerBound(const Eigen::VectorXd& lb) { lb_ = lb.array(); }
 
 // Solve the quadratic program.
 bool QPSolver::Solve(Eigen::VectorXd* solution) {
+  Eigen::VectorXd z, y;
+  return Solve(solution, &z, &y);
+}
+
+bool QPSolver::Solve(Eigen::VectorXd* solution,
+                     Eigen::VectorXd* splitting_variable,
+                     Eigen::VectorXd* dual_variable) {
+  CHECK_NOTNULL(splitting_variable);
+  CHECK_NOTNULL(dual_variable);
+  num_iterations_ = 0;
+
   // Ensure the bounds are valid. If there are any invalid bounds then the
   // difference between the bounds would be a negative value.
   int coeff_index = -1;
@@ -92,11 +125,27 @@ bool QPSolver::Solve(Eigen::VectorXd* solution) {
     return false;
   }
 
+  // Each solve starts with the initial rho.
+  if (factorized_rho_ != options_.rho &&
+      !FactorizeLinearSystem(options_.rho)) {
+    return false;
+  }
+  double rho = factorized_rho_;
+
   CHECK_NOTNULL(solution)->setZero(q_.size());
   Eigen::VectorXd& x = *solution;
-  Eigen::VectorXd z(P_.rows()), u(P_.rows());
-  z.setZero();
-  u.setZero();
+  Eigen::VectorXd& z = *splitting_variable;
+  Eigen::VectorXd& u = *dual_variable;
+  if (z.size() == 0) {
+    z.setZero(P_.rows());
+  }
+  if (u.size() == 0) {
+    u.setZero(P_.rows());
+  }
+  CHECK_EQ(z.size(), P_.rows());
+  CHECK_EQ(u.size(), P_.rows());
+  // The iterations use the scaled dual variable u = y / rho.
+  u /= rho;
 
   Eigen::VectorXd z_old(z.size()), x_hat(P_.rows());
 
@@ -111,11 +160,14 @@ bool QPSolver::Solve(Eigen::VectorXd* solution) {
       "  % 4d      % 4.4e     % 4.4e     % 4.4e     % 4.4e     % 4.4e";
 
   // Run the iterations.
+  bool success = true;
   for (int i = 0; i < options_.max_num_iterations; i++) {
+    ++num_iterations_;
     // Update x.
-    x.noalias() = linear_solver_.Solve(options_.rho * (z - u) - q_);
+    x.noalias() = linear_solver_.Solve(rho * (z - u) - q_);
     if (linear_solver_.Info() != Eigen::Success) {
-      return false;
+      success = false;
+      break;
     }
 
     // Update x_hat.
@@ -131,13 +183,13 @@ bool QPSolver::Solve(Eigen::VectorXd* solution) {
     // Compute the convergence terms.
     const double objval = 0.5 * x.dot(P_ * x) + q_.dot(x) + r_;
     const double r_norm = (x - z).norm();
-    const double s_norm = (-options_.rho * (z - z_old)).norm();
+    const double s_norm = (-rho * (z - z_old)).norm();
     const double max_norm = std::max({x.norm(), z.norm()});
+    const double dual_norm = (rho * u).norm();
     const double primal_eps =
         primal_abs_tolerance_eps + options_.relative_tolerance * max_norm;
     const double dual_eps =
-        dual_abs_tolerance_eps +
-        options_.relative_tolerance * (options_.rho * u).norm();
+        dual_abs_tolerance_eps + options_.relative_tolerance * dual_norm;
 
     // Log the result to the screen.
     VLOG(2) << StringPrintf(row_format.c_str(), objval, i, r_norm, s_norm,
@@ -146,8 +198,27 @@ bool QPSolver::Solve(Eigen::VectorXd* solution) {
     if (r_norm < primal_eps && s_norm < dual_eps) {
       break;
     }
+
+    // Balance the primal and dual residuals by updating rho. The scaled dual
+    // variable must be rescaled accordingly.
+    if (options_.adaptive_rho && r_norm > 0.0 && s_norm > 0.0) {
+      const double balanced_rho = rho * std::sqrt(r_norm / s_norm);
+      if (balanced_rho > options_.adaptive_rho_tolerance * rho ||
+          balanced_rho * options_.adaptive_rho_tolerance < rho) {
+        VLOG(2) << "Updating rho from " << rho << " to " << balanced_rho;
+        if (!FactorizeLinearSystem(balanced_rho)) {
+          success = false;
+          break;
+        }
+        u *= rho / balanced_rho;
+        rho = balanced_rho;
+      }
+    }
   }
-  return true;
+
+  // Return the unscaled dual variable.
+  u *= rho;
+  return success;
 }
 
 }  // namespace theia
@@ -73,6 +73,16 @@ class QPSolver {
 
     double absolute_tolerance = 1e-6;
     double relative_tolerance = 1e-4;
+
+    // If true, rho is adapted during the iterations to balance the primal and
+    // dual residuals (see Section 3.4.1 of Boyd et al.). This makes the
+    // convergence much less sensitive to the initial choice of rho. Since the
+    // linear system P + rho * I must be refactorized whenever rho changes, rho
+    // is only updated when the balanced value differs from the current rho by
+    // more than a factor of adaptive_rho_tolerance. The symbolic analysis of
+    // the linear system is reused for each refactorization.
+    bool adaptive_rho = false;
+    double adaptive_rho_tolerance = 5.0;
   };
 
   // Set Q, p, and r according to the notation above.
@@ -91,7 +101,22 @@ class QPSolver {
   // Solve the quadratic program.
   bool Solve(Eigen::VectorXd* solution);
 
+  // Same as above, but the ADMM iterations are warm started from the splitting
+  // variable z and the (unscaled) dual variable y, e.g., the values from a
+  // previous solve of a similar problem. Empty vectors are initialized to zero.
+  // The initial value of x is not needed since it is computed from z and y in
+  // the first iteration. On return, z and y contain the final iterates.
+  bool Solve(Eigen::VectorXd* solution,
+             Eigen::VectorXd* splitting_variable,
+             Eigen::VectorXd* dual_variable);
+
+  // Returns the number of iterations performed by the last call to Solve.
+  int num_iterations() const { return num_iterations_; }
+
  private:
+  // Sets the linear system to P + rho * I and factorizes it numerically.
+  bool FactorizeLinearSystem(const double rho);
+
   Options options_;
 
   // Matrix P, q, double r where || 1/2 * x * P * x + q' * x + b ||_2 is the
@@ -106,6 +131,11 @@ class QPSolver {
   // Cholesky linear solver. Since our linear system will be a SPD matrix we can
   // utilize the Cholesky factorization.
   SparseCholeskyLLt linear_solver_;
+
+  // The value of rho for which the linear system was factorized.
+  double factorized_rho_;
+
+  int num_iterations_;
 };
 
 }  // namespace theia
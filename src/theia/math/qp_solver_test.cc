@@ -200,4 +200,85 @@ TEST(QPSolver, InvalidBounds) {
   EXPECT_FALSE(qp_solver.Solve(&solution));
 }
 
+// Adapting rho should find the same solution as the fixed rho in fewer
+// iterations when the initial rho is a poor choice.
+TEST(QPSolver, AdaptiveRho) {
+  static const double kTolerance = 1e-4;
+
+  Eigen::MatrixXd P(3, 3);
+  P << 5, -2, -1,
+    -2, 4, 3,
+    -1, 3, 5;
+  Eigen::VectorXd q(3);
+  q << 2, -35, -47;
+  const double r = 5;
+  Eigen::VectorXd lower_bound(3), upper_bound(3);
+  lower_bound << 0, 0, 0;
+  upper_bound << 10, 10, 10;
+
+  QPSolver::Options options;
+  options.max_num_iterations = 10000;
+  options.absolute_tolerance = 1e-8;
+  options.relative_tolerance = 1e-8;
+  options.rho = 100.0;
+  Eigen::SparseMatrix<double> P_sparse(P.sparseView());
+
+  QPSolver fixed_rho_solver(options, P_sparse, q, r);
+  fixed_rho_solver.SetLowerBound(lower_bound);
+  fixed_rho_solver.SetUpperBound(upper_bound);
+  Eigen::VectorXd fixed_rho_solution;
+  ASSERT_TRUE(fixed_rho_solver.Solve(&fixed_rho_solution));
+
+  options.adaptive_rho = true;
+  QPSolver adaptive_rho_solver(options, P_sparse, q, r);
+  adaptive_rho_solver.SetLowerBound(lower_bound);
+  adaptive_rho_solver.SetUpperBound(upper_bound);
+  Eigen::VectorXd adaptive_rho_solution;
+  ASSERT_TRUE(adaptive_rho_solver.Solve(&adaptive_rho_solution));
+
+  const Eigen::Vector3d gt_solution(3, 5, 7);
+  for (int i = 0; i < 3; i++) {
+    EXPECT_NEAR(fixed_rho_solution(i), gt_solution(i), kTolerance);
+    EXPECT_NEAR(adaptive_rho_solution(i), gt_solution(i), kTolerance);
+  }
+  EXPECT_LT(adaptive_rho_solver.num_iterations(),
+            fixed_rho_solver.num_iterations());
+}
+
+TEST(QPSolver, WarmStart) {
+  static const double kTolerance = 1e-4;
+
+  Eigen::MatrixXd P(3, 3);
+  P << 5, -2, -1,
+    -2, 4, 3,
+    -1, 3, 5;
+  Eigen::VectorXd q(3);
+  q << 2, -35, -47;
+  const double r = 5;
+  Eigen::VectorXd lower_bound(3), upper_bound(3);
+  lower_bound << 5, 7, 9;
+  upper_bound << 10, 12, 14;
+
+  QPSolver::Options options;
+  options.absolute_tolerance = 1e-8;
+  options.relative_tolerance = 1e-8;
+  Eigen::SparseMatrix<double> P_sparse(P.sparseView());
+  QPSolver qp_solver(options, P_sparse, q, r);
+  qp_solver.SetLowerBound(lower_bound);
+  qp_solver.SetUpperBound(upper_bound);
+
+  Eigen::VectorXd solution, z, y;
+  ASSERT_TRUE(qp_solver.Solve(&solution, &z, &y));
+  const int num_cold_start_iterations = qp_solver.num_iterations();
+
+  // Solving again from the final iterates should converge almost immediately
+  // to the same solution.
+  Eigen::VectorXd warm_start_solution;
+  ASSERT_TRUE(qp_solver.Solve(&warm_start_solution, &z, &y));
+  EXPECT_LT(qp_solver.num_iterations(), num_cold_start_iterations / 10);
+  for (int i = 0; i < 3; i++) {
+    EXPECT_NEAR(warm_start_solution(i), solution(i), kTolerance);
+  }
+}
+
 }  // namespace theia
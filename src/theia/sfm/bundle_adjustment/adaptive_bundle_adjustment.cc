@@ -0,0 +1,271 @@
+// Copyright (C) 2026 The Regents of the University of California (Regents).
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials provided
+//       with the distribution.
+//
+//     * Neither the name of The Regents or University of California nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+// Please contact the author of this library if you have any questions.
+// Author: agent (agent@local)
+
+#include "theia/sfm/bundle_adjustment/adaptive_bundle_adjustment.h"
+
+#include <ceres/ceres.h>
+#include <glog/logging.h>
+#include <algorithm>
+#include <unordered_set>
+#include <vector>
+
+#include "theia/sfm/reconstruction.h"
+#include "theia/sfm/track.h"
+#include "theia/sfm/types.h"
+#include "theia/sfm/view.h"
+#include "theia/util/hash.h"
+#include "theia/util/map_util.h"
+
+namespace theia {
+
+namespace {
+
+// Dense factorization of the Schur complement is the fastest option for small
+// problems. For larger problems, a dense solver is only used if the Schur
+// complement is mostly dense anyways.
+static const int kMaxNumCamerasForDenseSchur = 100;
+static const int kMaxNumCamerasForDenseSchurComplement = 500;
+static const double kMinDensityForDenseSchur = 0.5;
+
+// Sparse factorization of the Schur complement is used as long as the Schur
+// complement is sparse and small enough that the fill-in of the factorization
+// remains tractable.
+static const double kMaxDensityForSparseSchur = 0.2;
+static const int kMaxNumSchurComplementBlocksForSparseSchur = 500000;
+
+// For iterative solvers, the cluster-based preconditioner pays off when cameras
+// are highly covisible because the block diagonal of the Schur complement is
+// then a poor approximation of the full Schur complement.
+static const double kMinCovisibilityForClusterPreconditioner = 30.0;
+
+// Counting the covisible camera pairs is quadratic in the track length, so each
+// view of a longer track is only paired with this many of the views that
+// follow it (cyclically) in the track.
+static const int kMaxNumPairedViewsPerObservation = 32;
+
+}  // namespace
+
+BundleAdjustmentProblemStatistics ComputeBundleAdjustmentProblemStatistics(
+    const Reconstruction& reconstruction,
+    const std::unordered_set<ViewId>& view_ids,
+    const std::unordered_set<TrackId>& track_ids) {
+  BundleAdjustmentProblemStatistics statistics;
+
+  std::unordered_set<ViewId> estimated_view_ids;
+  for (const ViewId view_id : view_ids) {
+    const View* view = reconstruction.View(view_id);
+    if (view != nullptr && view->IsEstimated()) {
+      estimated_view_ids.emplace(view_id);
+    }
+  }
+  statistics.num_cameras = estimated_view_ids.size();
+
+  // Each pair of optimized cameras that observe the same optimized point
+  // creates an off-diagonal block in the Schur complement.
+  std::unordered_set<ViewIdPair> covisible_camera_pairs;
+  std::vector<ViewId> observing_view_ids;
+  for (const TrackId track_id : track_ids) {
+    const Track* track = reconstruction.Track(track_id);
+    if (track == nullptr || !track->IsEstimated()) {
+      continue;
+    }
+    ++statistics.num_points;
+
+    observing_view_ids.clear();
+    for (const ViewId view_id : track->ViewIds()) {
+      if (ContainsKey(estimated_view_ids, view_id)) {
+        observing_view_ids.emplace_back(view_id);
+      }
+    }
+    statistics.num_observations += observing_view_ids.size();
+
+    // Long tracks are rare and their views are usually also connected by
+    // shorter tracks, so limiting their pairs to the views that follow in the
+    // track has little effect on the counted pairs.
+    const int num_observing_views = observing_view_ids.size();
+    const int num_paired_views =
+        std::min(num_observing_views - 1, kMaxNumPairedViewsPerObservation);
+    for (int i = 0; i < num_observing_views; i++) {
+      const int last_paired_view =
+          num_observing_views <= kMaxNumPairedViewsPerObservation + 1
+              ? num_observing_views - 1
+              : i + num_paired_views;
+      for (int j = i + 1; j <= last_paired_view; j++) {
+        const ViewId view_id1 = observing_view_ids[i];
+        const ViewId view_id2 = observing_view_ids[j % num_observing_views];
+        covisible_camera_pairs.emplace(std::min(view_id1, view_id2),
+                                       std::max(view_id1, view_id2));
+      }
+    }
+  }
+  statistics.num_covisible_camera_pairs = covisible_camera_pairs.size();
+
+  if (statistics.num_cameras > 0) {
+    const double num_cameras = statistics.num_cameras;
+    statistics.schur_complement_density =
+        (num_cameras + 2.0 * statistics.num_covisible_camera_pairs) /
+        (num_cameras * num_cameras);
+    statistics.mean_camera_covisibility =
+        2.0 * statistics.num_covisible_camera_pairs / num_cameras;
+  }
+  return statistics;
+}
+
+void SelectLinearSolverFromProblemStatistics(
+    const BundleAdjustmentProblemStatistics& statistics,
+    ceres::LinearSolverType* linear_solver_type,
+    ceres::PreconditionerType* preconditioner_type) {
+  CHECK_NOTNULL(linear_solver_type);
+  CHECK_NOTNULL(preconditioner_type);
+
+  const int num_schur_complement_blocks =
+      statistics.num_cameras + 2 * statistics.num_covisible_camera_pairs;
+
+  if (statistics.num_cameras <= kMaxNumCamerasForDenseSchur ||
+      (statistics.num_cameras <= kMaxNumCamerasForDenseSchurComplement &&
+       statistics.schur_complement_density >= kMinDensityForDenseSchur)) {
+    *linear_solver_type = ceres::DENSE_SCHUR;
+  } else if (statistics.schur_complement_density <=
+                 kMaxDensityForSparseSchur &&
+             num_schur_complement_blocks <=
+                 kMaxNumSchurComplementBlocksForSparseSchur) {
+    *linear_solver_type = ceres::SPARSE_SCHUR;
+  } else {
+    *linear_solver_type = ceres::ITERATIVE_SCHUR;
+  }
+
+  *preconditioner_type = ceres::SCHUR_JACOBI;
+#ifndef CERES_NO_SUITESPARSE
+  if (*linear_solver_type == ceres::ITERATIVE_SCHUR &&
+      statistics.mean_camera_covisibility >=
+          kMinCovisibilityForClusterPreconditioner) {
+    *preconditioner_type = ceres::CLUSTER_JACOBI;
+  }
+#endif  // CERES_NO_SUITESPARSE
+
+  VLOG(2) << "Selected linear solver " << *linear_solver_type
+          << " with preconditioner " << *preconditioner_type << " for "
+          << statistics.num_cameras << " cameras, " << statistics.num_points
+          << " points, Schur complement density "
+          << statistics.schur_complement_density
+          << " and mean camera covisibility "
+          << statistics.mean_camera_covisibility;
+}
+
+bool StrengthenIterativeSchurPreconditioner(
+    ceres::PreconditionerType* preconditioner_type) {
+  CHECK_NOTNULL(preconditioner_type);
+#ifndef CERES_NO_SUITESPARSE
+  switch (*preconditioner_type) {
+    case ceres::IDENTITY:
+    case ceres::JACOBI:
+    case ceres::SCHUR_JACOBI:
+      *preconditioner_type = ceres::CLUSTER_JACOBI;
+      return true;
+    case ceres::CLUSTER_JACOBI:
+      *preconditioner_type = ceres::CLUSTER_TRIDIAGONAL;
+      return true;
+    default:
+      return false;
+  }
+#else
+  return false;
+#endif  // CERES_NO_SUITESPARSE
+}
+
+BundleAdjustmentConvergenceMonitor::BundleAdjustmentConvergenceMonitor(
+    const double min_relative_cost_decrease_per_second,
+    const int max_num_slow_iterations,
+    const int max_num_stalled_iterations,
+    const int max_linear_solver_iterations)
+    : min_relative_cost_decrease_per_second_(
+          min_relative_cost_decrease_per_second),
+      max_num_slow_iterations_(max_num_slow_iterations),
+      max_num_stalled_iterations_(max_num_stalled_iterations),
+      max_linear_solver_iterations_(max_linear_solver_iterations),
+      num_slow_iterations_(0),
+      num_stalled_iterations_(0),
+      stalled_(false),
+      converged_(false) {}
+
+ceres::CallbackReturnType BundleAdjustmentConvergenceMonitor::operator()(
+    const ceres::IterationSummary& summary) {
+  // The first iteration only evaluates the initial cost.
+  if (summary.iteration == 0) {
+    return ceres::SOLVER_CONTINUE;
+  }
+
+  // Detect whether the linear solver fails to converge within its iteration
+  // limit. Rejected steps are not stalls: the trust region is simply shrunk.
+  if (max_num_stalled_iterations_ > 0 && max_linear_solver_iterations_ > 0) {
+    const bool linear_solver_stalled =
+        summary.linear_solver_iterations >= max_linear_solver_iterations_;
+    num_stalled_iterations_ =
+        linear_solver_stalled ? num_stalled_iterations_ + 1 : 0;
+    if (num_stalled_iterations_ >= max_num_stalled_iterations_) {
+      VLOG(2) << "The linear solver stalled for " << num_stalled_iterations_
+              << " iterations.";
+      stalled_ = true;
+      return ceres::SOLVER_TERMINATE_SUCCESSFULLY;
+    }
+  }
+
+  // Measure the relative decrease in cost per second of this iteration. A
+  // rejected step does not decrease the cost at all.
+  if (min_relative_cost_decrease_per_second_ > 0.0 &&
+      max_num_slow_iterations_ > 0) {
+    double relative_decrease_per_second = 0.0;
+    const double previous_cost = summary.cost + summary.cost_change;
+    if (summary.step_is_successful && previous_cost > 0.0) {
+      relative_decrease_per_second =
+          summary.cost_change / previous_cost /
+          std::max(summary.iteration_time_in_seconds, 1e-9);
+    }
+    num_slow_iterations_ =
+        relative_decrease_per_second < min_relative_cost_decrease_per_second_
+            ? num_slow_iterations_ + 1
+            : 0;
+    if (num_slow_iterations_ >= max_num_slow_iterations_) {
+      VLOG(2) << "The relative cost decrease was below "
+              << min_relative_cost_decrease_per_second_ << " per second for "
+              << num_slow_iterations_ << " iterations.";
+      converged_ = true;
+      return ceres::SOLVER_TERMINATE_SUCCESSFULLY;
+    }
+  }
+
+  return ceres::SOLVER_CONTINUE;
+}
+
+}  // namespace theia
@@ -0,0 +1,145 @@
+// Copyright (C) 2026 The Regents of the University of California (Regents).
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials provided
+//       with the distribution.
+//
+//     * Neither the name of The Regents or University of California nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+// Please contact the author of this library if you have any questions.
+// Author: agent (agent@local)
+
+#ifndef THEIA_SFM_BUNDLE_ADJUSTMENT_ADAPTIVE_BUNDLE_ADJUSTMENT_H_
+#define THEIA_SFM_BUNDLE_ADJUSTMENT_ADAPTIVE_BUNDLE_ADJUSTMENT_H_
+
+#include <ceres/ceres.h>
+#include <ceres/types.h>
+#include <unordered_set>
+
+#include "theia/sfm/types.h"
+
+namespace theia {
+
+class Reconstruction;
+
+// Statistics describing the sparsity of a bundle adjustment problem. The Schur
+// complement (i.e., the reduced camera system) has one block per pair of
+// optimized cameras that observe a common optimized point, so its sparsity is
+// determined by the covisibility of the cameras.
+struct BundleAdjustmentProblemStatistics {
+  int num_cameras = 0;
+  int num_points = 0;
+  int num_observations = 0;
+
+  // The number of camera pairs that observe at least one common point.
+  int num_covisible_camera_pairs = 0;
+
+  // The fraction of nonzero blocks in the Schur complement, including the
+  // diagonal blocks.
+  double schur_complement_density = 0.0;
+
+  // The average number of other cameras that each camera shares a point with.
+  double mean_camera_covisibility = 0.0;
+};
+
+// Computes the problem statistics for bundle adjusting the given views and
+// tracks. Only observations of the tracks by the given (estimated) views are
+// considered since all other parameters are held constant and do not
+// contribute to the Schur complement. To keep the cost linear in the number of
+// observations, each view of a track that is observed by more than 33 of the
+// views is only paired with the 32 views that follow it in the track, so the
+// number of covisible camera pairs is a lower bound for problems with such long
+// tracks.
+BundleAdjustmentProblemStatistics ComputeBundleAdjustmentProblemStatistics(
+    const Reconstruction& reconstruction,
+    const std::unordered_set<ViewId>& view_ids,
+    const std::unordered_set<TrackId>& track_ids);
+
+// Chooses the linear solver and preconditioner for bundle adjustment from the
+// measured problem sparsity:
+//   - DENSE_SCHUR if the Schur complement is small or mostly dense.
+//   - SPARSE_SCHUR if the Schur complement is sparse enough to factorize.
+//   - ITERATIVE_SCHUR otherwise, with the CLUSTER_JACOBI preconditioner for
+//     highly covisible problems (if available) and SCHUR_JACOBI for the rest.
+void SelectLinearSolverFromProblemStatistics(
+    const BundleAdjustmentProblemStatistics& statistics,
+    ceres::LinearSolverType* linear_solver_type,
+    ceres::PreconditionerType* preconditioner_type);
+
+// Replaces the preconditioner of an ITERATIVE_SCHUR solve that stalled with a
+// stronger one: SCHUR_JACOBI is replaced by CLUSTER_JACOBI and CLUSTER_JACOBI
+// by CLUSTER_TRIDIAGONAL. The direct solvers are never chosen since
+// ITERATIVE_SCHUR is only selected for problems whose statistics exclude them.
+// Returns false if there is no stronger preconditioner (e.g., if Ceres was
+// built without SuiteSparse).
+bool StrengthenIterativeSchurPreconditioner(
+    ceres::PreconditionerType* preconditioner_type);
+
+// An iteration callback that terminates the Ceres solve early when:
+//   - The relative decrease in cost per second of solver time has been below
+//     min_relative_cost_decrease_per_second for max_num_slow_iterations
+//     consecutive iterations. The solve is considered converged.
+//   - The linear solver has stalled (i.e., it hit max_linear_solver_iterations
+//     without converging) for max_num_stalled_iterations consecutive
+//     iterations. Rejected steps are part of the normal trust region behavior
+//     and are not considered stalls. This is intended for ITERATIVE_SCHUR so
+//     that the caller may continue the solve with a stronger preconditioner.
+// Either criterion is disabled by setting its threshold to 0.
+class BundleAdjustmentConvergenceMonitor : public ceres::IterationCallback {
+ public:
+  BundleAdjustmentConvergenceMonitor(
+      const double min_relative_cost_decrease_per_second,
+      const int max_num_slow_iterations,
+      const int max_num_stalled_iterations,
+      const int max_linear_solver_iterations);
+  ~BundleAdjustmentConvergenceMonitor() {}
+
+  ceres::CallbackReturnType operator()(
+      const ceres::IterationSummary& summary) override;
+
+  // Returns true if the solve was terminated because the linear solver
+  // stalled.
+  bool stalled() const { return stalled_; }
+
+  // Returns true if the solve was terminated because the cost was not
+  // decreasing fast enough.
+  bool converged() const { return converged_; }
+
+ private:
+  const double min_relative_cost_decrease_per_second_;
+  const int max_num_slow_iterations_;
+  const int max_num_stalled_iterations_;
+  const int max_linear_solver_iterations_;
+
+  int num_slow_iterations_;
+  int num_stalled_iterations_;
+  bool stalled_;
+  bool converged_;
+};
+
+}  // namespace theia
+
+#endif  // THEIA_SFM_BUNDLE_ADJUSTMENT_ADAPTIVE_BUNDLE_ADJUSTMENT_H_
@@ -0,0 +1,253 @@
+// Copyright (C) 2026 The Regents of the University of California (Regents).
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials provided
+//       with the distribution.
+//
+//     * Neither the name of The Regents or University of California nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+// Please contact the author of this library if you have any questions.
+// Author: agent (agent@local)
+
+#include <ceres/ceres.h>
+#include <string>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "theia/sfm/bundle_adjustment/adaptive_bundle_adjustment.h"
+#include "theia/sfm/feature.h"
+#include "theia/sfm/reconstruction.h"
+#include "theia/sfm/track.h"
+#include "theia/sfm/types.h"
+#include "theia/sfm/view.h"
+
+namespace theia {
+
+namespace {
+
+// Creates a reconstruction with num_views estimated views where each track is
+// observed by track_length consecutive views.
+void CreateSequentialReconstruction(const int num_views,
+                                    const int track_length,
+                                    Reconstruction* reconstruction,
+                                    std::unordered_set<ViewId>* view_ids,
+                                    std::unordered_set<TrackId>* track_ids) {
+  std::vector<ViewId> views;
+  for (int i = 0; i < num_views; i++) {
+    const ViewId view_id = reconstruction->AddView(std::to_string(i));
+    reconstruction->MutableView(view_id)->SetEstimated(true);
+    views.emplace_back(view_id);
+    view_ids->emplace(view_id);
+  }
+
+  for (int i = 0; i + track_length <= num_views; i++) {
+    std::vector<std::pair<ViewId, Feature> > observations;
+    for (int j = 0; j < track_length; j++) {
+      observations.emplace_back(views[i + j], Feature(i, j));
+    }
+    const TrackId track_id = reconstruction->AddTrack(observations);
+    reconstruction->MutableTrack(track_id)->SetEstimated(true);
+    track_ids->emplace(track_id);
+  }
+}
+
+ceres::IterationSummary MakeIterationSummary(
+    const int iteration,
+    const bool step_is_successful,
+    const double cost,
+    const double cost_change,
+    const double time_in_seconds,
+    const int linear_solver_iterations = 0) {
+  ceres::IterationSummary summary;
+  summary.iteration = iteration;
+  summary.step_is_successful = step_is_successful;
+  summary.cost = cost;
+  summary.cost_change = cost_change;
+  summary.iteration_time_in_seconds = time_in_seconds;
+  summary.linear_solver_iterations = linear_solver_iterations;
+  return summary;
+}
+
+}  // namespace
+
+TEST(AdaptiveBundleAdjustment, ProblemStatistics) {
+  static const int kNumViews = 10;
+  static const int kTrackLength = 3;
+  Reconstruction reconstruction;
+  std::unordered_set<ViewId> view_ids;
+  std::unordered_set<TrackId> track_ids;
+  CreateSequentialReconstruction(
+      kNumViews, kTrackLength, &reconstruction, &view_ids, &track_ids);
+
+  const BundleAdjustmentProblemStatistics statistics =
+      ComputeBundleAdjustmentProblemStatistics(
+          reconstruction, view_ids, track_ids);
+  EXPECT_EQ(statistics.num_cameras, kNumViews);
+  EXPECT_EQ(statistics.num_points, kNumViews - kTrackLength + 1);
+  EXPECT_EQ(statistics.num_observations,
+            kTrackLength * (kNumViews - kTrackLength + 1));
+  // Each view is covisible with the (up to) two views before and after it.
+  EXPECT_EQ(statistics.num_covisible_camera_pairs, 2 * kNumViews - 3);
+  EXPECT_DOUBLE_EQ(statistics.mean_camera_covisibility,
+                   2.0 * (2 * kNumViews - 3) / kNumViews);
+  EXPECT_DOUBLE_EQ(statistics.schur_complement_density,
+                   (kNumViews + 2.0 * (2 * kNumViews - 3)) /
+                       (kNumViews * kNumViews));
+
+  // Views that are not estimated do not contribute to the problem.
+  reconstruction.MutableView(*view_ids.begin())->SetEstimated(false);
+  const BundleAdjustmentProblemStatistics partial_statistics =
+      ComputeBundleAdjustmentProblemStatistics(
+          reconstruction, view_ids, track_ids);
+  EXPECT_EQ(partial_statistics.num_cameras, kNumViews - 1);
+  EXPECT_LT(partial_statistics.num_observations, statistics.num_observations);
+}
+
+TEST(AdaptiveBundleAdjustment, ProblemStatisticsWithLongTracks) {
+  static const int kNumViews = 200;
+  Reconstruction reconstruction;
+  std::unordered_set<ViewId> view_ids;
+  std::unordered_set<TrackId> track_ids;
+  CreateSequentialReconstruction(
+      kNumViews, kNumViews, &reconstruction, &view_ids, &track_ids);
+
+  // The observations are counted exactly but the covisible camera pairs of the
+  // single track that is observed by all views are capped per observation.
+  const BundleAdjustmentProblemStatistics statistics =
+      ComputeBundleAdjustmentProblemStatistics(
+          reconstruction, view_ids, track_ids);
+  EXPECT_EQ(statistics.num_cameras, kNumViews);
+  EXPECT_EQ(statistics.num_points, 1);
+  EXPECT_EQ(statistics.num_observations, kNumViews);
+  EXPECT_GE(statistics.num_covisible_camera_pairs, kNumViews);
+  EXPECT_LT(statistics.num_covisible_camera_pairs,
+            kNumViews * (kNumViews - 1) / 2);
+}
+
+TEST(AdaptiveBundleAdjustment, SelectLinearSolver) {
+  ceres::LinearSolverType linear_solver_type;
+  ceres::PreconditionerType preconditioner_type;
+
+  // Small problems use a dense solver.
+  BundleAdjustmentProblemStatistics statistics;
+  statistics.num_cameras = 50;
+  statistics.num_covisible_camera_pairs = 100;
+  statistics.schur_complement_density = 0.1;
+  SelectLinearSolverFromProblemStatistics(
+      statistics, &linear_solver_type, &preconditioner_type);
+  EXPECT_EQ(linear_solver_type, ceres::DENSE_SCHUR);
+
+  // Larger problems with a dense Schur complement also use a dense solver.
+  statistics.num_cameras = 300;
+  statistics.num_covisible_camera_pairs = 40000;
+  statistics.schur_complement_density = 0.9;
+  SelectLinearSolverFromProblemStatistics(
+      statistics, &linear_solver_type, &preconditioner_type);
+  EXPECT_EQ(linear_solver_type, ceres::DENSE_SCHUR);
+
+  // Sparse problems use a sparse direct solver.
+  statistics.num_cameras = 2000;
+  statistics.num_covisible_camera_pairs = 20000;
+  statistics.schur_complement_density = 0.01;
+  statistics.mean_camera_covisibility = 20;
+  SelectLinearSolverFromProblemStatistics(
+      statistics, &linear_solver_type, &preconditioner_type);
+  EXPECT_EQ(linear_solver_type, ceres::SPARSE_SCHUR);
+
+  // Large problems with too many Schur complement blocks use an iterative
+  // solver.
+  statistics.num_cameras = 20000;
+  statistics.num_covisible_camera_pairs = 2000000;
+  statistics.schur_complement_density = 0.01;
+  statistics.mean_camera_covisibility = 200;
+  SelectLinearSolverFromProblemStatistics(
+      statistics, &linear_solver_type, &preconditioner_type);
+  EXPECT_EQ(linear_solver_type, ceres::ITERATIVE_SCHUR);
+}
+
+TEST(AdaptiveBundleAdjustment, ConvergenceMonitorStopsOnSlowProgress) {
+  BundleAdjustmentConvergenceMonitor monitor(1e-3, 2, 0, 0);
+  EXPECT_EQ(monitor(MakeIterationSummary(0, true, 100.0, 0.0, 0.0)),
+            ceres::SOLVER_CONTINUE);
+  // A 10% decrease in one second is fast enough.
+  EXPECT_EQ(monitor(MakeIterationSummary(1, true, 90.0, 10.0, 1.0)),
+            ceres::SOLVER_CONTINUE);
+  // A 1e-5 relative decrease in one second is too slow.
+  EXPECT_EQ(monitor(MakeIterationSummary(2, true, 90.0, 9e-4, 1.0)),
+            ceres::SOLVER_CONTINUE);
+  EXPECT_EQ(monitor(MakeIterationSummary(3, true, 90.0, 9e-4, 1.0)),
+            ceres::SOLVER_TERMINATE_SUCCESSFULLY);
+  EXPECT_TRUE(monitor.converged());
+  EXPECT_FALSE(monitor.stalled());
+}
+
+TEST(AdaptiveBundleAdjustment, ConvergenceMonitorDetectsStalls) {
+  static const int kMaxLinearSolverIterations = 50;
+  BundleAdjustmentConvergenceMonitor monitor(
+      0.0, 0, 3, kMaxLinearSolverIterations);
+  // Rejected steps are normal trust region behavior and are not stalls.
+  for (int i = 1; i <= 5; i++) {
+    EXPECT_EQ(monitor(MakeIterationSummary(i, false, 100.0, 0.0, 1.0, 10)),
+              ceres::SOLVER_CONTINUE);
+  }
+  EXPECT_EQ(monitor(MakeIterationSummary(
+                6, true, 100.0, 0.0, 1.0, kMaxLinearSolverIterations)),
+            ceres::SOLVER_CONTINUE);
+  // A linear solve that converges resets the number of stalled iterations.
+  EXPECT_EQ(monitor(MakeIterationSummary(7, true, 90.0, 10.0, 1.0, 10)),
+            ceres::SOLVER_CONTINUE);
+  EXPECT_EQ(monitor(MakeIterationSummary(
+                8, false, 90.0, 0.0, 1.0, kMaxLinearSolverIterations)),
+            ceres::SOLVER_CONTINUE);
+  EXPECT_EQ(monitor(MakeIterationSummary(
+                9, true, 89.0, 1.0, 1.0, kMaxLinearSolverIterations)),
+            ceres::SOLVER_CONTINUE);
+  EXPECT_EQ(monitor(MakeIterationSummary(
+                10, false, 89.0, 0.0, 1.0, kMaxLinearSolverIterations)),
+            ceres::SOLVER_TERMINATE_SUCCESSFULLY);
+  EXPECT_TRUE(monitor.stalled());
+  EXPECT_FALSE(monitor.converged());
+}
+
+TEST(AdaptiveBundleAdjustment, StrengthenIterativeSchurPreconditioner) {
+  ceres::PreconditionerType preconditioner_type = ceres::SCHUR_JACOBI;
+#ifndef CERES_NO_SUITESPARSE
+  EXPECT_TRUE(StrengthenIterativeSchurPreconditioner(&preconditioner_type));
+  EXPECT_EQ(preconditioner_type, ceres::CLUSTER_JACOBI);
+  EXPECT_TRUE(StrengthenIterativeSchurPreconditioner(&preconditioner_type));
+  EXPECT_EQ(preconditioner_type, ceres::CLUSTER_TRIDIAGONAL);
+  EXPECT_FALSE(StrengthenIterativeSchurPreconditioner(&preconditioner_type));
+  EXPECT_EQ(preconditioner_type, ceres::CLUSTER_TRIDIAGONAL);
+#else
+  EXPECT_FALSE(StrengthenIterativeSchurPreconditioner(&preconditioner_type));
+  EXPECT_EQ(preconditioner_type, ceres::SCHUR_JACOBI);
+#endif  // CERES_NO_SUITESPARSE
+}
+
+}  // namespace theia
@@ -41,6 +41,7 @@
 #include <unordered_set>
 #include <vector>
 
+#include "theia/sfm/bundle_adjustment/adaptive_bundle_adjustment.h"
 #include "theia/sfm/bundle_adjustment/bundle_adjustment.h"
 #include "theia/sfm/bundle_adjustment/create_loss_function.h"
 #include "theia/sfm/camera/camera.h"
@@ -53,6 +54,11 @@
 
 namespace theia {
 namespace {
+
+// The number of consecutive iterations without a useful step after which the
+// ITERATIVE_SCHUR solver is considered to have stalled.
+static const int kMaxNumStalledIterations = 3;
+
 // Set the solver options to defaults.
 void SetSolverOptions(const BundleAdjustmentOptions& options,
                       ceres::Solver::Options* solver_options) {
@@ -139,42 +145,72 @@ void BundleAdjuster::AddView(const ViewId view_id) {
 }
 
 void BundleAdjuster::AddTrack(const TrackId track_id) {
-  Track* track = CHECK_NOTNULL(reconstruction_->MutableTrack(track_id));
+  if (!StartAddingTrack(track_id)) {
+    return;
+  }
+
+  // Add all observations of the track to the problem.
+  const auto& observed_view_ids = reconstruction_->Track(track_id)->ViewIds();
+  for (const ViewId view_id : observed_view_ids) {
+    AddTrackObservation(track_id, view_id);
+  }
+  FinishAddingTrack(track_id);
+}
+
+void BundleAdjuster::AddTrack(const TrackId track_id,
+                              const std::vector<ViewId>& view_ids) {
+  if (!StartAddingTrack(track_id)) {
+    return;
+  }
+
+  for (const ViewId view_id : view_ids) {
+    CHECK(ContainsKey(reconstruction_->Track(track_id)->ViewIds(), view_id))
+        << "View " << view_id << " does not observe track " << track_id;
+    AddTrackObservation(track_id, view_id);
+  }
+  FinishAddingTrack(track_id);
+}
+
+bool BundleAdjuster::StartAddingTrack(const TrackId track_id) {
+  const Track* track = CHECK_NOTNULL(reconstruction_->Track(track_id));
   // Only optimize estimated tracks.
   if (!track->IsEstimated() || ContainsKey(optimized_tracks_, track_id)) {
-    return;
+    return false;
   }
 
   // Mark the track as optimized.
   optimized_tracks_.emplace(track_id);
+  return true;
+}
 
-  // Add all observations of the track to the problem.
-  const auto& observed_view_ids = track->ViewIds();
-  for (const ViewId view_id : observed_view_ids) {
-    View* view = CHECK_NOTNULL(reconstruction_->MutableView(view_id));
-    // Only optimize estimated views that have not already been added.
-    if (ContainsKey(optimized_views_, view_id) || !view->IsEstimated()) {
-      continue;
-    }
+void BundleAdjuster::AddTrackObservation(const TrackId track_id,
+                                         const ViewId view_id) {
+  View* view = CHECK_NOTNULL(reconstruction_->MutableView(view_id));
+  // Only optimize estimated views that have not already been added.
+  if (ContainsKey(optimized_views_, view_id) || !view->IsEstimated()) {
+    return;
+  }
 
-    const Feature* feature = CHECK_NOTNULL(view->GetFeature(track_id));
-    Camera* camera = view->MutableCamera();
+  const Feature* feature = CHECK_NOTNULL(view->GetFeature(track_id));
+  Camera* camera = view->MutableCamera();
 
-    // Add the reprojection error to the optimization.
-    AddReprojectionErrorResidual(*feature, camera, track);
+  // Add the reprojection error to the optimization.
+  AddReprojectionErrorResidual(
+      *feature, camera, reconstruction_->MutableTrack(track_id));
 
-    // Any camera that reaches this point was not added by AddView() and so we
-    // want to mark it as constant.
-    SetCameraExtrinsicsConstant(view_id);
+  // Any camera that reaches this point was not added by AddView() and so we
+  // want to mark it as constant.
+  SetCameraExtrinsicsConstant(view_id);
 
-    // Mark the camera intrinsics as "potentially constant." We only set the
-    // parameter block to constant if the shared intrinsics are not shared
-    // with cameras that are being optimized.
-    const CameraIntrinsicsGroupId intrinsics_group_id =
-        reconstruction_->CameraIntrinsicsGroupIdFromViewId(view_id);
-    potentially_constant_camera_intrinsics_groups_.emplace(intrinsics_group_id);
-  }
+  // Mark the camera intrinsics as "potentially constant." We only set the
+  // parameter block to constant if the shared intrinsics are not shared
+  // with cameras that are being optimized.
+  const CameraIntrinsicsGroupId intrinsics_group_id =
+      reconstruction_->CameraIntrinsicsGroupIdFromViewId(view_id);
+  potentially_constant_camera_intrinsics_groups_.emplace(intrinsics_group_id);
+}
 
+void BundleAdjuster::FinishAddingTrack(const TrackId track_id) {
   SetTrackVariable(track_id);
   SetTrackSchurGroup(track_id);
 }
@@ -199,10 +235,40 @@ BundleAdjustmentSummary BundleAdjuster::Optimize() {
     solver_options_.inner_iteration_ordering->Reverse();
   }
 
+  // The adaptive solver selection and the fallback after a stall only apply to
+  // this solve, so they modify a copy of the solver options.
+  ceres::Solver::Options solver_options = solver_options_;
+
+  // Choose the linear solver based on the sparsity of the problem.
+  if (options_.use_adaptive_linear_solver) {
+    const BundleAdjustmentProblemStatistics statistics =
+        ComputeBundleAdjustmentProblemStatistics(
+            *reconstruction_, optimized_views_, optimized_tracks_);
+    SelectLinearSolverFromProblemStatistics(
+        statistics,
+        &solver_options.linear_solver_type,
+        &solver_options.preconditioner_type);
+  }
+
+  // Monitor the progress of the solver to stop early once the cost is no
+  // longer decreasing noticeably, or to detect when the iterative solver
+  // stalls.
+  const bool detect_stalls =
+      options_.use_adaptive_linear_solver &&
+      solver_options.linear_solver_type == ceres::ITERATIVE_SCHUR;
+  BundleAdjustmentConvergenceMonitor convergence_monitor(
+      options_.min_relative_cost_decrease_per_second,
+      options_.max_num_slow_iterations,
+      detect_stalls ? kMaxNumStalledIterations : 0,
+      solver_options.max_linear_solver_iterations);
+  if (detect_stalls || options_.min_relative_cost_decrease_per_second > 0.0) {
+    solver_options.callbacks.emplace_back(&convergence_monitor);
+  }
+
   // Solve the problem.
   const double internal_setup_time = timer_.ElapsedTimeInSeconds();
   ceres::Solver::Summary solver_summary;
-  ceres::Solve(solver_options_, problem_.get(), &solver_summary);
+  ceres::Solve(solver_options, problem_.get(), &solver_summary);
   LOG_IF(INFO, options_.verbose) << solver_summary.FullReport();
 
   // Set the BundleAdjustmentSummary.
@@ -213,6 +279,41 @@ BundleAdjustmentSummary BundleAdjuster::Optimize() {
   summary.initial_cost = solver_summary.initial_cost;
   summary.final_cost = solver_summary.final_cost;
 
+  // If the iterative solver stalled then continue from the current estimate
+  // with a stronger preconditioner for the remaining iterations and time. The
+  // direct solvers are not used since the problem statistics excluded them.
+  int num_iterations = solver_summary.iterations.size();
+  double solve_time_in_seconds = solver_summary.total_time_in_seconds;
+  bool stalled = convergence_monitor.stalled();
+  while (stalled && num_iterations < solver_options_.max_num_iterations &&
+         StrengthenIterativeSchurPreconditioner(
+             &solver_options.preconditioner_type)) {
+    BundleAdjustmentConvergenceMonitor preconditioned_convergence_monitor(
+        options_.min_relative_cost_decrease_per_second,
+        options_.max_num_slow_iterations,
+        kMaxNumStalledIterations,
+        solver_options.max_linear_solver_iterations);
+    solver_options.callbacks.clear();
+    solver_options.callbacks.emplace_back(&preconditioned_convergence_monitor);
+    solver_options.max_num_iterations =
+        solver_options_.max_num_iterations - num_iterations;
+    solver_options.max_solver_time_in_seconds =
+        std::max(0.0,
+                 solver_options_.max_solver_time_in_seconds -
+                     solve_time_in_seconds);
+    VLOG(2) << "ITERATIVE_SCHUR stalled after " << num_iterations
+            << " iterations. Continuing bundle adjustment with preconditioner "
+            << solver_options.preconditioner_type << ".";
+
+    ceres::Solve(solver_options, problem_.get(), &solver_summary);
+    LOG_IF(INFO, options_.verbose) << solver_summary.FullReport();
+    num_iterations += solver_summary.iterations.size();
+    solve_time_in_seconds += solver_summary.total_time_in_seconds;
+    summary.final_cost = solver_summary.final_cost;
+    stalled = preconditioned_convergence_monitor.stalled();
+  }
+  summary.solve_time_in_seconds = solve_time_in_seconds;
+
   // This only indicates whether the optimization was successfully run and makes
   // no guarantees on the quality or convergence.
   summary.success = solver_summary.IsSolutionUsable();
@@ -38,6 +38,7 @@
 #include <ceres/ceres.h>
 #include <ceres/types.h>
 #include <unordered_set>
+#include <vector>
 
 #include "theia/sfm/bundle_adjustment/bundle_adjustment.h"
 #include "theia/sfm/feature.h"
@@ -72,11 +73,22 @@ class BundleAdjuster {
   // for each estimated view that observes the track.
   void AddTrack(const TrackId track_id);
 
+  // Same as above, but residuals are only created for the given views. This is
+  // useful for optimizing a track without its outlier observations.
+  void AddTrack(const TrackId track_id, const std::vector<ViewId>& view_ids);
+
   // After AddView and AddTrack have been called, optimize the provided views
   // and tracks with bundle adjustment.
   BundleAdjustmentSummary Optimize();
 
  protected:
+  // Marks the track as optimized. Returns false if the track cannot be added.
+  bool StartAddingTrack(const TrackId track_id);
+  // Adds the residual of the track observation in the view.
+  void AddTrackObservation(const TrackId track_id, const ViewId view_id);
+  // Sets the track parameters once all of its observations are added.
+  void FinishAddingTrack(const TrackId track_id);
+
   // Add all camera extrinsics and intrinsics to the optimization problem.
   void SetCameraExtrinsicsParameterization();
   void SetCameraIntrinsicsParameterization();
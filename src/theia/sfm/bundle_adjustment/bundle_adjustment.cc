@@ -106,4 +106,18 @@ BundleAdjustmentSummary BundleAdjustTrack(
   return bundle_adjuster.Optimize();
 }
 
+BundleAdjustmentSummary BundleAdjustTrack(
+    const BundleAdjustmentOptions& options,
+    const TrackId track_id,
+    const std::vector<ViewId>& view_ids,
+    Reconstruction* reconstruction) {
+  BundleAdjustmentOptions ba_options = options;
+  ba_options.linear_solver_type = ceres::DENSE_QR;
+  ba_options.use_inner_iterations = false;
+
+  BundleAdjuster bundle_adjuster(ba_options, reconstruction);
+  bundle_adjuster.AddTrack(track_id, view_ids);
+  return bundle_adjuster.Optimize();
+}
+
 }  // namespace theia
@@ -37,6 +37,7 @@
 
 #include <ceres/types.h>
 #include <unordered_set>
+#include <vector>
 
 #include "theia/sfm/bundle_adjustment/create_loss_function.h"
 #include "theia/sfm/types.h"
@@ -88,6 +89,13 @@ struct BundleAdjustmentOptions {
   ceres::VisibilityClusteringType visibility_clustering_type =
       ceres::CANONICAL_VIEWS;
 
+  // If true, the linear solver and preconditioner are chosen from the measured
+  // sparsity of the problem instead of linear_solver_type and
+  // preconditioner_type (see adaptive_bundle_adjustment.h). If the
+  // ITERATIVE_SCHUR solver is chosen and stalls, the optimization is continued
+  // with a stronger preconditioner.
+  bool use_adaptive_linear_solver = false;
+
   // If true, ceres will log verbosely.
   bool verbose = false;
 
@@ -119,6 +127,14 @@ struct BundleAdjustmentOptions {
   double gradient_tolerance = 1e-10;
   double parameter_tolerance = 1e-8;
   double max_trust_region_radius = 1e12;
+
+  // Stop the optimization once the relative decrease in cost per second of
+  // solver time has been below this value for max_num_slow_iterations
+  // consecutive iterations. This avoids spending many iterations on
+  // improvements that are not noticeable. A value of 0 disables this
+  // criterion.
+  double min_relative_cost_decrease_per_second = 0.0;
+  int max_num_slow_iterations = 3;
 };
 
 // Some important metrics for analyzing bundle adjustment results.
@@ -154,6 +170,13 @@ BundleAdjustmentSummary BundleAdjustTrack(
     const TrackId track_id,
     Reconstruction* reconstruction);
 
+// Bundle adjust a single track using only its observations in the given views.
+BundleAdjustmentSummary BundleAdjustTrack(
+    const BundleAdjustmentOptions& options,
+    const TrackId track_id,
+    const std::vector<ViewId>& view_ids,
+    Reconstruction* reconstruction);
+
 }  // namespace theia
 
 #endif  // THEIA_SFM_BUNDLE_ADJUSTMENT_BUNDLE_ADJUSTMENT_H_
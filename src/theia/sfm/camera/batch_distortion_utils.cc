@@ -0,0 +1,252 @@
+// Copyright (C) 2026 The Regents of the University of California (Regents).
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials provided
+//       with the distribution.
+//
+//     * Neither the name of The Regents or University of California nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+// Please contact the author of this library if you have any questions.
+// Author: agent (agent@local)
+
+#include "theia/sfm/camera/batch_distortion_utils.h"
+
+#include <Eigen/Core>
+#include <Eigen/QR>
+#include <glog/logging.h>
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <vector>
+
+namespace theia {
+
+using Eigen::ArrayXd;
+using Eigen::MatrixXd;
+using Eigen::VectorXd;
+
+namespace {
+
+// Number of samples of the distortion curve used to fit the inverse
+// polynomial, and the number of (even) terms of the inverse polynomial.
+static const int kNumInverseFitSamples = 64;
+static const int kNumInverseCoefficients = 4;
+
+// Newton's method roughly doubles the number of correct digits per iteration,
+// so a handful of iterations are enough when starting from the inverse
+// polynomial.
+static const int kMaxNewtonIterations = 10;
+static const double kNewtonTolerance = 1e-12;
+
+// Evaluates r * (1 + c_1 * r^2 + ... + c_n * r^(2n)) and its derivative with
+// respect to r using Horner's scheme.
+void EvaluateRadialPolynomial(const std::vector<double>& coefficients,
+                              const ArrayXd& radii,
+                              ArrayXd* value,
+                              ArrayXd* derivative) {
+  const ArrayXd radii_sq = radii.square();
+  ArrayXd poly = ArrayXd::Zero(radii.size());
+  ArrayXd poly_derivative = ArrayXd::Zero(radii.size());
+  for (int i = coefficients.size() - 1; i >= 0; --i) {
+    poly = (poly + coefficients[i]) * radii_sq;
+    poly_derivative =
+        (poly_derivative + (2.0 * i + 3.0) * coefficients[i]) * radii_sq;
+  }
+  *value = radii * (1.0 + poly);
+  *derivative = 1.0 + poly_derivative;
+}
+
+// Scalar version of the above, used when fitting the inverse polynomial.
+double EvaluateRadialPolynomial(const std::vector<double>& coefficients,
+                                const double radius,
+                                double* derivative) {
+  const double radius_sq = radius * radius;
+  double poly = 0.0;
+  double poly_derivative = 0.0;
+  for (int i = coefficients.size() - 1; i >= 0; --i) {
+    poly = (poly + coefficients[i]) * radius_sq;
+    poly_derivative =
+        (poly_derivative + (2.0 * i + 3.0) * coefficients[i]) * radius_sq;
+  }
+  *derivative = 1.0 + poly_derivative;
+  return radius * (1.0 + poly);
+}
+
+// Fits the coefficients of InverseRadialDistortionPolynomial. Normalizing the
+// radius keeps the least squares problem well-conditioned. The sampled range is
+// clamped to the part of the distortion curve that is monotonically increasing
+// so that the inverse is well-defined.
+VectorXd FitInverseRadialPolynomial(const std::vector<double>& coefficients,
+                                    const double max_distorted_radius) {
+  // Find the undistorted radius that maps to the largest distorted radius by
+  // stepping along the curve while it is increasing.
+  double max_undistorted_radius = 0.0;
+  double derivative = 1.0;
+  const double step = std::max(max_distorted_radius, 1e-6) /
+                      static_cast<double>(kNumInverseFitSamples);
+  for (int i = 0; i < 4 * kNumInverseFitSamples; i++) {
+    const double radius = (i + 1) * step;
+    const double value =
+        EvaluateRadialPolynomial(coefficients, radius, &derivative);
+    if (derivative <= 0.0) {
+      break;
+    }
+    max_undistorted_radius = radius;
+    if (value >= max_distorted_radius) {
+      break;
+    }
+  }
+
+  VectorXd inverse_coefficients = VectorXd::Zero(kNumInverseCoefficients);
+  if (max_undistorted_radius <= 0.0 || max_distorted_radius <= 0.0) {
+    return inverse_coefficients;
+  }
+
+  // Least squares fit of (r_u / r_d - 1) = b_1 * r_d^2 + b_2 * r_d^4 + ...
+  MatrixXd lhs(kNumInverseFitSamples, kNumInverseCoefficients);
+  VectorXd rhs(kNumInverseFitSamples);
+  for (int i = 0; i < kNumInverseFitSamples; i++) {
+    const double undistorted_radius =
+        max_undistorted_radius * (i + 1) / kNumInverseFitSamples;
+    const double distorted_radius = EvaluateRadialPolynomial(
+        coefficients, undistorted_radius, &derivative);
+    const double normalized_radius = distorted_radius / max_distorted_radius;
+    const double distorted_radius_sq = normalized_radius * normalized_radius;
+    double power = distorted_radius_sq;
+    for (int j = 0; j < kNumInverseCoefficients; j++) {
+      lhs(i, j) = power;
+      power *= distorted_radius_sq;
+    }
+    rhs(i) = undistorted_radius / distorted_radius - 1.0;
+  }
+  inverse_coefficients = lhs.colPivHouseholderQr().solve(rhs);
+  return inverse_coefficients;
+}
+
+}  // namespace
+
+std::shared_ptr<const InverseRadialDistortionPolynomial>
+InverseRadialDistortionCache::Get(const std::vector<double>& coefficients,
+                                  const double max_distorted_radius) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (inverse_ != nullptr && inverse_->coefficients == coefficients &&
+      inverse_->max_distorted_radius >= max_distorted_radius) {
+    return inverse_;
+  }
+
+  std::shared_ptr<InverseRadialDistortionPolynomial> inverse =
+      std::make_shared<InverseRadialDistortionPolynomial>();
+  inverse->coefficients = coefficients;
+  inverse->max_distorted_radius =
+      std::exp2(std::ceil(std::log2(std::max(max_distorted_radius, 1e-6))));
+  inverse->inverse_coefficients =
+      FitInverseRadialPolynomial(coefficients, inverse->max_distorted_radius);
+  inverse_ = inverse;
+  return inverse_;
+}
+
+void RemoveCalibrationFromPixels(const double focal_length,
+                                 const double aspect_ratio,
+                                 const double skew,
+                                 const double principal_point_x,
+                                 const double principal_point_y,
+                                 const Eigen::Matrix2Xd& pixels,
+                                 Eigen::Matrix2Xd* normalized_points) {
+  CHECK_NOTNULL(normalized_points)->resize(2, pixels.cols());
+  const double focal_length_y = focal_length * aspect_ratio;
+  normalized_points->row(1) =
+      (pixels.row(1).array() - principal_point_y) / focal_length_y;
+  normalized_points->row(0) =
+      (pixels.row(0).array() - principal_point_x -
+       normalized_points->row(1).array() * skew) /
+      focal_length;
+}
+
+void InvertRadialDistortionPolynomial(
+    const std::vector<double>& coefficients,
+    const Eigen::ArrayXd& distorted_radii,
+    InverseRadialDistortionCache* cache,
+    Eigen::ArrayXd* undistorted_radii,
+    Eigen::Array<bool, Eigen::Dynamic, 1>* converged) {
+  CHECK_NOTNULL(cache);
+  CHECK_NOTNULL(undistorted_radii);
+  CHECK_NOTNULL(converged);
+  if (distorted_radii.size() == 0) {
+    undistorted_radii->resize(0);
+    converged->resize(0);
+    return;
+  }
+
+  // Initial guess from the cached inverse polynomial.
+  const std::shared_ptr<const InverseRadialDistortionPolynomial> inverse =
+      cache->Get(coefficients, distorted_radii.maxCoeff());
+  const VectorXd& inverse_coefficients = inverse->inverse_coefficients;
+  const ArrayXd distorted_radii_sq =
+      (distorted_radii / inverse->max_distorted_radius).square();
+  ArrayXd inverse_poly = ArrayXd::Zero(distorted_radii.size());
+  for (int i = inverse_coefficients.size() - 1; i >= 0; --i) {
+    inverse_poly =
+        (inverse_poly + inverse_coefficients(i)) * distorted_radii_sq;
+  }
+  *undistorted_radii = distorted_radii * (1.0 + inverse_poly);
+
+  // Refine all radii at once with Newton's method.
+  ArrayXd value, derivative, residual;
+  for (int i = 0; i < kMaxNewtonIterations; i++) {
+    EvaluateRadialPolynomial(
+        coefficients, *undistorted_radii, &value, &derivative);
+    residual = value - distorted_radii;
+    if ((residual.abs() <= kNewtonTolerance * (1.0 + distorted_radii))
+            .all()) {
+      break;
+    }
+    *undistorted_radii -= residual / derivative;
+  }
+
+  EvaluateRadialPolynomial(
+      coefficients, *undistorted_radii, &value, &derivative);
+  residual = value - distorted_radii;
+  *converged = (residual.abs() <= 1e-9 * (1.0 + distorted_radii)) &&
+               (derivative > 0.0) && (*undistorted_radii >= 0.0);
+}
+
+void RescalePointsRadially(const Eigen::Matrix2Xd& points,
+                           const Eigen::ArrayXd& old_radii,
+                           const Eigen::ArrayXd& new_radii,
+                           Eigen::Matrix2Xd* rescaled_points) {
+  static const double kVerySmallNumber = 1e-12;
+  CHECK_EQ(points.cols(), old_radii.size());
+  CHECK_EQ(points.cols(), new_radii.size());
+  const ArrayXd scale =
+      (old_radii > kVerySmallNumber)
+          .select(new_radii / old_radii.max(kVerySmallNumber), 1.0);
+  *CHECK_NOTNULL(rescaled_points) =
+      (points.array().rowwise() * scale.transpose()).matrix();
+}
+
+}  // namespace theia
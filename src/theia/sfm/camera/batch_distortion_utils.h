@@ -0,0 +1,130 @@
+// Copyright (C) 2026 The Regents of the University of California (Regents).
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials provided
+//       with the distribution.
+//
+//     * Neither the name of The Regents or University of California nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+// Please contact the author of this library if you have any questions.
+// Author: agent (agent@local)
+
+#ifndef THEIA_SFM_CAMERA_BATCH_DISTORTION_UTILS_H_
+#define THEIA_SFM_CAMERA_BATCH_DISTORTION_UTILS_H_
+
+#include <Eigen/Core>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <vector>
+
+namespace theia {
+
+// Helpers for the batch (i.e. many points at once) distortion and undistortion
+// methods of the camera intrinsics models. All points are stored column-wise
+// and the computations are written as Eigen array expressions so that the
+// compiler can vectorize them over several points at once.
+
+// Removes the focal length, aspect ratio, skew and principal point from the
+// pixels to obtain distorted points in normalized image coordinates. This is
+// the same linear transformation that the pinhole-type camera models apply in
+// PixelToCameraCoordinates before undistortion.
+void RemoveCalibrationFromPixels(const double focal_length,
+                                 const double aspect_ratio,
+                                 const double skew,
+                                 const double principal_point_x,
+                                 const double principal_point_y,
+                                 const Eigen::Matrix2Xd& pixels,
+                                 Eigen::Matrix2Xd* normalized_points);
+
+// A least squares fit of r_u = r_d * (1 + b_1 * s^2 + b_2 * s^4 + ...) with
+// s = r_d / max_distorted_radius that approximates the inverse of the
+// distortion polynomial with the given coefficients on
+// [0, max_distorted_radius].
+struct InverseRadialDistortionPolynomial {
+  std::vector<double> coefficients;
+  double max_distorted_radius = 0.0;
+  Eigen::VectorXd inverse_coefficients;
+};
+
+// Holds the inverse polynomial fit of a camera model so that it is only
+// recomputed when the distortion coefficients change or when the distorted
+// radii exceed the range that the fit covers. The distortion parameters may be
+// modified directly through the parameter block, so the cached fit is always
+// validated against the current coefficients. Lookups are guarded by a mutex
+// so that const camera models may be used from several threads.
+class InverseRadialDistortionCache {
+ public:
+  InverseRadialDistortionCache() {}
+
+  // The fit is cheap to recompute and a copied camera model usually gets new
+  // parameters, so copies start with an empty cache.
+  InverseRadialDistortionCache(const InverseRadialDistortionCache&) {}
+  InverseRadialDistortionCache& operator=(const InverseRadialDistortionCache&) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    inverse_.reset();
+    return *this;
+  }
+
+  // Returns a fit for the coefficients that covers distorted radii up to at
+  // least max_distorted_radius. The range of a new fit is rounded up to the
+  // next power of two so that batches with similar radii share the fit.
+  std::shared_ptr<const InverseRadialDistortionPolynomial> Get(
+      const std::vector<double>& coefficients,
+      const double max_distorted_radius);
+
+ private:
+  std::mutex mutex_;
+  std::shared_ptr<const InverseRadialDistortionPolynomial> inverse_;
+};
+
+// Inverts the odd radial distortion polynomial
+//
+//   r_d = r_u * (1 + c_1 * r_u^2 + c_2 * r_u^4 + ... + c_n * r_u^(2n))
+//
+// for every distorted radius r_d. A polynomial of the same form that maps r_d
+// to r_u is obtained from the cache and is used as the initial guess for a few
+// Newton iterations that are applied to all radii at once. Entries of converged
+// are false if Newton's method did not reach a solution on the monotonic part
+// of the distortion curve; callers should fall back to their scalar
+// undistortion for those entries.
+void InvertRadialDistortionPolynomial(
+    const std::vector<double>& coefficients,
+    const Eigen::ArrayXd& distorted_radii,
+    InverseRadialDistortionCache* cache,
+    Eigen::ArrayXd* undistorted_radii,
+    Eigen::Array<bool, Eigen::Dynamic, 1>* converged);
+
+// Scales each point along its ray from the center of distortion so that its
+// radius changes from old_radii(i) to new_radii(i). Points with a (near) zero
+// radius are copied unchanged.
+void RescalePointsRadially(const Eigen::Matrix2Xd& points,
+                           const Eigen::ArrayXd& old_radii,
+                           const Eigen::ArrayXd& new_radii,
+                           Eigen::Matrix2Xd* rescaled_points);
+
+}  // namespace theia
+
+#endif  // THEIA_SFM_CAMERA_BATCH_DISTORTION_UTILS_H_
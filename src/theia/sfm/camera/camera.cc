@@ -226,6 +226,11 @@ Vector3d Camera::PixelToNormalizedCoordinates(const Vector2d& pixel) const {
   return camera_intrinsics_->ImageToCameraCoordinates(pixel);
 }
 
+void Camera::PixelsToNormalizedCoordinates(
+    const Eigen::Matrix2Xd& pixels, Eigen::Matrix3Xd* normalized_points) const {
+  camera_intrinsics_->ImagePointsToCameraCoordinates(pixels, normalized_points);
+}
+
 void Camera::PrintCameraIntrinsics() const {
   camera_intrinsics_->PrintIntrinsics();
 }
@@ -146,6 +146,12 @@ class Camera {
   Eigen::Vector3d PixelToNormalizedCoordinates(
       const Eigen::Vector2d& pixel) const;
 
+  // Batch version of PixelToNormalizedCoordinates where each column is one
+  // pixel. This uses the batch undistortion of the camera intrinsics model and
+  // should be preferred when normalizing many features of the same image.
+  void PixelsToNormalizedCoordinates(const Eigen::Matrix2Xd& pixels,
+                                     Eigen::Matrix3Xd* normalized_points) const;
+
   // Print the camera intrinsics values in a human-readable format.
   void PrintCameraIntrinsics() const;
 
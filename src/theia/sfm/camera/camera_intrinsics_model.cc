@@ -189,6 +189,60 @@ Eigen::Vector2d CameraIntrinsicsModel::UndistortPoint(
   return undistorted_point;
 }
 
+void CameraIntrinsicsModel::ImagePointsToCameraCoordinates(
+    const Eigen::Matrix2Xd& pixels, Eigen::Matrix3Xd* points) const {
+  CHECK_NOTNULL(points)->resize(3, pixels.cols());
+
+// The switch statement is hoisted outside of the loop so that the camera model
+// type is only resolved once for all points.
+#define CAMERA_MODEL_CASE_BODY(CameraModel)                                   \
+  for (int i = 0; i < pixels.cols(); i++) {                                   \
+    CameraModel::PixelToCameraCoordinates(                                    \
+        parameters(), pixels.col(i).data(), points->col(i).data());           \
+  }
+
+  // Execute the switch statement.
+  CAMERA_MODEL_SWITCH_STATEMENT
+
+#undef CAMERA_MODEL_CASE_BODY
+}
+
+void CameraIntrinsicsModel::DistortPoints(
+    const Eigen::Matrix2Xd& undistorted_points,
+    Eigen::Matrix2Xd* distorted_points) const {
+  CHECK_NOTNULL(distorted_points)->resize(2, undistorted_points.cols());
+
+#define CAMERA_MODEL_CASE_BODY(CameraModel)                                   \
+  for (int i = 0; i < undistorted_points.cols(); i++) {                       \
+    CameraModel::DistortPoint(parameters(),                                   \
+                              undistorted_points.col(i).data(),               \
+                              distorted_points->col(i).data());               \
+  }
+
+  // Execute the switch statement.
+  CAMERA_MODEL_SWITCH_STATEMENT
+
+#undef CAMERA_MODEL_CASE_BODY
+}
+
+void CameraIntrinsicsModel::UndistortPoints(
+    const Eigen::Matrix2Xd& distorted_points,
+    Eigen::Matrix2Xd* undistorted_points) const {
+  CHECK_NOTNULL(undistorted_points)->resize(2, distorted_points.cols());
+
+#define CAMERA_MODEL_CASE_BODY(CameraModel)                                   \
+  for (int i = 0; i < distorted_points.cols(); i++) {                         \
+    CameraModel::UndistortPoint(parameters(),                                 \
+                                distorted_points.col(i).data(),               \
+                                undistorted_points->col(i).data());           \
+  }
+
+  // Execute the switch statement.
+  CAMERA_MODEL_SWITCH_STATEMENT
+
+#undef CAMERA_MODEL_CASE_BODY
+}
+
 void CameraIntrinsicsModel::SetFocalLength(const double focal_length) {
   // Define the functions that we want to execute in every case of the switch
   // statement. CameraModel will be filled in with the appropriate derived
@@ -188,6 +188,18 @@ class CameraIntrinsicsModel {
   virtual Eigen::Vector2d UndistortPoint(
       const Eigen::Vector2d& distorted_point) const;
 
+  // Batch versions of the methods above where each column is one point. The
+  // default implementations simply call the static per-point methods of the
+  // derived class; derived classes may override them with implementations that
+  // process many points at once (e.g., for undistorting all features of an
+  // image).
+  virtual void ImagePointsToCameraCoordinates(
+      const Eigen::Matrix2Xd& pixels, Eigen::Matrix3Xd* points) const;
+  virtual void DistortPoints(const Eigen::Matrix2Xd& undistorted_points,
+                             Eigen::Matrix2Xd* distorted_points) const;
+  virtual void UndistortPoints(const Eigen::Matrix2Xd& distorted_points,
+                               Eigen::Matrix2Xd* undistorted_points) const;
+
   // ----------------------- Getter and Setter methods ---------------------- //
   virtual void SetFocalLength(const double focal_length);
   virtual double FocalLength() const;
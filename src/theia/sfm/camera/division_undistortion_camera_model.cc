@@ -38,6 +38,7 @@
 #include <Eigen/Geometry>
 #include <ceres/rotation.h>
 #include <glog/logging.h>
+#include <limits>
 
 #include "theia/sfm/bundle_adjustment/bundle_adjustment.h"
 #include "theia/sfm/camera/projection_matrix_utils.h"
@@ -170,6 +171,54 @@ void DivisionUndistortionCameraModel::PrintIntrinsics() const {
             << "\nRadialDistortion: " << RadialDistortion1();
 }
 
+// The division model operates on pixels centered at the principal point rather
+// than on normalized image coordinates, so the focal length is removed after
+// undistortion.
+void DivisionUndistortionCameraModel::ImagePointsToCameraCoordinates(
+    const Eigen::Matrix2Xd& pixels, Eigen::Matrix3Xd* points) const {
+  const Eigen::Vector2d principal_point(PrincipalPointX(), PrincipalPointY());
+  const Eigen::Matrix2Xd distorted_points =
+      pixels.colwise() - principal_point;
+  Eigen::Matrix2Xd undistorted_points;
+  UndistortPoints(distorted_points, &undistorted_points);
+
+  CHECK_NOTNULL(points)->resize(3, pixels.cols());
+  points->row(0) = undistorted_points.row(0) / FocalLength();
+  points->row(1) =
+      undistorted_points.row(1) / (FocalLength() * AspectRatio());
+  points->row(2).setOnes();
+}
+
+void DivisionUndistortionCameraModel::DistortPoints(
+    const Eigen::Matrix2Xd& undistorted_points,
+    Eigen::Matrix2Xd* distorted_points) const {
+  static const double kVerySmallNumber =
+      std::numeric_limits<double>::epsilon();
+  const double k = RadialDistortion1();
+  const Eigen::ArrayXd r_u_sq =
+      undistorted_points.colwise().squaredNorm().transpose().array();
+  const Eigen::ArrayXd denom = 2.0 * k * r_u_sq;
+  const Eigen::ArrayXd inner_sqrt = 1.0 - 4.0 * k * r_u_sq;
+
+  // Use the identity where the closed-form expression is degenerate, as in
+  // DistortPoint.
+  const Eigen::ArrayXd scale =
+      (denom.abs() < kVerySmallNumber || inner_sqrt < 0.0)
+          .select(1.0, (1.0 - inner_sqrt.max(0.0).sqrt()) / denom);
+  *CHECK_NOTNULL(distorted_points) =
+      (undistorted_points.array().rowwise() * scale.transpose()).matrix();
+}
+
+void DivisionUndistortionCameraModel::UndistortPoints(
+    const Eigen::Matrix2Xd& distorted_points,
+    Eigen::Matrix2Xd* undistorted_points) const {
+  const Eigen::ArrayXd r_d_sq =
+      distorted_points.colwise().squaredNorm().transpose().array();
+  const Eigen::ArrayXd undistortion = 1.0 / (1.0 + RadialDistortion1() * r_d_sq);
+  *CHECK_NOTNULL(undistorted_points) =
+      (distorted_points.array().rowwise() * undistortion.transpose()).matrix();
+}
+
 // ----------------------- Getter and Setter methods ---------------------- //
 
 void DivisionUndistortionCameraModel::SetAspectRatio(
@@ -38,8 +38,11 @@
 #include <Eigen/Core>
 #include <Eigen/Geometry>
 #include <glog/logging.h>
+#include <cmath>
+#include <vector>
 
 #include "theia/sfm/bundle_adjustment/bundle_adjustment.h"
+#include "theia/sfm/camera/batch_distortion_utils.h"
 #include "theia/sfm/camera_intrinsics_prior.h"
 #include "theia/sfm/camera/projection_matrix_utils.h"
 
@@ -194,6 +197,90 @@ void FisheyeCameraModel::PrintIntrinsics() const {
             << RadialDistortion4();
 }
 
+void FisheyeCameraModel::ImagePointsToCameraCoordinates(
+    const Eigen::Matrix2Xd& pixels, Eigen::Matrix3Xd* points) const {
+  Eigen::Matrix2Xd distorted_points, undistorted_points;
+  RemoveCalibrationFromPixels(FocalLength(),
+                              AspectRatio(),
+                              Skew(),
+                              PrincipalPointX(),
+                              PrincipalPointY(),
+                              pixels,
+                              &distorted_points);
+  UndistortPoints(distorted_points, &undistorted_points);
+
+  CHECK_NOTNULL(points)->resize(3, pixels.cols());
+  points->topRows<2>() = undistorted_points;
+  points->row(2).setOnes();
+}
+
+// The undistorted points are treated as points on the image plane z = 1 so that
+// the angle to the optical axis is theta = atan(r).
+void FisheyeCameraModel::DistortPoints(
+    const Eigen::Matrix2Xd& undistorted_points,
+    Eigen::Matrix2Xd* distorted_points) const {
+  static const double kVerySmallNumber = 1e-8;
+  const Eigen::ArrayXd r_sq =
+      undistorted_points.colwise().squaredNorm().transpose().array();
+  const Eigen::ArrayXd r = r_sq.sqrt();
+  const Eigen::ArrayXd theta = r.unaryExpr([](const double x) {
+    return std::atan(x);
+  });
+  const Eigen::ArrayXd theta_sq = theta.square();
+  const Eigen::ArrayXd theta_d =
+      theta * (1.0 +
+               theta_sq * (RadialDistortion1() +
+                           theta_sq * (RadialDistortion2() +
+                                       theta_sq * (RadialDistortion3() +
+                                                   theta_sq *
+                                                       RadialDistortion4()))));
+
+  // Points very close to the center of distortion are not distorted.
+  const Eigen::ArrayXd scale =
+      (r_sq < kVerySmallNumber).select(1.0, theta_d / r.max(kVerySmallNumber));
+  *CHECK_NOTNULL(distorted_points) =
+      (undistorted_points.array().rowwise() * scale.transpose()).matrix();
+}
+
+void FisheyeCameraModel::UndistortPoints(
+    const Eigen::Matrix2Xd& distorted_points,
+    Eigen::Matrix2Xd* undistorted_points) const {
+  CHECK_NOTNULL(undistorted_points);
+
+  // The radius of the distorted point is theta_d. Invert the distortion
+  // polynomial to recover theta, then the undistorted radius is tan(theta).
+  const std::vector<double> radial_distortion = {RadialDistortion1(),
+                                                 RadialDistortion2(),
+                                                 RadialDistortion3(),
+                                                 RadialDistortion4()};
+  const Eigen::ArrayXd distorted_radii =
+      distorted_points.colwise().norm().transpose().array();
+  Eigen::ArrayXd theta;
+  Eigen::Array<bool, Eigen::Dynamic, 1> converged;
+  InvertRadialDistortionPolynomial(
+      radial_distortion,
+      distorted_radii,
+      &inverse_distortion_cache_,
+      &theta,
+      &converged);
+  converged = converged && (theta < M_PI / 2.0);
+  const Eigen::ArrayXd undistorted_radii =
+      converged.select(theta, 0.0).tan();
+  RescalePointsRadially(distorted_points,
+                        distorted_radii,
+                        undistorted_radii,
+                        undistorted_points);
+
+  // Use the iterative undistortion for any points that did not converge.
+  for (int i = 0; i < converged.size(); i++) {
+    if (!converged(i)) {
+      FisheyeCameraModel::UndistortPoint(parameters(),
+                                         distorted_points.col(i).data(),
+                                         undistorted_points->col(i).data());
+    }
+  }
+}
+
 // ----------------------- Getter and Setter methods ---------------------- //
 
 void FisheyeCameraModel::SetAspectRatio(const double aspect_ratio) {
@@ -38,8 +38,10 @@
 #include <Eigen/Core>
 #include <Eigen/Geometry>
 #include <glog/logging.h>
+#include <cmath>
 
 #include "theia/sfm/bundle_adjustment/bundle_adjustment.h"
+#include "theia/sfm/camera/batch_distortion_utils.h"
 #include "theia/sfm/camera_intrinsics_prior.h"
 #include "theia/sfm/camera/projection_matrix_utils.h"
 
@@ -167,6 +169,82 @@ void FOVCameraModel::PrintIntrinsics() const {
             << "\nRadialDistortion: " << RadialDistortion1();
 }
 
+void FOVCameraModel::ImagePointsToCameraCoordinates(
+    const Eigen::Matrix2Xd& pixels, Eigen::Matrix3Xd* points) const {
+  Eigen::Matrix2Xd distorted_points, undistorted_points;
+  RemoveCalibrationFromPixels(FocalLength(),
+                              AspectRatio(),
+                              0.0,
+                              PrincipalPointX(),
+                              PrincipalPointY(),
+                              pixels,
+                              &distorted_points);
+  UndistortPoints(distorted_points, &undistorted_points);
+
+  CHECK_NOTNULL(points)->resize(3, pixels.cols());
+  points->topRows<2>() = undistorted_points;
+  points->row(2).setOnes();
+}
+
+// The FOV model has closed-form distortion and undistortion so the batch
+// versions evaluate the same branches as DistortPoint and UndistortPoint for
+// all points at once.
+void FOVCameraModel::DistortPoints(
+    const Eigen::Matrix2Xd& undistorted_points,
+    Eigen::Matrix2Xd* distorted_points) const {
+  static const double kVerySmallNumber = 1e-3;
+  const double omega = RadialDistortion1();
+  const Eigen::ArrayXd r_u_sq =
+      undistorted_points.colwise().squaredNorm().transpose().array();
+
+  Eigen::ArrayXd r_d;
+  if (omega < kVerySmallNumber) {
+    r_d = (omega * omega * r_u_sq) / 3.0 - omega * omega / 12.0 + 1.0;
+  } else {
+    const double tan_half_omega = std::tan(omega / 2.0);
+    const Eigen::ArrayXd r_u = r_u_sq.max(kVerySmallNumber).sqrt();
+    const Eigen::ArrayXd r_d_exact =
+        (2.0 * tan_half_omega * r_u).unaryExpr([](const double x) {
+          return std::atan(x);
+        }) /
+        (r_u * omega);
+    r_d = (r_u_sq < kVerySmallNumber)
+              .select((-2.0 * tan_half_omega *
+                       (4.0 * r_u_sq * tan_half_omega * tan_half_omega - 3.0)) /
+                          (3.0 * omega),
+                      r_d_exact);
+  }
+
+  *CHECK_NOTNULL(distorted_points) =
+      (undistorted_points.array().rowwise() * r_d.transpose()).matrix();
+}
+
+void FOVCameraModel::UndistortPoints(
+    const Eigen::Matrix2Xd& distorted_points,
+    Eigen::Matrix2Xd* undistorted_points) const {
+  static const double kVerySmallNumber = 1e-3;
+  const double omega = RadialDistortion1();
+  const Eigen::ArrayXd r_d_sq =
+      distorted_points.colwise().squaredNorm().transpose().array();
+
+  Eigen::ArrayXd r_u;
+  if (omega < kVerySmallNumber) {
+    r_u = (omega * omega * r_d_sq) / 3.0 - omega * omega / 12.0 + 1.0;
+  } else {
+    const double tan_half_omega = std::tan(omega / 2.0);
+    const Eigen::ArrayXd r_d = r_d_sq.max(kVerySmallNumber).sqrt();
+    const Eigen::ArrayXd r_u_exact =
+        (r_d * omega).tan() / (2.0 * r_d * tan_half_omega);
+    r_u = (r_d_sq < kVerySmallNumber)
+              .select((omega * (omega * omega * r_d_sq + 3.0)) /
+                          (6.0 * tan_half_omega),
+                      r_u_exact);
+  }
+
+  *CHECK_NOTNULL(undistorted_points) =
+      (distorted_points.array().rowwise() * r_u.transpose()).matrix();
+}
+
 // ----------------------- Getter and Setter methods ---------------------- //
 
 void FOVCameraModel::SetAspectRatio(const double aspect_ratio) {
@@ -98,6 +98,15 @@ class FOVCameraModel : public CameraIntrinsicsModel {
   // Prints the camera intrinsics in a human-readable format.
   void PrintIntrinsics() const override;
 
+  // Batch versions of the CameraIntrinsicsModel methods that process all points
+  // (stored column-wise) at once with vectorized array expressions.
+  void ImagePointsToCameraCoordinates(const Eigen::Matrix2Xd& pixels,
+                                      Eigen::Matrix3Xd* points) const override;
+  void DistortPoints(const Eigen::Matrix2Xd& undistorted_points,
+                     Eigen::Matrix2Xd* distorted_points) const override;
+  void UndistortPoints(const Eigen::Matrix2Xd& distorted_points,
+                       Eigen::Matrix2Xd* undistorted_points) const override;
+
   // Given a point in the camera coordinate system, apply the camera intrinsics
   // (e.g., focal length, principal point, distortion) to transform the point
   // into pixel coordinates.
@@ -38,8 +38,10 @@
 #include <Eigen/Core>
 #include <Eigen/Geometry>
 #include <glog/logging.h>
+#include <vector>
 
 #include "theia/sfm/bundle_adjustment/bundle_adjustment.h"
+#include "theia/sfm/camera/batch_distortion_utils.h"
 #include "theia/sfm/camera_intrinsics_prior.h"
 #include "theia/sfm/camera/projection_matrix_utils.h"
 
@@ -181,6 +183,68 @@ void PinholeCameraModel::PrintIntrinsics() const {
             << RadialDistortion2();
 }
 
+void PinholeCameraModel::ImagePointsToCameraCoordinates(
+    const Eigen::Matrix2Xd& pixels, Eigen::Matrix3Xd* points) const {
+  Eigen::Matrix2Xd distorted_points, undistorted_points;
+  RemoveCalibrationFromPixels(FocalLength(),
+                              AspectRatio(),
+                              Skew(),
+                              PrincipalPointX(),
+                              PrincipalPointY(),
+                              pixels,
+                              &distorted_points);
+  UndistortPoints(distorted_points, &undistorted_points);
+
+  CHECK_NOTNULL(points)->resize(3, pixels.cols());
+  points->topRows<2>() = undistorted_points;
+  points->row(2).setOnes();
+}
+
+void PinholeCameraModel::DistortPoints(
+    const Eigen::Matrix2Xd& undistorted_points,
+    Eigen::Matrix2Xd* distorted_points) const {
+  const Eigen::ArrayXd r_sq =
+      undistorted_points.colwise().squaredNorm().transpose().array();
+  const Eigen::ArrayXd d =
+      1.0 + r_sq * (RadialDistortion1() + RadialDistortion2() * r_sq);
+  *CHECK_NOTNULL(distorted_points) =
+      (undistorted_points.array().rowwise() * d.transpose()).matrix();
+}
+
+void PinholeCameraModel::UndistortPoints(
+    const Eigen::Matrix2Xd& distorted_points,
+    Eigen::Matrix2Xd* undistorted_points) const {
+  CHECK_NOTNULL(undistorted_points);
+
+  // The radial distortion only changes the radius of each point so we only need
+  // to invert r_d = r_u * (1 + k1 * r_u^2 + k2 * r_u^4) for all radii.
+  const std::vector<double> radial_distortion = {RadialDistortion1(),
+                                                 RadialDistortion2()};
+  const Eigen::ArrayXd distorted_radii =
+      distorted_points.colwise().norm().transpose().array();
+  Eigen::ArrayXd undistorted_radii;
+  Eigen::Array<bool, Eigen::Dynamic, 1> converged;
+  InvertRadialDistortionPolynomial(
+      radial_distortion,
+      distorted_radii,
+      &inverse_distortion_cache_,
+      &undistorted_radii,
+      &converged);
+  RescalePointsRadially(distorted_points,
+                        distorted_radii,
+                        undistorted_radii,
+                        undistorted_points);
+
+  // Use the iterative undistortion for any points that did not converge.
+  for (int i = 0; i < converged.size(); i++) {
+    if (!converged(i)) {
+      PinholeCameraModel::UndistortPoint(parameters(),
+                                         distorted_points.col(i).data(),
+                                         undistorted_points->col(i).data());
+    }
+  }
+}
+
 // ----------------------- Getter and Setter methods ---------------------- //
 
 void PinholeCameraModel::SetAspectRatio(const double aspect_ratio) {
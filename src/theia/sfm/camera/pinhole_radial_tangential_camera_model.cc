@@ -38,8 +38,10 @@
 #include <Eigen/Core>
 #include <Eigen/Geometry>
 #include <glog/logging.h>
+#include <vector>
 
 #include "theia/sfm/bundle_adjustment/bundle_adjustment.h"
+#include "theia/sfm/camera/batch_distortion_utils.h"
 #include "theia/sfm/camera_intrinsics_prior.h"
 #include "theia/sfm/camera/projection_matrix_utils.h"
 
@@ -210,6 +212,129 @@ void PinholeRadialTangentialCameraModel::PrintIntrinsics() const {
             << TangentialDistortion2();
 }
 
+void PinholeRadialTangentialCameraModel::ImagePointsToCameraCoordinates(
+    const Eigen::Matrix2Xd& pixels, Eigen::Matrix3Xd* points) const {
+  Eigen::Matrix2Xd distorted_points, undistorted_points;
+  RemoveCalibrationFromPixels(FocalLength(),
+                              AspectRatio(),
+                              Skew(),
+                              PrincipalPointX(),
+                              PrincipalPointY(),
+                              pixels,
+                              &distorted_points);
+  UndistortPoints(distorted_points, &undistorted_points);
+
+  CHECK_NOTNULL(points)->resize(3, pixels.cols());
+  points->topRows<2>() = undistorted_points;
+  points->row(2).setOnes();
+}
+
+void PinholeRadialTangentialCameraModel::DistortPoints(
+    const Eigen::Matrix2Xd& undistorted_points,
+    Eigen::Matrix2Xd* distorted_points) const {
+  const double k1 = RadialDistortion1();
+  const double k2 = RadialDistortion2();
+  const double k3 = RadialDistortion3();
+  const double t1 = TangentialDistortion1();
+  const double t2 = TangentialDistortion2();
+
+  const Eigen::ArrayXd x = undistorted_points.row(0).transpose().array();
+  const Eigen::ArrayXd y = undistorted_points.row(1).transpose().array();
+  const Eigen::ArrayXd r_sq = x.square() + y.square();
+  const Eigen::ArrayXd rd = 1.0 + r_sq * (k1 + r_sq * (k2 + r_sq * k3));
+  const Eigen::ArrayXd xy = x * y;
+
+  CHECK_NOTNULL(distorted_points)->resize(2, undistorted_points.cols());
+  distorted_points->row(0) =
+      (x * rd + t2 * (r_sq + 2.0 * x.square()) + 2.0 * t1 * xy).transpose();
+  distorted_points->row(1) =
+      (y * rd + t1 * (r_sq + 2.0 * y.square()) + 2.0 * t2 * xy).transpose();
+}
+
+void PinholeRadialTangentialCameraModel::UndistortPoints(
+    const Eigen::Matrix2Xd& distorted_points,
+    Eigen::Matrix2Xd* undistorted_points) const {
+  static const int kMaxNewtonIterations = 20;
+  static const double kNewtonTolerance = 1e-12;
+  CHECK_NOTNULL(undistorted_points);
+  const double k1 = RadialDistortion1();
+  const double k2 = RadialDistortion2();
+  const double k3 = RadialDistortion3();
+  const double t1 = TangentialDistortion1();
+  const double t2 = TangentialDistortion2();
+
+  // Initialize by removing only the radial distortion, which is typically the
+  // dominant term.
+  const std::vector<double> radial_distortion = {k1, k2, k3};
+  const Eigen::ArrayXd distorted_radii =
+      distorted_points.colwise().norm().transpose().array();
+  Eigen::ArrayXd undistorted_radii;
+  Eigen::Array<bool, Eigen::Dynamic, 1> converged;
+  InvertRadialDistortionPolynomial(
+      radial_distortion,
+      distorted_radii,
+      &inverse_distortion_cache_,
+      &undistorted_radii,
+      &converged);
+  Eigen::Matrix2Xd initialization;
+  RescalePointsRadially(distorted_points,
+                        distorted_radii,
+                        undistorted_radii,
+                        &initialization);
+
+  // Refine the full radial and tangential model for all points at once with
+  // Newton's method using the analytic 2x2 Jacobian of the distortion.
+  const Eigen::ArrayXd x_d = distorted_points.row(0).transpose().array();
+  const Eigen::ArrayXd y_d = distorted_points.row(1).transpose().array();
+  Eigen::ArrayXd x = converged.select(
+      initialization.row(0).transpose().array(), x_d);
+  Eigen::ArrayXd y = converged.select(
+      initialization.row(1).transpose().array(), y_d);
+  Eigen::ArrayXd residual_x, residual_y, determinant;
+  for (int i = 0; i <= kMaxNewtonIterations; i++) {
+    const Eigen::ArrayXd r_sq = x.square() + y.square();
+    const Eigen::ArrayXd rd = 1.0 + r_sq * (k1 + r_sq * (k2 + r_sq * k3));
+    const Eigen::ArrayXd rd_derivative =
+        k1 + r_sq * (2.0 * k2 + 3.0 * k3 * r_sq);
+    const Eigen::ArrayXd xy = x * y;
+    residual_x =
+        x * rd + t2 * (r_sq + 2.0 * x.square()) + 2.0 * t1 * xy - x_d;
+    residual_y =
+        y * rd + t1 * (r_sq + 2.0 * y.square()) + 2.0 * t2 * xy - y_d;
+
+    const Eigen::ArrayXd j_xx =
+        rd + 2.0 * x.square() * rd_derivative + 6.0 * t2 * x + 2.0 * t1 * y;
+    const Eigen::ArrayXd j_xy =
+        2.0 * xy * rd_derivative + 2.0 * t1 * x + 2.0 * t2 * y;
+    const Eigen::ArrayXd j_yy =
+        rd + 2.0 * y.square() * rd_derivative + 6.0 * t1 * y + 2.0 * t2 * x;
+    determinant = j_xx * j_yy - j_xy * j_xy;
+
+    if (i == kMaxNewtonIterations ||
+        (residual_x.abs().max(residual_y.abs()) <= kNewtonTolerance).all()) {
+      break;
+    }
+    x -= (j_yy * residual_x - j_xy * residual_y) / determinant;
+    y -= (j_xx * residual_y - j_xy * residual_x) / determinant;
+  }
+  converged = (residual_x.abs().max(residual_y.abs()) <= 1e-9) &&
+              (determinant > 0.0);
+
+  undistorted_points->resize(2, distorted_points.cols());
+  undistorted_points->row(0) = x.transpose();
+  undistorted_points->row(1) = y.transpose();
+
+  // Use the iterative undistortion for any points that did not converge.
+  for (int i = 0; i < converged.size(); i++) {
+    if (!converged(i)) {
+      PinholeRadialTangentialCameraModel::UndistortPoint(
+          parameters(),
+          distorted_points.col(i).data(),
+          undistorted_points->col(i).data());
+    }
+  }
+}
+
 // ----------------------- Getter and Setter methods ---------------------- //
 
 void PinholeRadialTangentialCameraModel::SetAspectRatio(
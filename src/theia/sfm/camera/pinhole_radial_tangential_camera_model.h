@@ -46,6 +46,7 @@
 #include <Eigen/Geometry>
 #include <vector>
 
+#include "theia/sfm/camera/batch_distortion_utils.h"
 #include "theia/sfm/camera/camera_intrinsics_model.h"
 #include "theia/sfm/types.h"
 
@@ -125,6 +126,15 @@ class PinholeRadialTangentialCameraModel : public CameraIntrinsicsModel {
   // Prints the camera intrinsics in a human-readable format.
   void PrintIntrinsics() const override;
 
+  // Batch versions of the CameraIntrinsicsModel methods that process all points
+  // (stored column-wise) at once with vectorized array expressions.
+  void ImagePointsToCameraCoordinates(const Eigen::Matrix2Xd& pixels,
+                                      Eigen::Matrix3Xd* points) const override;
+  void DistortPoints(const Eigen::Matrix2Xd& undistorted_points,
+                     Eigen::Matrix2Xd* distorted_points) const override;
+  void UndistortPoints(const Eigen::Matrix2Xd& distorted_points,
+                       Eigen::Matrix2Xd* undistorted_points) const override;
+
   // Given a point in the camera coordinate system, apply the camera intrinsics
   // (e.g., focal length, principal point, distortion) to transform the point
   // into pixel coordinates.
@@ -185,6 +195,10 @@ class PinholeRadialTangentialCameraModel : public CameraIntrinsicsModel {
   void serialize(Archive& ar, const std::uint32_t version) {  // NOLINT
     ar(cereal::base_class<CameraIntrinsicsModel>(this));
   }
+
+  // Inverse distortion polynomial used as the initial guess of
+  // UndistortPoints.
+  mutable InverseRadialDistortionCache inverse_distortion_cache_;
 };
 
 template <typename T>
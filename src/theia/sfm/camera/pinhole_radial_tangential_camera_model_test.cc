@@ -342,4 +342,50 @@ TEST(PinholeRadialTangentialCameraModel, ReprojectionTwoTangentialDistortion) {
   ReprojectionTest(camera);
 }
 
+// Ensure that the batch methods give the same results as the single point
+// methods for points spread over the entire image.
+TEST(PinholeRadialTangentialCameraModel, BatchMatchesSinglePointMethods) {
+  static const double kTolerance = 1e-8;
+  static const int kImageWidth = 1200;
+  static const int kImageHeight = 980;
+  PinholeRadialTangentialCameraModel camera;
+  camera.SetFocalLength(1200);
+  camera.SetPrincipalPoint(600.0, 400.0);
+  camera.SetRadialDistortion(0.01, 0.001, 0.0001);
+  camera.SetTangentialDistortion(0.01, 0.001);
+
+  Eigen::Matrix2Xd pixels(2, (kImageWidth / 20) * (kImageHeight / 20));
+  int num_pixels = 0;
+  for (int x = 0; x < kImageWidth; x += 20) {
+    for (int y = 0; y < kImageHeight; y += 20) {
+      pixels.col(num_pixels++) = Vector2d(x, y);
+    }
+  }
+  pixels.conservativeResize(2, num_pixels);
+
+  Eigen::Matrix3Xd rays;
+  camera.ImagePointsToCameraCoordinates(pixels, &rays);
+  ASSERT_EQ(rays.cols(), pixels.cols());
+  for (int i = 0; i < pixels.cols(); i++) {
+    const Vector3d ray = camera.ImageToCameraCoordinates(pixels.col(i));
+    EXPECT_LT((ray - rays.col(i)).norm(), kTolerance);
+  }
+
+  const Eigen::Matrix2Xd points = 0.6 * Eigen::Matrix2Xd::Random(2, 500);
+  Eigen::Matrix2Xd distorted_points, undistorted_points;
+  camera.DistortPoints(points, &distorted_points);
+  camera.UndistortPoints(points, &undistorted_points);
+  for (int i = 0; i < points.cols(); i++) {
+    Vector2d distorted_point;
+    PinholeRadialTangentialCameraModel::DistortPoint(
+        camera.parameters(), points.col(i).data(), distorted_point.data());
+    EXPECT_LT((distorted_point - distorted_points.col(i)).norm(), kTolerance);
+    Vector2d undistorted_point;
+    PinholeRadialTangentialCameraModel::UndistortPoint(
+        camera.parameters(), points.col(i).data(), undistorted_point.data());
+    EXPECT_LT((undistorted_point - undistorted_points.col(i)).norm(),
+              kTolerance);
+  }
+}
+
 }  // namespace theia
@@ -37,6 +37,7 @@
 
 #include <glog/logging.h>
 
+#include "theia/solvers/evsac.h"
 #include "theia/solvers/exhaustive_ransac.h"
 #include "theia/solvers/lmed.h"
 #include "theia/solvers/prosac.h"
@@ -46,15 +47,22 @@
 namespace theia {
 
 // NOTE: Prosac requires correspondences to be sorted by the descriptor
-// distances with the best match first. See theia/solvers for more information
-// on the various types.
+// distances with the best match first. Evsac requires the sorted descriptor
+// distances of each correspondence in RansacParameters::evsac_sorted_distances
+// and falls back to Ransac if they are not given. See theia/solvers for more
+// information on the various types.
 enum class RansacType {
   RANSAC = 0,
   PROSAC = 1,
   LMED = 2,
   EXHAUSTIVE = 3,
+  EVSAC = 4,
 };
 
+// The recommended parameters of Evsac, see theia/solvers/evsac.h.
+static const double kEvsacPredictorThreshold = 0.65;
+static const FittingMethod kEvsacFittingMethod = MLE;
+
 // Factory method to create a ransac variant based on the specified options. The
 // variante is then initialized and fails if initialization is not successful.
 template <class Estimator>
@@ -77,6 +85,23 @@ CreateAndInitializeRansacVariant(const RansacType& ransac_type,
       ransac_variant.reset(
           new ExhaustiveRansac<Estimator>(ransac_options, estimator));
       break;
+    case RansacType::EVSAC:
+      if (ransac_options.evsac_sorted_distances == nullptr ||
+          ransac_options.evsac_sorted_distances->size() == 0) {
+        LOG(WARNING) << "Evsac requires the sorted descriptor distances of "
+                        "the correspondences. Using Ransac instead.";
+        ransac_variant.reset(new Ransac<Estimator>(ransac_options, estimator));
+        break;
+      }
+      // Like the other variants, Evsac references ransac_options and the
+      // sorted distances it holds, so they must outlive the estimator.
+      ransac_variant.reset(
+          new Evsac<Estimator>(ransac_options,
+                               estimator,
+                               *ransac_options.evsac_sorted_distances,
+                               kEvsacPredictorThreshold,
+                               kEvsacFittingMethod));
+      break;
     default:
       ransac_variant.reset(new Ransac<Estimator>(ransac_options, estimator));
       break;
@@ -36,7 +36,9 @@
 
 #include <Eigen/Core>
 #include <Eigen/Geometry>
+#include <cmath>
 #include <memory>
+#include <utility>
 #include <vector>
 
 #include "theia/math/util.h"
@@ -136,6 +138,7 @@ TrackEstimator::Summary TrackEstimator::EstimateAllTracks() {
 TrackEstimator::Summary TrackEstimator::EstimateTracks(
     const std::unordered_set<TrackId>& track_ids) {
   tracks_to_estimate_.clear();
+  outlier_observations_.clear();
   summary_ = TrackEstimator::Summary();
   num_bad_angles_ = 0;
   num_failed_triangulations_ = 0;
@@ -179,19 +182,32 @@ TrackEstimator::Summary TrackEstimator::EstimateTracks(
   // Wait for all tracks to be estimated.
   pool.reset(nullptr);
 
+  // Remove the observations that robust triangulation labeled as outliers. This
+  // modifies views that are shared between tracks so it must happen after all
+  // workers have finished.
+  for (const auto& observation : outlier_observations_) {
+    if (reconstruction_->RemoveObservation(observation.first,
+                                           observation.second)) {
+      ++summary_.num_outlier_observations_removed;
+    }
+  }
+
   LOG(INFO) << summary_.estimated_tracks.size() << " tracks were estimated of "
             << summary_.num_triangulation_attempts << " possible tracks. "
             << num_bad_angles_
             << " triangulations failed due to bad triangulation angles and "
             << num_bad_reprojections_
-            << " triangulations failed with too high reprojection errors.";
+            << " triangulations failed with too high reprojection errors. "
+            << summary_.num_outlier_observations_removed
+            << " outlier observations were removed.";
   return summary_;
 }
 
 void TrackEstimator::EstimateTrackSet(const int start, const int end) {
   std::unordered_set<TrackId> estimated_tracks;
+  std::vector<std::pair<ViewId, TrackId> > outlier_observations;
   for (int i = start; i < end; i++) {
-    if (EstimateTrack(tracks_to_estimate_[i])) {
+    if (EstimateTrack(tracks_to_estimate_[i], &outlier_observations)) {
       estimated_tracks.emplace(tracks_to_estimate_[i]);
     }
   }
@@ -200,9 +216,14 @@ void TrackEstimator::EstimateTrackSet(const int start, const int end) {
   std::lock_guard<std::mutex> guard(summary_mutex_);
   summary_.estimated_tracks.insert(estimated_tracks.begin(),
                                    estimated_tracks.end());
+  outlier_observations_.insert(outlier_observations_.end(),
+                               outlier_observations.begin(),
+                               outlier_observations.end());
 }
 
-bool TrackEstimator::EstimateTrack(const TrackId track_id) {
+bool TrackEstimator::EstimateTrack(
+    const TrackId track_id,
+    std::vector<std::pair<ViewId, TrackId> >* outlier_observations) {
   static const int kMinNumObservationsForTriangulation = 2;
 
   Track* track = reconstruction_->MutableTrack(track_id);
@@ -220,9 +241,66 @@ bool TrackEstimator::EstimateTrack(const TrackId track_id) {
                                 &origins,
                                 &ray_directions);
 
+  const double sq_max_reprojection_error_pixels =
+      options_.max_acceptable_reprojection_error_pixels *
+      options_.max_acceptable_reprojection_error_pixels;
+
+  if (view_ids.size() < kMinNumObservationsForTriangulation) {
+    ++num_bad_angles_;
+    return false;
+  }
+
+  if (options_.use_robust_triangulation) {
+    std::vector<int> inliers;
+    if (!RobustlyTriangulateTrack(origins, ray_directions, view_ids,
+                                  track->MutablePoint(), &inliers)) {
+      ++num_failed_triangulations_;
+      return false;
+    }
+
+    // Only the inlier observations must have acceptable reprojection errors.
+    std::vector<bool> is_inlier(view_ids.size(), false);
+    std::vector<ViewId> inlier_view_ids;
+    std::vector<Eigen::Vector2d> inlier_features;
+    inlier_view_ids.reserve(inliers.size());
+    inlier_features.reserve(inliers.size());
+    for (const int i : inliers) {
+      is_inlier[i] = true;
+      inlier_view_ids.emplace_back(view_ids[i]);
+      inlier_features.emplace_back(features[i]);
+    }
+
+    // Bundle adjust the track with its inlier observations only.
+    if (options_.bundle_adjustment) {
+      track->SetEstimated(true);
+      const BundleAdjustmentSummary summary = BundleAdjustTrack(
+          options_.ba_options, track_id, inlier_view_ids, reconstruction_);
+      track->SetEstimated(false);
+      if (!summary.success) {
+        return false;
+      }
+    }
+
+    if (!AcceptableReprojectionError(*reconstruction_,
+                                     track_id,
+                                     inlier_view_ids,
+                                     inlier_features,
+                                     sq_max_reprojection_error_pixels)) {
+      ++num_bad_reprojections_;
+      return false;
+    }
+
+    for (int i = 0; i < view_ids.size(); i++) {
+      if (!is_inlier[i]) {
+        outlier_observations->emplace_back(view_ids[i], track_id);
+      }
+    }
+    track->SetEstimated(true);
+    return true;
+  }
+
   // Check the angle between views.
-  if (view_ids.size() < kMinNumObservationsForTriangulation ||
-      !SufficientTriangulationAngle(ray_directions,
+  if (!SufficientTriangulationAngle(ray_directions,
                                     options_.min_triangulation_angle_degrees)) {
     ++num_bad_angles_;
     return false;
@@ -246,10 +324,6 @@ bool TrackEstimator::EstimateTrack(const TrackId track_id) {
   }
 
   // Ensure the reprojection errors are acceptable.
-  const double sq_max_reprojection_error_pixels =
-      options_.max_acceptable_reprojection_error_pixels *
-      options_.max_acceptable_reprojection_error_pixels;
-
   if (!AcceptableReprojectionError(*reconstruction_,
                                    track_id,
                                    view_ids,
@@ -263,4 +337,35 @@ bool TrackEstimator::EstimateTrack(const TrackId track_id) {
   return true;
 }
 
+bool TrackEstimator::RobustlyTriangulateTrack(
+    const std::vector<Eigen::Vector3d>& origins,
+    const std::vector<Eigen::Vector3d>& ray_directions,
+    const std::vector<ViewId>& view_ids,
+    Eigen::Vector4d* triangulated_point,
+    std::vector<int>* inliers) {
+  // Convert the reprojection error threshold to an angular threshold using the
+  // mean focal length of the cameras observing the track.
+  double mean_focal_length = 0;
+  for (const ViewId view_id : view_ids) {
+    mean_focal_length += reconstruction_->View(view_id)->Camera().FocalLength();
+  }
+  mean_focal_length /= static_cast<double>(view_ids.size());
+  if (mean_focal_length <= 0) {
+    return false;
+  }
+
+  RobustTriangulationOptions triangulation_options;
+  triangulation_options.max_num_samples =
+      options_.max_num_robust_triangulation_samples;
+  triangulation_options.max_angular_error_degrees = RadToDeg(std::atan(
+      options_.max_acceptable_reprojection_error_pixels / mean_focal_length));
+  triangulation_options.min_triangulation_angle_degrees =
+      options_.min_triangulation_angle_degrees;
+  return TriangulateRobust(triangulation_options,
+                           origins,
+                           ray_directions,
+                           triangulated_point,
+                           inliers);
+}
+
 }  // namespace theia
@@ -35,9 +35,11 @@
 #ifndef THEIA_SFM_ESTIMATE_TRACK_H_
 #define THEIA_SFM_ESTIMATE_TRACK_H_
 
+#include <Eigen/Core>
 #include <atomic>
 #include <mutex>
 #include <unordered_set>
+#include <utility>
 #include <vector>
 
 #include "theia/sfm/bundle_adjustment/bundle_adjustment.h"
@@ -71,6 +73,19 @@ class TrackEstimator {
     bool bundle_adjustment = true;
     BundleAdjustmentOptions ba_options;
 
+    // If true, tracks are triangulated with TriangulateRobust: RANSAC over
+    // pairs of observations followed by a fixed number of reweighted
+    // refinement iterations. Outlier observations are removed from the
+    // reconstruction once all tracks are estimated. If bundle_adjustment is
+    // true, each track is then bundle adjusted with its inlier observations
+    // only. This is recommended for scenes with very long tracks where a single
+    // bad observation corrupts the midpoint triangulation.
+    bool use_robust_triangulation = false;
+
+    // The maximum number of two-view hypotheses evaluated per track when using
+    // robust triangulation.
+    int max_num_robust_triangulation_samples = 100;
+
     // For thread-level parallelism, it is better to estimate a small fixed
     // number of tracks per thread worker instead of 1 track per worker. This
     // number controls how many points are estimated per worker.
@@ -87,6 +102,10 @@ class TrackEstimator {
     // TrackId of the newly estimated tracks. This set does not include tracks
     // that were input as estimated.
     std::unordered_set<TrackId> estimated_tracks;
+
+    // Number of outlier observations that were removed from the newly
+    // estimated tracks. This is only nonzero with robust triangulation.
+    int num_outlier_observations_removed = 0;
   };
 
   TrackEstimator(const Options& options, Reconstruction* reconstruction)
@@ -100,7 +119,18 @@ class TrackEstimator {
 
  private:
   void EstimateTrackSet(const int start, const int stop);
-  bool EstimateTrack(const TrackId track_id);
+  bool EstimateTrack(const TrackId track_id,
+                     std::vector<std::pair<ViewId, TrackId> >*
+                         outlier_observations);
+
+  // Triangulates the track with TriangulateRobust and returns the indices of
+  // the inlier observations.
+  bool RobustlyTriangulateTrack(
+      const std::vector<Eigen::Vector3d>& origins,
+      const std::vector<Eigen::Vector3d>& ray_directions,
+      const std::vector<ViewId>& view_ids,
+      Eigen::Vector4d* triangulated_point,
+      std::vector<int>* inliers);
 
   const Options options_;
   Reconstruction* reconstruction_;
@@ -110,6 +140,10 @@ class TrackEstimator {
   TrackEstimator::Summary summary_;
   std::mutex summary_mutex_;
 
+  // Observations rejected by robust triangulation. These are removed from the
+  // reconstruction after all worker threads have finished.
+  std::vector<std::pair<ViewId, TrackId> > outlier_observations_;
+
   std::atomic_int num_bad_angles_, num_failed_triangulations_,
       num_bad_reprojections_;
 };
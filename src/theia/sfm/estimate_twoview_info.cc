@@ -34,16 +34,20 @@
 
 #include "theia/sfm/estimate_twoview_info.h"
 
+#include <ceres/rotation.h>
 #include <Eigen/Core>
 #include <Eigen/Geometry>
 #include <glog/logging.h>
 
+#include <memory>
 #include <vector>
 
 #include "theia/matching/feature_correspondence.h"
 #include "theia/sfm/camera/camera.h"
 #include "theia/sfm/camera_intrinsics_prior.h"
 #include "theia/sfm/estimators/estimate_relative_pose.h"
+#include "theia/sfm/estimators/estimate_relative_pose_with_known_orientation.h"
+#include "theia/sfm/estimators/estimate_relative_pose_with_known_vertical.h"
 #include "theia/sfm/estimators/estimate_uncalibrated_relative_pose.h"
 #include "theia/sfm/pose/util.h"
 #include "theia/sfm/reconstruction_estimator_utils.h"
@@ -52,6 +56,7 @@
 #include "theia/sfm/twoview_info.h"
 #include "theia/sfm/types.h"
 #include "theia/sfm/visibility_pyramid.h"
+#include "theia/math/util.h"
 #include "theia/solvers/sample_consensus_estimator.h"
 
 namespace theia {
@@ -84,18 +89,24 @@ void NormalizeFeatures(
     camera2.SetFocalLength(1.0);
   }
 
-  normalized_correspondences->reserve(correspondences.size());
-  for (const FeatureCorrespondence& correspondence : correspondences) {
-    FeatureCorrespondence normalized_correspondence;
-    const Eigen::Vector3d normalized_feature1 =
-        camera1.PixelToNormalizedCoordinates(correspondence.feature1);
-    normalized_correspondence.feature1 = normalized_feature1.hnormalized();
-
-    const Eigen::Vector3d normalized_feature2 =
-        camera2.PixelToNormalizedCoordinates(correspondence.feature2);
-    normalized_correspondence.feature2 = normalized_feature2.hnormalized();
-
-    normalized_correspondences->emplace_back(normalized_correspondence);
+  // Normalize the features of each image at once with the batch
+  // undistortion.
+  Eigen::Matrix2Xd features1(2, correspondences.size());
+  Eigen::Matrix2Xd features2(2, correspondences.size());
+  for (int i = 0; i < correspondences.size(); i++) {
+    features1.col(i) = correspondences[i].feature1;
+    features2.col(i) = correspondences[i].feature2;
+  }
+  Eigen::Matrix3Xd normalized_features1, normalized_features2;
+  camera1.PixelsToNormalizedCoordinates(features1, &normalized_features1);
+  camera2.PixelsToNormalizedCoordinates(features2, &normalized_features2);
+
+  normalized_correspondences->resize(correspondences.size());
+  for (int i = 0; i < correspondences.size(); i++) {
+    (*normalized_correspondences)[i].feature1 =
+        normalized_features1.col(i).hnormalized();
+    (*normalized_correspondences)[i].feature2 =
+        normalized_features2.col(i).hnormalized();
   }
 }
 
@@ -115,9 +126,9 @@ int ComputeVisibilityScoreOfInliers(
   }
 
   // Compute the visibility score for all inliers.
-  VisibilityPyramid pyramid1(
+  BitsetVisibilityPyramid pyramid1(
       intrinsics1.image_width, intrinsics1.image_height, kNumPyramidLevels);
-  VisibilityPyramid pyramid2(
+  BitsetVisibilityPyramid pyramid2(
       intrinsics2.image_width, intrinsics2.image_height, kNumPyramidLevels);
   for (const int i : inlier_indices) {
     const FeatureCorrespondence& match = correspondences[i];
@@ -128,11 +139,154 @@ int ComputeVisibilityScoreOfInliers(
   return pyramid1.ComputeScore() + pyramid2.ComputeScore();
 }
 
+// The known orientation solvers rotate the normalized features, which is only
+// well-conditioned when the features stay in front of the rotated camera. If a
+// larger rotation must be applied we fall back to the five point algorithm.
+static const double kMaxFeatureRotationDegrees = 45.0;
+
+// Returns the world-to-camera rotation given by the orientation prior.
+Matrix3d RotationFromOrientationPrior(const CameraIntrinsicsPrior& prior) {
+  Matrix3d rotation;
+  ceres::AngleAxisToRotationMatrix(
+      prior.orientation.value, ceres::ColumnMajorAdapter3x3(rotation.data()));
+  return rotation;
+}
+
+// Rotates the normalized features of the first and second views.
+void RotateFeatures(const Matrix3d& rotation1,
+                    const Matrix3d& rotation2,
+                    std::vector<FeatureCorrespondence>* correspondences) {
+  for (FeatureCorrespondence& correspondence : *correspondences) {
+    correspondence.feature1 =
+        (rotation1 * correspondence.feature1.homogeneous()).hnormalized();
+    correspondence.feature2 =
+        (rotation2 * correspondence.feature2.homogeneous()).hnormalized();
+  }
+}
+
+// Estimates the relative pose when the relative rotation between the views is
+// given by the orientation priors. Only the translation direction is estimated
+// with the 2-point solver.
+bool EstimateRelativePoseWithKnownRotationPrior(
+    const RansacParameters& ransac_options,
+    const EstimateTwoViewInfoOptions& options,
+    const CameraIntrinsicsPrior& intrinsics1,
+    const CameraIntrinsicsPrior& intrinsics2,
+    const std::vector<FeatureCorrespondence>& normalized_correspondences,
+    RelativePose* relative_pose,
+    RansacSummary* summary) {
+  const Matrix3d relative_rotation =
+      RotationFromOrientationPrior(intrinsics2) *
+      RotationFromOrientationPrior(intrinsics1).transpose();
+  if (RadToDeg(AngleAxisd(relative_rotation).angle()) >
+      kMaxFeatureRotationDegrees) {
+    return EstimateRelativePose(ransac_options,
+                                options.ransac_type,
+                                normalized_correspondences,
+                                relative_pose,
+                                summary);
+  }
+
+  // Rotate the features of the second view into the coordinate system of the
+  // first camera so that the remaining unknown is the translation direction.
+  std::vector<FeatureCorrespondence> rotated_correspondences =
+      normalized_correspondences;
+  RotateFeatures(Matrix3d::Identity(),
+                 relative_rotation.transpose(),
+                 &rotated_correspondences);
+
+  Vector3d position;
+  if (!EstimateRelativePoseWithKnownOrientation(ransac_options,
+                                                options.ransac_type,
+                                                rotated_correspondences,
+                                                &position,
+                                                summary)) {
+    return false;
+  }
+
+  // The 2-point solver does not resolve the sign of the translation, so choose
+  // the sign that places most inliers in front of both cameras.
+  int num_inliers_in_front = 0;
+  for (const int i : summary->inliers) {
+    if (IsTriangulatedPointInFrontOfCameras(
+            rotated_correspondences[i], Matrix3d::Identity(), position)) {
+      ++num_inliers_in_front;
+    }
+  }
+  if (2 * num_inliers_in_front < summary->inliers.size()) {
+    position = -position;
+  }
+
+  relative_pose->rotation = relative_rotation;
+  relative_pose->position = position.normalized();
+  relative_pose->essential_matrix =
+      CrossProductMatrix(-relative_rotation * relative_pose->position) *
+      relative_rotation;
+  return true;
+}
+
+// Estimates the relative pose when only the gravity direction of each view is
+// trusted. The features of each view are rotated so that gravity is aligned
+// with the y-axis, and the rotation about that axis is then estimated along
+// with the translation direction using the 3-point solver.
+bool EstimateRelativePoseWithKnownVerticalPrior(
+    const RansacParameters& ransac_options,
+    const EstimateTwoViewInfoOptions& options,
+    const CameraIntrinsicsPrior& intrinsics1,
+    const CameraIntrinsicsPrior& intrinsics2,
+    const std::vector<FeatureCorrespondence>& normalized_correspondences,
+    RelativePose* relative_pose,
+    RansacSummary* summary) {
+  const Vector3d world_vertical =
+      options.world_vertical_direction.normalized();
+  const Vector3d vertical1 =
+      RotationFromOrientationPrior(intrinsics1) * world_vertical;
+  const Vector3d vertical2 =
+      RotationFromOrientationPrior(intrinsics2) * world_vertical;
+  const Matrix3d alignment1 =
+      Eigen::Quaterniond::FromTwoVectors(vertical1, Vector3d::UnitY())
+          .toRotationMatrix();
+  const Matrix3d alignment2 =
+      Eigen::Quaterniond::FromTwoVectors(vertical2, Vector3d::UnitY())
+          .toRotationMatrix();
+  if (RadToDeg(AngleAxisd(alignment1).angle()) > kMaxFeatureRotationDegrees ||
+      RadToDeg(AngleAxisd(alignment2).angle()) > kMaxFeatureRotationDegrees) {
+    return EstimateRelativePose(ransac_options,
+                                options.ransac_type,
+                                normalized_correspondences,
+                                relative_pose,
+                                summary);
+  }
+
+  std::vector<FeatureCorrespondence> aligned_correspondences =
+      normalized_correspondences;
+  RotateFeatures(alignment1, alignment2, &aligned_correspondences);
+
+  RelativePose aligned_pose;
+  if (!EstimateRelativePoseWithKnownVertical(ransac_options,
+                                             options.ransac_type,
+                                             Vector3d::UnitY(),
+                                             aligned_correspondences,
+                                             &aligned_pose,
+                                             summary)) {
+    return false;
+  }
+
+  // Undo the gravity alignment of both cameras.
+  relative_pose->rotation =
+      alignment2.transpose() * aligned_pose.rotation * alignment1;
+  relative_pose->position = alignment1.transpose() * aligned_pose.position;
+  relative_pose->essential_matrix =
+      alignment2.transpose() * aligned_pose.essential_matrix * alignment1;
+  return true;
+}
+
 bool EstimateTwoViewInfoCalibrated(
     const EstimateTwoViewInfoOptions& options,
     const CameraIntrinsicsPrior& intrinsics1,
     const CameraIntrinsicsPrior& intrinsics2,
     const std::vector<FeatureCorrespondence>& correspondences,
+    const std::shared_ptr<const Eigen::MatrixXd>& sorted_descriptor_distances,
     TwoViewInfo* twoview_info,
     std::vector<int>* inlier_indices) {
   // Normalize features w.r.t focal length.
@@ -146,6 +300,7 @@ bool EstimateTwoViewInfoCalibrated(
   ransac_options.failure_probability = 1.0 - options.expected_ransac_confidence;
   ransac_options.min_iterations = options.min_ransac_iterations;
   ransac_options.max_iterations = options.max_ransac_iterations;
+  ransac_options.evsac_sorted_distances = sorted_descriptor_distances;
 
   // Compute the sampson error threshold to account for the resolution of the
   // images.
@@ -162,13 +317,48 @@ bool EstimateTwoViewInfoCalibrated(
       (intrinsics1.focal_length.value[0] * intrinsics2.focal_length.value[0]);
   ransac_options.use_mle = options.use_mle;
 
+  // Use the orientation priors to reduce the size of the minimal sample if
+  // they are available.
+  const bool has_orientation_priors =
+      intrinsics1.orientation.is_set && intrinsics2.orientation.is_set;
+  RelativePoseVerificationType verification_type = options.verification_type;
+  if (!has_orientation_priors) {
+    verification_type = RelativePoseVerificationType::FIVE_POINT;
+  }
+
   RelativePose relative_pose;
   RansacSummary summary;
-  if (!EstimateRelativePose(ransac_options,
-                            options.ransac_type,
-                            normalized_correspondences,
-                            &relative_pose,
-                            &summary)) {
+  bool success = false;
+  switch (verification_type) {
+    case RelativePoseVerificationType::KNOWN_ROTATION:
+      success = EstimateRelativePoseWithKnownRotationPrior(
+          ransac_options,
+          options,
+          intrinsics1,
+          intrinsics2,
+          normalized_correspondences,
+          &relative_pose,
+          &summary);
+      break;
+    case RelativePoseVerificationType::KNOWN_VERTICAL:
+      success = EstimateRelativePoseWithKnownVerticalPrior(
+          ransac_options,
+          options,
+          intrinsics1,
+          intrinsics2,
+          normalized_correspondences,
+          &relative_pose,
+          &summary);
+      break;
+    default:
+      success = EstimateRelativePose(ransac_options,
+                                     options.ransac_type,
+                                     normalized_correspondences,
+                                     &relative_pose,
+                                     &summary);
+      break;
+  }
+  if (!success) {
     return false;
   }
 
@@ -193,6 +383,7 @@ bool EstimateTwoViewInfoUncalibrated(
     const CameraIntrinsicsPrior& intrinsics1,
     const CameraIntrinsicsPrior& intrinsics2,
     const std::vector<FeatureCorrespondence>& correspondences,
+    const std::shared_ptr<const Eigen::MatrixXd>& sorted_descriptor_distances,
     TwoViewInfo* twoview_info,
     std::vector<int>* inlier_indices) {
   // Normalize features w.r.t principal point.
@@ -206,6 +397,7 @@ bool EstimateTwoViewInfoUncalibrated(
   ransac_options.failure_probability = 1.0 - options.expected_ransac_confidence;
   ransac_options.min_iterations = options.min_ransac_iterations;
   ransac_options.max_iterations = options.max_ransac_iterations;
+  ransac_options.evsac_sorted_distances = sorted_descriptor_distances;
 
   // Compute the sampson error threshold to account for the resolution of the
   // images.
@@ -256,15 +448,43 @@ bool EstimateTwoViewInfo(
     const std::vector<FeatureCorrespondence>& correspondences,
     TwoViewInfo* twoview_info,
     std::vector<int>* inlier_indices) {
+  return EstimateTwoViewInfo(options,
+                             intrinsics1,
+                             intrinsics2,
+                             correspondences,
+                             Eigen::MatrixXd(),
+                             twoview_info,
+                             inlier_indices);
+}
+
+bool EstimateTwoViewInfo(
+    const EstimateTwoViewInfoOptions& options,
+    const CameraIntrinsicsPrior& intrinsics1,
+    const CameraIntrinsicsPrior& intrinsics2,
+    const std::vector<FeatureCorrespondence>& correspondences,
+    const Eigen::MatrixXd& sorted_descriptor_distances,
+    TwoViewInfo* twoview_info,
+    std::vector<int>* inlier_indices) {
   CHECK_NOTNULL(twoview_info);
   CHECK_NOTNULL(inlier_indices)->clear();
 
+  // The distances are shared with the ransac parameters of the estimators.
+  std::shared_ptr<const Eigen::MatrixXd> shared_sorted_descriptor_distances;
+  if (sorted_descriptor_distances.size() > 0) {
+    CHECK_EQ(sorted_descriptor_distances.rows(), correspondences.size())
+        << "There must be one row of sorted descriptor distances for each "
+           "correspondence.";
+    shared_sorted_descriptor_distances =
+        std::make_shared<const Eigen::MatrixXd>(sorted_descriptor_distances);
+  }
+
   // Case where both views are calibrated.
   if (intrinsics1.focal_length.is_set && intrinsics2.focal_length.is_set) {
     return EstimateTwoViewInfoCalibrated(options,
                                          intrinsics1,
                                          intrinsics2,
                                          correspondences,
+                                         shared_sorted_descriptor_distances,
                                          twoview_info,
                                          inlier_indices);
   }
@@ -278,6 +498,7 @@ bool EstimateTwoViewInfo(
                                            intrinsics1,
                                            intrinsics2,
                                            correspondences,
+                                           shared_sorted_descriptor_distances,
                                            twoview_info,
                                            inlier_indices);
   }
@@ -287,6 +508,7 @@ bool EstimateTwoViewInfo(
                                          intrinsics1,
                                          intrinsics2,
                                          correspondences,
+                                         shared_sorted_descriptor_distances,
                                          twoview_info,
                                          inlier_indices);
 }
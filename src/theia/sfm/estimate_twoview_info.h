@@ -35,6 +35,7 @@
 #ifndef THEIA_SFM_ESTIMATE_TWOVIEW_INFO_H_
 #define THEIA_SFM_ESTIMATE_TWOVIEW_INFO_H_
 
+#include <Eigen/Core>
 #include <memory>
 #include <vector>
 
@@ -47,6 +48,24 @@ class TwoViewInfo;
 struct CameraIntrinsicsPrior;
 struct FeatureCorrespondence;
 
+// The minimal solver used to verify calibrated view pairs. The known
+// orientation solvers are only used when both views have a focal length and an
+// orientation prior (e.g., from an IMU or a previous rotation estimate); all
+// other view pairs fall back to the five point algorithm.
+enum class RelativePoseVerificationType {
+  // Estimate the full relative pose from 5 correspondences.
+  FIVE_POINT = 0,
+
+  // Trust the relative rotation given by the orientation priors and only
+  // estimate the translation direction from 2 correspondences.
+  KNOWN_ROTATION = 1,
+
+  // Only trust the gravity direction of the orientation priors. The rotation
+  // about the vertical axis and the translation direction are estimated from 3
+  // correspondences.
+  KNOWN_VERTICAL = 2,
+};
+
 // Options for estimating two view infos.
 struct EstimateTwoViewInfoOptions {
   // The random number generator used to generate random numbers through the
@@ -70,6 +89,16 @@ struct EstimateTwoViewInfoOptions {
   int min_ransac_iterations = 10;
   int max_ransac_iterations = 1000;
   bool use_mle = true;
+
+  // The minimal solver to use for calibrated view pairs. See
+  // RelativePoseVerificationType above.
+  RelativePoseVerificationType verification_type =
+      RelativePoseVerificationType::FIVE_POINT;
+
+  // The vertical (i.e., gravity) direction in the world coordinate system that
+  // the orientation priors are expressed in. Only used for KNOWN_VERTICAL. The
+  // default assumes that a camera with an identity orientation is upright.
+  Eigen::Vector3d world_vertical_direction = Eigen::Vector3d(0.0, 1.0, 0.0);
 };
 
 // Estimates two view info for the given view pair from the correspondences. The
@@ -85,6 +114,10 @@ struct EstimateTwoViewInfoOptions {
 //   3) One view is calibrated and one view is uncalibrated. NOTE: This case is
 //      currently unsupported, and case 2) will be used instead.
 //
+// In case 1), if both views also have orientation priors then the smaller
+// minimal solver given by options.verification_type is used instead of the
+// five point algorithm.
+//
 // Returns true if a two view info could be successfully estimated and false if
 // not.
 bool EstimateTwoViewInfo(
@@ -95,6 +128,20 @@ bool EstimateTwoViewInfo(
     TwoViewInfo* twoview_info,
     std::vector<int>* inlier_indices);
 
+// Same as above, but also takes the k smallest L2 descriptor distances of the
+// first feature of each correspondence to the features of the second image, in
+// ascending order with one row per correspondence. The distances are used to
+// guide the sampling when options.ransac_type is RansacType::EVSAC and may be
+// empty otherwise.
+bool EstimateTwoViewInfo(
+    const EstimateTwoViewInfoOptions& options,
+    const CameraIntrinsicsPrior& intrinsics1,
+    const CameraIntrinsicsPrior& intrinsics2,
+    const std::vector<FeatureCorrespondence>& correspondences,
+    const Eigen::MatrixXd& sorted_descriptor_distances,
+    TwoViewInfo* twoview_info,
+    std::vector<int>* inlier_indices);
+
 }  // namespace theia
 
 #endif  // THEIA_SFM_ESTIMATE_TWOVIEW_INFO_H_
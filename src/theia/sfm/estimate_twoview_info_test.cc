@@ -0,0 +1,352 @@
+// Copyright (C) 2026 The Regents of the University of California (Regents).
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials provided
+//       with the distribution.
+//
+//     * Neither the name of The Regents or University of California nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+// Please contact the author of this library if you have any questions.
+// Author: agent (agent@local)
+
+#include <Eigen/Core>
+#include <Eigen/Geometry>
+#include <ceres/rotation.h>
+
+#include <memory>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "theia/matching/feature_correspondence.h"
+#include "theia/math/util.h"
+#include "theia/sfm/camera/camera.h"
+#include "theia/sfm/camera_intrinsics_prior.h"
+#include "theia/sfm/estimate_twoview_info.h"
+#include "theia/sfm/twoview_info.h"
+#include "theia/util/random.h"
+
+namespace theia {
+
+using Eigen::AngleAxisd;
+using Eigen::Matrix3d;
+using Eigen::Vector2d;
+using Eigen::Vector3d;
+using Eigen::Vector4d;
+
+namespace {
+
+static const int kImageWidth = 1000;
+static const int kImageHeight = 800;
+static const double kFocalLength = 800.0;
+static const double kPixelNoise = 0.1;
+static const int kNumPoints = 200;
+static const double kCameraDistance = 6.0;
+
+// The maximum errors of the estimated relative pose. The orientation priors
+// used to test the fallbacks are wrong by larger angles so that they would be
+// detected if they were used.
+static const double kMaxRotationErrorDegrees = 1.0;
+static const double kMaxPositionErrorDegrees = 3.0;
+static const double kPriorErrorDegrees = 5.0;
+
+// Returns a camera that is placed at the given azimuth and elevation on a
+// sphere around the origin and looks at the origin. The camera is then rolled
+// about its optical axis.
+Camera CreateCamera(const double azimuth_degrees,
+                    const double elevation_degrees,
+                    const double roll_degrees) {
+  const double azimuth = DegToRad(azimuth_degrees);
+  const double elevation = DegToRad(elevation_degrees);
+  const Vector3d position =
+      kCameraDistance * Vector3d(std::sin(azimuth) * std::cos(elevation),
+                                 std::sin(elevation),
+                                 -std::cos(azimuth) * std::cos(elevation));
+
+  // The y-axis of the camera is aligned with the vertical direction of the
+  // world before the roll is applied.
+  const Vector3d z_axis = -position.normalized();
+  const Vector3d y_axis =
+      (Vector3d::UnitY() - Vector3d::UnitY().dot(z_axis) * z_axis)
+          .normalized();
+  const Vector3d x_axis = y_axis.cross(z_axis);
+  Matrix3d rotation;
+  rotation.row(0) = x_axis.transpose();
+  rotation.row(1) = y_axis.transpose();
+  rotation.row(2) = z_axis.transpose();
+  rotation =
+      AngleAxisd(DegToRad(roll_degrees), Vector3d::UnitZ()) * rotation;
+
+  Camera camera;
+  camera.SetImageSize(kImageWidth, kImageHeight);
+  camera.SetFocalLength(kFocalLength);
+  camera.SetPrincipalPoint(kImageWidth / 2.0, kImageHeight / 2.0);
+  camera.SetOrientationFromRotationMatrix(rotation);
+  camera.SetPosition(position);
+  return camera;
+}
+
+// Returns the intrinsics prior of the camera with an orientation prior that is
+// the orientation of the camera composed with the given world rotation, i.e.
+// a rotation about the world vertical axis only changes the heading of the
+// prior.
+CameraIntrinsicsPrior CreatePrior(const Camera& camera,
+                                  const Matrix3d& world_rotation_error) {
+  CameraIntrinsicsPrior prior;
+  prior.image_width = kImageWidth;
+  prior.image_height = kImageHeight;
+  prior.focal_length.is_set = true;
+  prior.focal_length.value[0] = kFocalLength;
+  prior.principal_point.is_set = true;
+  prior.principal_point.value[0] = kImageWidth / 2.0;
+  prior.principal_point.value[1] = kImageHeight / 2.0;
+
+  Matrix3d rotation;
+  const Vector3d angle_axis = camera.GetOrientationAsAngleAxis();
+  ceres::AngleAxisToRotationMatrix(
+      angle_axis.data(), ceres::ColumnMajorAdapter3x3(rotation.data()));
+  const AngleAxisd prior_rotation(rotation * world_rotation_error);
+  prior.orientation.is_set = true;
+  Eigen::Map<Vector3d>(prior.orientation.value) =
+      prior_rotation.angle() * prior_rotation.axis();
+  return prior;
+}
+
+// Creates noisy correspondences of points around the origin that are visible
+// in both cameras.
+void CreateCorrespondences(const Camera& camera1,
+                           const Camera& camera2,
+                           RandomNumberGenerator* rng,
+                           std::vector<FeatureCorrespondence>* correspondences) {
+  while (correspondences->size() < kNumPoints) {
+    const Vector4d point = rng->RandVector3d().homogeneous();
+    FeatureCorrespondence correspondence;
+    if (camera1.ProjectPoint(point, &correspondence.feature1) < 0 ||
+        camera2.ProjectPoint(point, &correspondence.feature2) < 0) {
+      continue;
+    }
+    correspondence.feature1 += kPixelNoise * Vector2d(rng->RandGaussian(0, 1),
+                                                      rng->RandGaussian(0, 1));
+    correspondence.feature2 += kPixelNoise * Vector2d(rng->RandGaussian(0, 1),
+                                                      rng->RandGaussian(0, 1));
+    correspondences->emplace_back(correspondence);
+  }
+}
+
+double RotationErrorDegrees(const Vector3d& rotation1,
+                            const Vector3d& rotation2) {
+  Matrix3d rotation_matrix1, rotation_matrix2;
+  ceres::AngleAxisToRotationMatrix(
+      rotation1.data(), ceres::ColumnMajorAdapter3x3(rotation_matrix1.data()));
+  ceres::AngleAxisToRotationMatrix(
+      rotation2.data(), ceres::ColumnMajorAdapter3x3(rotation_matrix2.data()));
+  return RadToDeg(
+      AngleAxisd(rotation_matrix1 * rotation_matrix2.transpose()).angle());
+}
+
+double PositionErrorDegrees(const Vector3d& position1,
+                            const Vector3d& position2) {
+  const double cos_angle =
+      position1.normalized().dot(position2.normalized());
+  return RadToDeg(std::acos(std::max(-1.0, std::min(1.0, cos_angle))));
+}
+
+// Estimates the two view info of the cameras from the priors and returns the
+// rotation and position errors in degrees.
+void EstimateTwoViewInfoAndComputeErrors(
+    const RelativePoseVerificationType verification_type,
+    const Camera& camera1,
+    const Camera& camera2,
+    const CameraIntrinsicsPrior& prior1,
+    const CameraIntrinsicsPrior& prior2,
+    double* rotation_error_degrees,
+    double* position_error_degrees) {
+  auto rng = std::make_shared<RandomNumberGenerator>(59);
+  std::vector<FeatureCorrespondence> correspondences;
+  CreateCorrespondences(camera1, camera2, rng.get(), &correspondences);
+
+  EstimateTwoViewInfoOptions options;
+  options.rng = rng;
+  options.verification_type = verification_type;
+  options.min_ransac_iterations = 100;
+  TwoViewInfo twoview_info;
+  std::vector<int> inlier_indices;
+  ASSERT_TRUE(EstimateTwoViewInfo(options,
+                                  prior1,
+                                  prior2,
+                                  correspondences,
+                                  &twoview_info,
+                                  &inlier_indices));
+  EXPECT_GT(inlier_indices.size(), 0.9 * kNumPoints);
+
+  TwoViewInfo expected_twoview_info;
+  TwoViewInfoFromTwoCameras(camera1, camera2, &expected_twoview_info);
+  *rotation_error_degrees = RotationErrorDegrees(
+      twoview_info.rotation_2, expected_twoview_info.rotation_2);
+  *position_error_degrees = PositionErrorDegrees(
+      twoview_info.position_2, expected_twoview_info.position_2);
+}
+
+}  // namespace
+
+TEST(EstimateTwoViewInfo, KnownRotationUsesRotationFromPriors) {
+  const Camera camera1 = CreateCamera(-10.0, 5.0, 3.0);
+  const Camera camera2 = CreateCamera(10.0, 10.0, -5.0);
+  const CameraIntrinsicsPrior prior1 =
+      CreatePrior(camera1, Matrix3d::Identity());
+  const CameraIntrinsicsPrior prior2 =
+      CreatePrior(camera2, Matrix3d::Identity());
+
+  // The rotation is taken from the exact priors so it has no error, unlike the
+  // rotation estimated from noisy features with the five point algorithm.
+  double rotation_error_degrees, position_error_degrees;
+  EstimateTwoViewInfoAndComputeErrors(
+      RelativePoseVerificationType::KNOWN_ROTATION,
+      camera1,
+      camera2,
+      prior1,
+      prior2,
+      &rotation_error_degrees,
+      &position_error_degrees);
+  EXPECT_LT(rotation_error_degrees, 1e-6);
+  EXPECT_LT(position_error_degrees, kMaxPositionErrorDegrees);
+}
+
+TEST(EstimateTwoViewInfo, KnownRotationFallsBackForLargeRotations) {
+  // The relative rotation is larger than 45 degrees so the five point
+  // algorithm must be used even though the priors are available.
+  const Camera camera1 = CreateCamera(-30.0, 5.0, 0.0);
+  const Camera camera2 = CreateCamera(30.0, 5.0, 0.0);
+  const Matrix3d rotation_error =
+      AngleAxisd(DegToRad(kPriorErrorDegrees), Vector3d::UnitY()).toRotationMatrix();
+  const CameraIntrinsicsPrior prior1 = CreatePrior(camera1, rotation_error);
+  const CameraIntrinsicsPrior prior2 =
+      CreatePrior(camera2, rotation_error.transpose());
+
+  double rotation_error_degrees, position_error_degrees;
+  EstimateTwoViewInfoAndComputeErrors(
+      RelativePoseVerificationType::KNOWN_ROTATION,
+      camera1,
+      camera2,
+      prior1,
+      prior2,
+      &rotation_error_degrees,
+      &position_error_degrees);
+  EXPECT_LT(rotation_error_degrees, kMaxRotationErrorDegrees);
+  EXPECT_LT(position_error_degrees, kMaxPositionErrorDegrees);
+}
+
+TEST(EstimateTwoViewInfo, KnownRotationFallsBackWithoutPriors) {
+  const Camera camera1 = CreateCamera(-10.0, 5.0, 3.0);
+  const Camera camera2 = CreateCamera(10.0, 10.0, -5.0);
+  const CameraIntrinsicsPrior prior1 = CreatePrior(
+      camera1, AngleAxisd(DegToRad(kPriorErrorDegrees), Vector3d::UnitY()).toRotationMatrix());
+  CameraIntrinsicsPrior prior2 = CreatePrior(camera2, Matrix3d::Identity());
+  prior2.orientation.is_set = false;
+
+  double rotation_error_degrees, position_error_degrees;
+  EstimateTwoViewInfoAndComputeErrors(
+      RelativePoseVerificationType::KNOWN_ROTATION,
+      camera1,
+      camera2,
+      prior1,
+      prior2,
+      &rotation_error_degrees,
+      &position_error_degrees);
+  EXPECT_LT(rotation_error_degrees, kMaxRotationErrorDegrees);
+  EXPECT_LT(position_error_degrees, kMaxPositionErrorDegrees);
+}
+
+TEST(EstimateTwoViewInfo, KnownVerticalEstimatesHeading) {
+  // The headings of the priors are wrong but their vertical directions are
+  // exact, so the relative pose must still be recovered.
+  const Camera camera1 = CreateCamera(-10.0, 5.0, 8.0);
+  const Camera camera2 = CreateCamera(15.0, 20.0, -4.0);
+  const CameraIntrinsicsPrior prior1 = CreatePrior(
+      camera1, AngleAxisd(DegToRad(5.0), Vector3d::UnitY()).toRotationMatrix());
+  const CameraIntrinsicsPrior prior2 = CreatePrior(
+      camera2,
+      AngleAxisd(DegToRad(-7.0), Vector3d::UnitY()).toRotationMatrix());
+
+  double rotation_error_degrees, position_error_degrees;
+  EstimateTwoViewInfoAndComputeErrors(
+      RelativePoseVerificationType::KNOWN_VERTICAL,
+      camera1,
+      camera2,
+      prior1,
+      prior2,
+      &rotation_error_degrees,
+      &position_error_degrees);
+  EXPECT_LT(rotation_error_degrees, kMaxRotationErrorDegrees);
+  EXPECT_LT(position_error_degrees, kMaxPositionErrorDegrees);
+}
+
+TEST(EstimateTwoViewInfo, KnownVerticalFallsBackForLargeTilts) {
+  // The second camera looks down at 60 degrees so aligning its features with
+  // gravity requires a rotation larger than 45 degrees, so its wrong vertical
+  // direction must not be used.
+  const Camera camera1 = CreateCamera(-10.0, 5.0, 0.0);
+  const Camera camera2 = CreateCamera(10.0, 60.0, 0.0);
+  const CameraIntrinsicsPrior prior1 =
+      CreatePrior(camera1, Matrix3d::Identity());
+  const CameraIntrinsicsPrior prior2 = CreatePrior(
+      camera2, AngleAxisd(DegToRad(kPriorErrorDegrees), Vector3d::UnitX()).toRotationMatrix());
+
+  double rotation_error_degrees, position_error_degrees;
+  EstimateTwoViewInfoAndComputeErrors(
+      RelativePoseVerificationType::KNOWN_VERTICAL,
+      camera1,
+      camera2,
+      prior1,
+      prior2,
+      &rotation_error_degrees,
+      &position_error_degrees);
+  EXPECT_LT(rotation_error_degrees, kMaxRotationErrorDegrees);
+  EXPECT_LT(position_error_degrees, kMaxPositionErrorDegrees);
+}
+
+TEST(EstimateTwoViewInfo, KnownVerticalFallsBackWithoutPriors) {
+  const Camera camera1 = CreateCamera(-10.0, 5.0, 8.0);
+  const Camera camera2 = CreateCamera(15.0, 20.0, -4.0);
+  CameraIntrinsicsPrior prior1 = CreatePrior(camera1, Matrix3d::Identity());
+  prior1.orientation.is_set = false;
+  const CameraIntrinsicsPrior prior2 = CreatePrior(
+      camera2, AngleAxisd(DegToRad(kPriorErrorDegrees), Vector3d::UnitX()).toRotationMatrix());
+
+  double rotation_error_degrees, position_error_degrees;
+  EstimateTwoViewInfoAndComputeErrors(
+      RelativePoseVerificationType::KNOWN_VERTICAL,
+      camera1,
+      camera2,
+      prior1,
+      prior2,
+      &rotation_error_degrees,
+      &position_error_degrees);
+  EXPECT_LT(rotation_error_degrees, kMaxRotationErrorDegrees);
+  EXPECT_LT(position_error_degrees, kMaxPositionErrorDegrees);
+}
+
+}  // namespace theia
@@ -36,12 +36,15 @@
 
 #include <Eigen/Core>
 #include <Eigen/Geometry>
+#include <limits>
 #include <memory>
+#include <numeric>
 #include <vector>
 
 #include "theia/sfm/create_and_initialize_ransac_variant.h"
 #include "theia/sfm/estimators/feature_correspondence_2d_3d.h"
 #include "theia/sfm/pose/perspective_three_point.h"
+#include "theia/sfm/pose/perspective_three_point_lambda_twist.h"
 #include "theia/solvers/estimator.h"
 #include "theia/solvers/sample_consensus_estimator.h"
 #include "theia/util/util.h"
@@ -50,6 +53,7 @@ namespace theia {
 namespace {
 
 using Eigen::Matrix3d;
+using Eigen::Vector2d;
 using Eigen::Vector3d;
 
 // An estimator for computing the absolute pose from 3 feature
@@ -109,6 +113,106 @@ class CalibratedAbsolutePoseEstimator
   DISALLOW_COPY_AND_ASSIGN(CalibratedAbsolutePoseEstimator);
 };
 
+// An estimator for computing the absolute pose from 3 feature correspondences
+// with the Lambda Twist P3P solver. The correspondences are stored in a
+// structure-of-arrays layout (i.e., all x coordinates are contiguous, then all
+// y coordinates, etc.) and the data passed to RANSAC are the indices of the
+// correspondences. This allows the residuals of all correspondences to be
+// computed for a hypothesis with a single vectorized expression rather than
+// one 3x4 projection per correspondence.
+class SoaCalibratedAbsolutePoseEstimator
+    : public Estimator<int, CalibratedAbsolutePose> {
+ public:
+  explicit SoaCalibratedAbsolutePoseEstimator(
+      const std::vector<FeatureCorrespondence2D3D>& correspondences)
+      : features_(correspondences.size(), 2),
+        world_points_(correspondences.size(), 3) {
+    for (int i = 0; i < correspondences.size(); i++) {
+      features_.row(i) = correspondences[i].feature.transpose();
+      world_points_.row(i) = correspondences[i].world_point.transpose();
+    }
+  }
+
+  // 3 correspondences are needed to determine the absolute pose.
+  double SampleSize() const { return 3; }
+
+  // Estimates candidate absolute poses from the indexed correspondences.
+  bool EstimateModel(const std::vector<int>& indices,
+                     std::vector<CalibratedAbsolutePose>* absolute_poses) const {
+    Vector2d features[3];
+    Vector3d world_points[3];
+    for (int i = 0; i < 3; i++) {
+      features[i] = features_.row(indices[i]).transpose();
+      world_points[i] = world_points_.row(indices[i]).transpose();
+    }
+
+    Matrix3d rotations[kMaxNumLambdaTwistSolutions];
+    Vector3d translations[kMaxNumLambdaTwistSolutions];
+    const int num_solutions = PoseFromThreePointsLambdaTwist(
+        features, world_points, rotations, translations);
+    for (int i = 0; i < num_solutions; i++) {
+      CalibratedAbsolutePose pose;
+      pose.rotation = rotations[i];
+      pose.position = -pose.rotation.transpose() * translations[i];
+      absolute_poses->emplace_back(pose);
+    }
+
+    return num_solutions > 0;
+  }
+
+  // The squared reprojection error of a single correspondence.
+  double Error(const int& index,
+               const CalibratedAbsolutePose& absolute_pose) const {
+    const Vector3d camera_point =
+        absolute_pose.rotation *
+        (world_points_.row(index).transpose() - absolute_pose.position);
+    if (camera_point.z() <= 0) {
+      return std::numeric_limits<double>::max();
+    }
+    return (camera_point.hnormalized() - features_.row(index).transpose())
+        .squaredNorm();
+  }
+
+  // Computes the squared reprojection error of all correspondences at once.
+  // RANSAC always scores a hypothesis against all of the data, in which case
+  // the indices are 0...N-1 and the contiguous arrays are used directly.
+  std::vector<double> Residuals(
+      const std::vector<int>& indices,
+      const CalibratedAbsolutePose& absolute_pose) const {
+    if (indices.size() != features_.rows()) {
+      return Estimator<int, CalibratedAbsolutePose>::Residuals(indices,
+                                                              absolute_pose);
+    }
+
+    const Matrix3d& rotation = absolute_pose.rotation;
+    const Vector3d translation = -rotation * absolute_pose.position;
+    const auto x = world_points_.col(0).array();
+    const auto y = world_points_.col(1).array();
+    const auto z = world_points_.col(2).array();
+    const auto px = rotation(0, 0) * x + rotation(0, 1) * y +
+                    rotation(0, 2) * z + translation[0];
+    const auto py = rotation(1, 0) * x + rotation(1, 1) * y +
+                    rotation(1, 2) * z + translation[1];
+    const auto pz = rotation(2, 0) * x + rotation(2, 1) * y +
+                    rotation(2, 2) * z + translation[2];
+
+    // Points behind the camera are given the maximum error.
+    std::vector<double> residuals(indices.size());
+    Eigen::Map<Eigen::ArrayXd>(residuals.data(), residuals.size()) =
+        (pz > 0.0).select((px / pz - features_.col(0).array()).square() +
+                              (py / pz - features_.col(1).array()).square(),
+                          std::numeric_limits<double>::max());
+    return residuals;
+  }
+
+ private:
+  // Column-major storage so that each coordinate is contiguous in memory.
+  Eigen::Matrix<double, Eigen::Dynamic, 2> features_;
+  Eigen::Matrix<double, Eigen::Dynamic, 3> world_points_;
+
+  DISALLOW_COPY_AND_ASSIGN(SoaCalibratedAbsolutePoseEstimator);
+};
+
 }  // namespace
 
 bool EstimateCalibratedAbsolutePose(
@@ -128,4 +232,32 @@ bool EstimateCalibratedAbsolutePose(
                           ransac_summary);
 }
 
+bool EstimateCalibratedAbsolutePose(
+    const RansacParameters& ransac_params,
+    const RansacType& ransac_type,
+    const PnPType& pnp_type,
+    const std::vector<FeatureCorrespondence2D3D>& normalized_correspondences,
+    CalibratedAbsolutePose* absolute_pose,
+    RansacSummary* ransac_summary) {
+  if (pnp_type == PnPType::KNEIP) {
+    return EstimateCalibratedAbsolutePose(ransac_params,
+                                          ransac_type,
+                                          normalized_correspondences,
+                                          absolute_pose,
+                                          ransac_summary);
+  }
+
+  SoaCalibratedAbsolutePoseEstimator absolute_pose_estimator(
+      normalized_correspondences);
+  std::unique_ptr<SampleConsensusEstimator<SoaCalibratedAbsolutePoseEstimator> >
+      ransac = CreateAndInitializeRansacVariant(ransac_type,
+                                                ransac_params,
+                                                absolute_pose_estimator);
+
+  // The data passed to RANSAC are the indices of the correspondences.
+  std::vector<int> indices(normalized_correspondences.size());
+  std::iota(indices.begin(), indices.end(), 0);
+  return ransac->Estimate(indices, absolute_pose, ransac_summary);
+}
+
 }  // namespace theia
@@ -51,6 +51,18 @@ struct CalibratedAbsolutePose {
   Eigen::Vector3d position;
 };
 
+// The minimal solver used for calibrated absolute pose estimation.
+//   KNEIP: The P3P algorithm of Kneip et al. (see perspective_three_point.h).
+//   LAMBDA_TWIST: The Lambda Twist P3P algorithm of Persson and Nordberg (see
+//     perspective_three_point_lambda_twist.h). The correspondences are copied
+//     into a structure-of-arrays layout so that each hypothesis is scored with
+//     a vectorized reprojection over contiguous 2D and 3D arrays. This is
+//     typically much faster when there are many correspondences.
+enum class PnPType {
+  KNEIP = 0,
+  LAMBDA_TWIST = 1
+};
+
 // Estimates the calibrated absolute pose using the ransac variant of choice
 // (e.g. Ransac, Prosac, etc.). Correspondences must be normalized by the camera
 // intrinsics. Returns true if a pose could be succesfully estimated, and false
@@ -63,6 +75,15 @@ bool EstimateCalibratedAbsolutePose(
     CalibratedAbsolutePose* absolute_pose,
     RansacSummary* ransac_summary);
 
+// Same as above, but the minimal solver may be chosen with pnp_type.
+bool EstimateCalibratedAbsolutePose(
+    const RansacParameters& ransac_params,
+    const RansacType& ransac_type,
+    const PnPType& pnp_type,
+    const std::vector<FeatureCorrespondence2D3D>& normalized_correspondences,
+    CalibratedAbsolutePose* absolute_pose,
+    RansacSummary* ransac_summary);
+
 }  // namespace theia
 
 #endif  // THEIA_SFM_ESTIMATORS_ESTIMATE_CALIBRATED_ABSOLUTE_POSE_H_
@@ -70,7 +70,8 @@ void ExecuteRandomTest(const RansacParameters& options,
                        const Vector3d& position,
                        const double inlier_ratio,
                        const double noise,
-                       const double tolerance) {
+                       const double tolerance,
+                       const PnPType pnp_type = PnPType::KNEIP) {
   // Create feature correspondences (inliers and outliers) and add noise if
   // appropriate.
   std::vector<FeatureCorrespondence2D3D> correspondences;
@@ -102,6 +103,7 @@ void ExecuteRandomTest(const RansacParameters& options,
   RansacSummary ransac_summary;
   EXPECT_TRUE(EstimateCalibratedAbsolutePose(options,
                                              RansacType::RANSAC,
+                                             pnp_type,
                                              correspondences,
                                              &pose,
                                              &ransac_summary));
@@ -235,4 +237,63 @@ TEST(EstimateCalibratedAbsolutePose, OutliersWithNoise) {
   }
 }
 
+TEST(EstimateCalibratedAbsolutePose, LambdaTwistAllInliersNoNoise) {
+  RansacParameters options;
+  options.rng = std::make_shared<RandomNumberGenerator>(rng);
+  options.use_mle = true;
+  options.error_thresh = kErrorThreshold;
+  options.failure_probability = 0.001;
+  const double kInlierRatio = 1.0;
+  const double kNoise = 0.0;
+  const double kPoseTolerance = 1e-4;
+
+  const std::vector<Matrix3d> rotations = {
+    Matrix3d::Identity(),
+    AngleAxisd(DegToRad(12.0), Vector3d::UnitY()).toRotationMatrix(),
+    AngleAxisd(DegToRad(-9.0), Vector3d(1.0, 0.2, -0.8).normalized())
+        .toRotationMatrix()
+  };
+  const std::vector<Vector3d> positions = { Vector3d(-1.3, 0, 0),
+                                            Vector3d(0, 0, 0.5) };
+  for (int i = 0; i < rotations.size(); i++) {
+    for (int j = 0; j < positions.size(); j++) {
+      ExecuteRandomTest(options,
+                        rotations[i],
+                        positions[j],
+                        kInlierRatio,
+                        kNoise,
+                        kPoseTolerance,
+                        PnPType::LAMBDA_TWIST);
+    }
+  }
+}
+
+TEST(EstimateCalibratedAbsolutePose, LambdaTwistOutliersWithNoise) {
+  RansacParameters options;
+  options.rng = std::make_shared<RandomNumberGenerator>(rng);
+  options.use_mle = true;
+  options.error_thresh = kErrorThreshold;
+  options.failure_probability = 0.001;
+  const double kInlierRatio = 0.7;
+  const double kNoise = 1.0;
+  const double kPoseTolerance = 1e-2;
+
+  const std::vector<Matrix3d> rotations = {Matrix3d::Identity(),
+                                           RandomRotation(10.0, &rng)};
+  const std::vector<Vector3d> positions = {Vector3d(1, 0, 0),
+                                           Vector3d(0, 1, 0)};
+
+  for (int i = 0; i < rotations.size(); i++) {
+    for (int j = 0; j < positions.size(); j++) {
+      ExecuteRandomTest(options,
+                        rotations[i],
+                        positions[j],
+                        kInlierRatio,
+                        kNoise,
+                        kPoseTolerance,
+                        PnPType::LAMBDA_TWIST);
+    }
+  }
+}
+
 }  // namespace theia
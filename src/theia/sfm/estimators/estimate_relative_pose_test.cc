@@ -37,6 +37,8 @@
 #include <glog/logging.h>
 
 #include <algorithm>
+#include <cmath>
+#include <memory>
 #include <vector>
 
 #include "gtest/gtest.h"
@@ -248,4 +250,152 @@ TEST(EstimateRelativePose, OutliersWithNoise) {
   }
 }
 
+// Returns a sample of a Gamma(3, 2) distribution, which models the descriptor
+// distances of correct matches.
+double CorrectMatchDistance() {
+  double distance = 0.0;
+  for (int i = 0; i < 3; i++) {
+    distance -= 2.0 * std::log(rng.RandDouble(1e-6, 1.0));
+  }
+  return distance;
+}
+
+// Returns a sample of the descriptor distances of incorrect matches.
+double IncorrectMatchDistance() { return rng.RandGaussian(85.0, 4.0); }
+
+// Creates correspondences where the first num_inliers are inliers, along with
+// the k sorted descriptor distances of each correspondence as used by EVSAC.
+void CreateCorrespondencesWithSortedDistances(
+    const Matrix3d& rotation,
+    const Vector3d& position,
+    const int num_correspondences,
+    const int num_inliers,
+    const int num_sorted_distances,
+    std::vector<FeatureCorrespondence>* correspondences,
+    Eigen::MatrixXd* sorted_distances) {
+  static const double kNoise = 0.5;
+  const Vector3d translation = -rotation * position;
+  sorted_distances->resize(num_correspondences, num_sorted_distances);
+  for (int i = 0; i < num_correspondences; i++) {
+    FeatureCorrespondence correspondence;
+    std::vector<double> distances(num_sorted_distances);
+    for (int j = 0; j < num_sorted_distances; j++) {
+      distances[j] = IncorrectMatchDistance();
+    }
+
+    if (i < num_inliers) {
+      const Vector3d point(rng.RandDouble(-1.0, 1.0),
+                           rng.RandDouble(-1.0, 1.0),
+                           rng.RandDouble(4.0, 6.0));
+      correspondence.feature1 = point.hnormalized();
+      correspondence.feature2 = (rotation * point + translation).hnormalized();
+      AddNoiseToProjection(kNoise / kFocalLength, &rng,
+                           &correspondence.feature1);
+      AddNoiseToProjection(kNoise / kFocalLength, &rng,
+                           &correspondence.feature2);
+      distances[0] = CorrectMatchDistance();
+    } else {
+      correspondence.feature1 =
+          Vector2d(rng.RandDouble(-1.0, 1.0), rng.RandDouble(-1.0, 1.0));
+      correspondence.feature2 =
+          Vector2d(rng.RandDouble(-1.0, 1.0), rng.RandDouble(-1.0, 1.0));
+    }
+    correspondences->emplace_back(correspondence);
+
+    std::sort(distances.begin(), distances.end());
+    for (int j = 0; j < num_sorted_distances; j++) {
+      (*sorted_distances)(i, j) = distances[j];
+    }
+  }
+}
+
+TEST(EstimateRelativePose, EvsacWithOutliers) {
+  static const int kNumCorrespondences = 200;
+  static const int kNumSortedDistances = 10;
+  const double kPoseToleranceDegrees = 5.0;
+  const std::vector<double> kInlierRatios = {0.7, 0.4, 0.2};
+
+  const Matrix3d rotation = RandomRotation(10.0, &rng);
+  const Vector3d position = Vector3d(1, 0.2, 0).normalized();
+  for (const double inlier_ratio : kInlierRatios) {
+    const int num_inliers = inlier_ratio * kNumCorrespondences;
+    std::vector<FeatureCorrespondence> correspondences;
+    Eigen::MatrixXd sorted_distances;
+    CreateCorrespondencesWithSortedDistances(rotation,
+                                             position,
+                                             kNumCorrespondences,
+                                             num_inliers,
+                                             kNumSortedDistances,
+                                             &correspondences,
+                                             &sorted_distances);
+
+    // Use a small number of iterations so that only the sampler that favors
+    // the correct matches finds the pose at low inlier ratios.
+    RansacParameters options;
+    options.rng = std::make_shared<RandomNumberGenerator>(rng);
+    options.use_mle = true;
+    options.error_thresh = kErrorThreshold;
+    options.failure_probability = 0.001;
+    options.min_iterations = 10;
+    options.max_iterations = 50;
+    options.evsac_sorted_distances =
+        std::make_shared<const Eigen::MatrixXd>(sorted_distances);
+
+    RelativePose evsac_pose;
+    RansacSummary evsac_summary;
+    EXPECT_TRUE(EstimateRelativePose(options,
+                                     RansacType::EVSAC,
+                                     correspondences,
+                                     &evsac_pose,
+                                     &evsac_summary));
+    EXPECT_GE(evsac_summary.inliers.size(), 0.9 * num_inliers);
+
+    const Eigen::AngleAxisd rotation_loop(rotation *
+                                          evsac_pose.rotation.transpose());
+    EXPECT_LT(RadToDeg(rotation_loop.angle()), kPoseToleranceDegrees);
+    const double translation_diff_rad =
+        std::acos(Clamp(position.dot(evsac_pose.position), -1.0, 1.0));
+    EXPECT_LT(RadToDeg(translation_diff_rad), kPoseToleranceDegrees);
+
+    // With the same number of iterations, uniform sampling finds fewer inliers
+    // when most of the correspondences are outliers.
+    if (inlier_ratio < 0.5) {
+      RelativePose ransac_pose;
+      RansacSummary ransac_summary;
+      EstimateRelativePose(options,
+                           RansacType::RANSAC,
+                           correspondences,
+                           &ransac_pose,
+                           &ransac_summary);
+      EXPECT_LT(ransac_summary.inliers.size(), evsac_summary.inliers.size());
+    }
+  }
+}
+
+TEST(EstimateRelativePose, EvsacWithoutSortedDistances) {
+  static const int kNumCorrespondences = 100;
+  std::vector<FeatureCorrespondence> correspondences;
+  Eigen::MatrixXd sorted_distances;
+  CreateCorrespondencesWithSortedDistances(Matrix3d::Identity(),
+                                           Vector3d(1, 0, 0),
+                                           kNumCorrespondences,
+                                           kNumCorrespondences,
+                                           2,
+                                           &correspondences,
+                                           &sorted_distances);
+
+  // EVSAC falls back to RANSAC if the sorted distances are not given.
+  RansacParameters options;
+  options.rng = std::make_shared<RandomNumberGenerator>(rng);
+  options.error_thresh = kErrorThreshold;
+  RelativePose relative_pose;
+  RansacSummary summary;
+  EXPECT_TRUE(EstimateRelativePose(options,
+                                   RansacType::EVSAC,
+                                   correspondences,
+                                   &relative_pose,
+                                   &summary));
+  EXPECT_GE(summary.inliers.size(), 0.9 * kNumCorrespondences);
+}
+
 }  // namespace theia
@@ -0,0 +1,155 @@
+// Copyright (C) 2026 The Regents of the University of California (Regents).
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials provided
+//       with the distribution.
+//
+//     * Neither the name of The Regents or University of California nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+// Please contact the author of this library if you have any questions.
+// Author: agent (agent@local)
+
+#include "theia/sfm/estimators/estimate_relative_pose_with_known_vertical.h"
+
+#include <Eigen/Core>
+#include <Eigen/Geometry>
+#include <glog/logging.h>
+#include <limits>
+#include <memory>
+#include <vector>
+
+#include "theia/matching/feature_correspondence.h"
+#include "theia/sfm/create_and_initialize_ransac_variant.h"
+#include "theia/sfm/pose/three_point_relative_pose_partial_rotation.h"
+#include "theia/sfm/pose/util.h"
+#include "theia/sfm/triangulation/triangulation.h"
+#include "theia/solvers/estimator.h"
+#include "theia/solvers/sample_consensus_estimator.h"
+#include "theia/util/util.h"
+
+namespace theia {
+namespace {
+
+using Eigen::Matrix3d;
+using Eigen::Quaterniond;
+using Eigen::Vector3d;
+
+// An estimator for computing the relative pose from 3 feature correspondences
+// when the rotation is known up to a single rotation about the vertical
+// axis. The feature correspondences should be normalized by the focal length
+// with the principal point at (0, 0).
+class RelativePoseWithKnownVerticalEstimator
+    : public Estimator<FeatureCorrespondence, RelativePose> {
+ public:
+  explicit RelativePoseWithKnownVerticalEstimator(const Vector3d& vertical_axis)
+      : vertical_axis_(vertical_axis.normalized()) {}
+
+  // 3 correspondences are needed to determine the rotation about the vertical
+  // axis and the translation direction.
+  double SampleSize() const { return 3; }
+
+  // Estimates candidate relative poses from correspondences.
+  bool EstimateModel(const std::vector<FeatureCorrespondence>& correspondences,
+                     std::vector<RelativePose>* relative_poses) const {
+    Vector3d image1_rays[3], image2_rays[3];
+    for (int i = 0; i < 3; i++) {
+      image1_rays[i] = correspondences[i].feature1.homogeneous();
+      image2_rays[i] = correspondences[i].feature2.homogeneous();
+    }
+
+    std::vector<Quaterniond> rotations;
+    std::vector<Vector3d> translations;
+    ThreePointRelativePosePartialRotation(
+        vertical_axis_, image1_rays, image2_rays, &rotations, &translations);
+
+    // The solver returns both signs of each translation, so only keep the
+    // solutions where the sampled points triangulate in front of both cameras.
+    for (int i = 0; i < rotations.size(); i++) {
+      const Vector3d translation = translations[i].normalized();
+      RelativePose relative_pose;
+      relative_pose.rotation = rotations[i].toRotationMatrix();
+      relative_pose.position = -relative_pose.rotation.transpose() * translation;
+      relative_pose.essential_matrix =
+          CrossProductMatrix(translation) * relative_pose.rotation;
+
+      int num_points_in_front_of_cameras = 0;
+      for (int j = 0; j < 3; j++) {
+        if (IsTriangulatedPointInFrontOfCameras(correspondences[j],
+                                                relative_pose.rotation,
+                                                relative_pose.position)) {
+          ++num_points_in_front_of_cameras;
+        }
+      }
+      if (num_points_in_front_of_cameras == 3) {
+        relative_poses->emplace_back(relative_pose);
+      }
+    }
+    return relative_poses->size() > 0;
+  }
+
+  // The error for a correspondences given a model. This is the squared sampson
+  // error.
+  double Error(const FeatureCorrespondence& correspondence,
+               const RelativePose& relative_pose) const {
+    if (IsTriangulatedPointInFrontOfCameras(correspondence,
+                                            relative_pose.rotation,
+                                            relative_pose.position)) {
+      return SquaredSampsonDistance(relative_pose.essential_matrix,
+                                    correspondence.feature1,
+                                    correspondence.feature2);
+    }
+    return std::numeric_limits<double>::max();
+  }
+
+ private:
+  const Vector3d vertical_axis_;
+
+  DISALLOW_COPY_AND_ASSIGN(RelativePoseWithKnownVerticalEstimator);
+};
+
+}  // namespace
+
+bool EstimateRelativePoseWithKnownVertical(
+    const RansacParameters& ransac_params,
+    const RansacType& ransac_type,
+    const Eigen::Vector3d& vertical_axis,
+    const std::vector<FeatureCorrespondence>& normalized_correspondences,
+    RelativePose* relative_pose,
+    RansacSummary* ransac_summary) {
+  CHECK_GT(vertical_axis.squaredNorm(), 0.0);
+  RelativePoseWithKnownVerticalEstimator relative_pose_estimator(vertical_axis);
+  std::unique_ptr<
+      SampleConsensusEstimator<RelativePoseWithKnownVerticalEstimator> >
+      ransac = CreateAndInitializeRansacVariant(ransac_type,
+                                                ransac_params,
+                                                relative_pose_estimator);
+  // Estimate the relative pose.
+  return ransac->Estimate(normalized_correspondences,
+                          relative_pose,
+                          ransac_summary);
+}
+
+}  // namespace theia
@@ -0,0 +1,73 @@
+// Copyright (C) 2026 The Regents of the University of California (Regents).
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials provided
+//       with the distribution.
+//
+//     * Neither the name of The Regents or University of California nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+// Please contact the author of this library if you have any questions.
+// Author: agent (agent@local)
+
+#ifndef THEIA_SFM_ESTIMATORS_ESTIMATE_RELATIVE_POSE_WITH_KNOWN_VERTICAL_H_
+#define THEIA_SFM_ESTIMATORS_ESTIMATE_RELATIVE_POSE_WITH_KNOWN_VERTICAL_H_
+
+#include <Eigen/Core>
+#include <vector>
+
+#include "theia/sfm/create_and_initialize_ransac_variant.h"
+#include "theia/sfm/estimators/estimate_relative_pose.h"
+
+namespace theia {
+
+struct FeatureCorrespondence;
+struct RansacParameters;
+struct RansacSummary;
+
+// Estimates the relative pose when the relative rotation is only unknown about
+// a single axis. This is the case when the gravity direction of both cameras
+// is known (e.g., from an IMU) and the features of the second camera have been
+// rotated so that the gravity directions of both cameras are aligned. The
+// remaining rotation about the vertical axis and the translation direction are
+// estimated from 3 correspondences with ThreePointRelativePosePartialRotation,
+// which requires far fewer RANSAC iterations than the 5-point algorithm.
+//
+// The correspondences must be normalized by the camera intrinsics, and
+// vertical_axis is the (unit-norm) gravity direction expressed in the
+// coordinate system of the first camera. The output pose has the same
+// convention as EstimateRelativePose. Returns true if a pose could be
+// estimated and false otherwise.
+bool EstimateRelativePoseWithKnownVertical(
+    const RansacParameters& ransac_params,
+    const RansacType& ransac_type,
+    const Eigen::Vector3d& vertical_axis,
+    const std::vector<FeatureCorrespondence>& normalized_correspondences,
+    RelativePose* relative_pose,
+    RansacSummary* ransac_summary);
+
+}  // namespace theia
+
+#endif  // THEIA_SFM_ESTIMATORS_ESTIMATE_RELATIVE_POSE_WITH_KNOWN_VERTICAL_H_
@@ -0,0 +1,194 @@
+// Copyright (C) 2026 The Regents of the University of California (Regents).
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials provided
+//       with the distribution.
+//
+//     * Neither the name of The Regents or University of California nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+// Please contact the author of this library if you have any questions.
+// Author: agent (agent@local)
+
+#include <Eigen/Core>
+#include <Eigen/Geometry>
+#include <glog/logging.h>
+
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "theia/matching/feature_correspondence.h"
+#include "theia/math/util.h"
+#include "theia/sfm/estimators/estimate_relative_pose_with_known_vertical.h"
+#include "theia/sfm/pose/test_util.h"
+#include "theia/sfm/pose/util.h"
+#include "theia/solvers/sample_consensus_estimator.h"
+#include "theia/test/test_utils.h"
+#include "theia/util/random.h"
+
+namespace theia {
+
+using Eigen::AngleAxisd;
+using Eigen::Matrix3d;
+using Eigen::Vector2d;
+using Eigen::Vector3d;
+
+static const int kNumPoints = 100;
+static const double kFocalLength = 1000.0;
+static const double kReprojectionError = 4.0;
+static const double kErrorThreshold =
+    (kReprojectionError * kReprojectionError) / (kFocalLength * kFocalLength);
+
+RandomNumberGenerator rng(67);
+
+void ExecuteRandomTest(const RansacParameters& options,
+                       const Vector3d& vertical_axis,
+                       const double rotation_angle_degrees,
+                       const Vector3d& position,
+                       const double inlier_ratio,
+                       const double noise,
+                       const double tolerance) {
+  const Matrix3d rotation =
+      AngleAxisd(DegToRad(rotation_angle_degrees), vertical_axis)
+          .toRotationMatrix();
+
+  // Create feature correspondences (inliers and outliers) and add noise if
+  // appropriate.
+  std::vector<FeatureCorrespondence> correspondences;
+  for (int i = 0; i < kNumPoints; i++) {
+    FeatureCorrespondence correspondence;
+    const Vector3d world_point(rng.RandDouble(-2.0, 2.0),
+                               rng.RandDouble(-2.0, 2.0),
+                               rng.RandDouble(6.0, 10.0));
+
+    // Add an inlier or outlier.
+    if (i < inlier_ratio * kNumPoints) {
+      correspondence.feature1 = world_point.hnormalized();
+      correspondence.feature2 =
+          (rotation * (world_point - position)).hnormalized();
+    } else {
+      correspondence.feature1 = rng.RandVector2d();
+      correspondence.feature2 = rng.RandVector2d();
+    }
+    correspondences.emplace_back(correspondence);
+  }
+
+  if (noise) {
+    for (int i = 0; i < kNumPoints; i++) {
+      AddNoiseToProjection(noise / kFocalLength, &rng,
+                           &correspondences[i].feature1);
+      AddNoiseToProjection(noise / kFocalLength, &rng,
+                           &correspondences[i].feature2);
+    }
+  }
+
+  // Estimate the relative pose.
+  RelativePose relative_pose;
+  RansacSummary ransac_summary;
+  EXPECT_TRUE(EstimateRelativePoseWithKnownVertical(options,
+                                                    RansacType::RANSAC,
+                                                    vertical_axis,
+                                                    correspondences,
+                                                    &relative_pose,
+                                                    &ransac_summary));
+
+  // Expect that the inlier ratio is close to the ground truth.
+  EXPECT_GE(static_cast<double>(ransac_summary.inliers.size()),
+            0.9 * inlier_ratio * kNumPoints);
+
+  // Expect poses are near. The rotation must be about the vertical axis only.
+  const AngleAxisd rotation_error(relative_pose.rotation.transpose() *
+                                  rotation);
+  EXPECT_LT(RadToDeg(rotation_error.angle()), tolerance * 100.0);
+  EXPECT_LT((relative_pose.rotation * vertical_axis - vertical_axis).norm(),
+            1e-8);
+  EXPECT_LT((relative_pose.position - position.normalized()).norm(),
+            tolerance);
+}
+
+TEST(EstimateRelativePoseWithKnownVertical, AllInliersNoNoise) {
+  RansacParameters options;
+  options.rng = std::make_shared<RandomNumberGenerator>(rng);
+  options.use_mle = true;
+  options.error_thresh = kErrorThreshold;
+  options.failure_probability = 0.001;
+  const double kInlierRatio = 1.0;
+  const double kNoise = 0.0;
+  const double kPoseTolerance = 1e-4;
+
+  const std::vector<Vector3d> vertical_axes = {
+    Vector3d::UnitY(), Vector3d(0.1, 1.0, -0.2).normalized()
+  };
+  const std::vector<double> angles = { 0.0, 12.0, -25.0 };
+  const std::vector<Vector3d> positions = { Vector3d(-1.3, 0, 0),
+                                            Vector3d(0.2, 0.1, 0.5) };
+  for (const Vector3d& vertical_axis : vertical_axes) {
+    for (const double angle : angles) {
+      for (const Vector3d& position : positions) {
+        ExecuteRandomTest(options,
+                          vertical_axis,
+                          angle,
+                          position,
+                          kInlierRatio,
+                          kNoise,
+                          kPoseTolerance);
+      }
+    }
+  }
+}
+
+TEST(EstimateRelativePoseWithKnownVertical, OutliersWithNoise) {
+  RansacParameters options;
+  options.rng = std::make_shared<RandomNumberGenerator>(rng);
+  options.use_mle = true;
+  options.error_thresh = kErrorThreshold;
+  options.failure_probability = 0.001;
+  const double kInlierRatio = 0.6;
+  const double kNoise = 1.0;
+  const double kPoseTolerance = 5e-2;
+
+  const std::vector<Vector3d> vertical_axes = {
+    Vector3d::UnitY(), Vector3d(0.1, 1.0, -0.2).normalized()
+  };
+  const std::vector<double> angles = { 5.0, -15.0 };
+  const std::vector<Vector3d> positions = { Vector3d(1, 0, 0),
+                                            Vector3d(0, 0.3, 1) };
+  for (const Vector3d& vertical_axis : vertical_axes) {
+    for (const double angle : angles) {
+      for (const Vector3d& position : positions) {
+        ExecuteRandomTest(options,
+                          vertical_axis,
+                          angle,
+                          position,
+                          kInlierRatio,
+                          kNoise,
+                          kPoseTolerance);
+      }
+    }
+  }
+}
+
+}  // namespace theia
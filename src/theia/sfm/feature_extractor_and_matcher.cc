@@ -45,6 +45,7 @@
 #include "theia/image/descriptor/create_descriptor_extractor.h"
 #include "theia/image/descriptor/descriptor_extractor.h"
 #include "theia/image/image.h"
+#include "theia/image/image_mask.h"
 #include "theia/image/keypoint_detector/keypoint.h"
 #include "theia/matching/create_feature_matcher.h"
 #include "theia/matching/feature_correspondence.h"
@@ -87,35 +88,31 @@ void ExtractFeatures(const FeatureExtractorAndMatcher::Options& options,
       CreateDescriptorExtractor(options.descriptor_extractor_type,
                                 options.feature_density);
 
-  // Exit if the descriptor extraction fails.
-  if (!descriptor_extractor->DetectAndExtractDescriptors(
-          *image, keypoints, descriptors)) {
-    LOG(ERROR) << "Could not extract descriptors in image " << image_filepath;
-    return;
-  }
-
   if (imagemask_filepath.size() > 0) {
-    std::unique_ptr<FloatImage> image_mask(new FloatImage(imagemask_filepath));
+    const FloatImage mask_image(imagemask_filepath);
     // Check the size of the image and its associated mask.
-    CHECK(image_mask->Width() == image->Width() &&
-          image_mask->Height() == image->Height())
+    CHECK(mask_image.Width() == image->Width() &&
+          mask_image.Height() == image->Height())
         << "The image and the mask don't have the same size. \n"
         << "- Image: " << image_filepath << "\t(" << image->Width() << " x "
         << image->Height() << ")\n"
-        << "- Mask: " << imagemask_filepath << "\t(" << image_mask->Width()
-        << " x " << image_mask->Height() << ")";
-
-    // Convert the mask to grayscale.
-    image_mask->ConvertToGrayscaleImage();
-    // Remove keypoints according to the associated mask (remove kp. in black
-    // part).
-    for (int i = keypoints->size() - 1; i > -1; i--) {
-      if (image_mask->BilinearInterpolate(
-              keypoints->at(i).x(), keypoints->at(i).y(), 0) < kMaskThreshold) {
-        keypoints->erase(keypoints->begin() + i);
-        descriptors->erase(descriptors->begin() + i);
-      }
+        << "- Mask: " << imagemask_filepath << "\t(" << mask_image.Width()
+        << " x " << mask_image.Height() << ")";
+
+    // Only extract features in the valid (i.e., white) part of the mask so
+    // that no time is spent describing keypoints that would be discarded.
+    const ImageMask image_mask(mask_image, kMaskThreshold);
+    if (!descriptor_extractor->DetectAndExtractDescriptorsWithMask(
+            *image, image_mask, keypoints, descriptors)) {
+      LOG(ERROR) << "Could not extract descriptors in image "
+                 << image_filepath;
+      return;
     }
+  } else if (!descriptor_extractor->DetectAndExtractDescriptors(
+                 *image, keypoints, descriptors)) {
+    // Exit if the descriptor extraction fails.
+    LOG(ERROR) << "Could not extract descriptors in image " << image_filepath;
+    return;
   }
 
   if (keypoints->size() > options.max_num_features) {
@@ -217,6 +214,9 @@ void FeatureExtractorAndMatcher::SetPairsToMatch(
 void FeatureExtractorAndMatcher::ExtractAndMatchFeatures() {
   CHECK_NOTNULL(matcher_.get());
 
+  // Let the database batch the writes of the extracted features.
+  features_and_matches_database_->BeginBulkFeatureIngestion();
+
   // For each image, process the features and add it to the matcher.
   const int num_threads =
       std::min(options_.num_threads, static_cast<int>(image_filepaths_.size()));
@@ -231,6 +231,7 @@ void FeatureExtractorAndMatcher::ExtractAndMatchFeatures() {
   }
   // This forces all tasks to complete before proceeding.
   thread_pool.reset(nullptr);
+  features_and_matches_database_->EndBulkFeatureIngestion();
 
   // After all threads complete feature extraction, perform matching.
   SelectImagePairsWithGlobalDescriptorMatching();
@@ -316,11 +317,11 @@ void FeatureExtractorAndMatcher::ProcessImage(const int i) {
   // Add the descriptors to the global image descriptor extractor for training
   // if using a global image descriptor extractor.
   if (options_.select_image_pairs_with_global_image_descriptor_matching) {
-    const KeypointsAndDescriptors& features =
-        features_and_matches_database_->GetFeatures(image_filename);
-    CHECK_GT(features.descriptors.size(), 0);
+    const auto features =
+        features_and_matches_database_->GetSharedFeatures(image_filename);
+    CHECK_GT(features->descriptors.size(), 0);
     global_image_descriptor_extractor_->AddFeaturesForTraining(
-        features.descriptors);
+        features->descriptors);
   }
 
   // Add the image to the matcher.
@@ -338,12 +339,12 @@ void FeatureExtractorAndMatcher::ExtractGlobalDesriptors(
   for (int i = 0; i < image_names.size(); i++) {
     pool.Add(
         [&](const int i) {
-          const KeypointsAndDescriptors& features =
-              features_and_matches_database_->GetFeatures(image_names[i]);
+          const auto features =
+              features_and_matches_database_->GetSharedFeatures(image_names[i]);
           // Extract the global descriptors
           (*global_descriptors)[i] =
               global_image_descriptor_extractor_->ExtractGlobalDescriptor(
-                  features.descriptors);
+                  features->descriptors);
         },
         i);
   }
@@ -66,6 +66,11 @@ class LeastUnsquaredDeviationPositionEstimator : public PositionEstimator {
 
     // A measurement for convergence criterion.
     double convergence_criterion = 1e-4;
+
+    // If true, the ADMM penalty parameter of the constrained L1 solver is
+    // adapted to balance the primal and dual residuals. This usually reduces
+    // the number of iterations that are needed.
+    bool adaptive_rho = false;
   };
 
   LeastUnsquaredDeviationPositionEstimator(
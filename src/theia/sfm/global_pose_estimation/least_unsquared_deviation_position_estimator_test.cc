@@ -237,4 +237,27 @@ TEST_F(EstimatePositionsLeastUnsquaredDeviationTest, SmallTestWithNoise) {
                                                kTolerance);
 }
 
+TEST_F(EstimatePositionsLeastUnsquaredDeviationTest, AdaptiveRhoNoNoise) {
+  static const double kTolerance = 1e-2;
+  static const int kNumViews = 4;
+  static const int kNumViewPairs = 6;
+  options_.adaptive_rho = true;
+  TestLeastUnsquaredDeviationPositionEstimator(kNumViews,
+                                               kNumViewPairs,
+                                               0.0,
+                                               kTolerance);
+}
+
+TEST_F(EstimatePositionsLeastUnsquaredDeviationTest, AdaptiveRhoWithNoise) {
+  static const double kTolerance = 0.1;
+  static const int kNumViews = 4;
+  static const int kNumViewPairs = 6;
+  static const double kPoseNoiseDegrees = 1.0;
+  options_.adaptive_rho = true;
+  TestLeastUnsquaredDeviationPositionEstimator(kNumViews,
+                                               kNumViewPairs,
+                                               kPoseNoiseDegrees,
+                                               kTolerance);
+}
+
 }  // namespace theia
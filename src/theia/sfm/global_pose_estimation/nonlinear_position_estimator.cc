@@ -48,6 +48,7 @@
 #include "theia/sfm/types.h"
 #include "theia/util/map_util.h"
 #include "theia/util/random.h"
+#include "theia/util/threadpool.h"
 #include "theia/util/util.h"
 
 namespace theia {
@@ -65,22 +66,6 @@ Vector3d GetRotatedTranslation(const Vector3d& rotation_angle_axis,
   return rotation.transpose() * translation;
 }
 
-Vector3d GetRotatedFeatureRay(const Camera& camera,
-                              const Vector3d& orientation,
-                              const Feature& feature) {
-  Camera temp_camera = camera;
-  temp_camera.SetOrientationFromAngleAxis(orientation);
-  // Get the image ray rotated into the world reference frame.
-  return camera.PixelToUnitDepthRay(feature).normalized();
-}
-
-// Sorts the pairs such that the number of views (i.e. the int) is sorted in
-// descending order.
-bool CompareViewsPerTrack(const std::pair<TrackId, int>& t1,
-                          const std::pair<TrackId, int>& t2) {
-  return t1.second > t2.second;
-}
-
 }  // namespace
 
 NonlinearPositionEstimator::NonlinearPositionEstimator(
@@ -217,7 +202,7 @@ void NonlinearPositionEstimator::AddPointToCameraConstraints(
     const std::unordered_map<ViewId, Eigen::Vector3d>& orientations,
     std::unordered_map<ViewId, Eigen::Vector3d>* positions) {
   const int num_camera_to_camera_constraints = problem_->NumResidualBlocks();
-  std::unordered_set<TrackId> tracks_to_add;
+  std::vector<TrackId> tracks_to_add;
   const int num_point_to_camera_constraints =
       FindTracksForProblem(*positions, &tracks_to_add);
   if (num_point_to_camera_constraints == 0) {
@@ -229,12 +214,37 @@ void NonlinearPositionEstimator::AddPointToCameraConstraints(
       static_cast<double>(num_camera_to_camera_constraints) /
       static_cast<double>(num_point_to_camera_constraints);
 
+  // Compute the feature rays of all tracks in parallel before adding them to
+  // the problem.
+  std::unordered_map<ViewId, Matrix3d> rotations;
+  rotations.reserve(positions->size());
+  for (const auto& position : *positions) {
+    Matrix3d& rotation = rotations[position.first];
+    ceres::AngleAxisToRotationMatrix(
+        FindOrDie(orientations, position.first).data(),
+        ceres::ColumnMajorAdapter3x3(rotation.data()));
+  }
+  std::vector<std::vector<std::pair<ViewId, Vector3d> > > feature_rays(
+      tracks_to_add.size());
+  ParallelForBlocks(options_.num_threads,
+                    tracks_to_add.size(),
+                    [&](const int start, const int end) {
+                      for (int i = start; i < end; i++) {
+                        GetFeatureRaysForTrack(tracks_to_add[i],
+                                               rotations,
+                                               *positions,
+                                               &feature_rays[i]);
+                      }
+                    });
+
   triangulated_points_.reserve(tracks_to_add.size());
-  for (const TrackId track_id : tracks_to_add) {
-    triangulated_points_[track_id] = 100.0 * rng_->RandVector3d();
+  for (int i = 0; i < tracks_to_add.size(); i++) {
+    triangulated_points_[tracks_to_add[i]] = 100.0 * rng_->RandVector3d();
 
-    AddTrackToProblem(
-        track_id, orientations, point_to_camera_weight, positions);
+    AddTrackToProblem(tracks_to_add[i],
+                      feature_rays[i],
+                      point_to_camera_weight,
+                      positions);
   }
 
   VLOG(2) << num_point_to_camera_constraints
@@ -245,112 +255,133 @@ void NonlinearPositionEstimator::AddPointToCameraConstraints(
 
 int NonlinearPositionEstimator::FindTracksForProblem(
     const std::unordered_map<ViewId, Eigen::Vector3d>& positions,
-    std::unordered_set<TrackId>* tracks_to_add) {
+    std::vector<TrackId>* tracks_to_add) {
   CHECK_NOTNULL(tracks_to_add)->clear();
 
-  std::unordered_map<ViewId, int> tracks_per_camera;
+  // Assign contiguous indices to the cameras in order of their view ids. The
+  // cameras claim tracks in this order so that the chosen tracks do not depend
+  // on the number of threads.
+  std::vector<ViewId> view_ids;
+  view_ids.reserve(positions.size());
   for (const auto& position : positions) {
-    tracks_per_camera[position.first] = 0;
+    view_ids.emplace_back(position.first);
+  }
+  std::sort(view_ids.begin(), view_ids.end());
+  std::unordered_map<ViewId, int> view_indices;
+  view_indices.reserve(view_ids.size());
+  for (int i = 0; i < view_ids.size(); i++) {
+    view_indices[view_ids[i]] = i;
   }
 
-  // Add the tracks that see the most views until each camera has the minimum
-  // number of tracks.
-  for (const auto& position : positions) {
-    const View* view = reconstruction_.View(position.first);
-    if (view == nullptr ||
-        view->NumFeatures() < options_.min_num_points_per_view) {
-      continue;
-    }
+  // Find the candidate tracks of each camera in parallel. These are the
+  // min_num_points_per_view tracks that see the most views, with ties broken by
+  // the track id. A candidate that is already claimed when the camera is
+  // processed is observed by the camera, so the candidates always suffice to
+  // cover the camera.
+  std::vector<std::vector<TrackId> > candidate_tracks(view_ids.size());
+  const auto find_candidate_tracks = [&](const int start, const int end) {
+    std::vector<std::pair<int, TrackId> > track_lengths;
+    for (int i = start; i < end; i++) {
+      const View* view = reconstruction_.View(view_ids[i]);
+      if (view == nullptr ||
+          view->NumFeatures() < options_.min_num_points_per_view) {
+        continue;
+      }
 
-    // Get the tracks in sorted order so that we add the tracks that see the
-    // most cameras first.
-    const std::vector<TrackId>& sorted_tracks =
-        GetTracksSortedByNumViews(reconstruction_, *view, *tracks_to_add);
+      // Negate the track lengths so that the longest tracks come first.
+      track_lengths.clear();
+      for (const TrackId track_id : view->TrackIds()) {
+        const Track* track = reconstruction_.Track(track_id);
+        if (track != nullptr) {
+          track_lengths.emplace_back(-track->NumViews(), track_id);
+        }
+      }
+      const int num_candidates =
+          std::min(static_cast<int>(track_lengths.size()),
+                   options_.min_num_points_per_view);
+      std::partial_sort(track_lengths.begin(),
+                        track_lengths.begin() + num_candidates,
+                        track_lengths.end());
+
+      candidate_tracks[i].reserve(num_candidates);
+      for (int j = 0; j < num_candidates; j++) {
+        candidate_tracks[i].emplace_back(track_lengths[j].second);
+      }
+    }
+  };
+  ParallelForBlocks(
+      options_.num_threads, view_ids.size(), find_candidate_tracks);
+
+  // Add the candidate tracks until each camera has the minimum number of
+  // tracks.
+  std::vector<int> tracks_per_camera(view_ids.size(), 0);
+  std::unordered_set<TrackId> added_tracks;
+  for (int i = 0; i < view_ids.size(); i++) {
+    for (int j = 0;
+         j < candidate_tracks[i].size() &&
+         tracks_per_camera[i] < options_.min_num_points_per_view;
+         j++) {
+      const TrackId track_id = candidate_tracks[i][j];
+      if (!added_tracks.insert(track_id).second) {
+        continue;
+      }
 
-    for (int i = 0;
-         i < sorted_tracks.size() &&
-         tracks_per_camera[position.first] < options_.min_num_points_per_view;
-         i++) {
       // Update the number of point to camera constraints for each camera.
-      tracks_to_add->insert(sorted_tracks[i]);
-      for (const ViewId view_id :
-           reconstruction_.Track(sorted_tracks[i])->ViewIds()) {
-        if (!ContainsKey(positions, view_id)) {
-          continue;
+      tracks_to_add->emplace_back(track_id);
+      for (const ViewId view_id : reconstruction_.Track(track_id)->ViewIds()) {
+        const int* view_index = FindOrNull(view_indices, view_id);
+        if (view_index != nullptr) {
+          ++tracks_per_camera[*view_index];
         }
-        ++tracks_per_camera[view_id];
       }
     }
   }
 
+  // Sort the tracks so that the problem is built in a consistent order.
+  std::sort(tracks_to_add->begin(), tracks_to_add->end());
+
   int num_point_to_camera_constraints = 0;
-  for (const auto& tracks_in_camera : tracks_per_camera) {
-    num_point_to_camera_constraints += tracks_in_camera.second;
+  for (int i = 0; i < view_ids.size(); i++) {
+    num_point_to_camera_constraints += tracks_per_camera[i];
   }
   return num_point_to_camera_constraints;
 }
 
-std::vector<TrackId> NonlinearPositionEstimator::GetTracksSortedByNumViews(
-    const Reconstruction& reconstruction,
-    const View& view,
-    const std::unordered_set<TrackId>& existing_tracks) {
-  std::vector<std::pair<TrackId, int> > views_per_track;
-  views_per_track.reserve(view.NumFeatures());
-  const auto& track_ids = view.TrackIds();
-  for (const auto& track_id : track_ids) {
-    const Track* track = reconstruction.Track(track_id);
-
-    if (track == nullptr || ContainsKey(existing_tracks, track_id)) {
+void NonlinearPositionEstimator::GetFeatureRaysForTrack(
+    const TrackId track_id,
+    const std::unordered_map<ViewId, Matrix3d>& rotations,
+    const std::unordered_map<ViewId, Vector3d>& positions,
+    std::vector<std::pair<ViewId, Vector3d> >* feature_rays) {
+  const Track* track = reconstruction_.Track(track_id);
+  feature_rays->reserve(track->NumViews());
+  for (const ViewId view_id : track->ViewIds()) {
+    if (!ContainsKey(positions, view_id)) {
       continue;
     }
-    views_per_track.emplace_back(track_id, track->NumViews());
-  }
 
-  // Return an empty array if no tracks could be found for this view.
-  std::vector<TrackId> sorted_tracks(views_per_track.size());
-  if (views_per_track.size() == 0) {
-    return sorted_tracks;
-  }
-
-  // Sort the tracks by the number of views. Only sort the first few tracks
-  // since those are the ones that will be added to the problem.
-  const int num_tracks_to_sort =
-      std::min(static_cast<int>(views_per_track.size()),
-               options_.min_num_points_per_view);
-  std::partial_sort(views_per_track.begin(),
-                    views_per_track.begin() + num_tracks_to_sort,
-                    views_per_track.end(),
-                    CompareViewsPerTrack);
-
-  for (int i = 0; i < num_tracks_to_sort; i++) {
-    sorted_tracks[i] = views_per_track[i].first;
+    // Rotate the feature ray to be in the global orientation frame.
+    const View* view = reconstruction_.View(view_id);
+    const Vector3d feature_ray =
+        view->Camera().PixelToNormalizedCoordinates(
+            *view->GetFeature(track_id));
+    feature_rays->emplace_back(
+        view_id,
+        (FindOrDie(rotations, view_id).transpose() * feature_ray).normalized());
   }
-  return sorted_tracks;
 }
 
 void NonlinearPositionEstimator::AddTrackToProblem(
     const TrackId track_id,
-    const std::unordered_map<ViewId, Vector3d>& orientations,
+    const std::vector<std::pair<ViewId, Vector3d> >& feature_rays,
     const double point_to_camera_weight,
     std::unordered_map<ViewId, Vector3d>* positions) {
+  Vector3d& point = FindOrDie(triangulated_points_, track_id);
   // For each view in the track add the point to camera correspondences.
-  for (const ViewId view_id : reconstruction_.Track(track_id)->ViewIds()) {
-    if (!ContainsKey(*positions, view_id)) {
-      continue;
-    }
-    Vector3d& camera_position = FindOrDie(*positions, view_id);
-    Vector3d& point = FindOrDie(triangulated_points_, track_id);
-
-    // Rotate the feature ray to be in the global orientation frame.
-    const Vector3d feature_ray = GetRotatedFeatureRay(
-        reconstruction_.View(view_id)->Camera(),
-        FindOrDie(orientations, view_id),
-        *reconstruction_.View(view_id)->GetFeature(track_id));
+  for (const auto& feature_ray : feature_rays) {
+    Vector3d& camera_position = FindOrDie(*positions, feature_ray.first);
 
-    // Rotate the relative translation so that it is aligned to the global
-    // orientation frame.
-    ceres::CostFunction* cost_function =
-        PairwiseTranslationError::Create(feature_ray, point_to_camera_weight);
+    ceres::CostFunction* cost_function = PairwiseTranslationError::Create(
+        feature_ray.second, point_to_camera_weight);
 
     // Add the residual block
     problem_->AddResidualBlock(cost_function,
@@ -41,6 +41,7 @@
 #include <memory>
 #include <unordered_map>
 #include <unordered_set>
+#include <utility>
 #include <vector>
 
 #include "theia/sfm/global_pose_estimation/position_estimator.h"
@@ -110,21 +111,28 @@ class NonlinearPositionEstimator : public PositionEstimator {
 
   // Determines which tracks should be used for point to camera constraints. A
   // greedy approach is used so that the fewest number of tracks are chosen such
-  // that all cameras have at least k point to camera constraints.
+  // that all cameras have at least k point to camera constraints. The k longest
+  // tracks of each camera are found in parallel and the cameras then claim
+  // their tracks serially in order of their view ids, so the result does not
+  // depend on the number of threads. The chosen tracks are returned in
+  // ascending order.
   int FindTracksForProblem(
       const std::unordered_map<ViewId, Eigen::Vector3d>& global_poses,
-      std::unordered_set<TrackId>* tracks_to_add);
+      std::vector<TrackId>* tracks_to_add);
 
-  // Sort the tracks by the number of views that observe them.
-  std::vector<TrackId> GetTracksSortedByNumViews(
-      const Reconstruction& reconstruction,
-      const View& view,
-      const std::unordered_set<TrackId>& existing_tracks);
+  // Returns the feature rays of the track in the global orientation frame for
+  // all views that have a position.
+  void GetFeatureRaysForTrack(
+      const TrackId track_id,
+      const std::unordered_map<ViewId, Eigen::Matrix3d>& rotations,
+      const std::unordered_map<ViewId, Eigen::Vector3d>& positions,
+      std::vector<std::pair<ViewId, Eigen::Vector3d> >* feature_rays);
 
-  // Adds all point to camera constraints for a given track.
+  // Adds all point to camera constraints for a given track from its feature
+  // rays.
   void AddTrackToProblem(
       const TrackId track_id,
-      const std::unordered_map<ViewId, Eigen::Vector3d>& orientations,
+      const std::vector<std::pair<ViewId, Eigen::Vector3d> >& feature_rays,
       const double point_to_camera_weight,
       std::unordered_map<ViewId, Eigen::Vector3d>* positions);
 
@@ -160,6 +160,67 @@ class EstimatePositionsNonlinearTest : public ::testing::Test {
     }
   }
 
+  void TestFindTracksForProblem(const int num_views,
+                                const int num_tracks,
+                                const int max_num_views_per_track,
+                                const int min_num_points_per_view,
+                                const int num_threads) {
+    // Create tracks that are observed by random subsets of the views.
+    SetupReconstruction(num_views, 0);
+    std::vector<ViewId> view_ids = reconstruction_.ViewIds();
+    for (int i = 0; i < num_tracks; i++) {
+      std::random_shuffle(view_ids.begin(), view_ids.end());
+      const int num_views_in_track = rng.RandInt(2, max_num_views_per_track);
+      std::vector<std::pair<ViewId, Feature> > features;
+      for (int j = 0; j < num_views_in_track; j++) {
+        features.emplace_back(view_ids[j], rng.RandVector2d());
+      }
+      reconstruction_.AddTrack(features);
+    }
+
+    options_.min_num_points_per_view = min_num_points_per_view;
+    options_.num_threads = num_threads;
+    NonlinearPositionEstimator position_estimator(options_, reconstruction_);
+    std::vector<TrackId> tracks_to_add;
+    const int num_point_to_camera_constraints =
+        position_estimator.FindTracksForProblem(positions_, &tracks_to_add);
+
+    // The tracks must be unique and sorted.
+    for (int i = 1; i < tracks_to_add.size(); i++) {
+      EXPECT_LT(tracks_to_add[i - 1], tracks_to_add[i]);
+    }
+
+    // Each view with enough features must be constrained by enough tracks.
+    std::unordered_map<ViewId, int> tracks_per_view;
+    for (const TrackId track_id : tracks_to_add) {
+      for (const ViewId view_id : reconstruction_.Track(track_id)->ViewIds()) {
+        ++tracks_per_view[view_id];
+      }
+    }
+    int expected_num_point_to_camera_constraints = 0;
+    for (const ViewId view_id : view_ids) {
+      const int num_tracks_in_view =
+          FindWithDefault(tracks_per_view, view_id, 0);
+      expected_num_point_to_camera_constraints += num_tracks_in_view;
+      if (reconstruction_.View(view_id)->NumFeatures() >=
+          min_num_points_per_view) {
+        EXPECT_GE(num_tracks_in_view, min_num_points_per_view);
+      }
+    }
+    EXPECT_EQ(num_point_to_camera_constraints,
+              expected_num_point_to_camera_constraints);
+
+    // The chosen tracks must not depend on the number of threads.
+    options_.num_threads = 1;
+    NonlinearPositionEstimator serial_position_estimator(options_,
+                                                         reconstruction_);
+    std::vector<TrackId> serial_tracks_to_add;
+    EXPECT_EQ(serial_position_estimator.FindTracksForProblem(
+                  positions_, &serial_tracks_to_add),
+              num_point_to_camera_constraints);
+    EXPECT_EQ(serial_tracks_to_add, tracks_to_add);
+  }
+
  protected:
   void SetUp() {}
 
@@ -281,4 +342,26 @@ TEST_F(EstimatePositionsNonlinearTest, SmallTestWithNoise) {
                                  kTolerance);
 }
 
+TEST_F(EstimatePositionsNonlinearTest, FindTracksForProblem) {
+  static const int kNumViews = 50;
+  static const int kNumTracks = 2000;
+  static const int kMaxNumViewsPerTrack = 10;
+  static const int kMinNumPointsPerView = 20;
+  TestFindTracksForProblem(
+      kNumViews, kNumTracks, kMaxNumViewsPerTrack, kMinNumPointsPerView, 1);
+}
+
+TEST_F(EstimatePositionsNonlinearTest, FindTracksForProblemMultiThreaded) {
+  static const int kNumViews = 50;
+  static const int kNumTracks = 2000;
+  static const int kMaxNumViewsPerTrack = 10;
+  static const int kMinNumPointsPerView = 20;
+  static const int kNumThreads = 4;
+  TestFindTracksForProblem(kNumViews,
+                           kNumTracks,
+                           kMaxNumViewsPerTrack,
+                           kMinNumPointsPerView,
+                           kNumThreads);
+}
+
 }  // namespace theia
@@ -34,22 +34,163 @@
 
 #include "theia/sfm/global_pose_estimation/nonlinear_rotation_estimator.h"
 
-#include <ceres/ceres.h>
+#include <ceres/rotation.h>
 #include <Eigen/Core>
-#include <memory>
+#include <Eigen/SparseCore>
+#include <glog/logging.h>
+#include <algorithm>
+#include <cmath>
+#include <string>
 #include <unordered_map>
+#include <vector>
 
+#include "theia/math/matrix/sparse_cholesky_llt.h"
+#include "theia/math/rotation.h"
+#include "theia/sfm/twoview_info.h"
+#include "theia/sfm/types.h"
 #include "theia/util/hash.h"
 #include "theia/util/map_util.h"
-#include "theia/sfm/global_pose_estimation/pairwise_rotation_error.h"
-#include "theia/sfm/types.h"
+#include "theia/util/stringprintf.h"
+#include "theia/util/threadpool.h"
 
 namespace theia {
+namespace {
+
+using Eigen::Matrix3d;
+using Eigen::Vector3d;
+
+// The first view is held constant to remove the gauge freedom of the problem
+// and is not part of the linear system.
+static const int kConstantViewIndex = 0;
+
+// A relative rotation constraint R_12 = R_2 * R_1' between two views given by
+// their indices in the contiguous remapping of the views.
+struct RelativeRotationConstraint {
+  int view1_index;
+  int view2_index;
+  Matrix3d relative_rotation;
+};
+
+// The linearization of the weighted error of a constraint. The Jacobian of the
+// error with respect to the increment of the second rotation is J and with
+// respect to the increment of the first rotation is -J. The contributions to
+// the normal equations are thus given by +/- w * J' * J and +/- w * J' * r.
+struct LinearizedConstraint {
+  Matrix3d hessian;
+  Vector3d gradient;
+};
+
+// An incident constraint of a view and the position of the block of the other
+// view in the column of the view in the normal equations.
+struct IncidentConstraint {
+  int constraint_index;
+  bool is_second_view;
+  int neighbor_block_position;
+};
+
+Matrix3d AngleAxisToRotationMatrix(const Vector3d& angle_axis) {
+  Matrix3d rotation;
+  ceres::AngleAxisToRotationMatrix(
+      angle_axis.data(), ceres::ColumnMajorAdapter3x3(rotation.data()));
+  return rotation;
+}
+
+Vector3d RotationMatrixToAngleAxis(const Matrix3d& rotation) {
+  Vector3d angle_axis;
+  ceres::RotationMatrixToAngleAxis(
+      ceres::ColumnMajorAdapter3x3(rotation.data()), angle_axis.data());
+  return angle_axis;
+}
+
+Matrix3d CrossProductMatrix(const Vector3d& vector) {
+  Matrix3d cross_product_matrix;
+  cross_product_matrix << 0.0, -vector.z(), vector.y(), vector.z(), 0.0,
+      -vector.x(), -vector.y(), vector.x(), 0.0;
+  return cross_product_matrix;
+}
+
+// Returns the inverse of the left Jacobian of SO(3) such that for small a:
+//   log(exp(a) * exp(r)) ~= r + InverseLeftJacobian(r) * a.
+Matrix3d InverseLeftJacobian(const Vector3d& rotation) {
+  static const double kSmallAngle = 1e-4;
+  const double angle = rotation.norm();
+  const Matrix3d cross_product_matrix = CrossProductMatrix(rotation);
+  // The coefficient is (1 - (angle / 2) * cot(angle / 2)) / angle^2, which
+  // tends to 1 / 12 as the angle goes to zero.
+  const double coefficient =
+      angle < kSmallAngle
+          ? 1.0 / 12.0
+          : (1.0 - 0.5 * angle / std::tan(0.5 * angle)) / (angle * angle);
+  return Matrix3d::Identity() - 0.5 * cross_product_matrix +
+         coefficient * cross_product_matrix * cross_product_matrix;
+}
+
+// The SoftL1 loss rho(s) = 2 * b^2 * (sqrt(1 + s / b^2) - 1) of the squared
+// error s and its derivative, which is the weight used by the iteratively
+// reweighted least squares.
+double SoftLOneLoss(const double sq_error, const double sq_loss_width) {
+  return 2.0 * sq_loss_width *
+         (std::sqrt(1.0 + sq_error / sq_loss_width) - 1.0);
+}
+
+double SoftLOneWeight(const double sq_error, const double sq_loss_width) {
+  return 1.0 / std::sqrt(1.0 + sq_error / sq_loss_width);
+}
+
+// Returns the rotation error R_2 * R_1' * R_12' of the constraint.
+Vector3d ComputeRotationError(const RelativeRotationConstraint& constraint,
+                              const std::vector<Matrix3d>& rotations) {
+  return RotationMatrixToAngleAxis(
+      rotations[constraint.view2_index] *
+      rotations[constraint.view1_index].transpose() *
+      constraint.relative_rotation.transpose());
+}
+
+void ComputeRotationMatrices(const int num_threads,
+                             const std::vector<Vector3d>& orientations,
+                             std::vector<Matrix3d>* rotations) {
+  rotations->resize(orientations.size());
+  ParallelForBlocks(num_threads,
+                    orientations.size(),
+                    [&](const int start, const int end) {
+                      for (int i = start; i < end; i++) {
+                        (*rotations)[i] =
+                            AngleAxisToRotationMatrix(orientations[i]);
+                      }
+                    });
+}
+
+// Returns the total cost 1/2 * sum rho(|r|^2) of the constraints.
+double ComputeCost(const int num_threads,
+                   const double sq_loss_width,
+                   const std::vector<RelativeRotationConstraint>& constraints,
+                   const std::vector<Matrix3d>& rotations,
+                   std::vector<double>* costs) {
+  costs->resize(constraints.size());
+  ParallelForBlocks(
+      num_threads, constraints.size(), [&](const int start, const int end) {
+        for (int i = start; i < end; i++) {
+          const Vector3d error =
+              ComputeRotationError(constraints[i], rotations);
+          (*costs)[i] = 0.5 * SoftLOneLoss(error.squaredNorm(), sq_loss_width);
+        }
+      });
+
+  double cost = 0;
+  for (const double constraint_cost : *costs) {
+    cost += constraint_cost;
+  }
+  return cost;
+}
+
+}  // namespace
 
 bool NonlinearRotationEstimator::EstimateRotations(
-      const std::unordered_map<ViewIdPair, TwoViewInfo>& view_pairs,
-      std::unordered_map<ViewId, Eigen::Vector3d>* global_orientations) {
+    const std::unordered_map<ViewIdPair, TwoViewInfo>& view_pairs,
+    std::unordered_map<ViewId, Eigen::Vector3d>* global_orientations) {
   CHECK_NOTNULL(global_orientations);
+  CHECK_GT(options_.robust_loss_width, 0.0);
+  CHECK_GT(options_.num_threads, 0);
   if (global_orientations->size() == 0) {
     LOG(INFO) << "Skipping nonlinear rotation optimization because no "
                  "initialization was provivded.";
@@ -61,41 +202,304 @@ bool NonlinearRotationEstimator::EstimateRotations(
     return false;
   }
 
-  // Set up the problem and loss function.
-  std::unique_ptr<ceres::Problem> problem(new ceres::Problem());
-  ceres::LossFunction* loss_function =
-      new ceres::SoftLOneLoss(robust_loss_width_);
-
+  // Remap the views that are constrained by at least one relative rotation to
+  // contiguous indices. The relative rotation constraints are only added if
+  // both orientations have an initialization.
+  std::vector<ViewId> view_ids;
   for (const auto& view_pair : view_pairs) {
     const ViewIdPair& view_id_pair = view_pair.first;
-    Eigen::Vector3d* rotation1 =
-        FindOrNull(*global_orientations, view_id_pair.first);
-    Eigen::Vector3d* rotation2 =
-        FindOrNull(*global_orientations, view_id_pair.second);
-
-    // Do not add the relative rotation constaint if it requires an orientation
-    // that we do not have an initialization for.
-    if (rotation1 == nullptr || rotation2 == nullptr) {
+    if (view_id_pair.first == view_id_pair.second ||
+        !ContainsKey(*global_orientations, view_id_pair.first) ||
+        !ContainsKey(*global_orientations, view_id_pair.second)) {
       continue;
     }
+    view_ids.emplace_back(view_id_pair.first);
+    view_ids.emplace_back(view_id_pair.second);
+  }
+  std::sort(view_ids.begin(), view_ids.end());
+  view_ids.erase(std::unique(view_ids.begin(), view_ids.end()),
+                 view_ids.end());
+  if (view_ids.empty()) {
+    LOG(INFO) << "Skipping nonlinear rotation optimization because no "
+                 "relative rotation constraints have initialized views.";
+    return false;
+  }
 
-    ceres::CostFunction* cost_function =
-        PairwiseRotationError::Create(view_pair.second.rotation_2, 1.0);
-    problem->AddResidualBlock(cost_function,
-                              loss_function,
-                              rotation1->data(),
-                              rotation2->data());
+  std::unordered_map<ViewId, int> view_id_to_index;
+  view_id_to_index.reserve(view_ids.size());
+  std::vector<Vector3d> orientations(view_ids.size());
+  for (int i = 0; i < view_ids.size(); i++) {
+    view_id_to_index[view_ids[i]] = i;
+    orientations[i] = FindOrDie(*global_orientations, view_ids[i]);
   }
 
-  // The problem should be relatively sparse so sparse cholesky is a good
-  // choice.
-  ceres::Solver::Options options;
-  options.linear_solver_type = ceres::SPARSE_NORMAL_CHOLESKY;
-  options.max_num_iterations = 200;
+  std::vector<RelativeRotationConstraint> constraints;
+  constraints.reserve(view_pairs.size());
+  for (const auto& view_pair : view_pairs) {
+    const int* view1_index =
+        FindOrNull(view_id_to_index, view_pair.first.first);
+    const int* view2_index =
+        FindOrNull(view_id_to_index, view_pair.first.second);
+    if (view1_index == nullptr || view2_index == nullptr ||
+        *view1_index == *view2_index) {
+      continue;
+    }
+    RelativeRotationConstraint constraint;
+    constraint.view1_index = *view1_index;
+    constraint.view2_index = *view2_index;
+    constraint.relative_rotation =
+        AngleAxisToRotationMatrix(view_pair.second.rotation_2);
+    constraints.emplace_back(constraint);
+  }
+
+  // Find the constraints that are incident to each view along with the views
+  // that share a block in the normal equations.
+  const int num_views = view_ids.size();
+  std::vector<std::vector<IncidentConstraint> > incident_constraints(
+      num_views);
+  std::vector<std::vector<int> > neighbor_views(num_views);
+  for (int i = 0; i < constraints.size(); i++) {
+    const int view1_index = constraints[i].view1_index;
+    const int view2_index = constraints[i].view2_index;
+    incident_constraints[view1_index].push_back({i, false, -1});
+    incident_constraints[view2_index].push_back({i, true, -1});
+    neighbor_views[view1_index].emplace_back(view2_index);
+    neighbor_views[view2_index].emplace_back(view1_index);
+  }
+  for (int i = 0; i < num_views; i++) {
+    std::vector<int>& neighbors = neighbor_views[i];
+    neighbors.emplace_back(i);
+    neighbors.erase(std::remove(neighbors.begin(),
+                                neighbors.end(),
+                                kConstantViewIndex),
+                    neighbors.end());
+    std::sort(neighbors.begin(), neighbors.end());
+    neighbors.erase(std::unique(neighbors.begin(), neighbors.end()),
+                    neighbors.end());
+    for (IncidentConstraint& incident_constraint : incident_constraints[i]) {
+      const RelativeRotationConstraint& constraint =
+          constraints[incident_constraint.constraint_index];
+      const int neighbor_index = incident_constraint.is_second_view
+                                     ? constraint.view1_index
+                                     : constraint.view2_index;
+      if (neighbor_index != kConstantViewIndex) {
+        incident_constraint.neighbor_block_position =
+            std::lower_bound(neighbors.begin(), neighbors.end(),
+                             neighbor_index) -
+            neighbors.begin();
+      }
+    }
+  }
+
+  // Set up the block sparse normal equations. The constant view is not part of
+  // the system, so view i corresponds to block i - 1. Each column of a block
+  // stores the 3x3 blocks of the neighboring views in order.
+  const int num_parameters = 3 * (num_views - 1);
+  if (num_parameters == 0) {
+    return true;
+  }
+  Eigen::SparseMatrix<double> hessian(num_parameters, num_parameters);
+  Eigen::VectorXi column_sizes(num_parameters);
+  for (int i = 1; i < num_views; i++) {
+    column_sizes.segment<3>(3 * (i - 1))
+        .setConstant(3 * neighbor_views[i].size());
+  }
+  hessian.reserve(column_sizes);
+  std::vector<int> diagonal_block_positions(num_views, -1);
+  for (int i = 1; i < num_views; i++) {
+    for (int c = 0; c < 3; c++) {
+      for (const int neighbor_index : neighbor_views[i]) {
+        for (int r = 0; r < 3; r++) {
+          hessian.insert(3 * (neighbor_index - 1) + r, 3 * (i - 1) + c) = 0.0;
+        }
+      }
+    }
+    diagonal_block_positions[i] =
+        std::lower_bound(neighbor_views[i].begin(), neighbor_views[i].end(),
+                         i) -
+        neighbor_views[i].begin();
+  }
+  hessian.makeCompressed();
+
+  // The sparsity pattern never changes so the symbolic factorization is only
+  // computed once.
+  SparseCholeskyLLt linear_solver;
+  linear_solver.AnalyzePattern(hessian);
+  if (linear_solver.Info() != Eigen::Success) {
+    LOG(ERROR) << "Could not analyze the sparsity pattern of the rotation "
+                  "averaging problem.";
+    return false;
+  }
+
+  static const double kInitialDamping = 1e-4;
+  static const double kMinDamping = 1e-12;
+  static const double kMaxDamping = 1e16;
+  static const double kMinDiagonal = 1e-6;
+  const double sq_loss_width =
+      options_.robust_loss_width * options_.robust_loss_width;
+  const int num_threads = options_.num_threads;
+
+  std::vector<Matrix3d> rotations, trial_rotations;
+  std::vector<Vector3d> trial_orientations(num_views);
+  std::vector<LinearizedConstraint> linearized_constraints(constraints.size());
+  std::vector<double> costs;
+  Eigen::VectorXd gradient(num_parameters), diagonal(num_parameters);
+  double* hessian_values = hessian.valuePtr();
+  const int* hessian_column_starts = hessian.outerIndexPtr();
 
-  ceres::Solver::Summary summary;
-  ceres::Solve(options, problem.get(), &summary);
-  VLOG(1) << summary.FullReport();
+  ComputeRotationMatrices(num_threads, orientations, &rotations);
+  double cost =
+      ComputeCost(num_threads, sq_loss_width, constraints, rotations, &costs);
+  const double initial_cost = cost;
+  double damping = kInitialDamping;
+
+  VLOG(2) << "Iteration   Cost            Damping";
+  const std::string row_format = "  % 4d     % 4.4e     % 4.4e";
+  int iteration = 0;
+  for (; iteration < options_.max_num_iterations && cost > 0.0;
+       iteration++) {
+    // Linearize the constraints around the current rotations. The weight of
+    // each constraint is given by the robust loss.
+    ParallelForBlocks(
+        num_threads, constraints.size(), [&](const int start, const int end) {
+          for (int i = start; i < end; i++) {
+            const RelativeRotationConstraint& constraint = constraints[i];
+            const Vector3d error = ComputeRotationError(constraint, rotations);
+            const double weight =
+                SoftLOneWeight(error.squaredNorm(), sq_loss_width);
+            const Matrix3d jacobian = InverseLeftJacobian(error) *
+                                      rotations[constraint.view2_index];
+            linearized_constraints[i].hessian =
+                weight * jacobian.transpose() * jacobian;
+            linearized_constraints[i].gradient =
+                weight * jacobian.transpose() * error;
+          }
+        });
+
+    // Assemble the normal equations. Each view fills its own columns so the
+    // views may be processed in parallel.
+    ParallelForBlocks(
+        num_threads, num_views - 1, [&](const int start, const int end) {
+          for (int i = start + 1; i < end + 1; i++) {
+            const int column = 3 * (i - 1);
+            const int column_size = 3 * neighbor_views[i].size();
+            for (int c = 0; c < 3; c++) {
+              std::fill(hessian_values + hessian_column_starts[column + c],
+                        hessian_values + hessian_column_starts[column + c] +
+                            column_size,
+                        0.0);
+            }
+
+            Vector3d view_gradient = Vector3d::Zero();
+            const auto add_block = [&](const int block_position,
+                                       const Matrix3d& block) {
+              for (int c = 0; c < 3; c++) {
+                double* column_values = hessian_values +
+                                        hessian_column_starts[column + c] +
+                                        3 * block_position;
+                for (int r = 0; r < 3; r++) {
+                  column_values[r] += block(r, c);
+                }
+              }
+            };
+            for (const IncidentConstraint& incident_constraint :
+                 incident_constraints[i]) {
+              const LinearizedConstraint& linearized_constraint =
+                  linearized_constraints[incident_constraint.constraint_index];
+              add_block(diagonal_block_positions[i],
+                        linearized_constraint.hessian);
+              if (incident_constraint.is_second_view) {
+                view_gradient += linearized_constraint.gradient;
+              } else {
+                view_gradient -= linearized_constraint.gradient;
+              }
+              if (incident_constraint.neighbor_block_position >= 0) {
+                add_block(incident_constraint.neighbor_block_position,
+                          -linearized_constraint.hessian);
+              }
+            }
+            gradient.segment<3>(column) = view_gradient;
+            for (int c = 0; c < 3; c++) {
+              diagonal(column + c) = std::max(
+                  kMinDiagonal,
+                  hessian_values[hessian_column_starts[column + c] +
+                                 3 * diagonal_block_positions[i] + c]);
+            }
+          }
+        });
+
+    // Find a step that decreases the cost, increasing the damping of the
+    // normal equations until one is found.
+    bool step_accepted = false;
+    double max_rotation_change = 0.0;
+    double trial_cost = cost;
+    while (!step_accepted && damping < kMaxDamping) {
+      for (int i = 0; i < num_parameters; i++) {
+        hessian_values[hessian_column_starts[i] +
+                       3 * diagonal_block_positions[i / 3 + 1] + i % 3] =
+            (1.0 + damping) * diagonal(i);
+      }
+      linear_solver.Factorize(hessian);
+      if (linear_solver.Info() != Eigen::Success) {
+        damping *= 10.0;
+        continue;
+      }
+      const Eigen::VectorXd rotation_change = linear_solver.Solve(-gradient);
+      if (linear_solver.Info() != Eigen::Success) {
+        damping *= 10.0;
+        continue;
+      }
+      max_rotation_change = rotation_change.lpNorm<Eigen::Infinity>();
+
+      // Apply the rotation change such that R_i <- R_i * exp(dR_i).
+      trial_orientations[kConstantViewIndex] =
+          orientations[kConstantViewIndex];
+      ParallelForBlocks(
+          num_threads, num_views - 1, [&](const int start, const int end) {
+            for (int i = start + 1; i < end + 1; i++) {
+              trial_orientations[i] = MultiplyRotations(
+                  orientations[i], rotation_change.segment<3>(3 * (i - 1)));
+            }
+          });
+      ComputeRotationMatrices(num_threads, trial_orientations,
+                              &trial_rotations);
+      trial_cost = ComputeCost(
+          num_threads, sq_loss_width, constraints, trial_rotations, &costs);
+
+      if (trial_cost < cost) {
+        step_accepted = true;
+        damping = std::max(kMinDamping, damping / 10.0);
+      } else {
+        damping *= 10.0;
+      }
+    }
+
+    if (!step_accepted) {
+      VLOG(1) << "Could not find a step that reduces the rotation error.";
+      break;
+    }
+
+    const double cost_change = cost - trial_cost;
+    orientations.swap(trial_orientations);
+    rotations.swap(trial_rotations);
+    cost = trial_cost;
+    VLOG(2) << StringPrintf(row_format.c_str(), iteration, cost, damping);
+
+    if (cost_change < options_.function_tolerance * (cost + cost_change) ||
+        max_rotation_change < options_.parameter_tolerance) {
+      ++iteration;
+      break;
+    }
+  }
+
+  VLOG(1) << "Nonlinear rotation estimation reduced the cost from "
+          << initial_cost << " to " << cost << " in " << iteration
+          << " iterations.";
+
+  // Update the global orientations.
+  for (int i = 0; i < num_views; i++) {
+    (*global_orientations)[view_ids[i]] = orientations[i];
+  }
   return true;
 }
 
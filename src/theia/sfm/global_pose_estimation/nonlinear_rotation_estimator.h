@@ -45,13 +45,43 @@
 namespace theia {
 
 // Computes the global rotations given relative rotations and an initial guess
-// for the global orientations. Nonlinear optimization is performed with Ceres
-// using a SoftL1 loss function to be robust to outliers.
+// for the global orientations. The relative rotation error of all view pairs is
+// minimized with a SoftL1 loss function to be robust to outliers.
+//
+// The optimization is performed directly on SO(3): each iteration linearizes
+// the errors around the current rotations with respect to Lie algebra
+// increments R_i <- R_i * exp(dR_i) using analytic 3x3 Jacobians. The weighted
+// normal equations (using iteratively reweighted least squares for the robust
+// loss) have a 3x3 block structure given by the view graph, so the sparsity
+// pattern is analyzed once and only the numeric factorization is recomputed in
+// each iteration. Levenberg-Marquardt damping is used to ensure that each step
+// reduces the cost. The views are remapped to contiguous indices so that the
+// errors and normal equations may be computed in parallel.
 class NonlinearRotationEstimator : public RotationEstimator {
  public:
-  NonlinearRotationEstimator() : robust_loss_width_(0.1) {}
-  explicit NonlinearRotationEstimator(const double robust_loss_width)
-      : robust_loss_width_(robust_loss_width) {}
+  struct Options {
+    // The width of the SoftL1 loss function applied to the angular error (in
+    // radians) of each relative rotation.
+    double robust_loss_width = 0.1;
+
+    // The maximum number of iterations to perform.
+    int max_num_iterations = 200;
+
+    // The number of threads used to compute the errors and normal equations.
+    int num_threads = 1;
+
+    // The optimization stops when the relative decrease in cost or the largest
+    // rotation change (in radians) of an iteration falls below these values.
+    double function_tolerance = 1e-6;
+    double parameter_tolerance = 1e-8;
+  };
+
+  NonlinearRotationEstimator() {}
+  explicit NonlinearRotationEstimator(const double robust_loss_width) {
+    options_.robust_loss_width = robust_loss_width;
+  }
+  explicit NonlinearRotationEstimator(const Options& options)
+      : options_(options) {}
 
   // Estimates the global orientations of all views based on an initial
   // guess. Returns true on successful estimation and false otherwise.
@@ -60,7 +90,7 @@ class NonlinearRotationEstimator : public RotationEstimator {
       std::unordered_map<ViewId, Eigen::Vector3d>* global_orientations);
 
  private:
-  const double robust_loss_width_;
+  Options options_;
 };
 
 }  // namespace theia
@@ -309,7 +309,7 @@ bool GlobalReconstructionEstimator::FilterInitialViewGraph() {
   }
 
   // Only reconstruct the largest connected component.
-  RemoveDisconnectedViewPairs(view_graph_);
+  RemoveDisconnectedViewPairs(options_.num_threads, view_graph_);
   return view_graph_->NumEdges() >= 1;
 }
 
@@ -336,7 +336,10 @@ bool GlobalReconstructionEstimator::EstimateGlobalRotations() {
       // Initialize the orientation estimations by walking along the maximum
       // spanning tree.
       OrientationsFromMaximumSpanningTree(*view_graph_, &orientations_);
-      rotation_estimator.reset(new NonlinearRotationEstimator());
+      NonlinearRotationEstimator::Options nonlinear_rotation_estimator_options;
+      nonlinear_rotation_estimator_options.num_threads = options_.num_threads;
+      rotation_estimator.reset(
+          new NonlinearRotationEstimator(nonlinear_rotation_estimator_options));
       break;
     }
     case GlobalRotationEstimatorType::LINEAR: {
@@ -363,7 +366,7 @@ void GlobalReconstructionEstimator::FilterRotations() {
       view_graph_);
   // Remove any disconnected views from the estimation.
   const std::unordered_set<ViewId> removed_views =
-      RemoveDisconnectedViewPairs(view_graph_);
+      RemoveDisconnectedViewPairs(options_.num_threads, view_graph_);
   for (const ViewId removed_view : removed_views) {
     orientations_.erase(removed_view);
   }
@@ -395,7 +398,7 @@ void GlobalReconstructionEstimator::FilterRelativeTranslation() {
   }
   // Remove any disconnected views from the estimation.
   const std::unordered_set<ViewId> removed_views =
-      RemoveDisconnectedViewPairs(view_graph_);
+      RemoveDisconnectedViewPairs(options_.num_threads, view_graph_);
   for (const ViewId removed_view : removed_views) {
     orientations_.erase(removed_view);
   }
@@ -443,6 +446,8 @@ void GlobalReconstructionEstimator::EstimateStructure() {
   triangulation_options.min_triangulation_angle_degrees =
       options_.min_triangulation_angle_degrees;
   triangulation_options.bundle_adjustment = options_.bundle_adjust_tracks;
+  triangulation_options.use_robust_triangulation =
+      options_.use_robust_triangulation;
   triangulation_options.ba_options = SetBundleAdjustmentOptions(options_, 0);
   triangulation_options.ba_options.num_threads = 1;
   triangulation_options.ba_options.verbose = false;
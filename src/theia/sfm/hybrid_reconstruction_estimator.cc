@@ -118,6 +118,8 @@ HybridReconstructionEstimator::HybridReconstructionEstimator(
   triangulation_options_.min_triangulation_angle_degrees =
       options_.min_triangulation_angle_degrees;
   triangulation_options_.bundle_adjustment = options_.bundle_adjust_tracks;
+  triangulation_options_.use_robust_triangulation =
+      options_.use_robust_triangulation;
   triangulation_options_.ba_options = SetBundleAdjustmentOptions(options_, 0);
   triangulation_options_.ba_options.num_threads = 1;
   triangulation_options_.ba_options.verbose = false;
@@ -127,6 +129,7 @@ HybridReconstructionEstimator::HybridReconstructionEstimator(
   localization_options_.reprojection_error_threshold_pixels =
       options_.absolute_pose_reprojection_error_threshold;
   localization_options_.ransac_params = ransac_params_;
+  localization_options_.pnp_type = options_.absolute_pose_pnp_type;
   localization_options_.bundle_adjust_view = false;
   localization_options_.ba_options = SetBundleAdjustmentOptions(options_, 0);
   localization_options_.ba_options.constant_camera_orientation = true;
@@ -331,7 +334,10 @@ bool HybridReconstructionEstimator::EstimateCameraOrientations() {
       // spanning tree.
       CHECK(OrientationsFromMaximumSpanningTree(*view_graph_, &orientations_))
           << "Could not estimate orientations from a spanning tree.";
-      rotation_estimator.reset(new NonlinearRotationEstimator());
+      NonlinearRotationEstimator::Options nonlinear_rotation_estimator_options;
+      nonlinear_rotation_estimator_options.num_threads = options_.num_threads;
+      rotation_estimator.reset(
+          new NonlinearRotationEstimator(nonlinear_rotation_estimator_options));
       break;
     }
     case GlobalRotationEstimatorType::LINEAR: {
@@ -658,7 +664,7 @@ void HybridReconstructionEstimator::FindViewsToLocalize(
 
     // Count the number of estimated tracks for this view.
     const auto& track_ids = view->TrackIds();
-    VisibilityPyramid pyramid(
+    BitsetVisibilityPyramid pyramid(
         camera.ImageWidth(), camera.ImageHeight(), kNumPyramidLevels);
     int num_estimated_tracks = 0;
     for (const TrackId track_id : track_ids) {
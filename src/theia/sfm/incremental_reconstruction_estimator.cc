@@ -113,6 +113,8 @@ IncrementalReconstructionEstimator::IncrementalReconstructionEstimator(
   triangulation_options_.min_triangulation_angle_degrees =
       options_.min_triangulation_angle_degrees;
   triangulation_options_.bundle_adjustment = options_.bundle_adjust_tracks;
+  triangulation_options_.use_robust_triangulation =
+      options_.use_robust_triangulation;
   triangulation_options_.ba_options = SetBundleAdjustmentOptions(options_, 0);
   triangulation_options_.ba_options.num_threads = 1;
   triangulation_options_.ba_options.verbose = false;
@@ -122,6 +124,7 @@ IncrementalReconstructionEstimator::IncrementalReconstructionEstimator(
   localization_options_.reprojection_error_threshold_pixels =
       options_.absolute_pose_reprojection_error_threshold;
   localization_options_.ransac_params = ransac_params_;
+  localization_options_.pnp_type = options_.absolute_pose_pnp_type;
   localization_options_.bundle_adjust_view = true;
   localization_options_.ba_options = SetBundleAdjustmentOptions(options_, 0);
   localization_options_.ba_options.verbose = false;
@@ -434,7 +437,7 @@ void IncrementalReconstructionEstimator::FindViewsToLocalize(
 
     // Count the number of estimated tracks for this view.
     const auto& track_ids = view->TrackIds();
-    VisibilityPyramid pyramid(
+    BitsetVisibilityPyramid pyramid(
         camera.ImageWidth(), camera.ImageHeight(), kNumPyramidLevels);
     int num_estimated_tracks = 0;
     for (const TrackId track_id : track_ids) {
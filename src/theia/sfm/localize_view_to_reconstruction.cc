@@ -34,6 +34,7 @@
 
 #include "theia/sfm/localize_view_to_reconstruction.h"
 
+#include <Eigen/Core>
 #include <glog/logging.h>
 #include <vector>
 
@@ -113,13 +114,21 @@ void GetIntrinsicsNormalized2D3DMatches(
     }
 
     FeatureCorrespondence2D3D correspondence;
-    const Feature& feature = *view.GetFeature(track_id);
-    // Remove the camera intrinsics from the feature.
-    correspondence.feature =
-        camera.PixelToNormalizedCoordinates(feature).hnormalized();
+    correspondence.feature = *view.GetFeature(track_id);
     correspondence.world_point = track->Point().hnormalized();
     matches->emplace_back(correspondence);
   }
+
+  // Remove the camera intrinsics from all features at once.
+  Eigen::Matrix2Xd features(2, matches->size());
+  for (int i = 0; i < matches->size(); i++) {
+    features.col(i) = (*matches)[i].feature;
+  }
+  Eigen::Matrix3Xd normalized_features;
+  camera.PixelsToNormalizedCoordinates(features, &normalized_features);
+  for (int i = 0; i < matches->size(); i++) {
+    (*matches)[i].feature = normalized_features.col(i).hnormalized();
+  }
 }
 
 bool EstimateCameraPose(const bool known_intrinsics,
@@ -190,8 +199,12 @@ bool EstimateCameraPose(const bool known_intrinsics,
         resolution_scaled_reprojection_error_threshold_pixels /
         (camera->FocalLength() * camera->FocalLength());
     CalibratedAbsolutePose pose;
-    if (EstimateCalibratedAbsolutePose(
-            ransac_parameters, RansacType::RANSAC, matches, &pose, summary)) {
+    if (EstimateCalibratedAbsolutePose(ransac_parameters,
+                                       RansacType::RANSAC,
+                                       options.pnp_type,
+                                       matches,
+                                       &pose,
+                                       summary)) {
       camera->SetOrientationFromRotationMatrix(pose.rotation);
       camera->SetPosition(pose.position);
       return true;
@@ -36,6 +36,7 @@
 #define THEIA_SFM_LOCALIZE_VIEW_TO_RECONSTRUCTION_H_
 
 #include "theia/sfm/bundle_adjustment/bundle_adjustment.h"
+#include "theia/sfm/estimators/estimate_calibrated_absolute_pose.h"
 #include "theia/sfm/types.h"
 #include "theia/solvers/sample_consensus_estimator.h"
 
@@ -60,6 +61,9 @@ struct LocalizeViewToReconstructionOptions {
   // then standard P3P is used.
   bool assume_known_orientation = false;
 
+  // The P3P solver used when the camera intrinsics are known.
+  PnPType pnp_type = PnPType::KNEIP;
+
   // The RANSAC parameters used for robust estimation in the localization
   // algorithms.
   RansacParameters ransac_params;
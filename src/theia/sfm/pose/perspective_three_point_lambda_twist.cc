@@ -0,0 +1,286 @@
+// Copyright (C) 2026 The Regents of the University of California (Regents).
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials provided
+//       with the distribution.
+//
+//     * Neither the name of The Regents or University of California nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+// Please contact the author of this library if you have any questions.
+// Author: agent (agent@local)
+
+#include "theia/sfm/pose/perspective_three_point_lambda_twist.h"
+
+#include <Eigen/Core>
+#include <Eigen/Eigenvalues>
+#include <Eigen/LU>
+#include <algorithm>
+#include <cmath>
+
+#include "theia/math/closed_form_polynomial_solver.h"
+
+namespace theia {
+
+using Eigen::Matrix3d;
+using Eigen::Vector2d;
+using Eigen::Vector3d;
+
+namespace {
+
+// Computes the real roots of x^2 + b * x + c = 0 in a numerically stable way.
+// Returns false if the roots are complex.
+inline bool SolveMonicQuadratic(const double b,
+                                const double c,
+                                double* root1,
+                                double* root2) {
+  const double discriminant = b * b - 4.0 * c;
+  if (discriminant < 0) {
+    return false;
+  }
+
+  const double sqrt_discriminant = std::sqrt(discriminant);
+  *root1 = (b < 0) ? 0.5 * (-b + sqrt_discriminant)
+                   : 0.5 * (-b - sqrt_discriminant);
+  *root2 = (*root1 != 0) ? c / *root1 : 0.0;
+  return true;
+}
+
+// Returns a single real root of the monic cubic x^3 + b * x^2 + c * x + d = 0.
+// Any real root may be used to diagonalize the degenerate conic, so we take
+// the root that is furthest from zero and polish it with Newton iterations.
+double SolveCubicForSingleRoot(const double b, const double c, const double d) {
+  static const int kNumNewtonIterations = 5;
+
+  double roots[3];
+  const int num_roots = SolveCubicReals(1.0, b, c, d, roots);
+  double root = roots[0];
+  for (int i = 1; i < num_roots; i++) {
+    if (std::abs(roots[i]) > std::abs(root)) {
+      root = roots[i];
+    }
+  }
+
+  for (int i = 0; i < kNumNewtonIterations; i++) {
+    const double f = ((root + b) * root + c) * root + d;
+    const double df = (3.0 * root + 2.0 * b) * root + c;
+    if (df == 0) {
+      break;
+    }
+    root -= f / df;
+  }
+  return root;
+}
+
+// Polishes the depths of the three points with Gauss-Newton so that the
+// distances between the back-projected points match the world distances.
+void RefineDepths(const double a12,
+                  const double a13,
+                  const double a23,
+                  const double b12,
+                  const double b13,
+                  const double b23,
+                  Vector3d* depths) {
+  static const int kNumIterations = 5;
+  static const double kResidualTolerance = 1e-10;
+
+  Vector3d& l = *depths;
+  for (int i = 0; i < kNumIterations; i++) {
+    const Vector3d residual(l[0] * l[0] + l[1] * l[1] + b12 * l[0] * l[1] - a12,
+                            l[0] * l[0] + l[2] * l[2] + b13 * l[0] * l[2] - a13,
+                            l[1] * l[1] + l[2] * l[2] + b23 * l[1] * l[2] - a23);
+    if (residual.cwiseAbs().maxCoeff() < kResidualTolerance) {
+      return;
+    }
+
+    Matrix3d jacobian;
+    jacobian << 2.0 * l[0] + b12 * l[1], 2.0 * l[1] + b12 * l[0], 0.0,
+        2.0 * l[0] + b13 * l[2], 0.0, 2.0 * l[2] + b13 * l[0],
+        0.0, 2.0 * l[1] + b23 * l[2], 2.0 * l[2] + b23 * l[1];
+
+    const Eigen::FullPivLU<Matrix3d> lu(jacobian);
+    if (!lu.isInvertible()) {
+      return;
+    }
+    l -= lu.solve(residual);
+  }
+}
+
+}  // namespace
+
+int PoseFromThreePointsLambdaTwist(
+    const Vector2d feature_point[3],
+    const Vector3d world_point[3],
+    Matrix3d solution_rotations[kMaxNumLambdaTwistSolutions],
+    Vector3d solution_translations[kMaxNumLambdaTwistSolutions]) {
+  const Vector3d y1 = feature_point[0].homogeneous().normalized();
+  const Vector3d y2 = feature_point[1].homogeneous().normalized();
+  const Vector3d y3 = feature_point[2].homogeneous().normalized();
+
+  const double b12 = -2.0 * y1.dot(y2);
+  const double b13 = -2.0 * y1.dot(y3);
+  const double b23 = -2.0 * y2.dot(y3);
+
+  const Vector3d d12 = world_point[0] - world_point[1];
+  const Vector3d d13 = world_point[0] - world_point[2];
+  const Vector3d d23 = world_point[1] - world_point[2];
+  const Vector3d d12_cross_d13 = d12.cross(d13);
+
+  const double a12 = d12.squaredNorm();
+  const double a13 = d13.squaredNorm();
+  const double a23 = d23.squaredNorm();
+
+  // Compute the cubic whose roots make the conic pencil degenerate.
+  const double c31 = -0.5 * b13;
+  const double c23 = -0.5 * b23;
+  const double c12 = -0.5 * b12;
+  const double blob = c12 * c23 * c31 - 1.0;
+
+  const double s31_squared = 1.0 - c31 * c31;
+  const double s23_squared = 1.0 - c23 * c23;
+  const double s12_squared = 1.0 - c12 * c12;
+
+  const double p3 = a13 * (a23 * s31_squared - a13 * s23_squared);
+  const double p2 = 2.0 * blob * a23 * a13 +
+                    a13 * (2.0 * a12 + a13) * s23_squared +
+                    a23 * (a23 - a12) * s31_squared;
+  const double p1 = a23 * (a13 - a23) * s12_squared -
+                    a12 * a12 * s23_squared -
+                    2.0 * a12 * (blob * a23 + a13 * s23_squared);
+  const double p0 = a12 * (a12 * s23_squared - a23 * s12_squared);
+  if (p3 == 0) {
+    return 0;
+  }
+
+  const double g = SolveCubicForSingleRoot(p2 / p3, p1 / p3, p0 / p3);
+
+  // The degenerate conic. One of its eigenvalues is zero.
+  Matrix3d degenerate_conic;
+  degenerate_conic(0, 0) = a23 * (1.0 - g);
+  degenerate_conic(0, 1) = 0.5 * a23 * b12;
+  degenerate_conic(0, 2) = -0.5 * a23 * b13 * g;
+  degenerate_conic(1, 1) = a23 - a12 + a13 * g;
+  degenerate_conic(1, 2) = 0.5 * b23 * (a13 * g - a12);
+  degenerate_conic(2, 2) = g * (a13 - a23) - a12;
+  degenerate_conic(1, 0) = degenerate_conic(0, 1);
+  degenerate_conic(2, 0) = degenerate_conic(0, 2);
+  degenerate_conic(2, 1) = degenerate_conic(1, 2);
+
+  // Sort the eigenvalues by decreasing magnitude so that the (near) zero
+  // eigenvalue is last.
+  Eigen::SelfAdjointEigenSolver<Matrix3d> eigen_solver;
+  eigen_solver.computeDirect(degenerate_conic);
+  const Vector3d& eigenvalues = eigen_solver.eigenvalues();
+  int order[3] = {0, 1, 2};
+  std::sort(order, order + 3, [&eigenvalues](const int i, const int j) {
+    return std::abs(eigenvalues[i]) > std::abs(eigenvalues[j]);
+  });
+  const Vector3d u0 = eigen_solver.eigenvectors().col(order[0]);
+  const Vector3d u1 = eigen_solver.eigenvectors().col(order[1]);
+  const double lambda0 = eigenvalues[order[0]];
+  const double lambda1 = eigenvalues[order[1]];
+  if (lambda0 == 0) {
+    return 0;
+  }
+  const double v = std::sqrt(std::max(0.0, -lambda1 / lambda0));
+
+  // Each sign of v gives a line through the conic intersection, which we
+  // intersect with the remaining constraint to recover the depths.
+  Vector3d depths[kMaxNumLambdaTwistSolutions];
+  int num_depths = 0;
+  for (const double s : {v, -v}) {
+    const double w2_denominator = s * u1[0] - u0[0];
+    if (w2_denominator == 0) {
+      continue;
+    }
+    const double w2 = 1.0 / w2_denominator;
+    const double w0 = (u0[1] - s * u1[1]) * w2;
+    const double w1 = (u0[2] - s * u1[2]) * w2;
+
+    const double a_denominator =
+        (a13 - a12) * w1 * w1 - a12 * b13 * w1 - a12;
+    if (a_denominator == 0) {
+      continue;
+    }
+    const double a = 1.0 / a_denominator;
+    const double b =
+        (a13 * b12 * w1 - a12 * b13 * w0 - 2.0 * w0 * w1 * (a12 - a13)) * a;
+    const double c = ((a13 - a12) * w0 * w0 + a13 * b12 * w0 + a13) * a;
+
+    double taus[2];
+    if (!SolveMonicQuadratic(b, c, &taus[0], &taus[1])) {
+      continue;
+    }
+
+    for (const double tau : taus) {
+      if (tau <= 0) {
+        continue;
+      }
+      const double d = a23 / (tau * (b23 + tau) + 1.0);
+      if (d <= 0) {
+        continue;
+      }
+      const double l2 = std::sqrt(d);
+      const double l3 = tau * l2;
+      const double l1 = w0 * l2 + w1 * l3;
+      if (l1 >= 0 && num_depths < kMaxNumLambdaTwistSolutions) {
+        depths[num_depths++] = Vector3d(l1, l2, l3);
+      }
+    }
+  }
+
+  // Recover the pose from the depths by aligning the triangle of world points
+  // to the triangle of back-projected points.
+  Matrix3d world_basis;
+  world_basis << d12, d13, d12_cross_d13;
+  const Eigen::FullPivLU<Matrix3d> world_basis_lu(world_basis);
+  if (!world_basis_lu.isInvertible()) {
+    return 0;
+  }
+  const Matrix3d world_basis_inverse = world_basis_lu.inverse();
+
+  int num_solutions = 0;
+  for (int i = 0; i < num_depths; i++) {
+    RefineDepths(a12, a13, a23, b12, b13, b23, &depths[i]);
+
+    const Vector3d ry1 = depths[i][0] * y1;
+    const Vector3d ry2 = depths[i][1] * y2;
+    const Vector3d ry3 = depths[i][2] * y3;
+    const Vector3d yd1 = ry1 - ry2;
+    const Vector3d yd2 = ry1 - ry3;
+
+    Matrix3d camera_basis;
+    camera_basis << yd1, yd2, yd1.cross(yd2);
+
+    solution_rotations[num_solutions] = camera_basis * world_basis_inverse;
+    solution_translations[num_solutions] =
+        ry1 - solution_rotations[num_solutions] * world_point[0];
+    ++num_solutions;
+  }
+
+  return num_solutions;
+}
+
+}  // namespace theia
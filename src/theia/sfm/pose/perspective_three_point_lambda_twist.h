@@ -0,0 +1,71 @@
+// Copyright (C) 2026 The Regents of the University of California (Regents).
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials provided
+//       with the distribution.
+//
+//     * Neither the name of The Regents or University of California nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+// Please contact the author of this library if you have any questions.
+// Author: agent (agent@local)
+
+#ifndef THEIA_SFM_POSE_PERSPECTIVE_THREE_POINT_LAMBDA_TWIST_H_
+#define THEIA_SFM_POSE_PERSPECTIVE_THREE_POINT_LAMBDA_TWIST_H_
+
+#include <Eigen/Core>
+
+namespace theia {
+
+// The maximum number of poses that are returned by the P3P solver.
+static const int kMaxNumLambdaTwistSolutions = 4;
+
+// Computes camera pose using the "Lambda Twist" P3P algorithm from "Lambda
+// Twist: An Accurate Fast Robust Perspective Three Point (P3P) Solver" by
+// Persson and Nordberg (ECCV 2018). Instead of solving a quartic, the method
+// finds a single root of a cubic to diagonalize a degenerate conic and then
+// recovers the depths of the three points directly. The depths are polished
+// with a few Gauss-Newton iterations. The solver does not allocate: all
+// solutions are written to the fixed-size output arrays.
+//
+// Params:
+//   feature_point: Feature points corresponding to model points. NOTE: these
+//     points should be calibrated with the camera intrinsics as opposed to raw
+//     pixel coordinates.
+//   world_point: 3D location of features. Must correspond to the feature_point
+//     of the same index.
+//   solution_rotations: the rotation matrix of the candidate solutions.
+//   solution_translations: the translation of the candidate solutions such
+//     that a world point X projects to R * X + t.
+// Return: the number of poses computed (at most kMaxNumLambdaTwistSolutions).
+int PoseFromThreePointsLambdaTwist(
+    const Eigen::Vector2d feature_point[3],
+    const Eigen::Vector3d world_point[3],
+    Eigen::Matrix3d solution_rotations[kMaxNumLambdaTwistSolutions],
+    Eigen::Vector3d solution_translations[kMaxNumLambdaTwistSolutions]);
+
+}  // namespace theia
+
+#endif  // THEIA_SFM_POSE_PERSPECTIVE_THREE_POINT_LAMBDA_TWIST_H_
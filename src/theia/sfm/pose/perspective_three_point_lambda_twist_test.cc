@@ -0,0 +1,196 @@
+// Copyright (C) 2026 The Regents of the University of California (Regents).
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials provided
+//       with the distribution.
+//
+//     * Neither the name of The Regents or University of California nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+// Please contact the author of this library if you have any questions.
+// Author: agent (agent@local)
+
+#include <Eigen/Core>
+#include <Eigen/Geometry>
+#include "gtest/gtest.h"
+
+#include "theia/math/util.h"
+#include "theia/sfm/pose/perspective_three_point.h"
+#include "theia/sfm/pose/perspective_three_point_lambda_twist.h"
+#include "theia/sfm/pose/test_util.h"
+#include "theia/sfm/pose/util.h"
+#include "theia/util/random.h"
+
+namespace theia {
+
+using Eigen::Matrix3d;
+using Eigen::Vector2d;
+using Eigen::Vector3d;
+
+namespace {
+
+RandomNumberGenerator rng(57);
+
+// Returns true if any of the solutions matches the ground truth pose.
+bool ContainsPose(const Matrix3d& gt_rotation,
+                  const Vector3d& gt_translation,
+                  const int num_solutions,
+                  const Matrix3d* rotations,
+                  const Vector3d* translations,
+                  const double max_angular_error_degrees,
+                  const double max_position_error) {
+  for (int i = 0; i < num_solutions; i++) {
+    const double angular_error =
+        RadToDeg(Eigen::Quaterniond(rotations[i])
+                     .angularDistance(Eigen::Quaterniond(gt_rotation)));
+    const double position_error =
+        ((-gt_rotation.transpose() * gt_translation) -
+         (-rotations[i].transpose() * translations[i])).norm();
+    if (angular_error < max_angular_error_degrees &&
+        position_error < max_position_error) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// Creates a random pose and three points that are visible to the camera.
+void CreateRandomProblem(const double noise,
+                         Matrix3d* gt_rotation,
+                         Vector3d* gt_translation,
+                         Vector3d world_points[3],
+                         Vector2d features[3]) {
+  *gt_rotation = RandomRotation(30.0, &rng);
+  *gt_translation = rng.RandVector3d();
+  for (int i = 0; i < 3; i++) {
+    // Create the point in the camera frame so that it is visible.
+    const Vector3d camera_point(rng.RandDouble(-1.0, 1.0),
+                                rng.RandDouble(-1.0, 1.0),
+                                rng.RandDouble(4.0, 8.0));
+    world_points[i] =
+        gt_rotation->transpose() * (camera_point - *gt_translation);
+    features[i] = camera_point.hnormalized();
+    if (noise) {
+      AddNoiseToProjection(noise, &rng, &features[i]);
+    }
+  }
+}
+
+}  // namespace
+
+TEST(LambdaTwist, NoNoise) {
+  static const int kNumTrials = 100;
+  for (int trial = 0; trial < kNumTrials; trial++) {
+    Matrix3d gt_rotation;
+    Vector3d gt_translation, world_points[3];
+    Vector2d features[3];
+    CreateRandomProblem(0.0, &gt_rotation, &gt_translation, world_points,
+                        features);
+
+    Matrix3d rotations[kMaxNumLambdaTwistSolutions];
+    Vector3d translations[kMaxNumLambdaTwistSolutions];
+    const int num_solutions = PoseFromThreePointsLambdaTwist(
+        features, world_points, rotations, translations);
+    EXPECT_GT(num_solutions, 0);
+    EXPECT_LE(num_solutions, kMaxNumLambdaTwistSolutions);
+    EXPECT_TRUE(ContainsPose(gt_rotation,
+                             gt_translation,
+                             num_solutions,
+                             rotations,
+                             translations,
+                             1e-4,
+                             1e-4));
+  }
+}
+
+// With noisy observations, P3P is still an exact fit to the three features so
+// every solution must reproject the features exactly and be a valid rotation.
+TEST(LambdaTwist, Noise) {
+  static const int kNumTrials = 100;
+  static const double kNoise = 1.0 / 800.0;
+  static const double kTolerance = 1e-8;
+  for (int trial = 0; trial < kNumTrials; trial++) {
+    Matrix3d gt_rotation;
+    Vector3d gt_translation, world_points[3];
+    Vector2d features[3];
+    CreateRandomProblem(kNoise, &gt_rotation, &gt_translation, world_points,
+                        features);
+
+    Matrix3d rotations[kMaxNumLambdaTwistSolutions];
+    Vector3d translations[kMaxNumLambdaTwistSolutions];
+    const int num_solutions = PoseFromThreePointsLambdaTwist(
+        features, world_points, rotations, translations);
+    EXPECT_GT(num_solutions, 0);
+    for (int i = 0; i < num_solutions; i++) {
+      EXPECT_LT((rotations[i] * rotations[i].transpose() -
+                 Matrix3d::Identity()).norm(),
+                kTolerance);
+      for (int j = 0; j < 3; j++) {
+        const Vector2d reprojection =
+            (rotations[i] * world_points[j] + translations[i]).hnormalized();
+        EXPECT_LT((reprojection - features[j]).norm(), kTolerance);
+      }
+    }
+  }
+}
+
+// The solutions should agree with the existing P3P solver.
+TEST(LambdaTwist, ConsistentWithKneip) {
+  const Matrix3d gt_rotation =
+      (Eigen::AngleAxisd(DegToRad(15.0), Vector3d(1.0, 0.0, 0.0)) *
+       Eigen::AngleAxisd(DegToRad(-10.0), Vector3d(0.0, 1.0, 0.0)))
+          .toRotationMatrix();
+  const Vector3d gt_translation(0.3, -1.7, 1.15);
+  const Vector3d world_points[3] = {Vector3d(-0.3001, -0.5840, 1.2271),
+                                    Vector3d(-1.4487, 0.6965, 0.3889),
+                                    Vector3d(-0.7815, 0.7642, 0.1257)};
+  Vector2d features[3];
+  for (int i = 0; i < 3; i++) {
+    features[i] = (gt_rotation * world_points[i] + gt_translation).hnormalized();
+  }
+
+  std::vector<Matrix3d> kneip_rotations;
+  std::vector<Vector3d> kneip_translations;
+  EXPECT_TRUE(PoseFromThreePoints(
+      features, world_points, &kneip_rotations, &kneip_translations));
+
+  Matrix3d rotations[kMaxNumLambdaTwistSolutions];
+  Vector3d translations[kMaxNumLambdaTwistSolutions];
+  const int num_solutions = PoseFromThreePointsLambdaTwist(
+      features, world_points, rotations, translations);
+
+  // Every Lambda Twist solution must also be a Kneip solution.
+  for (int i = 0; i < num_solutions; i++) {
+    EXPECT_TRUE(ContainsPose(rotations[i],
+                             translations[i],
+                             kneip_rotations.size(),
+                             kneip_rotations.data(),
+                             kneip_translations.data(),
+                             1e-4,
+                             1e-4));
+  }
+}
+
+}  // namespace theia
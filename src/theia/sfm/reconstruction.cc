@@ -39,6 +39,8 @@
 #include <glog/logging.h>
 
 #include <algorithm>
+#include <functional>
+#include <memory>
 #include <string>
 #include <unordered_map>
 #include <utility>
@@ -51,6 +53,7 @@
 #include "theia/sfm/types.h"
 #include "theia/sfm/view.h"
 #include "theia/util/map_util.h"
+#include "theia/util/threadpool.h"
 #include "theia/util/util.h"
 
 namespace theia {
@@ -77,6 +80,20 @@ double Median(std::vector<double>* data) {
   return *mid_point;
 }
 
+// Computes the median of each of the three coordinates. The selection for
+// each coordinate is independent, so they are run in parallel.
+Eigen::Vector3d MarginalMedian(const int num_threads,
+                               std::vector<std::vector<double> >* coordinates) {
+  Eigen::Vector3d median;
+  ParallelForBlocks(std::min(num_threads, 3), 3,
+                    [&](const int start, const int end) {
+                      for (int i = start; i < end; i++) {
+                        median(i) = Median(&(*coordinates)[i]);
+                      }
+                    });
+  return median;
+}
+
 }  // namespace
 
 Reconstruction::Reconstruction()
@@ -280,6 +297,23 @@ bool Reconstruction::AddObservation(const ViewId view_id,
   return true;
 }
 
+bool Reconstruction::RemoveObservation(const ViewId view_id,
+                                       const TrackId track_id) {
+  class View* view = FindOrNull(views_, view_id);
+  class Track* track = FindOrNull(tracks_, track_id);
+  if (view == nullptr || track == nullptr) {
+    LOG(WARNING) << "Cannot remove the observation of track " << track_id
+                 << " in view " << view_id
+                 << " because the view or track does not exist.";
+    return false;
+  }
+
+  if (!view->RemoveFeature(track_id)) {
+    return false;
+  }
+  return track->RemoveView(view_id);
+}
+
 TrackId Reconstruction::AddTrack(
     const std::vector<std::pair<ViewId, Feature> >& track) {
   if (track.size() < 2) {
@@ -319,6 +353,100 @@ TrackId Reconstruction::AddTrack(
   return new_track_id;
 }
 
+std::vector<TrackId> Reconstruction::AddTracks(
+    const std::vector<std::vector<std::pair<ViewId, Feature> > >& tracks,
+    const int num_threads) {
+  // Validate all tracks. This only reads from the reconstruction so it may be
+  // done in parallel.
+  std::vector<char> is_valid_track(tracks.size());
+  ParallelForBlocks(
+      num_threads, tracks.size(), [&](const int start, const int end) {
+        for (int i = start; i < end; i++) {
+          is_valid_track[i] =
+              tracks[i].size() >= 2 && !DuplicateViewsExistInTrack(tracks[i]);
+          for (const auto& observation : tracks[i]) {
+            CHECK(ContainsKey(views_, observation.first))
+                << "Cannot add a track containing an observation in view id "
+                << observation.first << " because the view does not exist.";
+          }
+        }
+      });
+
+  // Assign the track ids in order and create the (empty) tracks. Pointers to
+  // elements of an unordered_map remain valid after insertion so the tracks
+  // may be filled in afterwards.
+  std::vector<TrackId> track_ids(tracks.size(), kInvalidTrackId);
+  std::vector<class Track*> new_tracks(tracks.size(), nullptr);
+  int num_invalid_tracks = 0;
+  tracks_.reserve(tracks_.size() + tracks.size());
+  for (int i = 0; i < tracks.size(); i++) {
+    if (!is_valid_track[i]) {
+      ++num_invalid_tracks;
+      continue;
+    }
+
+    const TrackId new_track_id = next_track_id_;
+    CHECK(!ContainsKey(tracks_, new_track_id))
+        << "The reconstruction already contains a track with id: "
+        << new_track_id;
+    track_ids[i] = new_track_id;
+    new_tracks[i] = &tracks_[new_track_id];
+    ++next_track_id_;
+  }
+  if (num_invalid_tracks > 0) {
+    LOG(WARNING) << num_invalid_tracks
+                 << " tracks had fewer than 2 observations or contained the "
+                    "same view twice and could not be added to the "
+                    "reconstruction.";
+  }
+
+  // Add the views to each track. Each track is only modified by one thread.
+  ParallelForBlocks(
+      num_threads, tracks.size(), [&](const int start, const int end) {
+        for (int i = start; i < end; i++) {
+          if (new_tracks[i] == nullptr) {
+            continue;
+          }
+          for (const auto& observation : tracks[i]) {
+            new_tracks[i]->AddView(observation.first);
+          }
+        }
+      });
+
+  // Group the observations by view so that the features may be added to each
+  // view independently.
+  std::vector<ViewId> view_ids;
+  std::unordered_map<ViewId, int> view_index;
+  std::vector<std::vector<std::pair<TrackId, const Feature*> > >
+      features_per_view;
+  for (int i = 0; i < tracks.size(); i++) {
+    if (track_ids[i] == kInvalidTrackId) {
+      continue;
+    }
+    for (const auto& observation : tracks[i]) {
+      const auto& index =
+          view_index.emplace(observation.first, view_ids.size()).first->second;
+      if (index == view_ids.size()) {
+        view_ids.emplace_back(observation.first);
+        features_per_view.emplace_back();
+      }
+      features_per_view[index].emplace_back(track_ids[i], &observation.second);
+    }
+  }
+
+  ParallelForBlocks(
+      num_threads, view_ids.size(), [&](const int start, const int end) {
+        for (int i = start; i < end; i++) {
+          class View* view = FindOrNull(views_, view_ids[i]);
+          for (const auto& feature : features_per_view[i]) {
+            view->AddFeature(feature.first, *feature.second);
+          }
+        }
+      });
+
+  return track_ids;
+}
+
 bool Reconstruction::RemoveTrack(const TrackId track_id) {
   class Track* track = FindOrNull(tracks_, track_id);
   if (track == nullptr) {
@@ -367,71 +495,88 @@ std::vector<TrackId> Reconstruction::TrackIds() const {
 }
 
 void Reconstruction::Normalize() {
+  Normalize(1);
+}
+
+void Reconstruction::Normalize(const int num_threads) {
+  CHECK_GE(num_threads, 1);
+
+  // Gather the estimated views and tracks once. All of the passes below only
+  // operate on these.
+  std::vector<ViewId> view_ids;
+  view_ids.reserve(views_.size());
+  for (const auto& view : views_) {
+    if (view.second.IsEstimated()) {
+      view_ids.emplace_back(view.first);
+    }
+  }
+  std::vector<TrackId> track_ids;
+  track_ids.reserve(tracks_.size());
+  for (const auto& track : tracks_) {
+    if (track.second.IsEstimated()) {
+      track_ids.emplace_back(track.first);
+    }
+  }
+
   // First normalize the position so that the marginal median of the camera
   // positions is at the origin.
   std::vector<std::vector<double> > camera_positions(3);
-  Eigen::Vector3d median_camera_position;
-  const auto& view_ids = ViewIds();
+  for (int i = 0; i < 3; i++) {
+    camera_positions[i].reserve(view_ids.size());
+  }
   for (const ViewId view_id : view_ids) {
-    const class View* view = View(view_id);
-    if (view == nullptr || !view->IsEstimated()) {
-      continue;
-    }
-
-    const Eigen::Vector3d point = view->Camera().GetPosition();
+    const Eigen::Vector3d point = View(view_id)->Camera().GetPosition();
     camera_positions[0].push_back(point[0]);
     camera_positions[1].push_back(point[1]);
     camera_positions[2].push_back(point[2]);
   }
-  median_camera_position(0) = Median(&camera_positions[0]);
-  median_camera_position(1) = Median(&camera_positions[1]);
-  median_camera_position(2) = Median(&camera_positions[2]);
-  TransformReconstruction(
-      Eigen::Matrix3d::Identity(), -median_camera_position, 1.0, this);
-
-  // Get the estimated track ids.
-  const auto& temp_track_ids = TrackIds();
-  std::vector<TrackId> track_ids;
-  track_ids.reserve(temp_track_ids.size());
-  for (const TrackId track_id : temp_track_ids) {
-    const class Track* track = Track(track_id);
-    if (track == nullptr || !track->IsEstimated()) {
-      continue;
-    }
-    track_ids.emplace_back(track_id);
-  }
+  const Eigen::Vector3d median_camera_position =
+      MarginalMedian(num_threads, &camera_positions);
 
   if (track_ids.size() == 0) {
+    TransformReconstruction(Eigen::Matrix3d::Identity(),
+                            -median_camera_position,
+                            1.0,
+                            view_ids,
+                            track_ids,
+                            num_threads,
+                            this);
     return;
   }
 
-  // Compute the marginal median of the 3D points.
+  // Compute the marginal median of the 3D points. Translating the
+  // reconstruction does not change the median absolute deviation or the
+  // camera orientations, so all statistics below are computed on the original
+  // coordinates and a single combined transformation is applied at the end.
   std::vector<std::vector<double> > points(3);
-  Eigen::Vector3d median;
-  for (const TrackId track_id : track_ids) {
-    const class Track* track = Track(track_id);
-    const Eigen::Vector3d point = track->Point().hnormalized();
-    points[0].push_back(point[0]);
-    points[1].push_back(point[1]);
-    points[2].push_back(point[2]);
+  for (int i = 0; i < 3; i++) {
+    points[i].resize(track_ids.size());
   }
-  median(0) = Median(&points[0]);
-  median(1) = Median(&points[1]);
-  median(2) = Median(&points[2]);
+  ParallelForBlocks(
+      num_threads, track_ids.size(), [&](const int start, const int end) {
+        for (int i = start; i < end; i++) {
+          const Eigen::Vector3d point =
+              Track(track_ids[i])->Point().hnormalized();
+          points[0][i] = point[0];
+          points[1][i] = point[1];
+          points[2][i] = point[2];
+        }
+      });
+  const Eigen::Vector3d median = MarginalMedian(num_threads, &points);
 
   // Find the median absolute deviation of the points from the median.
-  std::vector<double> distance_to_median;
-  distance_to_median.reserve(track_ids.size());
-  for (const TrackId track_id : track_ids) {
-    const class Track* track = Track(track_id);
-    const Eigen::Vector3d point = track->Point().hnormalized();
-    distance_to_median.emplace_back((point - median).lpNorm<1>());
-  }
+  std::vector<double> distance_to_median(track_ids.size());
+  ParallelForBlocks(
+      num_threads, track_ids.size(), [&](const int start, const int end) {
+        for (int i = start; i < end; i++) {
+          const Eigen::Vector3d point =
+              Track(track_ids[i])->Point().hnormalized();
+          distance_to_median[i] = (point - median).lpNorm<1>();
+        }
+      });
   // This will scale the reconstruction so that the median absolute deviation of
   // the points is 100.
   const double scale = 100.0 / Median(&distance_to_median);
-  TransformReconstruction(
-      Eigen::Matrix3d::Identity(), Eigen::Vector3d::Zero(), scale, this);
 
   // Most images are taken relatively upright with the x-direction of the image
   // parallel to the ground plane. We can solve for the transformation that
@@ -440,10 +585,6 @@ void Reconstruction::Normalize() {
   Eigen::Matrix3d correlation;
   correlation.setZero();
   for (const ViewId view_id : view_ids) {
-    const class View* view = View(view_id);
-    if (view == nullptr || !view->IsEstimated()) {
-      continue;
-    }
     const Camera& camera = View(view_id)->Camera();
     const Eigen::Vector3d x =
         camera.GetOrientationAsRotationMatrix().transpose() *
@@ -461,7 +602,16 @@ void Reconstruction::Normalize() {
   Eigen::Matrix3d rotation =
       Eigen::Quaterniond::FromTwoVectors(plane_normal, Eigen::Vector3d(0, 1, 0))
           .toRotationMatrix();
-  TransformReconstruction(rotation, Eigen::Vector3d::Zero(), 1.0, this);
+
+  // Apply the translation, scale, and rotation as a single transformation:
+  //   X' = scale * rotation * (X - median_camera_position).
+  TransformReconstruction(rotation,
+                          -scale * rotation * median_camera_position,
+                          scale,
+                          view_ids,
+                          track_ids,
+                          num_threads,
+                          this);
 }
 
 void Reconstruction::GetSubReconstruction(
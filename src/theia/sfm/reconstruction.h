@@ -118,11 +118,25 @@ class Reconstruction {
                       const TrackId track_id,
                       const Feature& feature);
 
+  // Removes the observation of the track in the view. Returns true if the
+  // observation existed and was removed, and false otherwise. The track itself
+  // is not removed even if it has no observations left.
+  bool RemoveObservation(const ViewId view_id, const TrackId track_id);
+
   // Add a new track to the reconstruction. If successful, the new track id is
   // returned. Failure results when multiple features from the same image are
   // present, and kInvalidTrackId is returned.
   TrackId AddTrack(const std::vector<std::pair<ViewId, Feature> >& track);
 
+  // Adds many tracks at once. This is equivalent to calling AddTrack on each
+  // track in order (tracks receive the same ids), but the observations are
+  // added to the tracks and views with num_threads threads. The returned vector
+  // contains the track id of each input track, or kInvalidTrackId if the track
+  // could not be added.
+  std::vector<TrackId> AddTracks(
+      const std::vector<std::vector<std::pair<ViewId, Feature> > >& tracks,
+      const int num_threads);
+
   // Removes the track from the reconstruction including the corresponding
   // features that are present in the view that observe it.
   bool RemoveTrack(const TrackId track_id);
@@ -145,6 +159,12 @@ class Reconstruction {
   // Ceres Solver.
   void Normalize();
 
+  // Same as above, but the median computations and the transformation of the
+  // cameras and points are run with num_threads threads. The estimated views
+  // and tracks are only gathered once and the normalization is applied to them
+  // in a single pass.
+  void Normalize(const int num_threads);
+
   // Obtain a sub-reconstruction which only contains the specified views and
   // corresponding tracks observed by those views. All views and tracks maintain
   // the same IDs as the original reconstruction.
@@ -35,10 +35,13 @@
 #include "theia/sfm/reconstruction_builder.h"
 
 #include <glog/logging.h>
+#include <stdint.h>
+#include <algorithm>
 #include <memory>
 #include <string>
 #include <vector>
 
+#include "theia/io/track_and_view_graph_files.h"
 #include "theia/matching/features_and_matches_database.h"
 #include "theia/matching/image_pair_match.h"
 #include "theia/matching/rocksdb_features_and_matches_database.h"
@@ -47,10 +50,12 @@
 #include "theia/sfm/reconstruction.h"
 #include "theia/sfm/reconstruction_estimator.h"
 #include "theia/sfm/track_builder.h"
+#include "theia/sfm/twoview_info.h"
 #include "theia/sfm/types.h"
 #include "theia/sfm/view.h"
 #include "theia/sfm/view_graph/view_graph.h"
 #include "theia/util/filesystem.h"
+#include "theia/util/threadpool.h"
 
 namespace theia {
 
@@ -146,6 +151,49 @@ void RemoveEstimatedViewsAndTracks(Reconstruction* reconstruction,
   }
 }
 
+// The 64-bit FNV-1a hash. Unlike std::hash, its value is the same on all
+// platforms so it may be stored in files.
+static const uint64_t kFnvOffsetBasis = 14695981039346656037ULL;
+
+uint64_t HashBytes(const void* data, const size_t num_bytes, uint64_t hash) {
+  static const uint64_t kFnvPrime = 1099511628211ULL;
+  const unsigned char* bytes = static_cast<const unsigned char*>(data);
+  for (size_t i = 0; i < num_bytes; i++) {
+    hash = (hash ^ bytes[i]) * kFnvPrime;
+  }
+  return hash;
+}
+
+template <typename T>
+uint64_t HashValue(const T& value, const uint64_t hash) {
+  return HashBytes(&value, sizeof(value), hash);
+}
+
+uint64_t HashString(const std::string& value, uint64_t hash) {
+  hash = HashValue(value.size(), hash);
+  return HashBytes(value.data(), value.size(), hash);
+}
+
+// Returns a hash that identifies the match. Only the image names and the two
+// view info are hashed so that the correspondences never have to be loaded.
+// Matches that were estimated again yield a different two view info, which
+// includes the number of verified matches.
+uint64_t HashImagePairMatch(const std::string& image1,
+                            const std::string& image2,
+                            const TwoViewInfo& info) {
+  uint64_t hash = kFnvOffsetBasis;
+  hash = HashString(image1, hash);
+  hash = HashString(image2, hash);
+
+  hash = HashValue(info.focal_length_1, hash);
+  hash = HashValue(info.focal_length_2, hash);
+  hash = HashBytes(info.position_2.data(), 3 * sizeof(double), hash);
+  hash = HashBytes(info.rotation_2.data(), 3 * sizeof(double), hash);
+  hash = HashValue(info.num_verified_matches, hash);
+  hash = HashValue(info.num_homography_inliers, hash);
+  return HashValue(info.visibility_score, hash);
+}
+
 }  // namespace
 
 ReconstructionBuilder::ReconstructionBuilder(
@@ -262,9 +310,9 @@ bool ReconstructionBuilder::AddMaskForFeaturesExtraction(
 }
 
 bool ReconstructionBuilder::ExtractAndMatchFeatures() {
-  CHECK_EQ(view_graph_->NumViews(), 0) << "Cannot call ExtractAndMatchFeatures "
-                                          "after TwoViewMatches has been "
-                                          "called.";
+  CHECK(view_graph_->NumViews() == 0 && pending_view_pairs_.empty())
+      << "Cannot call ExtractAndMatchFeatures after TwoViewMatches has been "
+         "called.";
 
   // TODO: Remove all references to matches variable and replace with db
   // functions.
@@ -301,14 +349,42 @@ bool ReconstructionBuilder::ExtractAndMatchFeatures() {
   //
   ///////////////////////////////////
 
-  // Add the matches to the view graph and reconstruction.
+  // Read the two view info of each match in parallel. The correspondences stay
+  // in the database until the tracks are built, which is skipped altogether if
+  // the tracks and view graph can be loaded instead.
   const auto& match_keys =
       features_and_matches_database_->ImageNamesOfMatches();
-  for (const auto& match_key : match_keys) {
-    const ImagePairMatch& match =
-        features_and_matches_database_->GetImagePairMatch(match_key.first,
-                                                          match_key.second);
-    AddTwoViewMatch(match_key.first, match_key.second, match);
+  std::vector<PendingViewPair> pending_view_pairs(match_keys.size());
+  std::vector<uint64_t> match_content_hashes(match_keys.size());
+  ParallelForBlocks(
+      options_.num_threads,
+      match_keys.size(),
+      [&](const int start, const int end) {
+        for (int i = start; i < end; i++) {
+          PendingViewPair& view_pair = pending_view_pairs[i];
+          if (!GetViewIdsOfMatch(match_keys[i].first,
+                                 match_keys[i].second,
+                                 &view_pair.view_id1,
+                                 &view_pair.view_id2)) {
+            view_pair.view_id1 = kInvalidViewId;
+            continue;
+          }
+
+          view_pair.twoview_info =
+              features_and_matches_database_->GetTwoViewInfo(
+                  match_keys[i].first, match_keys[i].second);
+          view_pair.in_database = true;
+          match_content_hashes[i] = HashImagePairMatch(match_keys[i].first,
+                                                       match_keys[i].second,
+                                                       view_pair.twoview_info);
+        }
+      });
+
+  for (int i = 0; i < match_keys.size(); i++) {
+    if (pending_view_pairs[i].view_id1 != kInvalidViewId) {
+      pending_view_pairs_.emplace_back(pending_view_pairs[i]);
+      match_content_hashes_.emplace_back(match_content_hashes[i]);
+    }
   }
 
   return true;
@@ -317,47 +393,53 @@ bool ReconstructionBuilder::ExtractAndMatchFeatures() {
 bool ReconstructionBuilder::AddTwoViewMatch(const std::string& image1,
                                             const std::string& image2,
                                             const ImagePairMatch& matches) {
-  // Get view ids from names and check that the views are valid (i.e. that
-  // they have been added to the reconstruction).
-  const ViewId view_id1 = reconstruction_->ViewIdFromName(image1);
-  const ViewId view_id2 = reconstruction_->ViewIdFromName(image2);
-  CHECK_NE(view_id1, kInvalidViewId)
-      << "Tried to add a view with the name " << image1
-      << " to the view graph but does not exist in the reconstruction.";
-  CHECK_NE(view_id2, kInvalidViewId)
-      << "Tried to add a view with the name " << image2
-      << " to the view graph but does not exist in the reconstruction.";
-
-  // If we only want calibrated views, do not add the match if it contains an
-  // uncalibrated view since it will add uncalibrated views to the tracks.
-  const View* view1 = reconstruction_->View(view_id1);
-  const View* view2 = reconstruction_->View(view_id2);
-  if (options_.only_calibrated_views &&
-      (!view1->CameraIntrinsicsPrior().focal_length.is_set ||
-       !view2->CameraIntrinsicsPrior().focal_length.is_set)) {
+  ViewId view_id1, view_id2;
+  if (!GetViewIdsOfMatch(image1, image2, &view_id1, &view_id2)) {
     return true;
   }
 
-  // Add valid matches to view graph.
-  AddMatchToViewGraph(view_id1, view_id2, matches);
-
-  // Add tracks to the track builder.
-  AddTracksForMatch(view_id1, view_id2, matches);
+  // The correspondences are added to the track builder right away so that the
+  // matches do not have to be kept. The view pair is added to the view graph
+  // when the reconstruction is built.
+  if (track_builder_ != nullptr) {
+    AddTracksForMatch(view_id1, view_id2, matches);
+  }
+  pending_view_pairs_.emplace_back(
+      PendingViewPair{view_id1, view_id2, matches.twoview_info, false});
+  match_content_hashes_.emplace_back(
+      HashImagePairMatch(image1, image2, matches.twoview_info));
 
   return true;
 }
 
 bool ReconstructionBuilder::BuildReconstruction(
     std::vector<Reconstruction*>* reconstructions) {
+  // Build tracks if they were not explicitly specified. If the tracks and view
+  // graph were already built from the same matches in a previous run they are
+  // loaded instead and the correspondences in the database are never read.
+  if (reconstruction_->NumTracks() == 0) {
+    const bool use_cached_tracks =
+        !options_.tracks_and_view_graph_directory.empty();
+    const uint64_t content_hash =
+        use_cached_tracks ? ComputeTracksAndViewGraphContentHash() : 0;
+    if (use_cached_tracks && ReadTracksAndViewGraph(content_hash)) {
+      std::vector<PendingViewPair>().swap(pending_view_pairs_);
+      track_builder_.reset();
+    } else {
+      AddPendingViewPairs(true);
+      track_builder_->BuildTracks(options_.num_threads, reconstruction_.get());
+      if (use_cached_tracks) {
+        WriteTracksAndViewGraph(content_hash);
+      }
+    }
+  } else {
+    AddPendingViewPairs(false);
+  }
+
   CHECK_GE(view_graph_->NumViews(), 2) << "At least 2 images must be provided "
                                           "in order to create a "
                                           "reconstruction.";
 
-  // Build tracks if they were not explicitly specified.
-  if (reconstruction_->NumTracks() == 0) {
-    track_builder_->BuildTracks(reconstruction_.get());
-  }
-
   // Remove uncalibrated views from the reconstruction and view graph.
   if (options_.only_calibrated_views) {
     LOG(INFO) << "Removing uncalibrated views.";
@@ -414,28 +496,146 @@ bool ReconstructionBuilder::BuildReconstruction(
   return true;
 }
 
+bool ReconstructionBuilder::GetViewIdsOfMatch(const std::string& image1,
+                                              const std::string& image2,
+                                              ViewId* view_id1,
+                                              ViewId* view_id2) const {
+  // Get view ids from names and check that the views are valid (i.e. that
+  // they have been added to the reconstruction).
+  *view_id1 = reconstruction_->ViewIdFromName(image1);
+  *view_id2 = reconstruction_->ViewIdFromName(image2);
+  CHECK_NE(*view_id1, kInvalidViewId)
+      << "Tried to add a view with the name " << image1
+      << " to the view graph but does not exist in the reconstruction.";
+  CHECK_NE(*view_id2, kInvalidViewId)
+      << "Tried to add a view with the name " << image2
+      << " to the view graph but does not exist in the reconstruction.";
+
+  // If we only want calibrated views, do not add the match if it contains an
+  // uncalibrated view since it will add uncalibrated views to the tracks.
+  const View* view1 = reconstruction_->View(*view_id1);
+  const View* view2 = reconstruction_->View(*view_id2);
+  return !options_.only_calibrated_views ||
+         (view1->CameraIntrinsicsPrior().focal_length.is_set &&
+          view2->CameraIntrinsicsPrior().focal_length.is_set);
+}
+
 void ReconstructionBuilder::AddMatchToViewGraph(
     const ViewId view_id1,
     const ViewId view_id2,
-    const ImagePairMatch& image_matches) {
+    const TwoViewInfo& twoview_info) {
   // Add the view pair to the reconstruction. The view graph requires the two
   // view info to specify the transformation from the smaller view id to the
   // larger view id. We swap the cameras here if that is not already the case.
-  TwoViewInfo twoview_info = image_matches.twoview_info;
+  TwoViewInfo ordered_twoview_info = twoview_info;
   if (view_id1 > view_id2) {
-    SwapCameras(&twoview_info);
+    SwapCameras(&ordered_twoview_info);
+  }
+
+  view_graph_->AddEdge(view_id1, view_id2, ordered_twoview_info);
+}
+
+void ReconstructionBuilder::AddPendingViewPairs(const bool add_tracks) {
+  // Adding the correspondences to the track builder is thread-safe, so the
+  // matches are read from the database and added in parallel. Each match is
+  // released as soon as it has been added. The view graph is not thread-safe,
+  // so the edges are added afterwards in the order of the view pairs.
+  if (add_tracks) {
+    ParallelForBlocks(
+        options_.num_threads,
+        pending_view_pairs_.size(),
+        [&](const int start, const int end) {
+          for (int i = start; i < end; i++) {
+            const PendingViewPair& view_pair = pending_view_pairs_[i];
+            if (!view_pair.in_database) {
+              continue;
+            }
+            const ImagePairMatch match =
+                features_and_matches_database_->GetImagePairMatch(
+                    reconstruction_->View(view_pair.view_id1)->Name(),
+                    reconstruction_->View(view_pair.view_id2)->Name());
+            AddTracksForMatch(view_pair.view_id1, view_pair.view_id2, match);
+          }
+        });
+  }
+
+  for (const PendingViewPair& view_pair : pending_view_pairs_) {
+    AddMatchToViewGraph(
+        view_pair.view_id1, view_pair.view_id2, view_pair.twoview_info);
   }
+  std::vector<PendingViewPair>().swap(pending_view_pairs_);
+}
 
-  view_graph_->AddEdge(view_id1, view_id2, twoview_info);
+uint64_t ReconstructionBuilder::ComputeTracksAndViewGraphContentHash() const {
+  std::vector<uint64_t> match_content_hashes = match_content_hashes_;
+  std::sort(match_content_hashes.begin(), match_content_hashes.end());
+
+  uint64_t hash = kFnvOffsetBasis;
+  hash = HashValue(options_.min_track_length, hash);
+  hash = HashValue(options_.max_track_length, hash);
+  hash = HashValue(match_content_hashes.size(), hash);
+  return HashBytes(match_content_hashes.data(),
+                   match_content_hashes.size() * sizeof(uint64_t),
+                   hash);
+}
+
+bool ReconstructionBuilder::ReadTracksAndViewGraph(
+    const uint64_t content_hash) {
+  const std::string tracks_file =
+      options_.tracks_and_view_graph_directory + "/tracks.bin";
+  const std::string view_graph_file =
+      options_.tracks_and_view_graph_directory + "/view_graph.bin";
+
+  uint64_t tracks_content_hash, view_graph_content_hash;
+  if (!ReadTrackOrViewGraphFileContentHash(tracks_file,
+                                           &tracks_content_hash) ||
+      !ReadTrackOrViewGraphFileContentHash(view_graph_file,
+                                           &view_graph_content_hash)) {
+    return false;
+  }
+  if (tracks_content_hash != content_hash ||
+      view_graph_content_hash != content_hash) {
+    LOG(INFO) << "The tracks and view graph in "
+              << options_.tracks_and_view_graph_directory
+              << " were built from different matches and will be rebuilt.";
+    return false;
+  }
+
+  // The view graph is read first since reading it has no side effects if it
+  // fails.
+  std::unique_ptr<ViewGraph> view_graph(new ViewGraph());
+  if (!ReadViewGraphFile(view_graph_file, *reconstruction_, view_graph.get()) ||
+      !ReadTracksFile(tracks_file, options_.num_threads,
+                      reconstruction_.get())) {
+    return false;
+  }
+  view_graph_ = std::move(view_graph);
+
+  LOG(INFO) << "Loaded " << reconstruction_->NumTracks() << " tracks and "
+            << view_graph_->NumEdges() << " view pairs from "
+            << options_.tracks_and_view_graph_directory;
+  return true;
+}
+
+void ReconstructionBuilder::WriteTracksAndViewGraph(
+    const uint64_t content_hash) const {
+  const std::string tracks_file =
+      options_.tracks_and_view_graph_directory + "/tracks.bin";
+  const std::string view_graph_file =
+      options_.tracks_and_view_graph_directory + "/view_graph.bin";
+  if (!WriteTracksFile(*reconstruction_, content_hash, tracks_file) ||
+      !WriteViewGraphFile(
+          *reconstruction_, *view_graph_, content_hash, view_graph_file)) {
+    LOG(WARNING) << "Could not write the tracks and view graph to "
+                 << options_.tracks_and_view_graph_directory;
+  }
 }
 
 void ReconstructionBuilder::AddTracksForMatch(const ViewId view_id1,
                                               const ViewId view_id2,
                                               const ImagePairMatch& matches) {
-  for (const auto& match : matches.correspondences) {
-    track_builder_->AddFeatureCorrespondence(
-        view_id1, match.feature1, view_id2, match.feature2);
-  }
+  track_builder_->AddFeatureCorrespondences(
+      view_id1, view_id2, matches.correspondences);
 }
 
 }  // namespace theia
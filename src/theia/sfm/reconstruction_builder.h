@@ -35,6 +35,7 @@
 #ifndef THEIA_SFM_RECONSTRUCTION_BUILDER_H_
 #define THEIA_SFM_RECONSTRUCTION_BUILDER_H_
 
+#include <stdint.h>
 #include <memory>
 #include <string>
 #include <vector>
@@ -42,7 +43,9 @@
 #include "theia/image/descriptor/create_descriptor_extractor.h"
 #include "theia/matching/create_feature_matcher.h"
 #include "theia/matching/feature_matcher_options.h"
+#include "theia/matching/image_pair_match.h"
 #include "theia/sfm/reconstruction_estimator_options.h"
+#include "theia/sfm/twoview_info.h"
 #include "theia/sfm/types.h"
 #include "theia/util/util.h"
 
@@ -52,9 +55,9 @@ class FeaturesAndMatchesDatabase;
 class RandomNumberGenerator;
 class Reconstruction;
 class TrackBuilder;
+class TwoViewInfo;
 class ViewGraph;
 struct CameraIntrinsicsPrior;
-struct ImagePairMatch;
 
 struct ReconstructionBuilderOptions {
   // The random number generator used to generate random numbers through the
@@ -102,6 +105,15 @@ struct ReconstructionBuilderOptions {
   // valid writeable directory.
   std::string features_and_matches_database_directory = "";
 
+  // If set, the tracks and view graph are written to this directory after the
+  // tracks are built. Later runs with the same matches and track options (e.g.,
+  // when only the reconstruction estimator options change) load them from this
+  // directory instead of reading the correspondences from the database and
+  // building the tracks. The files store a hash of the image names and two view
+  // info of each match along with the track options, and are only reused if
+  // this hash is identical. The directory must exist and be writeable.
+  std::string tracks_and_view_graph_directory = "";
+
   // Matching strategy type.
   // See //theia/matching/create_feature_matcher.h
   MatchingStrategy matching_strategy = MatchingStrategy::BRUTE_FORCE;
@@ -184,13 +196,21 @@ class ReconstructionBuilder {
   bool BuildReconstruction(std::vector<Reconstruction*>* reconstructions);
 
  private:
+  // Looks up the view ids of the two images. Returns false if the match should
+  // not be used because one of the views is uncalibrated and only calibrated
+  // views were requested. This method is thread-safe.
+  bool GetViewIdsOfMatch(const std::string& image1,
+                         const std::string& image2,
+                         ViewId* view_id1,
+                         ViewId* view_id2) const;
+
   // Adds the given matches as edges in the view graph.
   void AddMatchToViewGraph(const ViewId view_id1,
                            const ViewId view_id2,
-                           const ImagePairMatch& image_matches);
+                           const TwoViewInfo& twoview_info);
 
   // Builds tracks from the two view inlier correspondences after geometric
-  // verification.
+  // verification. This method is thread-safe.
   void AddTracksForMatch(const ViewId view_id1,
                          const ViewId view_id2,
                          const ImagePairMatch& image_matches);
@@ -198,6 +218,22 @@ class ReconstructionBuilder {
   // Removes all uncalibrated views from the reconstruction and view graph.
   void RemoveUncalibratedViews();
 
+  // Adds the pending view pairs to the view graph. If add_tracks is true, the
+  // matches of the view pairs that are stored in the database are loaded and
+  // streamed into the track builder first. The pending view pairs are released
+  // afterwards.
+  void AddPendingViewPairs(const bool add_tracks);
+
+  // Returns a hash of the keys of all matches that were added and of the track
+  // options. The hash does not depend on the order of the matches.
+  uint64_t ComputeTracksAndViewGraphContentHash() const;
+
+  // Loads the tracks and view graph from tracks_and_view_graph_directory if
+  // the files exist and were created from the same content. Returns false and
+  // leaves the reconstruction and view graph unchanged otherwise.
+  bool ReadTracksAndViewGraph(const uint64_t content_hash);
+  void WriteTracksAndViewGraph(const uint64_t content_hash) const;
+
   ReconstructionBuilderOptions options_;
 
   // SfM objects.
@@ -208,6 +244,22 @@ class ReconstructionBuilder {
   // Container of image information.
   std::vector<std::string> image_filepaths_;
 
+  // View pairs are added to the view graph in BuildReconstruction, and only if
+  // the view graph cannot be loaded from tracks_and_view_graph_directory. Only
+  // the two view info is held. The correspondences of matches in the database
+  // are read when the tracks are built.
+  struct PendingViewPair {
+    ViewId view_id1;
+    ViewId view_id2;
+    TwoViewInfo twoview_info;
+    bool in_database;
+  };
+  std::vector<PendingViewPair> pending_view_pairs_;
+
+  // The hashes of the image names and two view info of all matches that were
+  // added.
+  std::vector<uint64_t> match_content_hashes_;
+
   // A DB for storing features and matches.
   FeaturesAndMatchesDatabase* features_and_matches_database_;
 
@@ -38,6 +38,7 @@
 #include <memory>
 
 #include "theia/sfm/bundle_adjustment/bundle_adjustment.h"
+#include "theia/sfm/estimators/estimate_calibrated_absolute_pose.h"
 #include "theia/sfm/global_pose_estimation/least_unsquared_deviation_position_estimator.h"
 #include "theia/sfm/global_pose_estimation/linear_position_estimator.h"
 #include "theia/sfm/global_pose_estimation/nonlinear_position_estimator.h"
@@ -182,6 +183,11 @@ struct ReconstructionEstimatorOptions {
   // threshold for images that have varying resolutions.
   double absolute_pose_reprojection_error_threshold = 4.0;
 
+  // The P3P solver used to localize views with known intrinsics. LAMBDA_TWIST
+  // scores hypotheses with vectorized reprojection and is typically faster
+  // when views observe many 3D points.
+  PnPType absolute_pose_pnp_type = PnPType::KNEIP;
+
   // Minimum number of inliers for absolute pose estimation to be considered
   // successful.
   int min_num_absolute_pose_inliers = 30;
@@ -220,6 +226,12 @@ struct ReconstructionEstimatorOptions {
   // Bundle adjust a track immediately after estimating it.
   bool bundle_adjust_tracks = true;
 
+  // If true, tracks are triangulated robustly by RANSAC over pairs of
+  // observations and outlier observations are removed from the tracks. If
+  // bundle_adjust_tracks is true, the tracks are bundle adjusted with their
+  // inlier observations only. This scales to very long tracks.
+  bool use_robust_triangulation = false;
+
   // --------------- Bundle Adjustment Options --------------- //
 
   // After computing a model and performing an initial BA, the reconstruction
@@ -249,6 +261,17 @@ struct ReconstructionEstimatorOptions {
   // for problems larger than this size.
   int min_cameras_for_iterative_solver = 1000;
 
+  // If true, the bundle adjustment linear solver is chosen from the sparsity of
+  // each problem (Schur complement density and camera covisibility) instead of
+  // only the number of cameras, and stalled ITERATIVE_SCHUR solves are
+  // continued with SPARSE_SCHUR.
+  bool bundle_adjustment_use_adaptive_linear_solver = false;
+
+  // If greater than 0, bundle adjustment stops once the relative decrease in
+  // reprojection error per second of solver time stays below this value for a
+  // few consecutive iterations.
+  double bundle_adjustment_min_relative_cost_decrease_per_second = 0.0;
+
   // If accurate calibration is known ahead of time then it is recommended to
   // set the camera intrinsics constant during bundle adjustment. Othewise, you
   // can choose which intrinsics to optimize. See
@@ -68,6 +68,7 @@ void GetNormalizedFeatureCorrespondences(
   const Camera& camera1 = view1.Camera();
   const Camera& camera2 = view2.Camera();
   const std::vector<TrackId>& tracks = view1.TrackIds();
+  const int first_match = matches->size();
   for (const TrackId track_id : tracks) {
     const Feature* feature2 = view2.GetFeature(track_id);
     // If view 2 does not contain the current track then it cannot be a
@@ -80,14 +81,27 @@ void GetNormalizedFeatureCorrespondences(
     const Feature* feature1 = view1.GetFeature(track_id);
     match.feature1 = *feature1;
     match.feature2 = *feature2;
-
-    // Normalize for camera intrinsics.
-    match.feature1 =
-        camera1.PixelToNormalizedCoordinates(match.feature1).hnormalized();
-    match.feature2 =
-        camera2.PixelToNormalizedCoordinates(match.feature2).hnormalized();
     matches->emplace_back(match);
   }
+
+  // Normalize for camera intrinsics. The features of each view are undistorted
+  // at once with the batch methods of the camera.
+  const int num_matches = matches->size() - first_match;
+  Eigen::Matrix2Xd features1(2, num_matches);
+  Eigen::Matrix2Xd features2(2, num_matches);
+  for (int i = 0; i < num_matches; i++) {
+    features1.col(i) = (*matches)[first_match + i].feature1;
+    features2.col(i) = (*matches)[first_match + i].feature2;
+  }
+  Eigen::Matrix3Xd normalized_features1, normalized_features2;
+  camera1.PixelsToNormalizedCoordinates(features1, &normalized_features1);
+  camera2.PixelsToNormalizedCoordinates(features2, &normalized_features2);
+  for (int i = 0; i < num_matches; i++) {
+    (*matches)[first_match + i].feature1 =
+        normalized_features1.col(i).hnormalized();
+    (*matches)[first_match + i].feature2 =
+        normalized_features2.col(i).hnormalized();
+  }
 }
 
 }  // namespace
@@ -117,6 +131,10 @@ BundleAdjustmentOptions SetBundleAdjustmentOptions(
   ba_options.robust_loss_width = options.bundle_adjustment_robust_loss_width;
   ba_options.use_inner_iterations = true;
   ba_options.intrinsics_to_optimize = options.intrinsics_to_optimize;
+  ba_options.use_adaptive_linear_solver =
+      options.bundle_adjustment_use_adaptive_linear_solver;
+  ba_options.min_relative_cost_decrease_per_second =
+      options.bundle_adjustment_min_relative_cost_decrease_per_second;
 
   if (num_views >= options.min_cameras_for_iterative_solver) {
     ba_options.linear_solver_type = ceres::ITERATIVE_SCHUR;
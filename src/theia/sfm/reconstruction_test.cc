@@ -32,10 +32,14 @@
 // Please contact the author of this library if you have any questions.
 // Author: Chris Sweeney (cmsweeney@cs.ucsb.edu)
 
+#include <Eigen/Core>
+#include <Eigen/Geometry>
+
 #include "gtest/gtest.h"
 
 #include "theia/sfm/reconstruction.h"
 #include "theia/util/map_util.h"
+#include "theia/util/random.h"
 #include "theia/util/stringprintf.h"
 
 namespace theia {
@@ -263,6 +267,28 @@ TEST(Reconstruction, AddObservationInvalid) {
   EXPECT_FALSE(reconstruction.AddObservation(view_id2, track_id, features[1]));
 }
 
+TEST(Reconstruction, RemoveObservation) {
+  Reconstruction reconstruction;
+
+  const ViewId view_id1 = reconstruction.AddView(view_names[0]);
+  const ViewId view_id2 = reconstruction.AddView(view_names[1]);
+  const TrackId track_id = reconstruction.AddTrack();
+  EXPECT_TRUE(reconstruction.AddObservation(view_id1, track_id, features[0]));
+  EXPECT_TRUE(reconstruction.AddObservation(view_id2, track_id, features[1]));
+
+  EXPECT_TRUE(reconstruction.RemoveObservation(view_id1, track_id));
+  EXPECT_EQ(reconstruction.View(view_id1)->GetFeature(track_id), nullptr);
+  EXPECT_NE(reconstruction.View(view_id2)->GetFeature(track_id), nullptr);
+
+  const Track* track = reconstruction.Track(track_id);
+  EXPECT_EQ(track->NumViews(), 1);
+  EXPECT_FALSE(ContainsKey(track->ViewIds(), view_id1));
+
+  // The observation no longer exists so it cannot be removed again.
+  EXPECT_FALSE(reconstruction.RemoveObservation(view_id1, track_id));
+  EXPECT_FALSE(reconstruction.RemoveObservation(kInvalidViewId, track_id));
+}
+
 TEST(Reconstruction, AddTrackValid) {
   Reconstruction reconstruction;
 
@@ -288,6 +314,42 @@ TEST(Reconstruction, AddTrackInvalid) {
   EXPECT_EQ(reconstruction.NumTracks(), 0);
 }
 
+TEST(Reconstruction, AddTracks) {
+  Reconstruction reconstruction;
+  for (const std::string& view_name : view_names) {
+    EXPECT_NE(reconstruction.AddView(view_name), kInvalidViewId);
+  }
+
+  // The second track is invalid because it contains the same view twice.
+  const std::vector<std::vector<std::pair<ViewId, Feature> > > tracks = {
+      {{0, features[0]}, {1, features[1]}},
+      {{0, features[1]}, {0, features[2]}},
+      {{0, features[2]}, {1, features[0]}, {2, features[1]}}};
+  const std::vector<TrackId> track_ids = reconstruction.AddTracks(tracks, 2);
+  ASSERT_EQ(track_ids.size(), tracks.size());
+  EXPECT_EQ(track_ids[0], 0);
+  EXPECT_EQ(track_ids[1], kInvalidTrackId);
+  EXPECT_EQ(track_ids[2], 1);
+  EXPECT_EQ(reconstruction.NumTracks(), 2);
+
+  for (const int i : {0, 2}) {
+    const Track* track = reconstruction.Track(track_ids[i]);
+    ASSERT_TRUE(track != nullptr);
+    EXPECT_EQ(track->NumViews(), tracks[i].size());
+    for (const auto& observation : tracks[i]) {
+      const Feature* feature =
+          reconstruction.View(observation.first)->GetFeature(track_ids[i]);
+      ASSERT_TRUE(feature != nullptr);
+      EXPECT_EQ(*feature, observation.second);
+    }
+  }
+  EXPECT_EQ(reconstruction.View(0)->NumFeatures(), 2);
+  EXPECT_EQ(reconstruction.View(2)->NumFeatures(), 1);
+
+  // Subsequent tracks should continue with the next track id.
+  EXPECT_EQ(reconstruction.AddTrack(tracks[0]), 2);
+}
+
 TEST(Reconstruction, RemoveTrackValid) {
   Reconstruction reconstruction;
 
@@ -430,4 +492,85 @@ TEST(Reconstruction, GetSubReconstruction) {
   }
 }
 
+// Builds a reconstruction with randomly placed cameras and points where all
+// views and tracks are estimated.
+void BuildRandomEstimatedReconstruction(Reconstruction* reconstruction) {
+  static const int kNumViews = 20;
+  static const int kNumTracks = 500;
+  RandomNumberGenerator rng(57);
+  for (int i = 0; i < kNumViews; i++) {
+    const ViewId view_id = reconstruction->AddView(StringPrintf("%d", i));
+    View* view = reconstruction->MutableView(view_id);
+    view->MutableCamera()->SetPosition(rng.RandVector3d());
+    view->MutableCamera()->SetOrientationFromAngleAxis(0.2 *
+                                                       rng.RandVector3d());
+    view->SetEstimated(true);
+  }
+  for (int i = 0; i < kNumTracks; i++) {
+    std::vector<std::pair<ViewId, Feature> > track;
+    track.emplace_back(i % kNumViews, Feature());
+    track.emplace_back((i + 1) % kNumViews, Feature());
+    const TrackId track_id = reconstruction->AddTrack(track);
+    Track* mutable_track = reconstruction->MutableTrack(track_id);
+    *mutable_track->MutablePoint() =
+        (5.0 * rng.RandVector3d() + Eigen::Vector3d(0, 0, 10)).homogeneous();
+    mutable_track->SetEstimated(true);
+  }
+}
+
+// Returns the bearing of the point in the camera coordinate system. This is
+// invariant to the similarity transformation applied by Normalize.
+Eigen::Vector3d CameraFrameBearing(const Reconstruction& reconstruction,
+                                   const ViewId view_id,
+                                   const TrackId track_id) {
+  const Camera& camera = reconstruction.View(view_id)->Camera();
+  const Eigen::Vector3d point =
+      reconstruction.Track(track_id)->Point().hnormalized();
+  return (camera.GetOrientationAsRotationMatrix() *
+          (point - camera.GetPosition()))
+      .normalized();
+}
+
+TEST(Reconstruction, NormalizeIsSimilarityTransformation) {
+  Reconstruction reconstruction;
+  BuildRandomEstimatedReconstruction(&reconstruction);
+  Reconstruction normalized = reconstruction;
+  normalized.Normalize();
+
+  for (const TrackId track_id : reconstruction.TrackIds()) {
+    for (const ViewId view_id : reconstruction.Track(track_id)->ViewIds()) {
+      const Eigen::Vector3d bearing =
+          CameraFrameBearing(reconstruction, view_id, track_id);
+      const Eigen::Vector3d normalized_bearing =
+          CameraFrameBearing(normalized, view_id, track_id);
+      EXPECT_LT((bearing - normalized_bearing).norm(), 1e-8);
+    }
+  }
+}
+
+TEST(Reconstruction, NormalizeMultithreaded) {
+  Reconstruction reconstruction;
+  BuildRandomEstimatedReconstruction(&reconstruction);
+  Reconstruction single_threaded = reconstruction;
+  single_threaded.Normalize();
+  Reconstruction multi_threaded = reconstruction;
+  multi_threaded.Normalize(4);
+
+  for (const ViewId view_id : reconstruction.ViewIds()) {
+    const Camera& camera1 = single_threaded.View(view_id)->Camera();
+    const Camera& camera2 = multi_threaded.View(view_id)->Camera();
+    EXPECT_LT((camera1.GetPosition() - camera2.GetPosition()).norm(), 1e-12);
+    EXPECT_LT((camera1.GetOrientationAsAngleAxis() -
+               camera2.GetOrientationAsAngleAxis())
+                  .norm(),
+              1e-12);
+  }
+  for (const TrackId track_id : reconstruction.TrackIds()) {
+    EXPECT_LT((single_threaded.Track(track_id)->Point() -
+               multi_threaded.Track(track_id)->Point())
+                  .norm(),
+              1e-12);
+  }
+}
+
 }  // namespace theia
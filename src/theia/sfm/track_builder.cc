@@ -34,28 +34,43 @@
 
 #include "theia/sfm/track_builder.h"
 
+#include <algorithm>
 #include <cstddef>
 #include <memory>
+#include <mutex>  // NOLINT
 #include <stdint.h>
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
 #include <utility>
 #include <vector>
 
 #include "theia/math/graph/connected_components.h"
+#include "theia/matching/feature_correspondence.h"
 #include "theia/sfm/feature.h"
 #include "theia/sfm/reconstruction.h"
 #include "theia/sfm/types.h"
 #include "theia/util/map_util.h"
+#include "theia/util/threadpool.h"
 
 namespace theia {
 
+namespace {
+
+// Lexicographic ordering of features used to assign deterministic feature ids.
+bool FeatureLess(const Feature& feature1, const Feature& feature2) {
+  if (feature1.x() != feature2.x()) {
+    return feature1.x() < feature2.x();
+  }
+  return feature1.y() < feature2.y();
+}
+
+}  // namespace
+
 TrackBuilder::TrackBuilder(const int min_track_length,
                            const int max_track_length)
-    : num_features_(0), min_track_length_(min_track_length) {
-  connected_components_.reset(
-      new ConnectedComponents<uint64_t>(max_track_length));
-}
+    : min_track_length_(min_track_length),
+      max_track_length_(max_track_length) {}
 
 TrackBuilder::~TrackBuilder() {}
 
@@ -67,87 +82,259 @@ void TrackBuilder::AddFeatureCorrespondence(const ViewId view_id1,
       << "Cannot add 2 features from the same image as a correspondence for "
          "track generation.";
 
-  const auto image_feature1 = std::make_pair(view_id1, feature1);
-  const auto image_feature2 = std::make_pair(view_id2, feature2);
+  // Store the correspondence with the smaller view id first.
+  const ViewId min_view_id = std::min(view_id1, view_id2);
+  const ViewId max_view_id = std::max(view_id1, view_id2);
+  std::vector<uint32_t> feature_ids1, feature_ids2;
+  FindOrInsertFeatureIds(FindOrAddViewFeatures(min_view_id),
+                         {view_id1 < view_id2 ? &feature1 : &feature2},
+                         &feature_ids1);
+  FindOrInsertFeatureIds(FindOrAddViewFeatures(max_view_id),
+                         {view_id1 < view_id2 ? &feature2 : &feature1},
+                         &feature_ids2);
 
-  const int feature1_id = FindOrInsert(image_feature1);
-  const int feature2_id = FindOrInsert(image_feature2);
+  std::lock_guard<std::mutex> lock(mutex_);
+  // Consecutive correspondences between the same views are grouped together.
+  if (view_pair_edges_.empty() ||
+      view_pair_edges_.back().view_id1 != min_view_id ||
+      view_pair_edges_.back().view_id2 != max_view_id) {
+    view_pair_edges_.emplace_back();
+    view_pair_edges_.back().view_id1 = min_view_id;
+    view_pair_edges_.back().view_id2 = max_view_id;
+  }
+  view_pair_edges_.back().edges.emplace_back(feature_ids1[0], feature_ids2[0]);
+}
+
+void TrackBuilder::AddFeatureCorrespondences(
+    const ViewId view_id1,
+    const ViewId view_id2,
+    const std::vector<FeatureCorrespondence>& correspondences) {
+  CHECK_NE(view_id1, view_id2)
+      << "Cannot add 2 features from the same image as a correspondence for "
+         "track generation.";
 
-  connected_components_->AddEdge(feature1_id, feature2_id);
+  // Store the correspondences with the smaller view id first.
+  const bool swap_views = view_id1 > view_id2;
+  std::vector<const Feature*> features1, features2;
+  features1.reserve(correspondences.size());
+  features2.reserve(correspondences.size());
+  for (const FeatureCorrespondence& correspondence : correspondences) {
+    features1.emplace_back(swap_views ? &correspondence.feature2
+                                      : &correspondence.feature1);
+    features2.emplace_back(swap_views ? &correspondence.feature1
+                                      : &correspondence.feature2);
+  }
+
+  ViewPairEdges view_pair;
+  view_pair.view_id1 = std::min(view_id1, view_id2);
+  view_pair.view_id2 = std::max(view_id1, view_id2);
+  std::vector<uint32_t> feature_ids1, feature_ids2;
+  FindOrInsertFeatureIds(
+      FindOrAddViewFeatures(view_pair.view_id1), features1, &feature_ids1);
+  FindOrInsertFeatureIds(
+      FindOrAddViewFeatures(view_pair.view_id2), features2, &feature_ids2);
+  view_pair.edges.reserve(correspondences.size());
+  for (int i = 0; i < feature_ids1.size(); i++) {
+    view_pair.edges.emplace_back(feature_ids1[i], feature_ids2[i]);
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  view_pair_edges_.emplace_back(std::move(view_pair));
+}
+
+TrackBuilder::ViewFeatures* TrackBuilder::FindOrAddViewFeatures(
+    const ViewId view_id) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  std::unique_ptr<ViewFeatures>& view_features = view_features_[view_id];
+  if (view_features == nullptr) {
+    view_features.reset(new ViewFeatures);
+  }
+  return view_features.get();
+}
+
+void TrackBuilder::FindOrInsertFeatureIds(
+    ViewFeatures* view_features,
+    const std::vector<const Feature*>& features,
+    std::vector<uint32_t>* feature_ids) {
+  feature_ids->reserve(features.size());
+  std::lock_guard<std::mutex> lock(view_features->mutex);
+  for (const Feature* feature : features) {
+    const uint32_t new_feature_id = view_features->feature_ids.size();
+    feature_ids->emplace_back(
+        view_features->feature_ids.emplace(*feature, new_feature_id)
+            .first->second);
+  }
 }
 
 void TrackBuilder::BuildTracks(Reconstruction* reconstruction) {
+  BuildTracks(1, reconstruction);
+}
+
+void TrackBuilder::BuildTracks(const int num_threads,
+                               Reconstruction* reconstruction) {
   CHECK_NOTNULL(reconstruction);
+  CHECK_GE(num_threads, 1);
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  // Sort the view pairs so that the edges are added to the connected components
+  // in the same order regardless of the order that the view pairs were added.
+  std::stable_sort(view_pair_edges_.begin(),
+                   view_pair_edges_.end(),
+                   [](const ViewPairEdges& pair1, const ViewPairEdges& pair2) {
+                     return std::make_pair(pair1.view_id1, pair1.view_id2) <
+                            std::make_pair(pair2.view_id1, pair2.view_id2);
+                   });
 
-  // Build a reverse map mapping feature ids to ImageNameFeaturePairs.
-  std::unordered_map<uint64_t, const std::pair<ViewId, Feature>*> id_to_feature;
-  id_to_feature.reserve(features_.size());
-  for (const auto& feature : features_) {
-    InsertOrDie(&id_to_feature, feature.second, &feature.first);
+  std::vector<ViewId> view_ids;
+  view_ids.reserve(view_features_.size());
+  for (const auto& view_features : view_features_) {
+    view_ids.emplace_back(view_features.first);
   }
+  std::sort(view_ids.begin(), view_ids.end());
+  const int num_views = view_ids.size();
+  const auto view_index = [&view_ids](const ViewId view_id) {
+    return std::lower_bound(view_ids.begin(), view_ids.end(), view_id) -
+           view_ids.begin();
+  };
+
+  // Rank the features of each view in sorted order. The id of a feature in the
+  // tracks is its rank within its view, offset by the total number of features
+  // in all views with a smaller view id. The feature maps are released as soon
+  // as they have been ranked.
+  std::vector<std::vector<Feature> > features(num_views);
+  std::vector<std::vector<uint32_t> > feature_ranks(num_views);
+  ParallelForBlocks(
+      num_threads, num_views, [&](const int start, const int end) {
+        for (int i = start; i < end; i++) {
+          std::unordered_map<Feature, uint32_t> feature_ids;
+          feature_ids.swap(
+              FindOrDie(view_features_, view_ids[i])->feature_ids);
+          features[i].resize(feature_ids.size());
+          for (const auto& feature : feature_ids) {
+            features[i][feature.second] = feature.first;
+          }
+          feature_ids.clear();
+
+          std::vector<uint32_t> order(features[i].size());
+          for (int j = 0; j < order.size(); j++) {
+            order[j] = j;
+          }
+          std::sort(order.begin(),
+                    order.end(),
+                    [&](const uint32_t feature1, const uint32_t feature2) {
+                      return FeatureLess(features[i][feature1],
+                                         features[i][feature2]);
+                    });
+
+          std::vector<Feature> sorted_features(order.size());
+          feature_ranks[i].resize(order.size());
+          for (int j = 0; j < order.size(); j++) {
+            sorted_features[j] = features[i][order[j]];
+            feature_ranks[i][order[j]] = j;
+          }
+          features[i].swap(sorted_features);
+        }
+      });
+  view_features_.clear();
+
+  std::vector<uint64_t> feature_id_offsets(num_views + 1, 0);
+  for (int i = 0; i < num_views; i++) {
+    feature_id_offsets[i + 1] = feature_id_offsets[i] + features[i].size();
+  }
+
+  // Union-find is inherently sequential, but operating on integer ids it is
+  // cheap. The edges of each view pair are released once they are added.
+  ConnectedComponents<uint64_t> connected_components(max_track_length_);
+  for (ViewPairEdges& view_pair : view_pair_edges_) {
+    const int index1 = view_index(view_pair.view_id1);
+    const int index2 = view_index(view_pair.view_id2);
+    for (const auto& edge : view_pair.edges) {
+      connected_components.AddEdge(
+          feature_id_offsets[index1] + feature_ranks[index1][edge.first],
+          feature_id_offsets[index2] + feature_ranks[index2][edge.second]);
+    }
+    std::vector<std::pair<uint32_t, uint32_t> >().swap(view_pair.edges);
+  }
+  view_pair_edges_.clear();
+  feature_ranks.clear();
 
   // Extract all connected components.
   std::unordered_map<uint64_t, std::unordered_set<uint64_t> > components;
-  connected_components_->Extract(&components);
+  connected_components.Extract(&components);
 
-  // Each connected component is a track. Add all tracks to the reconstruction.
+  // Each connected component is a track. Skip singleton tracks.
   int num_small_tracks = 0;
-  int num_inconsistent_features = 0;
+  std::vector<std::vector<uint64_t> > sorted_components;
+  sorted_components.reserve(components.size());
   for (const auto& component : components) {
-    // Skip singleton tracks.
     if (component.second.size() < min_track_length_) {
       ++num_small_tracks;
       continue;
     }
+    sorted_components.emplace_back(component.second.begin(),
+                                   component.second.end());
+  }
+  components.clear();
 
-    std::vector<std::pair<ViewId, Feature> > track;
-    track.reserve(component.second.size());
-
-    // Add all features in the connected component to the track.
-    std::unordered_set<ViewId> view_ids;
-    for (const auto& feature_id : component.second) {
-      const auto& feature_to_add = *FindOrDie(id_to_feature, feature_id);
-
-      // Do not add the feature if the track already contains a feature from the
-      // same image.
-      if (!InsertIfNotPresent(&view_ids, feature_to_add.first)) {
-        ++num_inconsistent_features;
-        continue;
-      }
+  // Order the tracks by their smallest feature id so that the track ids are
+  // deterministic.
+  const int num_tracks = sorted_components.size();
+  ParallelForBlocks(
+      num_threads, num_tracks, [&](const int start, const int end) {
+        for (int i = start; i < end; i++) {
+          std::sort(sorted_components[i].begin(), sorted_components[i].end());
+        }
+      });
+  std::sort(sorted_components.begin(),
+            sorted_components.end(),
+            [](const std::vector<uint64_t>& component1,
+               const std::vector<uint64_t>& component2) {
+              return component1.front() < component2.front();
+            });
 
-      track.emplace_back(feature_to_add);
-    }
+  // Convert the feature ids back to features. Feature ids are sorted by view,
+  // so features from the same view are adjacent and all but the first one are
+  // dropped to keep the tracks consistent.
+  std::vector<std::vector<std::pair<ViewId, Feature> > > tracks(num_tracks);
+  std::vector<int> num_inconsistent_features(num_tracks, 0);
+  ParallelForBlocks(
+      num_threads, num_tracks, [&](const int start, const int end) {
+        for (int i = start; i < end; i++) {
+          tracks[i].reserve(sorted_components[i].size());
+          for (const uint64_t feature_id : sorted_components[i]) {
+            const int index = std::upper_bound(feature_id_offsets.begin(),
+                                               feature_id_offsets.end(),
+                                               feature_id) -
+                              feature_id_offsets.begin() - 1;
+            if (!tracks[i].empty() &&
+                tracks[i].back().first == view_ids[index]) {
+              ++num_inconsistent_features[i];
+              continue;
+            }
+            tracks[i].emplace_back(
+                view_ids[index],
+                features[index][feature_id - feature_id_offsets[index]]);
+          }
+        }
+      });
 
-    CHECK_NE(reconstruction->AddTrack(track), kInvalidTrackId)
-        << "Could not build tracks.";
+  // Add all tracks to the reconstruction.
+  const std::vector<TrackId> track_ids =
+      reconstruction->AddTracks(tracks, num_threads);
+  for (const TrackId track_id : track_ids) {
+    CHECK_NE(track_id, kInvalidTrackId) << "Could not build tracks.";
   }
 
+  int total_num_inconsistent_features = 0;
+  for (const int num_inconsistent : num_inconsistent_features) {
+    total_num_inconsistent_features += num_inconsistent;
+  }
   LOG(INFO)
       << reconstruction->NumTracks() << " tracks were created. "
-      << num_inconsistent_features
+      << total_num_inconsistent_features
       << " features were dropped because they formed inconsistent tracks, and "
       << num_small_tracks << " features were dropped because they did not have "
                              "enough observations.";
 }
 
-uint64_t TrackBuilder::FindOrInsert(
-    const std::pair<ViewId, Feature>& image_feature) {
-  const uint64_t* feature_id = FindOrNull(features_, image_feature);
-
-  // If the feature is present, return the id.
-  if (feature_id != nullptr) {
-    return *feature_id;
-  }
-
-  // Otherwise, add the feature.
-  const uint64_t new_feature_id = num_features_;
-  InsertOrDieNoPrint(&features_, image_feature, new_feature_id);
-
-  // Increment the number of features.
-  ++num_features_;
-
-  return new_feature_id;
-  ;
-}
-
 }  // namespace theia
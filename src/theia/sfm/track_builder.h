@@ -38,23 +38,31 @@
 #include <stdint.h>
 #include <cstddef>
 #include <memory>
+#include <mutex>  // NOLINT
 #include <string>
 #include <unordered_map>
 #include <utility>
+#include <vector>
 
+#include "theia/matching/feature_correspondence.h"
 #include "theia/sfm/feature.h"
 #include "theia/sfm/types.h"
 
 namespace theia {
 
-template <typename T> class ConnectedComponents;
 class Reconstruction;
 
 // Build tracks from feature correspondences across multiple images. Tracks are
 // created with the connected components algorithm and have a maximum allowable
 // size. If there are multiple features from one image in a track, we do not do
-// any intelligent selection and just arbitrarily choose a feature to drop so
-// that the tracks are consistent.
+// any intelligent selection and just keep the first feature (in sorted order)
+// from each image so that the tracks are consistent.
+//
+// Each view assigns ids to its features as they arrive, and only the integer
+// feature ids of each correspondence are kept until BuildTracks. There, the
+// features of each view are ranked in sorted order and tracks are ordered by
+// their smallest ranked feature, so the track ids do not depend on the order
+// in which view pairs were added or on the number of threads used.
 class TrackBuilder {
  public:
   TrackBuilder(const int min_track_length, const int max_track_length);
@@ -65,16 +73,50 @@ class TrackBuilder {
   void AddFeatureCorrespondence(const ViewId view_id1, const Feature& feature1,
                                 const ViewId view_id2, const Feature& feature2);
 
+  // Adds all feature correspondences between two views. This method is
+  // thread-safe and may be called concurrently for different view pairs.
+  void AddFeatureCorrespondences(
+      const ViewId view_id1,
+      const ViewId view_id2,
+      const std::vector<FeatureCorrespondence>& correspondences);
+
   // Generates all tracks and adds them to the reconstruction.
   void BuildTracks(Reconstruction* reconstruction);
+  void BuildTracks(const int num_threads, Reconstruction* reconstruction);
 
  private:
-  uint64_t FindOrInsert(const std::pair<ViewId, Feature>& image_feature);
+  // The features observed in a single view. Features are given consecutive
+  // ids in the order that they are first seen.
+  struct ViewFeatures {
+    std::mutex mutex;
+    std::unordered_map<Feature, uint32_t> feature_ids;
+  };
+
+  // The feature ids of all correspondences that were added between a pair of
+  // views.
+  struct ViewPairEdges {
+    ViewId view_id1;
+    ViewId view_id2;
+    std::vector<std::pair<uint32_t, uint32_t> > edges;
+  };
+
+  // Returns the features of the view, adding them if the view is new.
+  ViewFeatures* FindOrAddViewFeatures(const ViewId view_id);
+
+  // Returns the ids of the features in the view, assigning new ids to features
+  // that have not been seen before. Only the mutex of the view is held.
+  void FindOrInsertFeatureIds(ViewFeatures* view_features,
+                              const std::vector<const Feature*>& features,
+                              std::vector<uint32_t>* feature_ids);
 
-  std::unordered_map<std::pair<ViewId, Feature>, uint64_t> features_;
-  std::unique_ptr<ConnectedComponents<uint64_t> > connected_components_;
-  uint64_t num_features_;
+  // Guards view_features_ and view_pair_edges_. The features of each view are
+  // guarded by their own mutex so that view pairs which do not share a view
+  // may be added concurrently.
+  std::mutex mutex_;
+  std::unordered_map<ViewId, std::unique_ptr<ViewFeatures> > view_features_;
+  std::vector<ViewPairEdges> view_pair_edges_;
   const int min_track_length_;
+  const int max_track_length_;
 };
 
 }  // namespace theia
@@ -34,16 +34,21 @@
 
 #include <glog/logging.h>
 
+#include <algorithm>
+#include <map>
 #include <string>
 #include <unordered_set>
 #include <vector>
 
 #include "gtest/gtest.h"
 
+#include "theia/matching/feature_correspondence.h"
 #include "theia/sfm/reconstruction.h"
 #include "theia/sfm/track.h"
 #include "theia/sfm/track_builder.h"
 #include "theia/sfm/types.h"
+#include "theia/util/random.h"
+#include "theia/util/threadpool.h"
 
 namespace theia {
 static const int kMinTrackLength = 2;
@@ -198,4 +203,73 @@ TEST(TrackBuilder, MinTrackLength) {
   EXPECT_EQ(reconstruction.NumTracks(), 1);
 }
 
+// The track ids and the tracks themselves should not depend on the order that
+// the view pairs were added in nor on the number of threads.
+TEST(TrackBuilder, DeterministicTracks) {
+  static const int kMaxTrackLength = 4;
+  static const int kNumViews = 8;
+  static const int kNumFeatures = 50;
+  static const int kNumCorrespondences = 30;
+
+  RandomNumberGenerator rng(51);
+  std::vector<ViewId> view_ids;
+  std::vector<std::vector<FeatureCorrespondence> > correspondences;
+  for (int i = 0; i < kNumViews; i++) {
+    for (int j = i + 1; j < kNumViews; j++) {
+      view_ids.emplace_back(i);
+      view_ids.emplace_back(j);
+      correspondences.emplace_back();
+      for (int k = 0; k < kNumCorrespondences; k++) {
+        correspondences.back().emplace_back(
+            Feature(rng.RandInt(0, kNumFeatures), 0),
+            Feature(rng.RandInt(0, kNumFeatures), 0));
+      }
+    }
+  }
+
+  std::vector<int> order(correspondences.size());
+  for (int i = 0; i < order.size(); i++) {
+    order[i] = i;
+  }
+
+  std::vector<std::map<ViewId, Feature> > expected_tracks;
+  for (const int num_threads : {1, 4}) {
+    // The view pairs are added concurrently so that features are first seen
+    // in an arbitrary order.
+    TrackBuilder track_builder(kMinTrackLength, kMaxTrackLength);
+    ParallelForBlocks(
+        num_threads, order.size(), [&](const int start, const int end) {
+          for (int j = start; j < end; j++) {
+            const int i = order[j];
+            track_builder.AddFeatureCorrespondences(
+                view_ids[2 * i], view_ids[2 * i + 1], correspondences[i]);
+          }
+        });
+
+    Reconstruction reconstruction;
+    for (int i = 0; i < kNumViews; i++) {
+      reconstruction.AddView(std::to_string(i));
+    }
+    track_builder.BuildTracks(num_threads, &reconstruction);
+    VerifyTracks(reconstruction);
+
+    std::vector<std::map<ViewId, Feature> > tracks(reconstruction.NumTracks());
+    for (int i = 0; i < tracks.size(); i++) {
+      const Track* track = CHECK_NOTNULL(reconstruction.Track(i));
+      for (const ViewId view_id : track->ViewIds()) {
+        tracks[i][view_id] = *reconstruction.View(view_id)->GetFeature(i);
+      }
+    }
+
+    if (expected_tracks.empty()) {
+      expected_tracks = tracks;
+    } else {
+      EXPECT_EQ(tracks, expected_tracks);
+    }
+
+    // Add the view pairs in reverse order for the next run.
+    std::reverse(order.begin(), order.end());
+  }
+}
+
 }  // namespace theia
@@ -96,6 +96,12 @@ class CameraAlignmentEstimator
 
 void AlignReconstructions(const Reconstruction& reconstruction1,
                           Reconstruction* reconstruction2) {
+  AlignReconstructions(reconstruction1, 1, reconstruction2);
+}
+
+void AlignReconstructions(const Reconstruction& reconstruction1,
+                          const int num_threads,
+                          Reconstruction* reconstruction2) {
   CHECK_NOTNULL(reconstruction2);
 
   const std::vector<std::string> common_view_names =
@@ -126,12 +132,22 @@ void AlignReconstructions(const Reconstruction& reconstruction1,
                           &scale);
 
   // Apply the similarity transformation to the reconstruction.
-  TransformReconstruction(rotation, translation, scale, reconstruction2);
+  TransformReconstruction(
+      rotation, translation, scale, num_threads, reconstruction2);
+}
+
+void AlignReconstructionsRobust(
+    const double robust_error_threshold,
+    const Reconstruction& reconstruction1,
+    Reconstruction* reconstruction2) {
+  AlignReconstructionsRobust(
+      robust_error_threshold, reconstruction1, 1, reconstruction2);
 }
 
 void AlignReconstructionsRobust(
     const double robust_error_threshold,
     const Reconstruction& reconstruction1,
+    const int num_threads,
     Reconstruction* reconstruction2) {
   CHECK_NOTNULL(reconstruction2);
 
@@ -189,7 +205,8 @@ void AlignReconstructionsRobust(
                           &scale);
 
   // Apply the similarity transformation to the reconstruction.
-  TransformReconstruction(rotation, translation, scale, reconstruction2);
+  TransformReconstruction(
+      rotation, translation, scale, num_threads, reconstruction2);
 }
 
 }  // namespace theia
@@ -43,6 +43,12 @@ class Reconstruction;
 void AlignReconstructions(const Reconstruction& reconstruction1,
                           Reconstruction* reconstruction2);
 
+// Same as above, but the similarity transformation is applied to
+// reconstruction2 with num_threads threads.
+void AlignReconstructions(const Reconstruction& reconstruction1,
+                          const int num_threads,
+                          Reconstruction* reconstruction2);
+
 // Aligns the reconstructions so that their commons cameras have the closest
 // positions. This method is robust by using RANSAC to compute similarity
 // transformations with inliers having a position distance less than
@@ -53,6 +59,14 @@ void AlignReconstructionsRobust(
     const Reconstruction& reconstruction1,
     Reconstruction* reconstruction2);
 
+// Same as above, but the similarity transformation is applied to
+// reconstruction2 with num_threads threads.
+void AlignReconstructionsRobust(
+    const double robust_error_threshold,
+    const Reconstruction& reconstruction1,
+    const int num_threads,
+    Reconstruction* reconstruction2);
+
 }  // namespace theia
 
 #endif  // THEIA_SFM_TRANSFORMATION_ALIGN_RECONSTRUCTIONS_H_
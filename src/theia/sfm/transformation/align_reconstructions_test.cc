@@ -190,5 +190,25 @@ TEST(AlignReconstructions, SimilarityTransformation) {
   TestAlignReconstructions(kNumViews, kNumTracks, rotation, translation, scale);
 }
 
+TEST(AlignReconstructions, SimilarityTransformationMultithreaded) {
+  static const int kNumViews = 10;
+  static const int kNumTracks = 200;
+  static const int kNumThreads = 4;
+  const Eigen::Vector3d rotation_aa = rng.RandVector3d();
+  const Eigen::Matrix3d rotation =
+      Eigen::AngleAxisd(rotation_aa.norm(), rotation_aa.normalized())
+          .toRotationMatrix();
+  const Eigen::Vector3d translation = rng.RandVector3d();
+  const double scale = 4.2;
+
+  Reconstruction reconstruction1, reconstruction2;
+  BuildReconstructions(kNumViews,
+                       kNumTracks,
+                       &reconstruction1,
+                       &reconstruction2);
+  TransformReconstruction(rotation, translation, scale, &reconstruction1);
+  AlignReconstructions(reconstruction1, kNumThreads, &reconstruction2);
+  VerifyAlignment(reconstruction1, reconstruction2);
+}
 
 }  // namespace theia
@@ -35,12 +35,19 @@
 #include "theia/sfm/transformation/transform_reconstruction.h"
 
 #include <Eigen/Core>
+#include <glog/logging.h>
+
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <vector>
 
 #include "theia/sfm/camera/camera.h"
 #include "theia/sfm/reconstruction.h"
 #include "theia/sfm/track.h"
 #include "theia/sfm/types.h"
 #include "theia/sfm/view.h"
+#include "theia/util/threadpool.h"
 
 namespace theia {
 namespace {
@@ -66,6 +73,38 @@ void TransformCamera(const Eigen::Matrix3d& rotation,
   camera->SetPosition(camera_position);
 }
 
+void TransformViews(const Eigen::Matrix3d& rotation,
+                    const Eigen::Vector3d& translation,
+                    const double scale,
+                    const std::vector<ViewId>& view_ids,
+                    const int start,
+                    const int end,
+                    Reconstruction* reconstruction) {
+  for (int i = start; i < end; i++) {
+    View* view = reconstruction->MutableView(view_ids[i]);
+    if (view != nullptr && view->IsEstimated()) {
+      TransformCamera(rotation, translation, scale, view->MutableCamera());
+    }
+  }
+}
+
+void TransformTracks(const Eigen::Matrix3d& rotation,
+                     const Eigen::Vector3d& translation,
+                     const double scale,
+                     const std::vector<TrackId>& track_ids,
+                     const int start,
+                     const int end,
+                     Reconstruction* reconstruction) {
+  for (int i = start; i < end; i++) {
+    Track* track = reconstruction->MutableTrack(track_ids[i]);
+    if (track != nullptr && track->IsEstimated()) {
+      Eigen::Vector3d point = track->Point().hnormalized();
+      TransformPoint(rotation, translation, scale, &point);
+      *track->MutablePoint() = point.homogeneous();
+    }
+  }
+}
+
 }  // namespace
 
 // Applies the similarity transformation to the reconstruction, transforming the
@@ -74,23 +113,60 @@ void TransformReconstruction(const Eigen::Matrix3d& rotation,
                              const Eigen::Vector3d& translation,
                              const double scale,
                              Reconstruction* reconstruction) {
-  const auto& view_ids = reconstruction->ViewIds();
-  for (const ViewId view_id : view_ids) {
-    View* view = reconstruction->MutableView(view_id);
-    if (view->IsEstimated()) {
-      TransformCamera(rotation, translation, scale, view->MutableCamera());
-    }
+  TransformReconstruction(rotation, translation, scale, 1, reconstruction);
+}
+
+void TransformReconstruction(const Eigen::Matrix3d& rotation,
+                             const Eigen::Vector3d& translation,
+                             const double scale,
+                             const int num_threads,
+                             Reconstruction* reconstruction) {
+  TransformReconstruction(rotation,
+                          translation,
+                          scale,
+                          reconstruction->ViewIds(),
+                          reconstruction->TrackIds(),
+                          num_threads,
+                          reconstruction);
+}
+
+void TransformReconstruction(const Eigen::Matrix3d& rotation,
+                             const Eigen::Vector3d& translation,
+                             const double scale,
+                             const std::vector<ViewId>& view_ids,
+                             const std::vector<TrackId>& track_ids,
+                             const int num_threads,
+                             Reconstruction* reconstruction) {
+  CHECK_NOTNULL(reconstruction);
+  CHECK_GE(num_threads, 1);
+  if (num_threads == 1) {
+    TransformViews(rotation, translation, scale, view_ids, 0, view_ids.size(),
+                   reconstruction);
+    TransformTracks(rotation, translation, scale, track_ids, 0,
+                    track_ids.size(), reconstruction);
+    return;
   }
 
-  const auto& track_ids = reconstruction->TrackIds();
-  for (const TrackId track_id : track_ids) {
-    Track* track = reconstruction->MutableTrack(track_id);
-    if (track->IsEstimated()) {
-      Eigen::Vector3d point = track->Point().hnormalized();
-      TransformPoint(rotation, translation, scale, &point);
-      *track->MutablePoint() = point.homogeneous();
-    }
+  // Each thread transforms a contiguous block of views or tracks. The
+  // reconstruction containers are not modified, so concurrent lookups are safe
+  // and each camera and point is only written by a single thread.
+  std::unique_ptr<ThreadPool> pool(new ThreadPool(num_threads));
+  const int view_block_size =
+      std::max<int>(1, (view_ids.size() + num_threads - 1) / num_threads);
+  for (int i = 0; i < view_ids.size(); i += view_block_size) {
+    const int end = std::min<int>(i + view_block_size, view_ids.size());
+    pool->Add(TransformViews, std::cref(rotation), std::cref(translation),
+              scale, std::cref(view_ids), i, end, reconstruction);
+  }
+  const int track_block_size =
+      std::max<int>(1, (track_ids.size() + num_threads - 1) / num_threads);
+  for (int i = 0; i < track_ids.size(); i += track_block_size) {
+    const int end = std::min<int>(i + track_block_size, track_ids.size());
+    pool->Add(TransformTracks, std::cref(rotation), std::cref(translation),
+              scale, std::cref(track_ids), i, end, reconstruction);
   }
+  // Wait for all threads to finish.
+  pool.reset(nullptr);
 }
 
 }  // namespace theia
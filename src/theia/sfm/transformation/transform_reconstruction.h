@@ -36,6 +36,9 @@
 #define THEIA_SFM_TRANSFORMATION_TRANSFORM_RECONSTRUCTION_H_
 
 #include <Eigen/Core>
+#include <vector>
+
+#include "theia/sfm/types.h"
 
 namespace theia {
 class Reconstruction;
@@ -47,6 +50,25 @@ void TransformReconstruction(const Eigen::Matrix3d& rotation,
                              const double scale,
                              Reconstruction* reconstruction);
 
+// Same as above, but the views and tracks are split into blocks that are
+// transformed in parallel with num_threads threads.
+void TransformReconstruction(const Eigen::Matrix3d& rotation,
+                             const Eigen::Vector3d& translation,
+                             const double scale,
+                             const int num_threads,
+                             Reconstruction* reconstruction);
+
+// Only transforms the given views and tracks (those that are not estimated are
+// skipped). Callers that already gathered the estimated view and track ids can
+// use this to avoid re-scanning the reconstruction for every transformation.
+void TransformReconstruction(const Eigen::Matrix3d& rotation,
+                             const Eigen::Vector3d& translation,
+                             const double scale,
+                             const std::vector<ViewId>& view_ids,
+                             const std::vector<TrackId>& track_ids,
+                             const int num_threads,
+                             Reconstruction* reconstruction);
+
 }  // namespace theia
 
 #endif  // THEIA_SFM_TRANSFORMATION_TRANSFORM_RECONSTRUCTION_H_
@@ -40,6 +40,10 @@
 #include <Eigen/Geometry>
 #include <Eigen/SVD>
 #include <glog/logging.h>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <random>
 #include <vector>
 
 #include "theia/matching/feature_correspondence.h"
@@ -103,6 +107,112 @@ void FindOptimalImagePoints(const Matrix3d& ematrix,
           .hnormalized();
 }
 
+// Triangulates the point closest to two rays in closed form. The directions
+// are assumed to be unit vectors. Returns false if the rays are nearly parallel
+// or if the point lies behind either of the ray origins.
+bool TriangulateTwoRays(const Vector3d& origin1,
+                        const Vector3d& direction1,
+                        const Vector3d& origin2,
+                        const Vector3d& direction2,
+                        Vector3d* point) {
+  static const double kMinDenominator = 1e-12;
+
+  const Vector3d baseline = origin1 - origin2;
+  const double cos_angle = direction1.dot(direction2);
+  const double d1_baseline = direction1.dot(baseline);
+  const double d2_baseline = direction2.dot(baseline);
+  const double denominator = 1.0 - cos_angle * cos_angle;
+  if (denominator < kMinDenominator) {
+    return false;
+  }
+
+  const double depth1 = (cos_angle * d2_baseline - d1_baseline) / denominator;
+  const double depth2 = (d2_baseline - cos_angle * d1_baseline) / denominator;
+  if (depth1 <= 0 || depth2 <= 0) {
+    return false;
+  }
+
+  *point = 0.5 * (origin1 + depth1 * direction1 + origin2 + depth2 * direction2);
+  return true;
+}
+
+// Returns true if the point is in front of the ray origin and the angle between
+// the ray and the direction to the point is below the threshold.
+inline bool IsAngularInlier(const Vector3d& origin,
+                            const Vector3d& direction,
+                            const Vector3d& point,
+                            const double sq_cos_max_angular_error) {
+  const Vector3d to_point = point - origin;
+  const double depth = to_point.dot(direction);
+  return depth > 0 &&
+         depth * depth >= sq_cos_max_angular_error * to_point.squaredNorm();
+}
+
+int FindAngularInliers(const std::vector<Vector3d>& origins,
+                       const std::vector<Vector3d>& directions,
+                       const Vector3d& point,
+                       const double sq_cos_max_angular_error,
+                       std::vector<int>* inliers) {
+  inliers->clear();
+  for (int i = 0; i < origins.size(); i++) {
+    if (IsAngularInlier(
+            origins[i], directions[i], point, sq_cos_max_angular_error)) {
+      inliers->emplace_back(i);
+    }
+  }
+  return inliers->size();
+}
+
+int CountAngularInliers(const std::vector<Vector3d>& origins,
+                        const std::vector<Vector3d>& directions,
+                        const Vector3d& point,
+                        const double sq_cos_max_angular_error) {
+  int num_inliers = 0;
+  for (int i = 0; i < origins.size(); i++) {
+    if (IsAngularInlier(
+            origins[i], directions[i], point, sq_cos_max_angular_error)) {
+      ++num_inliers;
+    }
+  }
+  return num_inliers;
+}
+
+// Solves the 3x3 normal equations of the midpoint method over the inlier rays,
+// where each ray is weighted by the inverse squared distance from its origin to
+// the current estimate of the point. The distance of the point to a ray divided
+// by the depth is the sine of the angular error, so this reweighting makes the
+// linear cost approximate the angular error of the observations.
+bool RefinePointFromInlierRays(const std::vector<Vector3d>& origins,
+                               const std::vector<Vector3d>& directions,
+                               const std::vector<int>& inliers,
+                               Vector3d* point) {
+  Matrix3d lhs = Matrix3d::Zero();
+  Vector3d rhs = Vector3d::Zero();
+  for (const int i : inliers) {
+    const double sq_distance = (*point - origins[i]).squaredNorm();
+    if (sq_distance <= 0) {
+      return false;
+    }
+    const double weight = 1.0 / sq_distance;
+    const Matrix3d projection =
+        weight *
+        (Matrix3d::Identity() - directions[i] * directions[i].transpose());
+    lhs += projection;
+    rhs += projection * origins[i];
+  }
+
+  Eigen::LDLT<Matrix3d> linear_solver(lhs);
+  if (linear_solver.info() != Eigen::Success) {
+    return false;
+  }
+  const Vector3d refined_point = linear_solver.solve(rhs);
+  if (linear_solver.info() != Eigen::Success || !refined_point.allFinite()) {
+    return false;
+  }
+  *point = refined_point;
+  return true;
+}
+
 }  // namespace
 
 // Triangulates 2 posed views
@@ -249,4 +359,171 @@ bool SufficientTriangulationAngle(
   return false;
 }
 
+bool SufficientTriangulationAngleFromExtremeBearings(
+    const std::vector<Eigen::Vector3d>& ray_directions,
+    const double min_triangulation_angle_degrees) {
+  if (ray_directions.size() < 2) {
+    return false;
+  }
+
+  // Find the bearing that is furthest from the mean bearing. If the rays are
+  // symmetric about the point the mean is degenerate and we start from the
+  // first ray instead.
+  Vector3d mean_bearing = Vector3d::Zero();
+  for (const Vector3d& ray_direction : ray_directions) {
+    mean_bearing += ray_direction;
+  }
+  if (mean_bearing.squaredNorm() < 1e-12) {
+    mean_bearing = ray_directions[0];
+  }
+
+  int first_extreme = 0;
+  double min_dot = std::numeric_limits<double>::max();
+  for (int i = 0; i < ray_directions.size(); i++) {
+    const double dot = ray_directions[i].dot(mean_bearing);
+    if (dot < min_dot) {
+      min_dot = dot;
+      first_extreme = i;
+    }
+  }
+
+  // The second extreme bearing is the one furthest from the first.
+  min_dot = std::numeric_limits<double>::max();
+  for (int i = 0; i < ray_directions.size(); i++) {
+    min_dot = std::min(min_dot,
+                       ray_directions[i].dot(ray_directions[first_extreme]));
+  }
+
+  const double cos_of_min_angle =
+      cos(DegToRad(min_triangulation_angle_degrees));
+  return min_dot < cos_of_min_angle;
+}
+
+bool TriangulateRobust(const RobustTriangulationOptions& options,
+                       const std::vector<Eigen::Vector3d>& origins,
+                       const std::vector<Eigen::Vector3d>& ray_directions,
+                       Eigen::Vector4d* triangulated_point,
+                       std::vector<int>* inliers) {
+  CHECK_NOTNULL(triangulated_point);
+  CHECK_NOTNULL(inliers);
+  CHECK_EQ(origins.size(), ray_directions.size());
+  CHECK_GT(options.max_num_samples, 0);
+  inliers->clear();
+
+  const int num_observations = origins.size();
+  if (num_observations < 2) {
+    return false;
+  }
+
+  const double cos_min_triangulation_angle =
+      cos(DegToRad(options.min_triangulation_angle_degrees));
+  const double cos_max_angular_error =
+      cos(DegToRad(options.max_angular_error_degrees));
+  const double sq_cos_max_angular_error =
+      cos_max_angular_error * cos_max_angular_error;
+
+  // Evaluates the two-view hypothesis from observations i and j and keeps it if
+  // it has more support than the current best hypothesis.
+  Vector3d best_point;
+  int best_num_inliers = 0;
+  const auto evaluate_pair = [&](const int i, const int j) {
+    if (ray_directions[i].dot(ray_directions[j]) > cos_min_triangulation_angle) {
+      return;
+    }
+    Vector3d point;
+    if (!TriangulateTwoRays(origins[i],
+                            ray_directions[i],
+                            origins[j],
+                            ray_directions[j],
+                            &point)) {
+      return;
+    }
+    const int num_inliers = CountAngularInliers(
+        origins, ray_directions, point, sq_cos_max_angular_error);
+    if (num_inliers > best_num_inliers) {
+      best_num_inliers = num_inliers;
+      best_point = point;
+    }
+  };
+
+  const int64_t num_pairs =
+      static_cast<int64_t>(num_observations) * (num_observations - 1) / 2;
+  if (num_pairs <= options.max_num_samples) {
+    for (int i = 0; i < num_observations; i++) {
+      for (int j = i + 1; j < num_observations; j++) {
+        evaluate_pair(i, j);
+      }
+    }
+  } else {
+    // Seed the sampler deterministically so that the same track always
+    // produces the same point regardless of which thread triangulates it.
+    std::minstd_rand generator(num_observations);
+    std::uniform_int_distribution<int> distribution(0, num_observations - 1);
+    const double log_failure_probability = std::log(1.0 - options.confidence);
+    for (int iteration = 0; iteration < options.max_num_samples; iteration++) {
+      const int i = distribution(generator);
+      int j = distribution(generator);
+      if (i == j) {
+        j = (j + 1) % num_observations;
+      }
+      evaluate_pair(i, j);
+
+      // Terminate once enough pairs have been drawn to reach the desired
+      // confidence for the current inlier ratio.
+      if (best_num_inliers == num_observations) {
+        break;
+      }
+      const double inlier_ratio =
+          static_cast<double>(best_num_inliers) / num_observations;
+      const double log_prob_outlier_sample =
+          std::log(1.0 - inlier_ratio * inlier_ratio);
+      if (best_num_inliers > 0 && log_prob_outlier_sample < 0 &&
+          iteration + 1 >= log_failure_probability / log_prob_outlier_sample) {
+        break;
+      }
+    }
+  }
+
+  if (best_num_inliers < 2) {
+    return false;
+  }
+
+  // Refine the point from the inliers with a fixed number of reweighted solves.
+  FindAngularInliers(
+      origins, ray_directions, best_point, sq_cos_max_angular_error, inliers);
+  for (int i = 0; i < options.num_refinement_iterations; i++) {
+    Vector3d refined_point = best_point;
+    if (!RefinePointFromInlierRays(
+            origins, ray_directions, *inliers, &refined_point)) {
+      break;
+    }
+
+    std::vector<int> refined_inliers;
+    if (FindAngularInliers(origins,
+                           ray_directions,
+                           refined_point,
+                           sq_cos_max_angular_error,
+                           &refined_inliers) < inliers->size()) {
+      break;
+    }
+    best_point = refined_point;
+    inliers->swap(refined_inliers);
+  }
+
+  // Ensure the inliers are well-constrained.
+  std::vector<Vector3d> inlier_directions;
+  inlier_directions.reserve(inliers->size());
+  for (const int i : *inliers) {
+    inlier_directions.emplace_back(ray_directions[i]);
+  }
+  if (inliers->size() < 2 ||
+      !SufficientTriangulationAngleFromExtremeBearings(
+          inlier_directions, options.min_triangulation_angle_degrees)) {
+    return false;
+  }
+
+  *triangulated_point = best_point.homogeneous();
+  return true;
+}
+
 }  // namespace theia
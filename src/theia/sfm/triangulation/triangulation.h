@@ -103,6 +103,54 @@ bool SufficientTriangulationAngle(
     const std::vector<Eigen::Vector3d>& ray_directions,
     const double min_triangulation_angle_degrees);
 
+// Same as above, but runs in O(n) rather than O(n^2) by only testing the angle
+// between the two most extreme bearings: the ray furthest from the mean bearing
+// and the ray furthest from that one. This never accepts a set of rays whose
+// maximum angle is insufficient, but it may reject some sets that the
+// exhaustive test would accept when the rays are spread over a large cone.
+bool SufficientTriangulationAngleFromExtremeBearings(
+    const std::vector<Eigen::Vector3d>& ray_directions,
+    const double min_triangulation_angle_degrees);
+
+struct RobustTriangulationOptions {
+  // The maximum number of two-view hypotheses that are evaluated. If there are
+  // fewer observation pairs than this then all pairs are tested exhaustively.
+  int max_num_samples = 100;
+
+  // Random sampling stops early once the probability of having drawn an
+  // all-inlier pair of observations exceeds this confidence.
+  double confidence = 0.999;
+
+  // An observation is an inlier if the angle between its ray and the direction
+  // from its origin to the triangulated point is less than this threshold.
+  double max_angular_error_degrees = 0.5;
+
+  // Minimum angle between the rays of a two-view hypothesis and between the
+  // extreme bearings of the final inlier set.
+  double min_triangulation_angle_degrees = 3.0;
+
+  // Number of reweighted normal-equation solves used to refine the point from
+  // the inliers of the best hypothesis.
+  int num_refinement_iterations = 3;
+};
+
+// Robustly triangulates a point observed by many rays. Pairs of observations
+// are sampled (exhaustively or randomly up to max_num_samples) and each pair is
+// triangulated in closed form. The hypothesis with the largest number of
+// inliers, measured by angular error, is then refined with a fixed number of
+// iterations of the normal equations of the midpoint method where each ray is
+// weighted by its inverse squared distance to the point so that the cost
+// approximates angular error. The total cost is bounded by
+// O(max_num_samples * n) regardless of track length. We assume that the
+// directions are unit vectors. The indices of the inlier rays are returned in
+// inliers. Returns true on success and false if no hypothesis with a
+// sufficient triangulation angle could be found.
+bool TriangulateRobust(const RobustTriangulationOptions& options,
+                       const std::vector<Eigen::Vector3d>& origins,
+                       const std::vector<Eigen::Vector3d>& ray_directions,
+                       Eigen::Vector4d* triangulated_point,
+                       std::vector<int>* inliers);
+
 }  // namespace theia
 
 #endif  // THEIA_SFM_TRIANGULATION_TRIANGULATION_H_
@@ -496,5 +496,128 @@ TEST(SufficientTriangulationAngle, TwoInsufficient) {
   EXPECT_FALSE(SufficientTriangulationAngle(rays, kMinSufficientAngle));
 }
 
+TEST(SufficientTriangulationAngleFromExtremeBearings, AllSufficient) {
+  static const double kMinSufficientAngle = 4.0;
+  static const double kAngleBetweenCameras = 5.0;
+
+  for (int i = 2; i < 50; i++) {
+    std::vector<Vector3d> rays;
+    for (int j = 0; j < i; j++) {
+      rays.emplace_back(cos(DegToRad(j * kAngleBetweenCameras)),
+                        sin(DegToRad(j * kAngleBetweenCameras)),
+                        0.0);
+    }
+
+    EXPECT_TRUE(SufficientTriangulationAngleFromExtremeBearings(
+        rays, kMinSufficientAngle));
+  }
+}
+
+TEST(SufficientTriangulationAngleFromExtremeBearings, AllInsufficient) {
+  static const double kMinSufficientAngle = 4.0;
+
+  for (int i = 2; i < 50; i++) {
+    std::vector<Vector3d> rays;
+    const double angle = kMinSufficientAngle / static_cast<double>(i + 1e-4);
+    for (int j = 0; j < i; j++) {
+      rays.emplace_back(cos(DegToRad(j * angle)),
+                        sin(DegToRad(j * angle)),
+                        0.0);
+    }
+
+    EXPECT_FALSE(SufficientTriangulationAngleFromExtremeBearings(
+        rays, kMinSufficientAngle));
+  }
+}
+
+TEST(SufficientTriangulationAngleFromExtremeBearings, SomeInsufficient) {
+  static const double kMinSufficientAngle = 4.0;
+
+  std::vector<Vector3d> rays;
+  rays.emplace_back(cos(DegToRad(0)), sin(DegToRad(0)), 0.0);
+  rays.emplace_back(cos(DegToRad(5.0)), sin(DegToRad(5.0)), 0.0);
+  rays.emplace_back(cos(DegToRad(1.0)), sin(DegToRad(1.0)), 0.0);
+  EXPECT_TRUE(SufficientTriangulationAngleFromExtremeBearings(
+      rays, kMinSufficientAngle));
+}
+
+// Creates cameras on a circle of radius 10 around the origin that observe the
+// point. The first num_outliers observations are replaced by random rays.
+void CreateRobustTriangulationObservations(const Vector3d& point,
+                                           const int num_observations,
+                                           const int num_outliers,
+                                           const double noise_degrees,
+                                           std::vector<Vector3d>* origins,
+                                           std::vector<Vector3d>* directions) {
+  for (int i = 0; i < num_observations; i++) {
+    const double angle = DegToRad(90.0 * i / num_observations);
+    origins->emplace_back(10.0 * cos(angle), 0.0, 10.0 * sin(angle));
+    Vector3d direction = (point - origins->back()).normalized();
+    if (i < num_outliers) {
+      direction = (direction + rng.RandVector3d(-0.5, 0.5)).normalized();
+    } else if (noise_degrees > 0) {
+      const Vector3d axis = direction.cross(rng.RandVector3d()).normalized();
+      direction = Eigen::AngleAxisd(DegToRad(noise_degrees), axis) * direction;
+    }
+    directions->emplace_back(direction);
+  }
+}
+
+TEST(TriangulateRobust, NoOutliers) {
+  const Vector3d point(0.1, -0.2, 0.3);
+  std::vector<Vector3d> origins, directions;
+  CreateRobustTriangulationObservations(point, 20, 0, 0.0, &origins,
+                                        &directions);
+
+  RobustTriangulationOptions options;
+  Vector4d triangulated_point;
+  std::vector<int> inliers;
+  EXPECT_TRUE(TriangulateRobust(
+      options, origins, directions, &triangulated_point, &inliers));
+  EXPECT_EQ(inliers.size(), origins.size());
+  EXPECT_LT((triangulated_point.hnormalized() - point).norm(), 1e-8);
+}
+
+TEST(TriangulateRobust, LongTrackWithOutliers) {
+  static const int kNumObservations = 500;
+  static const int kNumOutliers = 150;
+  static const double kNoiseDegrees = 0.05;
+
+  const Vector3d point(0.1, -0.2, 0.3);
+  std::vector<Vector3d> origins, directions;
+  CreateRobustTriangulationObservations(point, kNumObservations, kNumOutliers,
+                                        kNoiseDegrees, &origins, &directions);
+
+  RobustTriangulationOptions options;
+  options.max_angular_error_degrees = 0.25;
+  Vector4d triangulated_point;
+  std::vector<int> inliers;
+  EXPECT_TRUE(TriangulateRobust(
+      options, origins, directions, &triangulated_point, &inliers));
+  EXPECT_GE(inliers.size(), kNumObservations - kNumOutliers);
+  EXPECT_LT((triangulated_point.hnormalized() - point).norm(), 1e-2);
+
+  // The midpoint method is corrupted by the outliers.
+  Vector4d midpoint;
+  EXPECT_TRUE(TriangulateMidpoint(origins, directions, &midpoint));
+  EXPECT_GT((midpoint.hnormalized() - point).norm(),
+            (triangulated_point.hnormalized() - point).norm());
+}
+
+TEST(TriangulateRobust, InsufficientAngle) {
+  const Vector3d point(0.0, 0.0, 100.0);
+  std::vector<Vector3d> origins, directions;
+  for (int i = 0; i < 10; i++) {
+    origins.emplace_back(0.01 * i, 0.0, 0.0);
+    directions.emplace_back((point - origins.back()).normalized());
+  }
+
+  RobustTriangulationOptions options;
+  Vector4d triangulated_point;
+  std::vector<int> inliers;
+  EXPECT_FALSE(TriangulateRobust(
+      options, origins, directions, &triangulated_point, &inliers));
+}
+
 }  // namespace
 }  // namespace theia
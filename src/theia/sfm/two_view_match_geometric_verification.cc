@@ -34,7 +34,9 @@
 
 #include "theia/sfm/two_view_match_geometric_verification.h"
 
+#include <Eigen/Core>
 #include <glog/logging.h>
+#include <memory>
 #include <vector>
 
 #include "theia/matching/feature_correspondence.h"
@@ -91,12 +93,33 @@ TwoViewMatchGeometricVerification::TwoViewMatchGeometricVerification(
     const KeypointsAndDescriptors& features1,
     const KeypointsAndDescriptors& features2,
     const std::vector<IndexedFeatureMatch>& matches)
+    : TwoViewMatchGeometricVerification(options,
+                                        intrinsics1,
+                                        intrinsics2,
+                                        features1,
+                                        features2,
+                                        matches,
+                                        Eigen::MatrixXd()) {}
+
+TwoViewMatchGeometricVerification::TwoViewMatchGeometricVerification(
+    const TwoViewMatchGeometricVerification::Options& options,
+    const CameraIntrinsicsPrior& intrinsics1,
+    const CameraIntrinsicsPrior& intrinsics2,
+    const KeypointsAndDescriptors& features1,
+    const KeypointsAndDescriptors& features2,
+    const std::vector<IndexedFeatureMatch>& matches,
+    const Eigen::MatrixXd& sorted_descriptor_distances)
     : options_(options),
       intrinsics1_(intrinsics1),
       intrinsics2_(intrinsics2),
       features1_(features1),
       features2_(features2),
-      matches_(matches) {}
+      matches_(matches),
+      sorted_descriptor_distances_(sorted_descriptor_distances) {
+  CHECK(sorted_descriptor_distances_.size() == 0 ||
+        sorted_descriptor_distances_.rows() == matches_.size())
+      << "There must be one row of sorted descriptor distances for each match.";
+}
 
 void TwoViewMatchGeometricVerification::CreateCorrespondencesFromIndexedMatches(
     std::vector<FeatureCorrespondence>* correspondences) {
@@ -129,6 +152,7 @@ bool TwoViewMatchGeometricVerification::VerifyMatches(
                            intrinsics1_,
                            intrinsics2_,
                            correspondences,
+                           sorted_descriptor_distances_,
                            twoview_info,
                            &inlier_indices)) {
     return false;
@@ -349,6 +373,10 @@ int TwoViewMatchGeometricVerification::CountHomographyInliers() {
   homography_params.use_mle = etvi_options.use_mle;
   homography_params.failure_probability =
       1.0 - etvi_options.expected_ransac_confidence;
+  if (sorted_descriptor_distances_.size() > 0) {
+    homography_params.evsac_sorted_distances =
+        std::make_shared<const Eigen::MatrixXd>(sorted_descriptor_distances_);
+  }
   RansacSummary homography_summary;
   Eigen::Matrix3d unused_homography;
   std::vector<FeatureCorrespondence> correspondences;
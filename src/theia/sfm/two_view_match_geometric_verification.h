@@ -35,6 +35,7 @@
 #ifndef THEIA_SFM_TWO_VIEW_MATCH_GEOMETRIC_VERIFICATION_H_
 #define THEIA_SFM_TWO_VIEW_MATCH_GEOMETRIC_VERIFICATION_H_
 
+#include <Eigen/Core>
 #include <vector>
 
 #include "theia/alignment/alignment.h"
@@ -100,12 +101,29 @@ class TwoViewMatchGeometricVerification {
       const KeypointsAndDescriptors& features2,
       const std::vector<IndexedFeatureMatch>& matches);
 
+  // Same as above, but also takes the k smallest L2 descriptor distances of the
+  // first feature of each match to the features of the second image, in
+  // ascending order with one row per match. These are used to estimate the
+  // two view geometry with RansacType::EVSAC.
+  TwoViewMatchGeometricVerification(
+      const Options& options,
+      const CameraIntrinsicsPrior& intrinsics1,
+      const CameraIntrinsicsPrior& intrinsics2,
+      const KeypointsAndDescriptors& features1,
+      const KeypointsAndDescriptors& features2,
+      const std::vector<IndexedFeatureMatch>& matches,
+      const Eigen::MatrixXd& sorted_descriptor_distances);
+
   // Perform 2-view geometric verification for the input. The verified matches
   // are returned along with the 2-view info. If the verification fails, false
   // is returned and the outputs are undefined.
   bool VerifyMatches(std::vector<FeatureCorrespondence>* verified_matches,
                      TwoViewInfo* twoview_info);
 
+  // Returns the current set of matches. After VerifyMatches succeeds, these are
+  // the verified matches in the same order as the output verified_matches.
+  const std::vector<IndexedFeatureMatch>& matches() const { return matches_; }
+
  private:
   // A helper method that creates a vector of FeatureCorrespondence from the
   // matches_ vector of match indices.
@@ -134,6 +152,9 @@ class TwoViewMatchGeometricVerification {
   // to it.
   std::vector<IndexedFeatureMatch> matches_;
 
+  // The sorted descriptor distances of the input matches, if given.
+  const Eigen::MatrixXd sorted_descriptor_distances_;
+
   DISALLOW_COPY_AND_ASSIGN(TwoViewMatchGeometricVerification);
 };
 
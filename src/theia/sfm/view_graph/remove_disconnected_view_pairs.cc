@@ -35,54 +35,53 @@
 #include "theia/sfm/view_graph/remove_disconnected_view_pairs.h"
 
 #include <glog/logging.h>
+#include <algorithm>
 #include <unordered_map>
 #include <unordered_set>
+#include <vector>
 
-#include "theia/math/graph/connected_components.h"
 #include "theia/sfm/types.h"
 #include "theia/sfm/view_graph/view_graph.h"
 
 namespace theia {
 
-// Removes all view pairs that are not part of the largest connected component.
 std::unordered_set<ViewId> RemoveDisconnectedViewPairs(ViewGraph* view_graph) {
+  return RemoveDisconnectedViewPairs(1, view_graph);
+}
+
+// Removes all view pairs that are not part of the largest connected component.
+std::unordered_set<ViewId> RemoveDisconnectedViewPairs(const int num_threads,
+                                                       ViewGraph* view_graph) {
   CHECK_NOTNULL(view_graph);
   std::unordered_set<ViewId> removed_views;
 
   // Extract all connected components.
-  ConnectedComponents<ViewId> cc_extractor;
-  const auto& view_pairs = view_graph->GetAllEdges();
-  for (const auto& view_pair : view_pairs) {
-    cc_extractor.AddEdge(view_pair.first.first, view_pair.first.second);
+  std::vector<ViewId> view_ids;
+  std::vector<int> component_labels;
+  const int num_components = view_graph->GetConnectedComponents(
+      num_threads, &view_ids, &component_labels);
+  if (num_components <= 1) {
+    return removed_views;
   }
-  std::unordered_map<ViewId, std::unordered_set<ViewId> > connected_components;
-  cc_extractor.Extract(&connected_components);
 
   // Find the largest connected component.
-  int max_cc_size = 0;
-  ViewId largest_cc_root_id = kInvalidViewId;
-  for (const auto& connected_component : connected_components) {
-    if (connected_component.second.size() > max_cc_size) {
-      max_cc_size = connected_component.second.size();
-      largest_cc_root_id = connected_component.first;
-    }
+  std::vector<int> component_sizes(num_components, 0);
+  for (const int component_label : component_labels) {
+    ++component_sizes[component_label];
   }
+  const int largest_cc_label =
+      std::max_element(component_sizes.begin(), component_sizes.end()) -
+      component_sizes.begin();
 
   // Remove all view pairs containing a view to remove (i.e. the ones that are
-  // not in the largest connectedcomponent).
+  // not in the largest connected component).
   const int num_view_pairs_before_filtering = view_graph->NumEdges();
-  for (const auto& connected_component : connected_components) {
-    if (connected_component.first == largest_cc_root_id) {
+  for (int i = 0; i < view_ids.size(); i++) {
+    if (component_labels[i] == largest_cc_label) {
       continue;
     }
-
-    // NOTE: The connected component will contain the root id as well, so we do
-    // not explicity have to remove connected_component.first since it will
-    // exist in connected_components.second
-    for (const ViewId view_id2 : connected_component.second) {
-      view_graph->RemoveView(view_id2);
-      removed_views.insert(view_id2);
-    }
+    view_graph->RemoveView(view_ids[i]);
+    removed_views.insert(view_ids[i]);
   }
 
   const int num_removed_view_pairs =
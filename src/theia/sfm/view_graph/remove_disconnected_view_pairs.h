@@ -47,6 +47,11 @@ class ViewGraph;
 // and returns the ViewIds of the views that were removed.
 std::unordered_set<ViewId> RemoveDisconnectedViewPairs(ViewGraph* view_graph);
 
+// Same as above, but the connected components are computed with num_threads
+// threads.
+std::unordered_set<ViewId> RemoveDisconnectedViewPairs(const int num_threads,
+                                                       ViewGraph* view_graph);
+
 }  // namespace theia
 
 #endif  // THEIA_SFM_VIEW_GRAPH_REMOVE_DISCONNECTED_VIEW_PAIRS_H_
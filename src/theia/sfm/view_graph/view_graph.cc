@@ -35,18 +35,22 @@
 #include "theia/sfm/view_graph/view_graph.h"
 
 #include <cereal/archives/portable_binary.hpp>
+#include <algorithm>
 #include <cstdio>
 #include <cstdlib>
 #include <fstream>   // NOLINT
 #include <iostream>  // NOLINT
 #include <unordered_map>
 #include <unordered_set>
+#include <utility>
+#include <vector>
 
-#include "theia/math/graph/connected_components.h"
+#include "theia/math/graph/parallel_connected_components.h"
 #include "theia/sfm/twoview_info.h"
 #include "theia/sfm/types.h"
 #include "theia/util/hash.h"
 #include "theia/util/map_util.h"
+#include "theia/util/threadpool.h"
 
 namespace theia {
 
@@ -237,31 +241,75 @@ void ViewGraph::ExtractSubgraph(
   }
 }
 
-void ViewGraph::GetLargestConnectedComponentIds(
-    std::unordered_set<ViewId>* largest_cc) const {
-  ConnectedComponents<ViewId> cc_extractor;
-  // Add all edges to the connected components extractor.
+int ViewGraph::GetConnectedComponents(
+    const int num_threads,
+    std::vector<ViewId>* view_ids,
+    std::vector<int>* component_labels) const {
+  CHECK_NOTNULL(view_ids)->clear();
+  CHECK_NOTNULL(component_labels);
+
+  // Map the view ids to contiguous node indices.
+  view_ids->reserve(vertices_.size());
+  std::unordered_map<ViewId, int> view_id_to_index;
+  view_id_to_index.reserve(vertices_.size());
+  for (const auto& vertex : vertices_) {
+    view_id_to_index.emplace(vertex.first, view_ids->size());
+    view_ids->emplace_back(vertex.first);
+  }
+
+  std::vector<ViewIdPair> view_id_pairs;
+  view_id_pairs.reserve(edges_.size());
   for (const auto& edge : edges_) {
-    cc_extractor.AddEdge(edge.first.first, edge.first.second);
+    view_id_pairs.emplace_back(edge.first);
   }
 
-  // Extract all connected components.
-  std::unordered_map<ViewId, std::unordered_set<ViewId> > connected_components;
-  cc_extractor.Extract(&connected_components);
+  // Convert the edges to node indices in parallel. Concurrent lookups in the
+  // map are safe since it is not modified.
+  std::vector<std::pair<int, int> > edges(view_id_pairs.size());
+  ParallelForBlocks(
+      num_threads, edges.size(), [&](const int start, const int end) {
+        for (int i = start; i < end; i++) {
+          edges[i].first =
+              FindOrDieNoPrint(view_id_to_index, view_id_pairs[i].first);
+          edges[i].second =
+              FindOrDieNoPrint(view_id_to_index, view_id_pairs[i].second);
+        }
+      });
+
+  return ComputeConnectedComponentLabels(
+      view_ids->size(), edges, num_threads, component_labels);
+}
+
+void ViewGraph::GetLargestConnectedComponentIds(
+    std::unordered_set<ViewId>* largest_cc) const {
+  GetLargestConnectedComponentIds(1, largest_cc);
+}
+
+void ViewGraph::GetLargestConnectedComponentIds(
+    const int num_threads, std::unordered_set<ViewId>* largest_cc) const {
+  CHECK_NOTNULL(largest_cc)->clear();
+
+  std::vector<ViewId> view_ids;
+  std::vector<int> component_labels;
+  const int num_components =
+      GetConnectedComponents(num_threads, &view_ids, &component_labels);
+  CHECK_GT(num_components, 0);
 
   // Search for the largest CC in the viewing graph.
-  ViewId largest_cc_id = kInvalidViewId;
-  int largest_cc_size = 0;
-  for (const auto& connected_component : connected_components) {
-    if (connected_component.second.size() > largest_cc_size) {
-      largest_cc_size = connected_component.second.size();
-      largest_cc_id = connected_component.first;
+  std::vector<int> component_sizes(num_components, 0);
+  for (const int component_label : component_labels) {
+    ++component_sizes[component_label];
+  }
+  const int largest_cc_label =
+      std::max_element(component_sizes.begin(), component_sizes.end()) -
+      component_sizes.begin();
+
+  largest_cc->reserve(component_sizes[largest_cc_label]);
+  for (int i = 0; i < view_ids.size(); i++) {
+    if (component_labels[i] == largest_cc_label) {
+      largest_cc->insert(view_ids[i]);
     }
   }
-  CHECK_NE(largest_cc_id, kInvalidViewId);
-
-  // Swap the largest connected component to the output.
-  std::swap(*largest_cc, connected_components[largest_cc_id]);
 }
 
 }  // namespace theia
@@ -43,6 +43,7 @@
 #include <cereal/types/utility.hpp>
 #include <unordered_map>
 #include <unordered_set>
+#include <vector>
 
 #include "theia/sfm/twoview_info.h"
 #include "theia/sfm/types.h"
@@ -116,10 +117,20 @@ class ViewGraph {
   void ExtractSubgraph(const std::unordered_set<ViewId>& views_in_subgraph,
                        ViewGraph* subgraph) const;
 
+  // Computes the connected components of the view graph with num_threads
+  // threads. Each view in view_ids is assigned a component label in
+  // [0, num_components) in component_labels, and the number of connected
+  // components is returned.
+  int GetConnectedComponents(const int num_threads,
+                             std::vector<ViewId>* view_ids,
+                             std::vector<int>* component_labels) const;
+
   // Returns the views ids participating in the largest connected component in
   // the view graph.
   void GetLargestConnectedComponentIds(
       std::unordered_set<ViewId>* largest_cc) const;
+  void GetLargestConnectedComponentIds(
+      const int num_threads, std::unordered_set<ViewId>* largest_cc) const;
 
  private:
   // Templated method for disk I/O with cereal. This method tells cereal which
@@ -223,4 +223,28 @@ TEST(ViewGraph, ExtractSubgraphLarge) {
   }
 }
 
+TEST(ViewGraph, GetLargestConnectedComponentIds) {
+  const TwoViewInfo info;
+  ViewGraph graph;
+  // A component with views 10, 11, 12, 13 and one with views 0, 1, 2.
+  graph.AddEdge(10, 11, info);
+  graph.AddEdge(12, 11, info);
+  graph.AddEdge(13, 12, info);
+  graph.AddEdge(0, 1, info);
+  graph.AddEdge(1, 2, info);
+
+  std::vector<ViewId> view_ids;
+  std::vector<int> component_labels;
+  EXPECT_EQ(graph.GetConnectedComponents(2, &view_ids, &component_labels), 2);
+  EXPECT_EQ(view_ids.size(), 7);
+  EXPECT_EQ(component_labels.size(), 7);
+
+  const std::unordered_set<ViewId> expected_largest_cc = { 10, 11, 12, 13 };
+  for (const int num_threads : { 1, 4 }) {
+    std::unordered_set<ViewId> largest_cc;
+    graph.GetLargestConnectedComponentIds(num_threads, &largest_cc);
+    EXPECT_EQ(largest_cc, expected_largest_cc);
+  }
+}
+
 }  // namespace theia
@@ -36,12 +36,39 @@
 
 #include <Eigen/Core>
 #include <glog/logging.h>
+#include <stdint.h>
+#include <array>
 #include <vector>
 
 #include "theia/math/util.h"
 
 namespace theia {
 
+namespace {
+
+int PopulationCount(uint64_t value) {
+  value = value - ((value >> 1) & 0x5555555555555555ULL);
+  value = (value & 0x3333333333333333ULL) +
+          ((value >> 2) & 0x3333333333333333ULL);
+  value = (value + (value >> 4)) & 0x0f0f0f0f0f0f0f0fULL;
+  return static_cast<int>((value * 0x0101010101010101ULL) >> 56);
+}
+
+// ORs each pair of adjacent bits and packs the resulting 32 bits into the lower
+// half of the value, i.e. bit i of the output is bit 2i | bit 2i + 1 of the
+// input.
+uint64_t OrAdjacentBits(uint64_t value) {
+  value = (value | (value >> 1)) & 0x5555555555555555ULL;
+  value = (value | (value >> 1)) & 0x3333333333333333ULL;
+  value = (value | (value >> 2)) & 0x0f0f0f0f0f0f0f0fULL;
+  value = (value | (value >> 4)) & 0x00ff00ff00ff00ffULL;
+  value = (value | (value >> 8)) & 0x0000ffff0000ffffULL;
+  value = (value | (value >> 16)) & 0x00000000ffffffffULL;
+  return value;
+}
+
+}  // namespace
+
 // The inputs are the view/image width and height, as well as the number of
 // desired levels in the image pyramid.
 VisibilityPyramid::VisibilityPyramid(const int width,
@@ -102,4 +129,57 @@ int VisibilityPyramid::ComputeScore() const {
   return score;
 }
 
+// Definition of the static member, which is odr-used by CHECK_LE below.
+const int BitsetVisibilityPyramid::kMaxNumPyramidLevels;
+
+BitsetVisibilityPyramid::BitsetVisibilityPyramid(const int width,
+                                                 const int height,
+                                                 const int num_pyramid_levels)
+    : width_(width),
+      height_(height),
+      num_pyramid_levels_(num_pyramid_levels),
+      max_cells_in_dimension_(1 << num_pyramid_levels) {
+  CHECK_GT(width_, 0);
+  CHECK_GT(height_, 0);
+  CHECK_GT(num_pyramid_levels_, 0);
+  CHECK_LE(num_pyramid_levels_, kMaxNumPyramidLevels);
+  finest_level_.fill(0);
+}
+
+void BitsetVisibilityPyramid::AddPoint(const Eigen::Vector2d& point) {
+  // The grid cell is computed exactly as in VisibilityPyramid::AddPoint so that
+  // the scores are identical.
+  const int grid_cell_x = theia::Clamp(
+      static_cast<int>(max_cells_in_dimension_ * point.x() / width_),
+      0,
+      max_cells_in_dimension_ - 1);
+  const int grid_cell_y = theia::Clamp(
+      static_cast<int>(max_cells_in_dimension_ * point.y() / height_),
+      0,
+      max_cells_in_dimension_ - 1);
+  finest_level_[grid_cell_y] |= uint64_t(1) << grid_cell_x;
+}
+
+int BitsetVisibilityPyramid::ComputeScore() const {
+  std::array<uint64_t, kMaxCellsInDimension> level = finest_level_;
+  int score = 0;
+  // Go through the pyramid from fine to coarse. Each level is weighted by its
+  // number of grid cells as in VisibilityPyramid::ComputeScore.
+  for (int num_cells = max_cells_in_dimension_; num_cells >= 2;
+       num_cells >>= 1) {
+    int num_occupied_cells = 0;
+    for (int y = 0; y < num_cells; y++) {
+      num_occupied_cells += PopulationCount(level[y]);
+    }
+    score += num_occupied_cells * num_cells * num_cells;
+
+    // A cell of the next coarser level is occupied if any of the 2x2 cells it
+    // covers in this level is occupied.
+    for (int y = 0; y < num_cells / 2; y++) {
+      level[y] = OrAdjacentBits(level[2 * y] | level[2 * y + 1]);
+    }
+  }
+  return score;
+}
+
 }  // namespace theia
@@ -36,6 +36,8 @@
 #define THEIA_SFM_VISIBILITY_PYRAMID_H_
 
 #include <Eigen/Core>
+#include <stdint.h>
+#include <array>
 #include <vector>
 
 namespace theia {
@@ -77,6 +79,38 @@ class VisibilityPyramid {
   // The pyramid is stored from coarse to fine and is indexed as (x, y).
   std::vector<Eigen::MatrixXi> pyramid_;
 };
+
+// A fixed capacity variant of the VisibilityPyramid that does not allocate any
+// memory, so that it may be cheaply created on the stack for each view or view
+// pair that is scored. Only the occupancy of the finest level is stored, as one
+// 64-bit row of cells per grid row, and the coarser levels are derived by
+// OR-reducing 2x2 blocks of cells when the score is computed. The scores are
+// identical to those of a VisibilityPyramid with the same inputs.
+class BitsetVisibilityPyramid {
+ public:
+  // The finest level of the pyramid has 2^num_pyramid_levels cells in each
+  // dimension, so at most 6 levels may be used.
+  static const int kMaxNumPyramidLevels = 6;
+
+  BitsetVisibilityPyramid(const int width,
+                          const int height,
+                          const int num_pyramid_levels);
+
+  // Add a point to the visibility pyramid.
+  void AddPoint(const Eigen::Vector2d& point);
+
+  // Compute the score of the visibility pyramid. Higher scores indicate that
+  // the view is better constrained by the points.
+  int ComputeScore() const;
+
+ private:
+  static const int kMaxCellsInDimension = 1 << kMaxNumPyramidLevels;
+
+  const int width_, height_, num_pyramid_levels_, max_cells_in_dimension_;
+  // Bit x of row y is set if the cell (x, y) of the finest level is occupied.
+  std::array<uint64_t, kMaxCellsInDimension> finest_level_;
+};
+
 }  // namespace theia
 
 #endif  // THEIA_SFM_VISIBILITY_PYRAMID_H_
@@ -0,0 +1,95 @@
+// Copyright (C) 2026 The Regents of the University of California (Regents).
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials provided
+//       with the distribution.
+//
+//     * Neither the name of The Regents or University of California nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+// Please contact the author of this library if you have any questions.
+// Author: agent (agent@local)
+
+#include <Eigen/Core>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "theia/sfm/visibility_pyramid.h"
+#include "theia/util/random.h"
+
+namespace theia {
+
+namespace {
+
+RandomNumberGenerator rng(57);
+
+}  // namespace
+
+TEST(BitsetVisibilityPyramid, EmptyPyramid) {
+  const BitsetVisibilityPyramid pyramid(640, 480, 6);
+  EXPECT_EQ(pyramid.ComputeScore(), 0);
+}
+
+TEST(BitsetVisibilityPyramid, SinglePoint) {
+  static const int kNumPyramidLevels = 3;
+  BitsetVisibilityPyramid pyramid(640, 480, kNumPyramidLevels);
+  pyramid.AddPoint(Eigen::Vector2d(100.0, 200.0));
+  // One occupied cell in the 2x2, 4x4, and 8x8 levels.
+  EXPECT_EQ(pyramid.ComputeScore(), 4 + 16 + 64);
+
+  // Adding a point to the same cell does not change the score.
+  pyramid.AddPoint(Eigen::Vector2d(101.0, 201.0));
+  EXPECT_EQ(pyramid.ComputeScore(), 4 + 16 + 64);
+}
+
+TEST(BitsetVisibilityPyramid, SameScoreAsVisibilityPyramid) {
+  static const int kNumTrials = 1000;
+  static const int kMaxNumPoints = 500;
+
+  for (int i = 0; i < kNumTrials; i++) {
+    const int width = rng.RandInt(1, 4000);
+    const int height = rng.RandInt(1, 4000);
+    const int num_pyramid_levels =
+        rng.RandInt(1, BitsetVisibilityPyramid::kMaxNumPyramidLevels);
+    VisibilityPyramid pyramid(width, height, num_pyramid_levels);
+    BitsetVisibilityPyramid bitset_pyramid(width, height, num_pyramid_levels);
+
+    // Some of the points are outside of the image to test the clamping to the
+    // border cells.
+    const int num_points = rng.RandInt(0, kMaxNumPoints);
+    for (int j = 0; j < num_points; j++) {
+      const Eigen::Vector2d point(rng.RandDouble(-0.1 * width, 1.1 * width),
+                                  rng.RandDouble(-0.1 * height, 1.1 * height));
+      pyramid.AddPoint(point);
+      bitset_pyramid.AddPoint(point);
+      if (j % 50 == 0) {
+        ASSERT_EQ(bitset_pyramid.ComputeScore(), pyramid.ComputeScore());
+      }
+    }
+    ASSERT_EQ(bitset_pyramid.ComputeScore(), pyramid.ComputeScore());
+  }
+}
+
+}  // namespace theia
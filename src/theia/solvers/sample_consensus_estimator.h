@@ -35,6 +35,7 @@
 #ifndef THEIA_SOLVERS_SAMPLE_CONSENSUS_ESTIMATOR_H_
 #define THEIA_SOLVERS_SAMPLE_CONSENSUS_ESTIMATOR_H_
 
+#include <Eigen/Core>
 #include <algorithm>
 #include <cmath>
 #include <glog/logging.h>
@@ -111,6 +112,12 @@ struct RansacParameters {
   //
   // NOTE: Not currently implemented!
   bool use_Tdd_test;
+
+  // The k smallest descriptor distances of each data point (i.e., of the first
+  // feature of each correspondence to the features of the other image) in
+  // ascending order, with one row per data point. These are only used by the
+  // EVSAC sampler, which requires them when RansacType::EVSAC is used.
+  std::shared_ptr<const Eigen::MatrixXd> evsac_sorted_distances;
 };
 
 // A struct to hold useful outputs of Ransac-like methods.
@@ -0,0 +1,151 @@
+// Copyright (C) 2026 The Regents of the University of California (Regents).
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials provided
+//       with the distribution.
+//
+//     * Neither the name of The Regents or University of California nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+// Please contact the author of this library if you have any questions.
+// Author: agent (agent@local)
+
+#include "theia/util/cpu_features.h"
+
+#include <glog/logging.h>
+#include <stdint.h>
+#include <string>
+
+#if (defined(__GNUC__) || defined(__clang__)) && defined(__x86_64__)
+#define THEIA_DETECT_X86_CPU_FEATURES
+#include <cpuid.h>
+#endif
+
+namespace theia {
+
+namespace {
+
+#ifdef THEIA_DETECT_X86_CPU_FEATURES
+
+// Returns the extended control register 0 which describes the register states
+// that the operating system saves on context switches.
+uint64_t GetExtendedControlRegister() {
+  uint32_t eax, edx;
+  __asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+  return (static_cast<uint64_t>(edx) << 32) | eax;
+}
+
+CpuFeatures DetectCpuFeatures() {
+  CpuFeatures features;
+  uint32_t eax, ebx, ecx, edx;
+  const uint32_t max_leaf = __get_cpuid_max(0, nullptr);
+  if (max_leaf < 1) {
+    return features;
+  }
+
+  __cpuid(1, eax, ebx, ecx, edx);
+  features.sse4_2 = ecx & (1 << 20);
+  features.popcnt = ecx & (1 << 23);
+  const bool has_osxsave = ecx & (1 << 27);
+  const bool has_avx = ecx & (1 << 28);
+  const bool has_fma = ecx & (1 << 12);
+
+  // The AVX and AVX-512 registers may only be used if the operating system
+  // saves them.
+  const uint64_t xcr0 = has_osxsave ? GetExtendedControlRegister() : 0;
+  // XMM and YMM state.
+  const bool os_saves_avx = (xcr0 & 0x6) == 0x6;
+  // XMM, YMM, opmask and ZMM state.
+  const bool os_saves_avx512 = (xcr0 & 0xe6) == 0xe6;
+
+  features.avx = has_avx && os_saves_avx;
+  features.fma = has_fma && features.avx;
+  if (max_leaf < 7) {
+    return features;
+  }
+
+  __cpuid_count(7, 0, eax, ebx, ecx, edx);
+  features.avx2 = features.avx && (ebx & (1 << 5));
+  features.avx512f = os_saves_avx512 && (ebx & (1 << 16));
+  features.avx512bw = features.avx512f && (ebx & (1 << 30));
+  features.avx512vnni = features.avx512f && (ecx & (1 << 11));
+  features.avx512vpopcntdq = features.avx512f && (ecx & (1 << 14));
+  return features;
+}
+
+#else
+
+CpuFeatures DetectCpuFeatures() { return CpuFeatures(); }
+
+#endif  // THEIA_DETECT_X86_CPU_FEATURES
+
+SimdLevel DetermineSimdLevel(const CpuFeatures& features) {
+  if (!features.sse4_2 || !features.popcnt) {
+    return SimdLevel::SCALAR;
+  }
+  if (!features.avx2 || !features.fma) {
+    return SimdLevel::SSE4_2;
+  }
+  if (!features.avx512f || !features.avx512bw) {
+    return SimdLevel::AVX2;
+  }
+  return SimdLevel::AVX512;
+}
+
+}  // namespace
+
+const CpuFeatures& GetCpuFeatures() {
+  // Function-local statics are initialized exactly once in a thread-safe way.
+  static const CpuFeatures features = DetectCpuFeatures();
+  return features;
+}
+
+SimdLevel GetSupportedSimdLevel() {
+  static const SimdLevel simd_level = DetermineSimdLevel(GetCpuFeatures());
+  return simd_level;
+}
+
+bool IsSimdLevelSupported(const SimdLevel simd_level) {
+  return static_cast<int>(simd_level) <=
+         static_cast<int>(GetSupportedSimdLevel());
+}
+
+std::string SimdLevelToString(const SimdLevel simd_level) {
+  switch (simd_level) {
+    case SimdLevel::SCALAR:
+      return "SCALAR";
+    case SimdLevel::SSE4_2:
+      return "SSE4_2";
+    case SimdLevel::AVX2:
+      return "AVX2";
+    case SimdLevel::AVX512:
+      return "AVX512";
+    default:
+      LOG(FATAL) << "Invalid SIMD level.";
+      return "";
+  }
+}
+
+}  // namespace theia
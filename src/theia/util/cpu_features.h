@@ -0,0 +1,86 @@
+// Copyright (C) 2026 The Regents of the University of California (Regents).
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials provided
+//       with the distribution.
+//
+//     * Neither the name of The Regents or University of California nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+// Please contact the author of this library if you have any questions.
+// Author: agent (agent@local)
+
+#ifndef THEIA_UTIL_CPU_FEATURES_H_
+#define THEIA_UTIL_CPU_FEATURES_H_
+
+#include <string>
+
+namespace theia {
+
+// The instruction set extensions that the CPU and operating system support.
+// The features are detected once at runtime so that a single binary can select
+// the fastest kernels for the machine it runs on, independently of the flags
+// the library was compiled with.
+struct CpuFeatures {
+  bool sse4_2 = false;
+  bool popcnt = false;
+  bool avx = false;
+  bool avx2 = false;
+  bool fma = false;
+  bool avx512f = false;
+  bool avx512bw = false;
+  bool avx512vnni = false;
+  bool avx512vpopcntdq = false;
+};
+
+// The levels of SIMD kernels that may be dispatched to. Each level implies
+// that all lower levels are supported as well.
+//   SSE4_2: SSE4.2 and POPCNT.
+//   AVX2:   AVX2 and FMA.
+//   AVX512: AVX-512F and AVX-512BW. Kernels may additionally use VNNI or
+//           VPOPCNTDQ if CpuFeatures reports them.
+enum class SimdLevel {
+  SCALAR = 0,
+  SSE4_2 = 1,
+  AVX2 = 2,
+  AVX512 = 3,
+};
+
+// Returns the features of the CPU. The features are only detected on the first
+// call. On platforms other than x86-64 with GCC or Clang no features are
+// reported and only the scalar kernels are used.
+const CpuFeatures& GetCpuFeatures();
+
+// Returns the highest SIMD level supported by the CPU.
+SimdLevel GetSupportedSimdLevel();
+
+// Returns true if kernels of the SIMD level may be run on the CPU.
+bool IsSimdLevelSupported(const SimdLevel simd_level);
+
+std::string SimdLevelToString(const SimdLevel simd_level);
+
+}  // namespace theia
+
+#endif  // THEIA_UTIL_CPU_FEATURES_H_
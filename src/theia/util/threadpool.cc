@@ -62,6 +62,7 @@
 
 #include <glog/logging.h>
 
+#include <algorithm>
 #include <condition_variable>
 #include <functional>
 #include <future>
@@ -114,4 +115,21 @@ ThreadPool::~ThreadPool() {
     worker.join();
 }
 
+void ParallelForBlocks(const int num_threads,
+                       const int num_items,
+                       const std::function<void(const int, const int)>& fn) {
+  if (num_threads <= 1 || num_items < num_threads) {
+    fn(0, num_items);
+    return;
+  }
+
+  const int block_size = (num_items + num_threads - 1) / num_threads;
+  std::unique_ptr<ThreadPool> pool(new ThreadPool(num_threads));
+  for (int i = 0; i < num_items; i += block_size) {
+    pool->Add(fn, i, std::min(i + block_size, num_items));
+  }
+  // Wait for all blocks to be processed.
+  pool.reset(nullptr);
+}
+
 }  // namespace theia
@@ -107,6 +107,13 @@ class ThreadPool {
   DISALLOW_COPY_AND_ASSIGN(ThreadPool);
 };
 
+// Runs fn(start, end) on contiguous blocks of [0, num_items) with num_threads
+// threads and waits for all blocks to finish. Each block is only visited by a
+// single thread. If num_threads is 1 then fn is run on the calling thread.
+void ParallelForBlocks(const int num_threads,
+                       const int num_items,
+                       const std::function<void(const int, const int)>& fn);
+
 // add new work item to the pool
 template <class F, class... Args>
 auto ThreadPool::Add(F&& f, Args&& ... args)